@@ -4,9 +4,11 @@
 
 #include "flutter/assets/directory_asset_bundle.h"
 
+#include <functional>
 #include <regex>
 #include <utility>
 
+#include "flutter/assets/packed_asset_bundle.h"
 #include "flutter/fml/eintr_wrapper.h"
 #include "flutter/fml/file.h"
 #include "flutter/fml/mapping.h"
@@ -14,13 +16,45 @@
 
 namespace flutter {
 
+namespace {
+
+using AssetVisitor = std::function<void(const fml::UniqueFD& directory,
+                                        const std::string& filename,
+                                        const std::string& asset_name)>;
+
+// Visits the files in |directory|, and in its subdirectories if |recursive|,
+// along with their path from the assets directory.
+void VisitAssets(const fml::UniqueFD& directory,
+                 const std::string& prefix,
+                 bool recursive,
+                 const AssetVisitor& visitor) {
+  fml::VisitFiles(directory, [&](const fml::UniqueFD& parent,
+                                 const std::string& filename) {
+    if (fml::IsDirectory(parent, filename.c_str())) {
+      if (recursive) {
+        VisitAssets(fml::OpenDirectoryReadOnly(parent, filename.c_str()),
+                    prefix + filename + "/", recursive, visitor);
+      }
+      return true;
+    }
+    visitor(parent, filename, prefix + filename);
+    return true;
+  });
+}
+
+}  // namespace
+
 DirectoryAssetBundle::DirectoryAssetBundle(
     fml::UniqueFD descriptor,
-    bool is_valid_after_asset_manager_change)
+    bool is_valid_after_asset_manager_change,
+    std::unique_ptr<AssetResolver> packed_assets)
     : descriptor_(std::move(descriptor)) {
   if (!fml::IsDirectory(descriptor_)) {
     return;
   }
+  if (packed_assets && packed_assets->IsValid()) {
+    packed_assets_ = std::move(packed_assets);
+  }
   is_valid_after_asset_manager_change_ = is_valid_after_asset_manager_change;
   is_valid_ = true;
 }
@@ -50,6 +84,16 @@ std::unique_ptr<fml::Mapping> DirectoryAssetBundle::GetAsMapping(
     return nullptr;
   }
 
+  if (asset_name == PackedAssetBundle::kFileName) {
+    return nullptr;
+  }
+  if (packed_assets_) {
+    auto mapping = packed_assets_->GetAsMapping(asset_name);
+    if (mapping != nullptr) {
+      return mapping;
+    }
+  }
+
   auto mapping = std::make_unique<fml::FileMapping>(fml::OpenFile(
       descriptor_, asset_name.c_str(), false, fml::FilePermission::kRead));
 
@@ -69,43 +113,52 @@ std::vector<std::unique_ptr<fml::Mapping>> DirectoryAssetBundle::GetAsMappings(
     return mappings;
   }
 
-  std::regex asset_regex(asset_pattern);
-  fml::FileVisitor visitor = [&](const fml::UniqueFD& directory,
-                                 const std::string& filename) {
-    TRACE_EVENT0("flutter", "DirectoryAssetBundle::GetAsMappings FileVisitor");
+  std::string prefix;
+  const fml::UniqueFD* search_dir = &descriptor_;
+  fml::UniqueFD subdir_fd;
+  if (subdir) {
+    prefix = subdir.value() + "/";
+    subdir_fd = fml::OpenFileReadOnly(descriptor_, subdir.value().c_str());
+    search_dir = &subdir_fd;
+    if (!fml::IsDirectory(subdir_fd)) {
+      FML_LOG(ERROR) << "Subdirectory path " << subdir.value()
+                     << " is not a directory";
+      return mappings;
+    }
+  }
 
-    if (std::regex_match(filename, asset_regex)) {
-      TRACE_EVENT0("flutter", "Matched File");
+  if (packed_assets_) {
+    mappings = packed_assets_->GetAsMappings(asset_pattern, subdir);
+  }
 
-      fml::UniqueFD fd = fml::OpenFile(directory, filename.c_str(), false,
-                                       fml::FilePermission::kRead);
+  std::regex asset_regex(asset_pattern);
+  AssetVisitor visitor = [&](const fml::UniqueFD& directory,
+                             const std::string& filename,
+                             const std::string& asset_name) {
+    TRACE_EVENT0("flutter", "DirectoryAssetBundle::GetAsMappings FileVisitor");
 
-      if (fml::IsDirectory(fd)) {
-        return true;
-      }
+    if (!std::regex_match(filename, asset_regex)) {
+      return;
+    }
+    // The pack is not an asset, and the assets in it were returned above.
+    if (asset_name == PackedAssetBundle::kFileName ||
+        (packed_assets_ &&
+         packed_assets_->GetAsMapping(asset_name) != nullptr)) {
+      return;
+    }
+    TRACE_EVENT0("flutter", "Matched File");
 
-      auto mapping = std::make_unique<fml::FileMapping>(fd);
+    auto mapping = std::make_unique<fml::FileMapping>(fml::OpenFile(
+        directory, filename.c_str(), false, fml::FilePermission::kRead));
 
-      if (mapping && mapping->IsValid()) {
-        mappings.push_back(std::move(mapping));
-      } else {
-        FML_LOG(ERROR) << "Mapping " << filename << " failed";
-      }
+    if (mapping && mapping->IsValid()) {
+      mappings.push_back(std::move(mapping));
+    } else {
+      FML_LOG(ERROR) << "Mapping " << filename << " failed";
     }
-    return true;
   };
-  if (!subdir) {
-    fml::VisitFilesRecursively(descriptor_, visitor);
-  } else {
-    fml::UniqueFD subdir_fd =
-        fml::OpenFileReadOnly(descriptor_, subdir.value().c_str());
-    if (!fml::IsDirectory(subdir_fd)) {
-      FML_LOG(ERROR) << "Subdirectory path " << subdir.value()
-                     << " is not a directory";
-      return mappings;
-    }
-    fml::VisitFiles(subdir_fd, visitor);
-  }
+  // A search in a subdirectory is flat.
+  VisitAssets(*search_dir, prefix, !subdir, visitor);
 
   return mappings;
 }
@@ -5,6 +5,7 @@
 #ifndef FLUTTER_ASSETS_DIRECTORY_ASSET_BUNDLE_H_
 #define FLUTTER_ASSETS_DIRECTORY_ASSET_BUNDLE_H_
 
+#include <memory>
 #include <optional>
 #include "flutter/assets/asset_resolver.h"
 #include "flutter/fml/macros.h"
@@ -15,13 +16,27 @@ namespace flutter {
 
 class DirectoryAssetBundle : public AssetResolver {
  public:
+  //----------------------------------------------------------------------------
+  /// @param[in]  descriptor     The assets directory.
+  /// @param[in]  is_valid_after_asset_manager_change
+  ///                            Whether this resolver is kept when the asset
+  ///                            manager is replaced.
+  /// @param[in]  packed_assets  The pack of the directory, usually a
+  ///                            |PackedAssetBundle|, or nullptr. Assets in the
+  ///                            pack are resolved from it, and only once by
+  ///                            |GetAsMappings| even if the file they were
+  ///                            packed from is still in the directory. The
+  ///                            pack file itself is never resolved.
+  ///
   DirectoryAssetBundle(fml::UniqueFD descriptor,
-                       bool is_valid_after_asset_manager_change);
+                       bool is_valid_after_asset_manager_change,
+                       std::unique_ptr<AssetResolver> packed_assets = nullptr);
 
   ~DirectoryAssetBundle() override;
 
  private:
   const fml::UniqueFD descriptor_;
+  std::unique_ptr<AssetResolver> packed_assets_;
   bool is_valid_ = false;
   bool is_valid_after_asset_manager_change_ = false;
 
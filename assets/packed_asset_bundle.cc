@@ -0,0 +1,311 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/assets/packed_asset_bundle.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <regex>
+#include <utility>
+
+#include "flutter/fml/file.h"
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+namespace {
+
+// Written at the start of the pack.
+struct PackHeader {
+  // A prefix used to identify the pack format.
+  static const uint32_t kSignature = 0x4B415046;
+  static const uint32_t kVersion1 = 1;
+
+  uint32_t signature = kSignature;
+  uint32_t version = kVersion1;
+  uint32_t entry_count = 0;
+  // A power of two. The header is followed by this many buckets, each holding
+  // the index of an entry plus one, or zero if it is empty.
+  uint32_t bucket_count = 0;
+};
+
+// The contents of the assets are aligned so that they can be read in place.
+constexpr size_t kDataAlignment = 16;
+
+// FNV-1a. The pack may be read by a different build than the one that wrote
+// it, so this must not change for a given version of the format.
+uint64_t HashName(std::string_view name) {
+  uint64_t hash = 0xCBF29CE484222325;
+  for (char c : name) {
+    hash = (hash ^ static_cast<uint8_t>(c)) * 0x100000001B3;
+  }
+  return hash;
+}
+
+size_t AlignUp(size_t offset, size_t alignment) {
+  return (offset + alignment - 1) / alignment * alignment;
+}
+
+using PackedFiles =
+    std::vector<std::pair<std::string, std::unique_ptr<fml::FileMapping>>>;
+
+// Adds the files in |directory| and its subdirectories to |files|, named by
+// their path from the assets directory.
+bool CollectFiles(const fml::UniqueFD& directory,
+                  const std::string& prefix,
+                  PackedFiles& files) {
+  bool collected = true;
+  fml::VisitFiles(directory, [&](const fml::UniqueFD& parent,
+                                 const std::string& filename) {
+    if (prefix.empty() && filename == PackedAssetBundle::kFileName) {
+      return true;
+    }
+    if (fml::IsDirectory(parent, filename.c_str())) {
+      fml::UniqueFD subdir =
+          fml::OpenDirectoryReadOnly(parent, filename.c_str());
+      collected = CollectFiles(subdir, prefix + filename + "/", files);
+      return collected;
+    }
+    auto mapping = std::make_unique<fml::FileMapping>(
+        fml::OpenFileReadOnly(parent, filename.c_str()));
+    if (!mapping->IsValid()) {
+      FML_LOG(ERROR) << "Could not read asset: " << prefix << filename;
+      collected = false;
+      return false;
+    }
+    files.emplace_back(prefix + filename, std::move(mapping));
+    return true;
+  });
+  return collected;
+}
+
+}  // namespace
+
+struct PackedAssetBundle::Entry {
+  uint64_t name_hash;
+  uint64_t data_offset;
+  uint64_t data_size;
+  uint32_t name_offset;
+  uint32_t name_size;
+};
+
+std::unique_ptr<fml::Mapping> PackedAssetBundle::CreatePack(
+    const fml::UniqueFD& directory) {
+  TRACE_EVENT0("flutter", "PackedAssetBundle::CreatePack");
+  PackedFiles files;
+  if (!fml::IsDirectory(directory) || !CollectFiles(directory, "", files)) {
+    return nullptr;
+  }
+  // Keep the output the same for the same assets.
+  std::sort(files.begin(), files.end(),
+            [](const auto& a, const auto& b) { return a.first < b.first; });
+
+  if (files.size() > std::numeric_limits<uint32_t>::max() / 4) {
+    FML_LOG(ERROR) << "Too many assets to pack.";
+    return nullptr;
+  }
+
+  PackHeader header;
+  header.entry_count = files.size();
+  // Keep the table at most half full so that probe sequences stay short.
+  header.bucket_count = 2;
+  while (header.bucket_count < header.entry_count * 2) {
+    header.bucket_count *= 2;
+  }
+
+  const size_t buckets_offset = sizeof(PackHeader);
+  const size_t entries_offset =
+      buckets_offset + header.bucket_count * sizeof(uint32_t);
+  const size_t names_offset = entries_offset + files.size() * sizeof(Entry);
+  size_t names_size = 0;
+  for (const auto& file : files) {
+    names_size += file.first.size();
+  }
+  // Name offsets are 32 bits.
+  if (names_offset + names_size > std::numeric_limits<uint32_t>::max()) {
+    FML_LOG(ERROR) << "Asset names are too long to pack.";
+    return nullptr;
+  }
+
+  std::vector<Entry> entries(files.size());
+  size_t name_offset = names_offset;
+  size_t data_offset = AlignUp(names_offset + names_size, kDataAlignment);
+  for (size_t i = 0; i < files.size(); i++) {
+    const std::string& name = files[i].first;
+    entries[i].name_hash = HashName(name);
+    entries[i].name_offset = name_offset;
+    entries[i].name_size = name.size();
+    entries[i].data_offset = data_offset;
+    entries[i].data_size = files[i].second->GetSize();
+    name_offset += name.size();
+    data_offset = AlignUp(data_offset + entries[i].data_size, kDataAlignment);
+  }
+
+  std::vector<uint8_t> pack(data_offset);
+  memcpy(pack.data(), &header, sizeof(PackHeader));
+  uint32_t* buckets = reinterpret_cast<uint32_t*>(pack.data() + buckets_offset);
+  const uint32_t mask = header.bucket_count - 1;
+  for (size_t i = 0; i < entries.size(); i++) {
+    uint32_t bucket = entries[i].name_hash & mask;
+    while (buckets[bucket] != 0) {
+      bucket = (bucket + 1) & mask;
+    }
+    buckets[bucket] = i + 1;
+
+    memcpy(pack.data() + entries[i].name_offset, files[i].first.data(),
+           entries[i].name_size);
+    if (entries[i].data_size > 0) {
+      memcpy(pack.data() + entries[i].data_offset,
+             files[i].second->GetMapping(), entries[i].data_size);
+    }
+  }
+  if (!entries.empty()) {
+    memcpy(pack.data() + entries_offset, entries.data(),
+           entries.size() * sizeof(Entry));
+  }
+  return std::make_unique<fml::DataMapping>(std::move(pack));
+}
+
+PackedAssetBundle::PackedAssetBundle(fml::UniqueFD descriptor,
+                                     bool is_valid_after_asset_manager_change) {
+  if (!descriptor.is_valid()) {
+    return;
+  }
+  TRACE_EVENT0("flutter", "PackedAssetBundle::Open");
+  auto mapping = std::make_shared<fml::FileMapping>(descriptor);
+  if (!mapping->IsValid() || mapping->GetSize() < sizeof(PackHeader)) {
+    return;
+  }
+
+  const uint8_t* data = mapping->GetMapping();
+  PackHeader header;
+  memcpy(&header, data, sizeof(PackHeader));
+  if (header.signature != PackHeader::kSignature ||
+      header.version != PackHeader::kVersion1) {
+    FML_LOG(ERROR) << "Asset pack header is corrupt.";
+    return;
+  }
+  const uint64_t index_size =
+      sizeof(PackHeader) +
+      static_cast<uint64_t>(header.bucket_count) * sizeof(uint32_t) +
+      static_cast<uint64_t>(header.entry_count) * sizeof(Entry);
+  if (header.bucket_count == 0 ||
+      (header.bucket_count & (header.bucket_count - 1)) != 0 ||
+      header.entry_count >= header.bucket_count ||
+      index_size > mapping->GetSize()) {
+    FML_LOG(ERROR) << "Asset pack index is corrupt.";
+    return;
+  }
+
+  buckets_ = reinterpret_cast<const uint32_t*>(data + sizeof(PackHeader));
+  entries_ = reinterpret_cast<const Entry*>(buckets_ + header.bucket_count);
+  entry_count_ = header.entry_count;
+  bucket_count_ = header.bucket_count;
+  mapping_ = std::move(mapping);
+  is_valid_after_asset_manager_change_ = is_valid_after_asset_manager_change;
+  is_valid_ = true;
+}
+
+PackedAssetBundle::~PackedAssetBundle() = default;
+
+bool PackedAssetBundle::IsEntryValid(const Entry& entry) const {
+  const uint64_t size = mapping_->GetSize();
+  return static_cast<uint64_t>(entry.name_offset) + entry.name_size <= size &&
+         entry.data_offset <= size && entry.data_size <= size &&
+         entry.data_offset + entry.data_size <= size;
+}
+
+std::string_view PackedAssetBundle::GetEntryName(const Entry& entry) const {
+  return std::string_view(
+      reinterpret_cast<const char*>(mapping_->GetMapping()) + entry.name_offset,
+      entry.name_size);
+}
+
+std::unique_ptr<fml::Mapping> PackedAssetBundle::GetEntryMapping(
+    const Entry& entry) const {
+  // The asset is only a view of the pack, which must outlive it.
+  return std::make_unique<fml::NonOwnedMapping>(
+      mapping_->GetMapping() + entry.data_offset, entry.data_size,
+      [mapping = mapping_](const uint8_t* data, size_t size) {});
+}
+
+// |AssetResolver|
+bool PackedAssetBundle::IsValid() const {
+  return is_valid_;
+}
+
+// |AssetResolver|
+bool PackedAssetBundle::IsValidAfterAssetManagerChange() const {
+  return is_valid_after_asset_manager_change_;
+}
+
+// |AssetResolver|
+AssetResolver::AssetResolverType PackedAssetBundle::GetType() const {
+  return AssetResolver::AssetResolverType::kPackedAssetBundle;
+}
+
+// |AssetResolver|
+std::unique_ptr<fml::Mapping> PackedAssetBundle::GetAsMapping(
+    const std::string& asset_name) const {
+  if (!is_valid_) {
+    FML_DLOG(WARNING) << "Asset bundle was not valid.";
+    return nullptr;
+  }
+
+  const uint64_t hash = HashName(asset_name);
+  const uint32_t mask = bucket_count_ - 1;
+  // The table is never full, so there is always an empty bucket to stop at.
+  // Only a corrupt pack would make this visit every bucket.
+  for (uint32_t probe = 0; probe < bucket_count_; probe++) {
+    const uint32_t bucket = buckets_[(hash + probe) & mask];
+    if (bucket == 0 || bucket > entry_count_) {
+      return nullptr;
+    }
+    const Entry& entry = entries_[bucket - 1];
+    if (entry.name_hash == hash && IsEntryValid(entry) &&
+        GetEntryName(entry) == asset_name) {
+      return GetEntryMapping(entry);
+    }
+  }
+  return nullptr;
+}
+
+// |AssetResolver|
+std::vector<std::unique_ptr<fml::Mapping>> PackedAssetBundle::GetAsMappings(
+    const std::string& asset_pattern,
+    const std::optional<std::string>& subdir) const {
+  std::vector<std::unique_ptr<fml::Mapping>> mappings;
+  if (!is_valid_) {
+    FML_DLOG(WARNING) << "Asset bundle was not valid.";
+    return mappings;
+  }
+
+  std::regex asset_regex(asset_pattern);
+  for (uint32_t i = 0; i < entry_count_; i++) {
+    const Entry& entry = entries_[i];
+    if (!IsEntryValid(entry)) {
+      continue;
+    }
+    // Like the directory bundle, match the pattern against the file name only,
+    // and only look at the files directly in |subdir| if one is given.
+    std::string_view name = GetEntryName(entry);
+    size_t separator = name.rfind('/');
+    std::string_view directory = separator == std::string_view::npos
+                                     ? std::string_view()
+                                     : name.substr(0, separator);
+    std::string_view filename = separator == std::string_view::npos
+                                    ? name
+                                    : name.substr(separator + 1);
+    if (subdir && directory != subdir.value()) {
+      continue;
+    }
+    if (std::regex_match(filename.begin(), filename.end(), asset_regex)) {
+      mappings.push_back(GetEntryMapping(entry));
+    }
+  }
+  return mappings;
+}
+
+}  // namespace flutter
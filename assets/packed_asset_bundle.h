@@ -0,0 +1,96 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_ASSETS_PACKED_ASSET_BUNDLE_H_
+#define FLUTTER_ASSETS_PACKED_ASSET_BUNDLE_H_
+
+#include <memory>
+#include <optional>
+#include <string_view>
+
+#include "flutter/assets/asset_resolver.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/mapping.h"
+#include "flutter/fml/unique_fd.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      An asset resolver for the assets of a directory packed into a
+///             single file.
+///
+///             The file starts with a hash table indexing the assets by name,
+///             followed by the contents of the assets. The file is mapped
+///             once, so that looking up an asset is a hash table probe
+///             instead of a path resolution and a file open, and the mappings
+///             returned point into the file.
+///
+///             Packs are created by |CreatePack|. When the assets directory
+///             of an application contains a pack named |kFileName|, the
+///             |DirectoryAssetBundle| of the directory resolves the assets in
+///             the pack ahead of the files in the directory.
+///
+class PackedAssetBundle : public AssetResolver {
+ public:
+  static constexpr char kFileName[] = "assets.pack";
+
+  //----------------------------------------------------------------------------
+  /// @brief      Packs all the files in |directory| and its subdirectories,
+  ///             except for any existing pack.
+  ///
+  /// @param[in]  directory  The assets directory to pack.
+  ///
+  /// @return     The contents of the pack, or nullptr if a file could not be
+  ///             read.
+  ///
+  static std::unique_ptr<fml::Mapping> CreatePack(
+      const fml::UniqueFD& directory);
+
+  PackedAssetBundle(fml::UniqueFD descriptor,
+                    bool is_valid_after_asset_manager_change);
+
+  ~PackedAssetBundle() override;
+
+ private:
+  struct Entry;
+
+  // Shared with the mappings returned for the assets.
+  std::shared_ptr<fml::FileMapping> mapping_;
+  const Entry* entries_ = nullptr;
+  const uint32_t* buckets_ = nullptr;
+  uint32_t entry_count_ = 0;
+  uint32_t bucket_count_ = 0;
+  bool is_valid_ = false;
+  bool is_valid_after_asset_manager_change_ = false;
+
+  bool IsEntryValid(const Entry& entry) const;
+
+  std::string_view GetEntryName(const Entry& entry) const;
+
+  std::unique_ptr<fml::Mapping> GetEntryMapping(const Entry& entry) const;
+
+  // |AssetResolver|
+  bool IsValid() const override;
+
+  // |AssetResolver|
+  bool IsValidAfterAssetManagerChange() const override;
+
+  // |AssetResolver|
+  AssetResolver::AssetResolverType GetType() const override;
+
+  // |AssetResolver|
+  std::unique_ptr<fml::Mapping> GetAsMapping(
+      const std::string& asset_name) const override;
+
+  // |AssetResolver|
+  std::vector<std::unique_ptr<fml::Mapping>> GetAsMappings(
+      const std::string& asset_pattern,
+      const std::optional<std::string>& subdir) const override;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(PackedAssetBundle);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_ASSETS_PACKED_ASSET_BUNDLE_H_
@@ -10,6 +10,7 @@
 #include <string_view>
 
 #include "flutter/fml/base32.h"
+#include "flutter/fml/closure.h"
 #include "flutter/fml/file.h"
 #include "flutter/fml/hex_codec.h"
 #include "flutter/fml/logging.h"
@@ -84,11 +85,15 @@ bool PersistentCache::Purge() {
   FML_CHECK(GetWorkerTaskRunner());
 
   std::promise<bool> removed;
-  GetWorkerTaskRunner()->PostTask([&removed,
-                                   cache_directory = cache_directory_]() {
+  GetWorkerTaskRunner()->PostTask([&removed, cache_directory = cache_directory_,
+                                   cache_pack = cache_pack_,
+                                   sksl_cache_pack = sksl_cache_pack_]() {
     if (cache_directory->is_valid()) {
       // Only remove files but not directories.
       FML_LOG(INFO) << "Purge persistent cache.";
+      // Close the packs so that their files can be removed.
+      cache_pack->Clear();
+      sksl_cache_pack->Clear();
       fml::FileVisitor delete_file = [](const fml::UniqueFD& directory,
                                         const std::string& filename) {
         // Do not delete directories. Return true to continue with other files.
@@ -190,21 +195,81 @@ sk_sp<SkData> ParseBase64(const std::string& input) {
   return data;
 }
 
-size_t PersistentCache::PrecompileKnownSkSLs(GrDirectContext* context) const {
-  auto known_sksls = LoadSkSLs();
+void PersistentCache::PrefetchKnownSkSLs() {
+  auto worker = GetWorkerTaskRunner();
+  if (!worker || !IsValid()) {
+    return;
+  }
+  size_t generation;
+  {
+    std::scoped_lock lock(sksl_prefetch_->mutex);
+    generation = sksl_prefetch_->generation;
+  }
+  // Only hold on to what is needed so that the task does not depend on the
+  // lifetime of this cache.
+  worker->PostTask([prefetch = sksl_prefetch_,  //
+                    generation,                 //
+                    cache_directory = cache_directory_,
+                    sksl_cache_pack = sksl_cache_pack_]() {
+    auto sksls = LoadSkSLsFromDirectory(*cache_directory, *sksl_cache_pack);
+    std::scoped_lock lock(prefetch->mutex);
+    // Drop the result if the SkSLs were precompiled in the meantime. It could
+    // miss shaders stored since.
+    if (prefetch->generation == generation) {
+      prefetch->sksls = std::move(sksls);
+      prefetch->ready = true;
+    }
+  });
+}
+
+size_t PersistentCache::PrecompileKnownSkSLs(
+    GrDirectContext* context,
+    const PrecompileProgressCallback& progress_callback) const {
+  std::vector<SkSLCache> known_sksls;
+  bool prefetched = false;
+  {
+    // Never wait for a prefetch that has not completed. The worker may be
+    // waiting on this thread.
+    std::scoped_lock lock(sksl_prefetch_->mutex);
+    if (sksl_prefetch_->ready) {
+      known_sksls = std::move(sksl_prefetch_->sksls);
+      prefetched = true;
+    }
+    sksl_prefetch_->Reset();
+  }
+  if (!prefetched && IsValid()) {
+    known_sksls = LoadSkSLsFromDirectory(*cache_directory_, *sksl_cache_pack_);
+  }
+  auto asset_sksls = LoadSkSLsFromAsset(asset_manager_);
+  known_sksls.insert(known_sksls.end(),
+                     std::make_move_iterator(asset_sksls.begin()),
+                     std::make_move_iterator(asset_sksls.end()));
+
   // A trace must be present even if no precompilations have been completed.
   FML_TRACE_EVENT("flutter", "PersistentCache::PrecompileKnownSkSLs", "count",
-                  known_sksls.size());
+                  known_sksls.size(), "prefetched", prefetched);
 
   if (context == nullptr) {
     return 0;
   }
 
+  // The SkSLs are compiled in the order they were stored, so that the shaders
+  // used earliest in previous runs are ready first.
+  const size_t total_count = known_sksls.size();
   size_t precompiled_count = 0;
-  for (const auto& sksl : known_sksls) {
-    TRACE_EVENT0("flutter", "PrecompilingSkSL");
-    if (context->precompileShader(*sksl.key, *sksl.value)) {
-      precompiled_count++;
+  if (total_count == 0 && progress_callback) {
+    progress_callback(0, 0);
+  }
+  for (size_t i = 0; i < total_count; i++) {
+    {
+      TRACE_EVENT0("flutter", "PrecompilingSkSL");
+      if (context->precompileShader(*known_sksls[i].key,
+                                    *known_sksls[i].value)) {
+        precompiled_count++;
+      }
+    }
+    if (progress_callback) {
+      progress_callback(i + 1, total_count);
     }
   }
 
@@ -214,11 +279,39 @@ size_t PersistentCache::PrecompileKnownSkSLs(GrDirectContext* context) const {
   return precompiled_count;
 }
 
+void PersistentCache::SkSLPrefetch::Reset() {
+  sksls.clear();
+  ready = false;
+  generation++;
+}
+
 std::vector<PersistentCache::SkSLCache> PersistentCache::LoadSkSLs() const {
   TRACE_EVENT0("flutter", "PersistentCache::LoadSkSLs");
-  std::vector<PersistentCache::SkSLCache> result;
+  std::vector<SkSLCache> result;
+  // Only visit sksl_cache_directory_ if this persistent cache is valid.
+  // However, we'd like to continue visit the asset dir even if this persistent
+  // cache is invalid.
+  if (IsValid()) {
+    result = LoadSkSLsFromDirectory(*cache_directory_, *sksl_cache_pack_);
+  }
+  auto asset_sksls = LoadSkSLsFromAsset(asset_manager_);
+  result.insert(result.end(), std::make_move_iterator(asset_sksls.begin()),
+                std::make_move_iterator(asset_sksls.end()));
+  return result;
+}
+
+std::vector<PersistentCache::SkSLCache> PersistentCache::LoadSkSLsFromDirectory(
+    const fml::UniqueFD& cache_directory,
+    PersistentCachePack& sksl_cache_pack) {
+  TRACE_EVENT0("flutter", "PersistentCache::LoadSkSLsFromDirectory");
+  std::vector<SkSLCache> result;
   fml::FileVisitor visitor = [&result](const fml::UniqueFD& directory,
                                        const std::string& filename) {
+    // The pack is read below. Skip it, and its temporary copy if it is being
+    // compacted.
+    if (filename.rfind(PersistentCachePack::kFileName, 0) == 0) {
+      return true;
+    }
     SkSLCache cache = LoadFile(directory, filename, true);
     if (cache.key != nullptr && cache.value != nullptr) {
       result.push_back(cache);
@@ -228,22 +321,29 @@ std::vector<PersistentCache::SkSLCache> PersistentCache::LoadSkSLs() const {
     return true;
   };
 
-  // Only visit sksl_cache_directory_ if this persistent cache is valid.
-  // However, we'd like to continue visit the asset dir even if this persistent
-  // cache is invalid.
-  if (IsValid()) {
-    // In case `rewinddir` doesn't work reliably, load SkSLs from a freshly
-    // opened directory (https://github.com/flutter/flutter/issues/65258).
-    fml::UniqueFD fresh_dir =
-        fml::OpenDirectoryReadOnly(*cache_directory_, kSkSLSubdirName);
-    if (fresh_dir.is_valid()) {
-      fml::VisitFiles(fresh_dir, visitor);
-    }
+  sksl_cache_pack.VisitEntries(
+      [&result](sk_sp<SkData> key, sk_sp<SkData> value) {
+        result.push_back({std::move(key), std::move(value)});
+      });
+
+  // Entries stored as individual files by earlier versions.
+  //
+  // In case `rewinddir` doesn't work reliably, load SkSLs from a freshly
+  // opened directory (https://github.com/flutter/flutter/issues/65258).
+  fml::UniqueFD fresh_dir =
+      fml::OpenDirectoryReadOnly(cache_directory, kSkSLSubdirName);
+  if (fresh_dir.is_valid()) {
+    fml::VisitFiles(fresh_dir, visitor);
   }
+  return result;
+}
 
+std::vector<PersistentCache::SkSLCache> PersistentCache::LoadSkSLsFromAsset(
+    const std::shared_ptr<AssetManager>& asset_manager) {
+  std::vector<SkSLCache> result;
   std::unique_ptr<fml::Mapping> mapping = nullptr;
-  if (asset_manager_ != nullptr) {
-    mapping = asset_manager_->GetAsMapping(kAssetFileName);
+  if (asset_manager != nullptr) {
+    mapping = asset_manager->GetAsMapping(kAssetFileName);
   }
   if (mapping == nullptr) {
     FML_LOG(INFO) << "No sksl asset found.";
@@ -275,7 +375,13 @@ PersistentCache::PersistentCache(bool read_only)
     : is_read_only_(read_only),
       cache_directory_(MakeCacheDirectory(cache_base_path_, read_only, false)),
       sksl_cache_directory_(
-          MakeCacheDirectory(cache_base_path_, read_only, true)) {
+          MakeCacheDirectory(cache_base_path_, read_only, true)),
+      cache_pack_(
+          std::make_shared<PersistentCachePack>(cache_directory_, read_only)),
+      sksl_cache_pack_(std::make_shared<PersistentCachePack>(
+          sksl_cache_directory_,
+          read_only)),
+      sksl_prefetch_(std::make_shared<SkSLPrefetch>()) {
   if (!IsValid()) {
     FML_LOG(WARNING) << "Could not acquire the persistent cache directory. "
                         "Caching of GPU resources on disk is disabled.";
@@ -328,25 +434,42 @@ sk_sp<SkData> PersistentCache::load(const SkData& key) {
   if (!IsValid()) {
     return nullptr;
   }
-  auto file_name = SkKeyToFilePath(key);
-  if (file_name.size() == 0) {
-    return nullptr;
+  sk_sp<SkData> result = cache_pack_->Load(key);
+  if (result == nullptr) {
+    // Fall back to an entry stored as an individual file.
+    auto file_name = SkKeyToFilePath(key);
+    if (file_name.size() == 0) {
+      return nullptr;
+    }
+    result =
+        PersistentCache::LoadFile(*cache_directory_, file_name, false).value;
   }
-  auto result =
-      PersistentCache::LoadFile(*cache_directory_, file_name, false).value;
   if (result != nullptr) {
     TRACE_EVENT0("flutter", "PersistentCacheLoadHit");
   }
   return result;
 }
 
+static void PostToWorker(fml::RefPtr<fml::TaskRunner> worker,
+                         const fml::closure& task) {
+  if (!worker) {
+    FML_LOG(WARNING)
+        << "The persistent cache has no available workers. Performing the task "
+           "on the current thread. This slow operation is going to occur on a "
+           "frame workload.";
+    task();
+  } else {
+    worker->PostTask(task);
+  }
+}
+
 static void PersistentCacheStore(fml::RefPtr<fml::TaskRunner> worker,
                                  std::shared_ptr<fml::UniqueFD> cache_directory,
                                  std::string key,
                                  std::unique_ptr<fml::Mapping> value) {
-  auto task = fml::MakeCopyable([cache_directory,             //
-                                 file_name = std::move(key),  //
-                                 mapping = std::move(value)   //
+  PostToWorker(worker, fml::MakeCopyable([cache_directory,             //
+                                          file_name = std::move(key),  //
+                                          mapping = std::move(value)   //
   ]() mutable {
     TRACE_EVENT0("flutter", "PersistentCacheStore");
     if (!fml::WriteAtomically(*cache_directory,   //
@@ -355,17 +478,23 @@ static void PersistentCacheStore(fml::RefPtr<fml::TaskRunner> worker,
     ) {
       FML_LOG(WARNING) << "Could not write cache contents to persistent store.";
     }
-  });
+  }));
+}
 
-  if (!worker) {
-    FML_LOG(WARNING)
-        << "The persistent cache has no available workers. Performing the task "
-           "on the current thread. This slow operation is going to occur on a "
-           "frame workload.";
-    task();
-  } else {
-    worker->PostTask(std::move(task));
-  }
+static void PersistentCachePackStore(fml::RefPtr<fml::TaskRunner> worker,
+                                     std::shared_ptr<PersistentCachePack> pack,
+                                     sk_sp<SkData> key,
+                                     sk_sp<SkData> value) {
+  PostToWorker(worker, [pack, key, value]() {
+    TRACE_EVENT0("flutter", "PersistentCacheStore");
+    if (!pack->Store(*key, *value)) {
+      FML_LOG(WARNING) << "Could not write cache contents to persistent store.";
+      return;
+    }
+    if (pack->ShouldCompact()) {
+      pack->Compact();
+    }
+  });
 }
 
 std::unique_ptr<fml::MallocMapping> PersistentCache::BuildCacheObject(
@@ -400,20 +529,14 @@ void PersistentCache::store(const SkData& key, const SkData& data) {
     return;
   }
 
-  auto file_name = SkKeyToFilePath(key);
-
-  if (file_name.size() == 0) {
-    return;
-  }
-
-  std::unique_ptr<fml::MallocMapping> mapping = BuildCacheObject(key, data);
-  if (!mapping) {
+  if (key.data() == nullptr || key.size() == 0) {
     return;
   }
 
-  PersistentCacheStore(GetWorkerTaskRunner(),
-                       cache_sksl_ ? sksl_cache_directory_ : cache_directory_,
-                       std::move(file_name), std::move(mapping));
+  PersistentCachePackStore(GetWorkerTaskRunner(),
+                           cache_sksl_ ? sksl_cache_pack_ : cache_pack_,
+                           SkData::MakeWithCopy(key.data(), key.size()),
+                           SkData::MakeWithCopy(data.data(), data.size()));
 }
 
 void PersistentCache::DumpSkp(const SkData& data) {
@@ -442,11 +565,21 @@ void PersistentCache::AddWorkerTaskRunner(
 
 void PersistentCache::RemoveWorkerTaskRunner(
     fml::RefPtr<fml::TaskRunner> task_runner) {
-  std::scoped_lock lock(worker_task_runners_mutex_);
-  auto found = worker_task_runners_.find(task_runner);
-  if (found != worker_task_runners_.end()) {
-    worker_task_runners_.erase(found);
+  {
+    std::scoped_lock lock(worker_task_runners_mutex_);
+    auto found = worker_task_runners_.find(task_runner);
+    if (found != worker_task_runners_.end()) {
+      worker_task_runners_.erase(found);
+    }
+    // The SkSLs prefetched for one shell can still be precompiled by another.
+    if (!worker_task_runners_.empty()) {
+      return;
+    }
   }
+
+  // Don't keep the SkSLs prefetched once no shell is left to precompile them.
+  std::scoped_lock lock(sksl_prefetch_->mutex);
+  sksl_prefetch_->Reset();
 }
 
 fml::RefPtr<fml::TaskRunner> PersistentCache::GetWorkerTaskRunner() const {
@@ -5,11 +5,13 @@
 #ifndef FLUTTER_COMMON_GRAPHICS_PERSISTENT_CACHE_H_
 #define FLUTTER_COMMON_GRAPHICS_PERSISTENT_CACHE_H_
 
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <set>
 
 #include "flutter/assets/asset_manager.h"
+#include "flutter/common/graphics/persistent_cache_pack.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/task_runner.h"
 #include "flutter/fml/unique_fd.h"
@@ -25,6 +27,10 @@ class ShellTest;
 ///
 /// This is mainly used for Shaders but is also written to by Dart.  It is
 /// thread-safe for reading and writing from multiple threads.
+///
+/// Entries are stored in a |PersistentCachePack| in each cache directory.
+/// Entries stored as individual files by earlier versions, or shipped as files
+/// for read-only caches, are still read when they are not in the pack.
 class PersistentCache : public GrContextOptions::PersistentCache {
  public:
   // Mutable static switch that can be set before GetCacheForProcess. If true,
@@ -41,6 +47,12 @@ class PersistentCache : public GrContextOptions::PersistentCache {
   // affect the cache directory returned by |GetCacheForProcess|.
   static void SetCacheDirectoryPath(std::string path);
 
+  // Called by |PrecompileKnownSkSLs| after each SkSL it precompiles, with the
+  // number of SkSLs handled so far and the number of SkSLs to precompile. It
+  // is called with zero counts when there are no SkSLs to precompile.
+  using PrecompileProgressCallback =
+      std::function<void(size_t precompiled_count, size_t total_count)>;
+
   // Convert a binary SkData key into a Base32 encoded string.
   //
   // This is used to specify persistent cache filenames and service protocol
@@ -94,8 +106,20 @@ class PersistentCache : public GrContextOptions::PersistentCache {
   };
 
   /// Load all the SkSL shader caches in the right directory.
+  ///
+  /// The SkSLs stored by previous runs come first, in the order they were
+  /// stored, followed by the SkSLs packaged with the application.
   std::vector<SkSLCache> LoadSkSLs() const;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Start loading the SkSLs gathered during previous runs on a
+  ///             worker task runner, so that |PrecompileKnownSkSLs| does not
+  ///             have to read them on the raster thread. Called by the
+  ///             surfaces that precompile SkSLs as they are set up. Does
+  ///             nothing if there are no worker task runners.
+  ///
+  void PrefetchKnownSkSLs();
+
   //----------------------------------------------------------------------------
   /// @brief      Precompile SkSLs packaged with the application and gathered
   ///             during previous runs in the given context.
@@ -105,11 +129,21 @@ class PersistentCache : public GrContextOptions::PersistentCache {
   ///             recreated. The SkSLs must be precompiled again in the new
   ///             context.
   ///
-  /// @param      context  The rendering context to precompile shaders in.
+  ///             The SkSLs loaded by |PrefetchKnownSkSLs| are used if they are
+  ///             ready. Otherwise, they are loaded on the calling thread.
+  ///             Shaders are compiled on the calling thread since the context
+  ///             may not be used from any other.
+  ///
+  /// @param      context            The rendering context to precompile
+  ///                                 shaders in.
+  /// @param      progress_callback  Called on the calling thread as the
+  ///                                 SkSLs are precompiled. May be null.
   ///
   /// @return     The number of SkSLs precompiled.
   ///
-  size_t PrecompileKnownSkSLs(GrDirectContext* context) const;
+  size_t PrecompileKnownSkSLs(
+      GrDirectContext* context,
+      const PrecompileProgressCallback& progress_callback = nullptr) const;
 
   // Return mappings for all skp's accessible through the AssetManager
   std::vector<std::unique_ptr<fml::Mapping>> GetSkpsFromAssetManager() const;
@@ -151,6 +185,20 @@ class PersistentCache : public GrContextOptions::PersistentCache {
   const bool is_read_only_;
   const std::shared_ptr<fml::UniqueFD> cache_directory_;
   const std::shared_ptr<fml::UniqueFD> sksl_cache_directory_;
+  const std::shared_ptr<PersistentCachePack> cache_pack_;
+  const std::shared_ptr<PersistentCachePack> sksl_cache_pack_;
+  // The SkSLs loaded by |PrefetchKnownSkSLs|. This is shared with the worker
+  // task loading them.
+  struct SkSLPrefetch {
+    std::mutex mutex;
+    // Incremented to drop the results of the loads in flight.
+    size_t generation = 0;
+    bool ready = false;
+    std::vector<SkSLCache> sksls;
+
+    void Reset();
+  };
+  const std::shared_ptr<SkSLPrefetch> sksl_prefetch_;
   mutable std::mutex worker_task_runners_mutex_;
   std::multiset<fml::RefPtr<fml::TaskRunner>> worker_task_runners_;
 
@@ -161,6 +209,13 @@ class PersistentCache : public GrContextOptions::PersistentCache {
                             const std::string& file_name,
                             bool need_key);
 
+  static std::vector<SkSLCache> LoadSkSLsFromDirectory(
+      const fml::UniqueFD& cache_directory,
+      PersistentCachePack& sksl_cache_pack);
+
+  static std::vector<SkSLCache> LoadSkSLsFromAsset(
+      const std::shared_ptr<AssetManager>& asset_manager);
+
   bool IsValid() const;
 
   PersistentCache(bool read_only = false);
@@ -0,0 +1,418 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/common/graphics/persistent_cache_pack.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <vector>
+
+#include "flutter/fml/file.h"
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+namespace {
+
+// Written at the start of the pack file.
+struct PackHeader {
+  // A prefix used to identify the pack file format.
+  static const uint32_t kSignature = 0x6B636150;
+  static const uint32_t kVersion1 = 1;
+
+  uint32_t signature = kSignature;
+  uint32_t version = kVersion1;
+};
+
+// Written before the key and the value of each record.
+struct RecordHeader {
+  uint32_t key_size;
+  uint32_t value_size;
+  uint32_t checksum;
+};
+
+// Replaced records taking less space than this are not worth rewriting the
+// file for.
+constexpr size_t kMinCompactionBytes = 64 * 1024;
+
+size_t GetRecordSize(size_t key_size, size_t value_size) {
+  return sizeof(RecordHeader) + key_size + value_size;
+}
+
+// Hashes |data| into |lanes|, FNV-1a style but a word at a time. The four
+// lanes are independent so that the multiplications can overlap, which
+// keeps verifying a record much cheaper than reading it from storage.
+void HashBytes(const uint8_t* data, size_t size, uint64_t lanes[4]) {
+  constexpr uint64_t kPrime = 0x100000001B3;
+  for (; size >= 4 * sizeof(uint64_t); size -= 4 * sizeof(uint64_t)) {
+    for (int i = 0; i < 4; i++) {
+      uint64_t word;
+      memcpy(&word, data, sizeof(uint64_t));
+      lanes[i] = (lanes[i] ^ word) * kPrime;
+      data += sizeof(uint64_t);
+    }
+  }
+  for (; size > 0; size--) {
+    lanes[0] = (lanes[0] ^ *data++) * kPrime;
+  }
+}
+
+// A checksum of the key followed by the value. This only needs to detect
+// records that were not completely written, not to resist tampering.
+uint32_t ComputeChecksum(const uint8_t* key,
+                         size_t key_size,
+                         const uint8_t* value,
+                         size_t value_size) {
+  uint64_t lanes[4] = {0xCBF29CE484222325, 0x84222325CBF29CE4,
+                       0x9E3779B97F4A7C15, 0x7F4A7C159E3779B9};
+  HashBytes(key, key_size, lanes);
+  HashBytes(value, value_size, lanes);
+  uint64_t hash = lanes[0] ^ (lanes[1] * 3) ^ (lanes[2] * 5) ^ (lanes[3] * 7) ^
+                  (key_size + value_size);
+  return static_cast<uint32_t>(hash ^ (hash >> 32));
+}
+
+std::string KeyToString(const SkData& key) {
+  return std::string(static_cast<const char*>(key.data()), key.size());
+}
+
+}  // namespace
+
+PersistentCachePack::PersistentCachePack(
+    std::shared_ptr<fml::UniqueFD> directory,
+    bool read_only)
+    : directory_(std::move(directory)), read_only_(read_only) {
+  TRACE_EVENT0("flutter", "PersistentCachePack::Open");
+  std::scoped_lock lock(mutex_);
+  OpenLocked(false);
+}
+
+PersistentCachePack::~PersistentCachePack() = default;
+
+void PersistentCachePack::OpenLocked(bool create) {
+  CloseLocked();
+  if (!directory_ || !directory_->is_valid()) {
+    return;
+  }
+
+  file_ = fml::OpenFile(*directory_, kFileName, create,
+                        read_only_ ? fml::FilePermission::kRead
+                                   : fml::FilePermission::kReadWrite);
+  if (!file_.is_valid()) {
+    return;
+  }
+  if (!MapLocked()) {
+    CloseLocked();
+    return;
+  }
+  IndexRecordsLocked();
+}
+
+bool PersistentCachePack::MapLocked() {
+  // The mapping is only read from. Records are written to the file, so that
+  // it does not have to be remapped for each of them.
+  auto mapping = std::make_unique<fml::FileMapping>(file_);
+  if (!mapping->IsValid()) {
+    FML_LOG(WARNING) << "Could not map the persistent cache pack.";
+    return false;
+  }
+  mapping_ = std::move(mapping);
+  return true;
+}
+
+void PersistentCachePack::IndexRecordsLocked() {
+  const uint8_t* data = mapping_->GetMapping();
+  const size_t size = mapping_->GetSize();
+  size_t offset = end_offset_;
+  if (offset == 0) {
+    if (size < sizeof(PackHeader)) {
+      return;
+    }
+    PackHeader header;
+    memcpy(&header, data, sizeof(PackHeader));
+    if (header.signature != PackHeader::kSignature ||
+        header.version != PackHeader::kVersion1) {
+      // The file is rewritten from the start by the next |Store|.
+      FML_LOG(INFO) << "Persistent cache pack header is corrupt.";
+      return;
+    }
+    offset = sizeof(PackHeader);
+  }
+
+  while (offset <= size && size - offset >= sizeof(RecordHeader)) {
+    RecordHeader record_header;
+    memcpy(&record_header, data + offset, sizeof(RecordHeader));
+    size_t available = size - offset - sizeof(RecordHeader);
+    if (record_header.key_size == 0 || record_header.key_size > available ||
+        record_header.value_size > available - record_header.key_size) {
+      // The rest of the file was left by an interrupted append.
+      break;
+    }
+
+    std::string key(
+        reinterpret_cast<const char*>(data + offset + sizeof(RecordHeader)),
+        record_header.key_size);
+    AddRecordLocked(std::move(key), {offset, record_header.key_size,
+                                     record_header.value_size});
+    offset += GetRecordSize(record_header.key_size, record_header.value_size);
+  }
+  end_offset_ = offset;
+}
+
+void PersistentCachePack::AddRecordLocked(std::string key, Record record) {
+  auto found = index_.find(key);
+  if (found != index_.end()) {
+    dead_bytes_ +=
+        GetRecordSize(found->second.key_size, found->second.value_size);
+    found->second = record;
+  } else {
+    index_.emplace(std::move(key), record);
+  }
+}
+
+bool PersistentCachePack::RefreshLocked() {
+  std::optional<size_t> file_size = fml::GetFileSize(file_);
+  if (!file_size) {
+    return false;
+  }
+  // Another process appended records, or an append was interrupted.
+  if (*file_size > end_offset_) {
+    if (!MapLocked()) {
+      return false;
+    }
+    IndexRecordsLocked();
+  }
+  return true;
+}
+
+void PersistentCachePack::CloseLocked() {
+  mapping_.reset();
+  file_.reset();
+  end_offset_ = 0;
+  dead_bytes_ = 0;
+  index_.clear();
+}
+
+const uint8_t* PersistentCachePack::GetValueLocked(const Record& record) {
+  const size_t record_end =
+      record.offset + GetRecordSize(record.key_size, record.value_size);
+  // Records stored since the file was mapped are past the end of the mapping.
+  if (record_end > mapping_->GetSize() &&
+      (!MapLocked() || record_end > mapping_->GetSize())) {
+    return nullptr;
+  }
+  const uint8_t* data = mapping_->GetMapping() + record.offset;
+  RecordHeader header;
+  memcpy(&header, data, sizeof(RecordHeader));
+  const uint8_t* key = data + sizeof(RecordHeader);
+  const uint8_t* value = key + record.key_size;
+  if (header.checksum !=
+      ComputeChecksum(key, record.key_size, value, record.value_size)) {
+    FML_LOG(INFO) << "Persistent cache pack record is corrupt.";
+    return nullptr;
+  }
+  return value;
+}
+
+std::vector<PersistentCachePack::Index::iterator>
+PersistentCachePack::GetEntriesInFileOrderLocked() {
+  std::vector<Index::iterator> entries;
+  entries.reserve(index_.size());
+  for (auto it = index_.begin(); it != index_.end(); ++it) {
+    entries.push_back(it);
+  }
+  std::sort(entries.begin(), entries.end(),
+            [](const Index::iterator& a, const Index::iterator& b) {
+              return a->second.offset < b->second.offset;
+            });
+  return entries;
+}
+
+void PersistentCachePack::RemoveLocked(Index::iterator it) {
+  dead_bytes_ += GetRecordSize(it->second.key_size, it->second.value_size);
+  index_.erase(it);
+}
+
+sk_sp<SkData> PersistentCachePack::Load(const SkData& key) {
+  std::scoped_lock lock(mutex_);
+  auto found = index_.find(KeyToString(key));
+  if (found == index_.end()) {
+    return nullptr;
+  }
+  const uint8_t* value = GetValueLocked(found->second);
+  if (value == nullptr) {
+    RemoveLocked(found);
+    return nullptr;
+  }
+  return SkData::MakeWithCopy(value, found->second.value_size);
+}
+
+void PersistentCachePack::VisitEntries(const Visitor& visitor) {
+  std::scoped_lock lock(mutex_);
+  for (const auto& it : GetEntriesInFileOrderLocked()) {
+    const uint8_t* value = GetValueLocked(it->second);
+    if (value == nullptr) {
+      RemoveLocked(it);
+      continue;
+    }
+    visitor(SkData::MakeWithCopy(it->first.data(), it->first.size()),
+            SkData::MakeWithCopy(value, it->second.value_size));
+  }
+}
+
+bool PersistentCachePack::Store(const SkData& key, const SkData& value) {
+  if (read_only_ || key.size() == 0 ||
+      key.size() > std::numeric_limits<uint32_t>::max() ||
+      value.size() > std::numeric_limits<uint32_t>::max()) {
+    return false;
+  }
+
+  std::scoped_lock lock(mutex_);
+  if (!file_.is_valid()) {
+    OpenLocked(true);
+    if (!file_.is_valid()) {
+      return false;
+    }
+  }
+
+  // Other processes may append to the same file. The file is locked so that
+  // appends do not overlap, and each starts after the last record in the
+  // file, which may not have been indexed yet.
+  if (!fml::LockFile(file_)) {
+    FML_LOG(WARNING) << "Could not lock the persistent cache pack.";
+    return false;
+  }
+  bool stored = AppendLocked(key, value);
+  fml::UnlockFile(file_);
+  return stored;
+}
+
+bool PersistentCachePack::AppendLocked(const SkData& key, const SkData& value) {
+  if (!RefreshLocked()) {
+    return false;
+  }
+
+  // The header is written along with the first record.
+  const size_t write_offset = end_offset_;
+  const size_t offset = end_offset_ == 0 ? sizeof(PackHeader) : end_offset_;
+  const size_t record_size = GetRecordSize(key.size(), value.size());
+  std::vector<uint8_t> buffer(offset + record_size - write_offset);
+  uint8_t* record = buffer.data();
+  if (write_offset == 0) {
+    PackHeader header;
+    memcpy(buffer.data(), &header, sizeof(PackHeader));
+    record += sizeof(PackHeader);
+  }
+  RecordHeader record_header = {
+      static_cast<uint32_t>(key.size()),
+      static_cast<uint32_t>(value.size()),
+      ComputeChecksum(key.bytes(), key.size(), value.bytes(), value.size()),
+  };
+  memcpy(record, &record_header, sizeof(RecordHeader));
+  memcpy(record + sizeof(RecordHeader), key.data(), key.size());
+  memcpy(record + sizeof(RecordHeader) + key.size(), value.data(),
+         value.size());
+
+  // If this fails part way, the next append overwrites what was written.
+  if (!fml::WriteFileAt(file_, write_offset, buffer.data(), buffer.size())) {
+    FML_LOG(WARNING) << "Could not write to the persistent cache pack.";
+    return false;
+  }
+  end_offset_ = offset + record_size;
+
+  // Drop what is left of an interrupted append, so that it is not mistaken
+  // for records. The file must not be mapped while it shrinks on some
+  // platforms.
+  std::optional<size_t> file_size = fml::GetFileSize(file_);
+  if (file_size && *file_size > end_offset_) {
+    mapping_.reset();
+    bool truncated = fml::TruncateFile(file_, end_offset_);
+    if (!MapLocked() || !truncated) {
+      OpenLocked(false);
+      return false;
+    }
+  }
+
+  AddRecordLocked(KeyToString(key), {offset, record_header.key_size,
+                                     record_header.value_size});
+  return true;
+}
+
+bool PersistentCachePack::ShouldCompact() const {
+  std::scoped_lock lock(mutex_);
+  return !read_only_ && dead_bytes_ >= kMinCompactionBytes &&
+         dead_bytes_ >= end_offset_ / 2;
+}
+
+bool PersistentCachePack::Compact() {
+  if (read_only_) {
+    return false;
+  }
+
+  TRACE_EVENT0("flutter", "PersistentCachePack::Compact");
+  std::scoped_lock lock(mutex_);
+  if (!file_.is_valid()) {
+    return true;
+  }
+
+  // Keep the records appended by other processes. Those appending to the file
+  // while it is replaced are lost, which only costs cache misses. The lock is
+  // released when the file is closed below.
+  if (!fml::LockFile(file_) || !RefreshLocked()) {
+    FML_LOG(WARNING) << "Could not lock the persistent cache pack.";
+    fml::UnlockFile(file_);
+    return false;
+  }
+
+  // Keep the records in the order they were written.
+  std::vector<Record> records;
+  records.reserve(index_.size());
+  size_t size = sizeof(PackHeader);
+  for (const auto& it : GetEntriesInFileOrderLocked()) {
+    if (GetValueLocked(it->second) != nullptr) {
+      records.push_back(it->second);
+      size += GetRecordSize(it->second.key_size, it->second.value_size);
+    }
+  }
+
+  std::vector<uint8_t> buffer(size);
+  PackHeader header;
+  memcpy(buffer.data(), &header, sizeof(PackHeader));
+  size_t offset = sizeof(PackHeader);
+  for (const Record& record : records) {
+    size_t record_size = GetRecordSize(record.key_size, record.value_size);
+    memcpy(buffer.data() + offset, mapping_->GetMapping() + record.offset,
+           record_size);
+    offset += record_size;
+  }
+
+  CloseLocked();
+  bool written = fml::WriteAtomically(*directory_, kFileName,
+                                      fml::DataMapping(std::move(buffer)));
+  if (!written) {
+    FML_LOG(WARNING) << "Could not compact the persistent cache pack.";
+  }
+  OpenLocked(false);
+  return written;
+}
+
+bool PersistentCachePack::Clear() {
+  std::scoped_lock lock(mutex_);
+  CloseLocked();
+  if (!directory_ || !directory_->is_valid() ||
+      !fml::FileExists(*directory_, kFileName)) {
+    return true;
+  }
+  return fml::UnlinkFile(*directory_, kFileName);
+}
+
+size_t PersistentCachePack::GetEntryCount() const {
+  std::scoped_lock lock(mutex_);
+  return index_.size();
+}
+
+}  // namespace flutter
@@ -0,0 +1,120 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_COMMON_GRAPHICS_PERSISTENT_CACHE_PACK_H_
+#define FLUTTER_COMMON_GRAPHICS_PERSISTENT_CACHE_PACK_H_
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/mapping.h"
+#include "flutter/fml/unique_fd.h"
+#include "third_party/skia/include/core/SkData.h"
+
+namespace flutter {
+
+/// A single file holding the entries of a |PersistentCache| directory.
+///
+/// Entries are appended to the end of the file as records. When the pack is
+/// opened, the file is mapped and an in-memory index of its records is built,
+/// so that a lookup is a hash table probe instead of a file open and read.
+/// Records replaced by a later record with the same key stay in the file until
+/// |Compact| rewrites it.
+///
+/// Each record carries a checksum that is verified when the record is read,
+/// so that a record torn by a crash during an append is treated as missing.
+///
+/// It is thread-safe to read from and write to a pack from multiple threads,
+/// although writes are expected to happen on a single worker thread. Several
+/// processes may also write to the same pack. Records are written to the file
+/// under an exclusive lock on it, after any records appended by others, and
+/// the file is only mapped for reading.
+class PersistentCachePack {
+ public:
+  static constexpr char kFileName[] = "io.flutter.shaders.pack";
+
+  using Visitor = std::function<void(sk_sp<SkData> key, sk_sp<SkData> value)>;
+
+  /// Opens the pack in |directory|, if there is one. Unless |read_only| is
+  /// set, the pack is created on the first call to |Store|.
+  PersistentCachePack(std::shared_ptr<fml::UniqueFD> directory,
+                      bool read_only);
+
+  ~PersistentCachePack();
+
+  /// Returns a copy of the value stored for |key|, or nullptr if there is
+  /// none or its record is corrupt.
+  sk_sp<SkData> Load(const SkData& key);
+
+  /// Calls |visitor| with every valid entry of the pack, in the order they
+  /// were stored. The visitor must not call back into the pack.
+  void VisitEntries(const Visitor& visitor);
+
+  /// Appends a record for |key| to the pack, replacing any previous value.
+  /// This writes to disk and should not be called on a frame workload.
+  bool Store(const SkData& key, const SkData& value);
+
+  /// Whether enough of the file is taken by replaced or corrupt records that
+  /// it should be compacted.
+  bool ShouldCompact() const;
+
+  /// Rewrites the pack with only its valid entries.
+  bool Compact();
+
+  /// Removes the pack file and all of its entries.
+  bool Clear();
+
+  size_t GetEntryCount() const;
+
+ private:
+  struct Record {
+    // The offset of the record header in the file.
+    size_t offset;
+    uint32_t key_size;
+    uint32_t value_size;
+  };
+
+  using Index = std::unordered_map<std::string, Record>;
+
+  const std::shared_ptr<fml::UniqueFD> directory_;
+  const bool read_only_;
+
+  mutable std::mutex mutex_;
+  fml::UniqueFD file_;
+  // A read-only mapping of the file. Records stored since it was created are
+  // past its end until it is remapped by a read.
+  std::unique_ptr<fml::FileMapping> mapping_;
+  // The end of the last complete record in the file. Anything past it is left
+  // over from an interrupted append and is overwritten by the next one.
+  size_t end_offset_ = 0;
+  // The bytes taken by records that are no longer in |index_|.
+  size_t dead_bytes_ = 0;
+  Index index_;
+
+  // These must be called with |mutex_| held.
+  void OpenLocked(bool create);
+  void CloseLocked();
+  bool MapLocked();
+  // Indexes the records in the mapping past |end_offset_|.
+  void IndexRecordsLocked();
+  void AddRecordLocked(std::string key, Record record);
+  // Indexes the records appended to the file by other processes.
+  bool RefreshLocked();
+  // This must also be called with the file locked.
+  bool AppendLocked(const SkData& key, const SkData& value);
+  const uint8_t* GetValueLocked(const Record& record);
+  std::vector<Index::iterator> GetEntriesInFileOrderLocked();
+  void RemoveLocked(Index::iterator it);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(PersistentCachePack);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_COMMON_GRAPHICS_PERSISTENT_CACHE_PACK_H_
@@ -286,6 +286,18 @@ struct Settings {
   /// https://github.com/dart-lang/sdk/blob/ca64509108b3e7219c50d6c52877c85ab6a35ff2/runtime/vm/flag_list.h#L150
   int64_t old_gen_heap_size = -1;
 
+  /// Max size of the images held by the raster cache in MB, or -1 to size the
+  /// cache from the dimensions of the viewport.
+  int64_t raster_cache_size = -1;
+
+  /// Rasterize raster cache entries of software rendered frames on worker
+  /// threads rather than on the raster thread.
+  bool enable_background_raster_cache = false;
+
+  /// Dispatch pointer events with a `CoalescingPointerDataDispatcher` instead
+  /// of the dispatcher of the platform view.
+  bool coalesce_pointer_events = false;
+
   /// A timestamp representing when the engine started. The value is based
   /// on the clock used by the Dart timeline APIs. This timestamp is used
   /// to log a timeline event that tracks the latency of engine startup.
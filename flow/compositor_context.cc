@@ -7,6 +7,7 @@
 #include <optional>
 #include "flutter/flow/layers/layer_tree.h"
 #include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkPath.h"
 
 namespace flutter {
 
@@ -132,6 +133,16 @@ RasterStatus CompositorContext::ScopedFrame::Raster(
   if (canvas()) {
     if (clip_rect) {
       canvas()->clipRect(*clip_rect);
+      // Areas between the damage rects within the clip rect are not painted.
+      auto damage_rects = frame_damage->GetBufferDamageRects();
+      if (frame_damage->clip_to_damage_rects() && damage_rects &&
+          damage_rects->size() > 1) {
+        SkPath damage_path;
+        for (const auto& rect : *damage_rects) {
+          damage_path.addRect(SkRect::Make(rect));
+        }
+        canvas()->clipPath(damage_path);
+      }
     }
 
     if (needs_save_layer) {
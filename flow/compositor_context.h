@@ -69,8 +69,19 @@ class FrameDamage {
     additional_damage_.join(damage);
   }
 
+  // Sets whether painting is clipped to each of the buffer damage rects, which
+  // is only correct if the surface supports more than one damage rect.
+  // Otherwise painting is only clipped to their bounds.
+  void SetClipToDamageRects(bool clip_to_damage_rects) {
+    clip_to_damage_rects_ = clip_to_damage_rects;
+  }
+
+  bool clip_to_damage_rects() const { return clip_to_damage_rects_; }
+
   // Calculates clip rect for current rasterization. This is diff of layer tree
-  // and previous layer tree + any additional provideddamage.
+  // and previous layer tree + any additional provideddamage. The clip rect is
+  // the bounds of the buffer damage; Painting should further be clipped to
+  // the buffer damage rects if |clip_to_damage_rects| is set.
   // If previous layer tree is not specified, clip rect will be nulloptional,
   // but the paint region of layer_tree will be calculated so that it can be
   // used for diffing of subsequent frames.
@@ -86,8 +97,21 @@ class FrameDamage {
     return damage_ ? std::make_optional(damage_->buffer_damage) : std::nullopt;
   }
 
+  // See Damage::frame_damage_rects.
+  std::optional<std::vector<SkIRect>> GetFrameDamageRects() const {
+    return damage_ ? std::make_optional(damage_->frame_damage_rects)
+                   : std::nullopt;
+  }
+
+  // See Damage::buffer_damage_rects.
+  std::optional<std::vector<SkIRect>> GetBufferDamageRects() const {
+    return damage_ ? std::make_optional(damage_->buffer_damage_rects)
+                   : std::nullopt;
+  }
+
  private:
   SkIRect additional_damage_ = SkIRect::MakeEmpty();
+  bool clip_to_damage_rects_ = false;
   std::optional<Damage> damage_;
   const LayerTree* prev_layer_tree_ = nullptr;
 };
@@ -7,6 +7,80 @@
 
 namespace flutter {
 
+namespace {
+
+// Rough cost, in pixels, of painting an additional damage rect. Two rects are
+// joined if that paints fewer extra pixels than this.
+constexpr int64_t kDamageRectCost = 64 * 64;
+
+int64_t Area(const SkIRect& rect) {
+  return static_cast<int64_t>(rect.width()) * rect.height();
+}
+
+// The number of pixels painted in addition to a and b if they are joined;
+// Negative if they overlap.
+int64_t JoinCost(const SkIRect& a, const SkIRect& b) {
+  SkIRect joined = a;
+  joined.join(b);
+  return Area(joined) - Area(a) - Area(b);
+}
+
+// Adds rect to rects, joining it with the rects that are cheap to join it with
+// and then joining the cheapest pairs until there are at most max_rects.
+void AddDamageRect(std::vector<SkIRect>& rects,
+                   SkIRect rect,
+                   size_t max_rects) {
+  while (true) {
+    auto cheapest = rects.end();
+    int64_t cheapest_cost = kDamageRectCost;
+    for (auto i = rects.begin(); i != rects.end(); ++i) {
+      int64_t cost = JoinCost(*i, rect);
+      if (cost < cheapest_cost) {
+        cheapest = i;
+        cheapest_cost = cost;
+      }
+    }
+    if (cheapest == rects.end()) {
+      break;
+    }
+    rect.join(*cheapest);
+    rects.erase(cheapest);
+  }
+  rects.push_back(rect);
+  if (rects.size() <= max_rects) {
+    return;
+  }
+
+  size_t first = 0, second = 1;
+  int64_t cheapest_cost = JoinCost(rects[0], rects[1]);
+  for (size_t i = 0; i < rects.size(); ++i) {
+    for (size_t j = i + 1; j < rects.size(); ++j) {
+      int64_t cost = JoinCost(rects[i], rects[j]);
+      if (cost < cheapest_cost) {
+        first = i;
+        second = j;
+        cheapest_cost = cost;
+      }
+    }
+  }
+  SkIRect joined = rects[first];
+  joined.join(rects[second]);
+  rects.erase(rects.begin() + second);
+  rects.erase(rects.begin() + first);
+  // The joined rect may now be cheap to join with others.
+  AddDamageRect(rects, joined, max_rects);
+}
+
+SkIRect Bounds(const std::vector<SkIRect>& rects) {
+  SkIRect bounds = SkIRect::MakeEmpty();
+  for (const auto& rect : rects) {
+    bounds.join(rect);
+  }
+  return bounds;
+}
+
+}  // namespace
+
 DiffContext::DiffContext(SkISize frame_size,
                          double frame_device_pixel_ratio,
                          PaintRegionMap& this_frame_paint_region_map,
@@ -67,30 +141,63 @@ SkRect DiffContext::ApplyFilterBoundsAdjustment(SkRect rect) const {
   return rect;
 }
 
-Damage DiffContext::ComputeDamage(
-    const SkIRect& accumulated_buffer_damage) const {
-  SkRect buffer_damage = SkRect::Make(accumulated_buffer_damage);
-  buffer_damage.join(damage_);
-  SkRect frame_damage(damage_);
-
-  for (const auto& r : readbacks_) {
-    SkRect rect = SkRect::Make(r.rect);
-    if (rect.intersects(frame_damage)) {
-      frame_damage.join(rect);
-    }
-    if (rect.intersects(buffer_damage)) {
-      buffer_damage.join(rect);
+Damage DiffContext::ComputeDamage(const SkIRect& accumulated_buffer_damage,
+                                  size_t max_rects) const {
+  FML_DCHECK(max_rects > 0);
+  SkIRect frame_clip = SkIRect::MakeSize(frame_size_);
+  std::vector<SkIRect> frame_damage;
+  for (const auto& r : damage_rects_) {
+    SkIRect rect = r.roundOut();
+    if (rect.intersect(frame_clip)) {
+      frame_damage.push_back(rect);
     }
   }
+  std::vector<SkIRect> buffer_damage = frame_damage;
+  SkIRect accumulated = accumulated_buffer_damage;
+  if (accumulated.intersect(frame_clip)) {
+    buffer_damage.push_back(accumulated);
+  }
 
   Damage res;
-  buffer_damage.roundOut(&res.buffer_damage);
-  frame_damage.roundOut(&res.frame_damage);
+  res.frame_damage_rects =
+      MergeDamageRects(std::move(frame_damage), max_rects);
+  res.buffer_damage_rects =
+      MergeDamageRects(std::move(buffer_damage), max_rects);
+  res.frame_damage = Bounds(res.frame_damage_rects);
+  res.buffer_damage = Bounds(res.buffer_damage_rects);
+  return res;
+}
 
+std::vector<SkIRect> DiffContext::MergeDamageRects(std::vector<SkIRect> rects,
+                                                   size_t max_rects) const {
   SkIRect frame_clip = SkIRect::MakeSize(frame_size_);
-  res.buffer_damage.intersect(frame_clip);
-  res.frame_damage.intersect(frame_clip);
-  return res;
+  std::vector<SkIRect> merged;
+  std::vector<bool> added_readbacks(readbacks_.size(), false);
+  while (true) {
+    for (const auto& rect : rects) {
+      AddDamageRect(merged, rect, max_rects);
+    }
+    rects.clear();
+
+    // Joining rects may have damaged more readback regions, so repeat until
+    // there are none left to add.
+    for (size_t i = 0; i < readbacks_.size(); ++i) {
+      SkIRect readback = readbacks_[i].rect;
+      if (added_readbacks[i] || !readback.intersect(frame_clip)) {
+        continue;
+      }
+      for (const auto& rect : merged) {
+        if (SkIRect::Intersects(rect, readback)) {
+          rects.push_back(readback);
+          added_readbacks[i] = true;
+          break;
+        }
+      }
+    }
+    if (rects.empty()) {
+      return merged;
+    }
+  }
 }
 
 bool DiffContext::PushCullRect(const SkRect& clip) {
@@ -181,12 +288,14 @@ PaintRegion DiffContext::CurrentSubtreeRegion() const {
 void DiffContext::AddDamage(const PaintRegion& damage) {
   FML_DCHECK(damage.is_valid());
   for (const auto& r : damage) {
-    damage_.join(r);
+    AddDamage(r);
   }
 }
 
 void DiffContext::AddDamage(const SkRect& rect) {
-  damage_.join(rect);
+  if (!rect.isEmpty()) {
+    damage_rects_.push_back(rect);
+  }
 }
 
 void DiffContext::SetLayerPaintRegion(const Layer* layer,
@@ -34,6 +34,13 @@ struct Damage {
   // upfront may be useful for tile based GPUs.
   // Corresponds to "buffer damage" from EGL_KHR_partial_update.
   SkIRect buffer_damage;
+
+  // The same areas as frame_damage and buffer_damage, split into at most
+  // DiffContext::kMaxDamageRects rectangles, so that unrelated changes far
+  // apart don't require repainting everything between them. The rectangles
+  // may overlap; frame_damage and buffer_damage are their bounds.
+  std::vector<SkIRect> frame_damage_rects;
+  std::vector<SkIRect> buffer_damage_rects;
 };
 
 // Layer Unique Id to PaintRegion
@@ -42,6 +49,11 @@ using PaintRegionMap = std::map<uint64_t, PaintRegion>;
 // Tracks state during tree diffing process and computes resulting damage
 class DiffContext {
  public:
+  // The number of rectangles that damage is split into at most by default.
+  // Surfaces often have a small limit on the number of damage rectangles, and
+  // each one adds overhead to painting.
+  static constexpr size_t kMaxDamageRects = 4;
+
   explicit DiffContext(SkISize frame_size,
                        double device_pixel_aspect_ratio,
                        PaintRegionMap& this_frame_paint_region_map,
@@ -133,7 +145,12 @@ class DiffContext {
   //
   // additional_damage is the previously accumulated frame_damage for
   // current framebuffer
-  Damage ComputeDamage(const SkIRect& additional_damage) const;
+  //
+  // Damaged areas are joined when painting the area between them costs less
+  // than painting them separately, and until there are at most max_rects of
+  // them.
+  Damage ComputeDamage(const SkIRect& additional_damage,
+                       size_t max_rects = kMaxDamageRects) const;
 
   double frame_device_pixel_ratio() const { return frame_device_pixel_ratio_; };
 
@@ -223,7 +240,8 @@ class DiffContext {
   // Rect must be in device coordinates.
   SkRect ApplyFilterBoundsAdjustment(SkRect rect) const;
 
-  SkRect damage_ = SkRect::MakeEmpty();
+  // In screen coordinates; Not merged until the damage is computed.
+  std::vector<SkRect> damage_rects_;
 
   PaintRegionMap& this_frame_paint_region_map_;
   const PaintRegionMap& last_frame_paint_region_map_;
@@ -241,6 +259,10 @@ class DiffContext {
 
   std::vector<Readback> readbacks_;
   Statistics statistics_;
+
+  // Merges the damage rects and adds the readback regions that intersect them.
+  std::vector<SkIRect> MergeDamageRects(std::vector<SkIRect> rects,
+                                        size_t max_rects) const;
 };
 
 }  // namespace flutter
@@ -0,0 +1,159 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/diff_context.h"
+
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+// Diffs a frame in which the given rects changed.
+class DamageBuilder {
+ public:
+  explicit DamageBuilder(SkISize frame_size = SkISize::Make(1000, 1000))
+      : context_(frame_size, 1, this_frame_, last_frame_) {
+    context_.PushCullRect(SkRect::Make(frame_size));
+    context_.BeginSubtree();
+    context_.MarkSubtreeDirty();
+  }
+
+  DamageBuilder& Add(const SkRect& rect) {
+    context_.AddLayerBounds(rect);
+    return *this;
+  }
+
+  DamageBuilder& AddReadback(const SkIRect& rect) {
+    context_.AddReadbackRegion(rect);
+    return *this;
+  }
+
+  Damage Compute(const SkIRect& additional_damage = SkIRect::MakeEmpty(),
+                 size_t max_rects = DiffContext::kMaxDamageRects) {
+    return context_.ComputeDamage(additional_damage, max_rects);
+  }
+
+ private:
+  PaintRegionMap this_frame_;
+  PaintRegionMap last_frame_;
+  DiffContext context_;
+};
+
+bool Covers(const std::vector<SkIRect>& rects, const SkIRect& rect) {
+  for (const auto& r : rects) {
+    if (r.contains(rect)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+TEST(DamageRectsTest, DistantDamageIsNotJoined) {
+  auto damage = DamageBuilder()
+                    .Add(SkRect::MakeLTRB(0, 0, 10, 10))
+                    .Add(SkRect::MakeLTRB(990, 990, 1000, 1000))
+                    .Compute();
+  EXPECT_EQ(damage.frame_damage, SkIRect::MakeLTRB(0, 0, 1000, 1000));
+  ASSERT_EQ(damage.frame_damage_rects.size(), 2u);
+  EXPECT_EQ(damage.frame_damage_rects[0], SkIRect::MakeLTRB(0, 0, 10, 10));
+  EXPECT_EQ(damage.frame_damage_rects[1],
+            SkIRect::MakeLTRB(990, 990, 1000, 1000));
+  EXPECT_EQ(damage.buffer_damage_rects, damage.frame_damage_rects);
+}
+
+TEST(DamageRectsTest, NearbyDamageIsJoined) {
+  auto damage = DamageBuilder()
+                    .Add(SkRect::MakeLTRB(0, 0, 10, 10))
+                    .Add(SkRect::MakeLTRB(5, 5, 15, 15))
+                    .Add(SkRect::MakeLTRB(20, 0, 30, 10))
+                    .Compute();
+  ASSERT_EQ(damage.frame_damage_rects.size(), 1u);
+  EXPECT_EQ(damage.frame_damage_rects[0], SkIRect::MakeLTRB(0, 0, 30, 15));
+  EXPECT_EQ(damage.frame_damage, SkIRect::MakeLTRB(0, 0, 30, 15));
+}
+
+TEST(DamageRectsTest, DamageIsClippedToFrame) {
+  auto damage = DamageBuilder(SkISize::Make(100, 100))
+                    .Add(SkRect::MakeLTRB(90.5, 90.5, 110, 110))
+                    .Add(SkRect::MakeLTRB(-10, -10, -5, -5))
+                    .Compute();
+  ASSERT_EQ(damage.frame_damage_rects.size(), 1u);
+  EXPECT_EQ(damage.frame_damage_rects[0], SkIRect::MakeLTRB(90, 90, 100, 100));
+}
+
+TEST(DamageRectsTest, DamageIsLimitedToMaxRects) {
+  DamageBuilder builder;
+  std::vector<SkIRect> changes;
+  for (int i = 0; i < 10; i++) {
+    changes.push_back(SkIRect::MakeXYWH(i * 100, i * 100, 10, 10));
+    builder.Add(SkRect::Make(changes.back()));
+  }
+  auto damage = builder.Compute(SkIRect::MakeEmpty(), 3);
+  ASSERT_EQ(damage.frame_damage_rects.size(), 3u);
+  for (const auto& change : changes) {
+    EXPECT_TRUE(Covers(damage.frame_damage_rects, change));
+  }
+  EXPECT_EQ(damage.frame_damage, SkIRect::MakeLTRB(0, 0, 910, 910));
+
+  // A single rect is the bounds of all damage.
+  damage = builder.Compute(SkIRect::MakeEmpty(), 1);
+  ASSERT_EQ(damage.frame_damage_rects.size(), 1u);
+  EXPECT_EQ(damage.frame_damage_rects[0], SkIRect::MakeLTRB(0, 0, 910, 910));
+}
+
+TEST(DamageRectsTest, AdditionalDamageIsOnlyBufferDamage) {
+  auto damage = DamageBuilder()
+                    .Add(SkRect::MakeLTRB(0, 0, 10, 10))
+                    .Compute(SkIRect::MakeLTRB(500, 500, 510, 510));
+  ASSERT_EQ(damage.frame_damage_rects.size(), 1u);
+  EXPECT_EQ(damage.frame_damage_rects[0], SkIRect::MakeLTRB(0, 0, 10, 10));
+  ASSERT_EQ(damage.buffer_damage_rects.size(), 2u);
+  EXPECT_TRUE(Covers(damage.buffer_damage_rects,
+                     SkIRect::MakeLTRB(500, 500, 510, 510)));
+  EXPECT_EQ(damage.buffer_damage, SkIRect::MakeLTRB(0, 0, 510, 510));
+}
+
+TEST(DamageRectsTest, ReadbackRegionsIntersectingDamageAreDamaged) {
+  auto damage = DamageBuilder()
+                    .AddReadback(SkIRect::MakeLTRB(0, 200, 300, 300))
+                    .AddReadback(SkIRect::MakeLTRB(400, 400, 500, 500))
+                    .Add(SkRect::MakeLTRB(0, 0, 10, 10))
+                    .Add(SkRect::MakeLTRB(250, 250, 260, 260))
+                    .Add(SkRect::MakeLTRB(900, 900, 910, 910))
+                    .Compute();
+  // The second readback region is within the bounds of the damage, but no
+  // damaged area reads back from it.
+  ASSERT_EQ(damage.frame_damage_rects.size(), 3u);
+  EXPECT_TRUE(Covers(damage.frame_damage_rects,
+                     SkIRect::MakeLTRB(0, 200, 300, 300)));
+  EXPECT_FALSE(Covers(damage.frame_damage_rects,
+                      SkIRect::MakeLTRB(450, 450, 460, 460)));
+}
+
+TEST(DamageRectsTest, ReadbackRegionsIntersectingJoinedDamageAreDamaged) {
+  // The readback region is between the changes, so it is only damaged once
+  // they are joined.
+  auto damage = DamageBuilder()
+                    .AddReadback(SkIRect::MakeLTRB(50, 0, 60, 10))
+                    .Add(SkRect::MakeLTRB(0, 0, 40, 10))
+                    .Add(SkRect::MakeLTRB(70, 0, 110, 10))
+                    .Compute();
+  ASSERT_EQ(damage.frame_damage_rects.size(), 1u);
+  EXPECT_EQ(damage.frame_damage_rects[0], SkIRect::MakeLTRB(0, 0, 110, 10));
+
+  damage = DamageBuilder()
+               .AddReadback(SkIRect::MakeLTRB(50, 0, 60, 10))
+               .Add(SkRect::MakeLTRB(0, 0, 10, 10))
+               .Add(SkRect::MakeLTRB(900, 0, 910, 10))
+               .Compute(SkIRect::MakeEmpty(), 1);
+  ASSERT_EQ(damage.frame_damage_rects.size(), 1u);
+  EXPECT_EQ(damage.frame_damage_rects[0], SkIRect::MakeLTRB(0, 0, 910, 10));
+}
+
+}  // namespace testing
+}  // namespace flutter
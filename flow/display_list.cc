@@ -2,6 +2,7 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <algorithm>
 #include <type_traits>
 
 #include "flutter/flow/display_list.h"
@@ -864,6 +865,56 @@ void DisplayList::ComputeBounds() {
   bounds_ = calculator.bounds();
 }
 
+// All of the rendering ops follow the attribute, save/restore, transform
+// and clip ops in |FOR_EACH_DISPLAY_LIST_OP|.
+static bool IsRenderingOp(DisplayListOpType type) {
+  return type >= DisplayListOpType::kDrawPaint;
+}
+
+static void DispatchOneOp(Dispatcher& dispatcher, const DLOp* op) {
+  switch (op->type) {
+#define DL_OP_DISPATCH(name)                                \
+  case DisplayListOpType::k##name:                          \
+    static_cast<const name##Op*>(op)->dispatch(dispatcher); \
+    break;
+
+    FOR_EACH_DISPLAY_LIST_OP(DL_OP_DISPATCH)
+
+#undef DL_OP_DISPATCH
+
+    default:
+      FML_DCHECK(false);
+      return;
+  }
+}
+
+SkRect DisplayList::ComputeOpBounds(std::vector<SkRect>& op_rects,
+                                    std::vector<int>& op_indices) const {
+  DisplayListBoundsCalculator calculator(&bounds_cull_, true);
+  uint8_t* ptr = storage_.get();
+  uint8_t* end = ptr + byte_count_;
+  int op_index = 0;
+  while (ptr < end) {
+    auto op = (const DLOp*)ptr;
+    ptr += op->size;
+    FML_DCHECK(ptr <= end);
+    calculator.set_op_index(IsRenderingOp(op->type) ? op_index : -1);
+    DispatchOneOp(calculator, op);
+    op_index++;
+  }
+  calculator.set_op_index(-1);
+  op_rects = calculator.op_rects();
+  op_indices = calculator.op_indices();
+  return calculator.bounds();
+}
+
+void DisplayList::ComputeRTree() {
+  std::vector<SkRect> rects;
+  bounds_ = ComputeOpBounds(rects, rtree_op_indices_);
+  rtree_ = sk_make_sp<RTree>();
+  rtree_->insert(rects.data(), static_cast<int>(rects.size()));
+}
+
 void DisplayList::Dispatch(Dispatcher& dispatcher,
                            uint8_t* ptr,
                            uint8_t* end) const {
@@ -871,20 +922,42 @@ void DisplayList::Dispatch(Dispatcher& dispatcher,
     auto op = (const DLOp*)ptr;
     ptr += op->size;
     FML_DCHECK(ptr <= end);
-    switch (op->type) {
-#define DL_OP_DISPATCH(name)                                \
-  case DisplayListOpType::k##name:                          \
-    static_cast<const name##Op*>(op)->dispatch(dispatcher); \
-    break;
-
-      FOR_EACH_DISPLAY_LIST_OP(DL_OP_DISPATCH)
+    DispatchOneOp(dispatcher, op);
+  }
+}
 
-#undef DL_OP_DISPATCH
+void DisplayList::Dispatch(Dispatcher& dispatcher,
+                           const SkRect& cull_rect) const {
+  if (!rtree_ || cull_rect.contains(bounds_)) {
+    Dispatch(dispatcher);
+    return;
+  }
+  std::vector<int> rect_indices;
+  rtree_->search(cull_rect, &rect_indices);
+  std::vector<int> op_indices;
+  op_indices.reserve(rect_indices.size());
+  for (int rect_index : rect_indices) {
+    op_indices.push_back(rtree_op_indices_[rect_index]);
+  }
+  std::sort(op_indices.begin(), op_indices.end());
 
-      default:
-        FML_DCHECK(false);
-        return;
+  auto next_op_index = op_indices.begin();
+  uint8_t* ptr = storage_.get();
+  uint8_t* end = ptr + byte_count_;
+  int op_index = 0;
+  while (ptr < end) {
+    auto op = (const DLOp*)ptr;
+    ptr += op->size;
+    FML_DCHECK(ptr <= end);
+    if (IsRenderingOp(op->type)) {
+      if (next_op_index == op_indices.end() || *next_op_index != op_index) {
+        op_index++;
+        continue;
+      }
+      next_op_index++;
     }
+    DispatchOneOp(dispatcher, op);
+    op_index++;
   }
 }
 
@@ -980,7 +1053,7 @@ static bool CompareOps(uint8_t* ptrA,
 
 void DisplayList::RenderTo(SkCanvas* canvas) const {
   DisplayListCanvasDispatcher dispatcher(canvas);
-  Dispatch(dispatcher);
+  Dispatch(dispatcher, canvas->getLocalClipBounds());
 }
 
 bool DisplayList::Equals(const DisplayList& other) const {
@@ -1067,13 +1140,18 @@ sk_sp<DisplayList> DisplayListBuilder::Build() {
   used_ = allocated_ = op_count_ = 0;
   nested_bytes_ = nested_op_count_ = 0;
   storage_.realloc(bytes);
-  return sk_sp<DisplayList>(new DisplayList(storage_.release(), bytes, count,
-                                            nested_bytes, nested_count,
-                                            cull_rect_));
+  sk_sp<DisplayList> display_list(new DisplayList(storage_.release(), bytes,
+                                                  count, nested_bytes,
+                                                  nested_count, cull_rect_));
+  if (prepare_rtree_) {
+    display_list->ComputeRTree();
+  }
+  return display_list;
 }
 
-DisplayListBuilder::DisplayListBuilder(const SkRect& cull_rect)
-    : cull_rect_(cull_rect) {}
+DisplayListBuilder::DisplayListBuilder(const SkRect& cull_rect,
+                                       bool prepare_rtree)
+    : cull_rect_(cull_rect), prepare_rtree_(prepare_rtree) {}
 
 DisplayListBuilder::~DisplayListBuilder() {
   uint8_t* ptr = storage_.get();
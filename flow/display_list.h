@@ -6,6 +6,7 @@
 #define FLUTTER_FLOW_DISPLAY_LIST_H_
 
 #include <optional>
+#include <vector>
 
 #include "third_party/skia/include/core/SkBlender.h"
 #include "third_party/skia/include/core/SkBlurTypes.h"
@@ -19,6 +20,7 @@
 #include "third_party/skia/include/core/SkShader.h"
 #include "third_party/skia/include/core/SkVertices.h"
 
+#include "flutter/flow/rtree.h"
 #include "flutter/fml/logging.h"
 
 // The Flutter DisplayList mechanism encapsulates a persistent sequence of
@@ -187,6 +189,17 @@ class DisplayList : public SkRefCnt {
     Dispatch(ctx, ptr, ptr + byte_count_);
   }
 
+  // Dispatches only those rendering ops whose bounds intersect the
+  // |cull_rect|, along with all of the attribute, transform, clip and
+  // save/restore ops so that the state seen by the dispatcher for each
+  // of those rendering ops is the same as in a full dispatch.
+  // If the DisplayList was not built with an RTree (see the
+  // |prepare_rtree| argument to the DisplayListBuilder constructor)
+  // then all ops will be dispatched.
+  void Dispatch(Dispatcher& ctx, const SkRect& cull_rect) const;
+
+  // Renders the DisplayList to the canvas, culling the rendering ops
+  // against the clip of the canvas if the DisplayList has an RTree.
   void RenderTo(SkCanvas* canvas) const;
 
   // SkPicture always includes nested bytes, but nested ops are
@@ -201,6 +214,10 @@ class DisplayList : public SkRefCnt {
   }
   uint32_t unique_id() const { return unique_id_; }
 
+  // The cull rect that was supplied to the DisplayListBuilder, used to
+  // bound the operations that flood the surface such as |drawPaint|.
+  const SkRect& cull_rect() const { return bounds_cull_; }
+
   const SkRect& bounds() {
     if (bounds_.width() < 0.0) {
       // ComputeBounds() will leave the variable with a
@@ -210,6 +227,14 @@ class DisplayList : public SkRefCnt {
     return bounds_;
   }
 
+  // The RTree holding the bounds of the rendering ops in the DisplayList,
+  // or null if the DisplayList was built without one. The indices returned
+  // from its search methods are those of its own entries, not those of the
+  // ops, and ops that are entirely clipped out have no entry. Use the
+  // |Dispatch| method that takes a cull rect to visit only the ops that
+  // intersect a given area.
+  sk_sp<const RTree> rtree() const { return rtree_; }
+
   bool Equals(const DisplayList& other) const;
 
  private:
@@ -233,10 +258,23 @@ class DisplayList : public SkRefCnt {
   // Only used for drawPaint() and drawColor()
   SkRect bounds_cull_;
 
+  // The bounds of each rendering op along with the index of the
+  // corresponding op in the stream for each entry in the RTree.
+  sk_sp<RTree> rtree_;
+  std::vector<int> rtree_op_indices_;
+
   void ComputeBounds();
+  void ComputeRTree();
+
+  // Computes the bounds of each rendering op that is not entirely clipped
+  // out, in the coordinate system of the DisplayList, along with the index
+  // of that op in the stream. Returns the bounds of the DisplayList.
+  SkRect ComputeOpBounds(std::vector<SkRect>& op_rects,
+                         std::vector<int>& op_indices) const;
   void Dispatch(Dispatcher& ctx, uint8_t* ptr, uint8_t* end) const;
 
   friend class DisplayListBuilder;
+  friend class DisplayListOptimizer;
 };
 
 // The pure virtual interface for interacting with a display list.
@@ -747,7 +785,11 @@ class DisplayListOpFlags : DisplayListFlags {
 // the DisplayListCanvasRecorder class.
 class DisplayListBuilder final : public virtual Dispatcher, public SkRefCnt {
  public:
-  DisplayListBuilder(const SkRect& cull_rect = kMaxCullRect_);
+  // If |prepare_rtree| is true then the DisplayList returned from
+  // |Build| will contain an RTree of the bounds of its rendering ops
+  // which can be used to cull the ops during |DisplayList::Dispatch|.
+  DisplayListBuilder(const SkRect& cull_rect = kMaxCullRect_,
+                     bool prepare_rtree = false);
   ~DisplayListBuilder();
 
   void setAntiAlias(bool aa) override {
@@ -975,6 +1017,7 @@ class DisplayListBuilder final : public virtual Dispatcher, public SkRefCnt {
   int nested_op_count_ = 0;
 
   SkRect cull_rect_;
+  bool prepare_rtree_;
   static constexpr SkRect kMaxCullRect_ =
       SkRect::MakeLTRB(-1E9F, -1E9F, 1E9F, 1E9F);
 
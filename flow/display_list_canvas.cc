@@ -191,7 +191,7 @@ void DisplayListCanvasDispatcher::drawDisplayList(
   int save_count = canvas_->save();
   {
     DisplayListCanvasDispatcher dispatcher(canvas_);
-    display_list->Dispatch(dispatcher);
+    display_list->Dispatch(dispatcher, canvas_->getLocalClipBounds());
   }
   canvas_->restoreToCount(save_count);
 }
@@ -209,9 +209,10 @@ void DisplayListCanvasDispatcher::drawShadow(const SkPath& path,
                                           transparent_occluder, dpr);
 }
 
-DisplayListCanvasRecorder::DisplayListCanvasRecorder(const SkRect& bounds)
+DisplayListCanvasRecorder::DisplayListCanvasRecorder(const SkRect& bounds,
+                                                     bool prepare_rtree)
     : SkCanvasVirtualEnforcer(bounds.width(), bounds.height()),
-      builder_(sk_make_sp<DisplayListBuilder>(bounds)) {}
+      builder_(sk_make_sp<DisplayListBuilder>(bounds, prepare_rtree)) {}
 
 sk_sp<DisplayList> DisplayListCanvasRecorder::Build() {
   sk_sp<DisplayList> display_list = builder_->Build();
@@ -123,7 +123,7 @@ class DisplayListCanvasRecorder
       public SkRefCnt,
       DisplayListOpFlags {
  public:
-  DisplayListCanvasRecorder(const SkRect& bounds);
+  DisplayListCanvasRecorder(const SkRect& bounds, bool prepare_rtree = false);
 
   const sk_sp<DisplayListBuilder> builder() { return builder_; }
 
@@ -0,0 +1,556 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/display_list_optimizer.h"
+
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "third_party/skia/include/core/SkM44.h"
+#include "third_party/skia/include/core/SkPath.h"
+#include "third_party/skia/include/core/SkRRect.h"
+
+namespace flutter {
+
+namespace {
+
+// A Dispatcher that forwards an op stream to a DisplayListBuilder while
+// deferring the attribute, save, transform and clip ops until a rendering
+// op is known to need them.
+class OptimizingDispatcher final : public virtual Dispatcher {
+ public:
+  OptimizingDispatcher(DisplayListBuilder& builder,
+                       std::vector<bool> visible_ops,
+                       DisplayListOptimizer::Stats& stats)
+      : builder_(builder),
+        visible_ops_(std::move(visible_ops)),
+        stats_(stats) {}
+
+  void setAntiAlias(bool aa) override { Defer(anti_alias_, aa); }
+  void setDither(bool dither) override { Defer(dither_, dither); }
+  void setInvertColors(bool invert) override { Defer(invert_colors_, invert); }
+  void setStrokeCap(SkPaint::Cap cap) override { Defer(stroke_cap_, cap); }
+  void setStrokeJoin(SkPaint::Join join) override {
+    Defer(stroke_join_, join);
+  }
+  void setStyle(SkPaint::Style style) override { Defer(style_, style); }
+  void setStrokeWidth(SkScalar width) override { Defer(stroke_width_, width); }
+  void setStrokeMiter(SkScalar limit) override { Defer(stroke_miter_, limit); }
+  void setColor(SkColor color) override { Defer(color_, color); }
+  void setBlendMode(SkBlendMode mode) override {
+    Defer(blend_mode_, mode);
+    blender_.reset();
+  }
+  void setBlender(sk_sp<SkBlender> blender) override {
+    if (!blender) {
+      // The builder treats a null blender as a reset to kSrcOver.
+      setBlendMode(SkBlendMode::kSrcOver);
+      return;
+    }
+    Defer(blender_, std::move(blender));
+    blend_mode_.reset();
+  }
+  void setShader(sk_sp<SkShader> shader) override {
+    Defer(shader_, std::move(shader));
+  }
+  void setImageFilter(sk_sp<SkImageFilter> filter) override {
+    Defer(image_filter_, std::move(filter));
+  }
+  void setColorFilter(sk_sp<SkColorFilter> filter) override {
+    Defer(color_filter_, std::move(filter));
+  }
+  void setPathEffect(sk_sp<SkPathEffect> effect) override {
+    Defer(path_effect_, std::move(effect));
+  }
+  void setMaskFilter(sk_sp<SkMaskFilter> filter) override {
+    Defer(mask_filter_, std::move(filter));
+    mask_blur_.reset();
+  }
+  void setMaskBlurFilter(SkBlurStyle style, SkScalar sigma) override {
+    Defer(mask_blur_, std::make_pair(style, sigma));
+    mask_filter_.reset();
+  }
+
+  void save() override {
+    op_index_++;
+    pending_.push_back({PendingOp::kSave});
+  }
+  void saveLayer(const SkRect* bounds, bool restore_with_paint) override {
+    op_index_++;
+    // A layer can affect the output even if it contains no rendering ops
+    // so it is always kept.
+    FlushState();
+    if (restore_with_paint) {
+      FlushAttributes();
+    }
+    builder_.saveLayer(bounds, restore_with_paint);
+  }
+  void restore() override {
+    op_index_++;
+    for (size_t i = pending_.size(); i > 0; i--) {
+      if (pending_[i - 1].kind == PendingOp::kSave) {
+        // Nothing was rendered since the matching save so it, and every
+        // transform or clip that followed it, can be dropped.
+        pending_.resize(i - 1);
+        stats_.save_restore_pairs_dropped++;
+        return;
+      }
+    }
+    // The matching save was already sent to the builder, but any pending
+    // transforms and clips since the last rendering op are now moot.
+    pending_.clear();
+    builder_.restore();
+  }
+
+  void translate(SkScalar tx, SkScalar ty) override {
+    DeferTransform(SkM44::Translate(tx, ty), DisplayListOpType::kTranslate,
+                   tx, ty);
+  }
+  void scale(SkScalar sx, SkScalar sy) override {
+    DeferTransform(SkM44::Scale(sx, sy), DisplayListOpType::kScale, sx, sy);
+  }
+  void rotate(SkScalar degrees) override {
+    DeferTransform(SkM44(SkMatrix::RotateDeg(degrees)),
+                   DisplayListOpType::kRotate, degrees, 0);
+  }
+  void skew(SkScalar sx, SkScalar sy) override {
+    DeferTransform(SkM44(SkMatrix::Skew(sx, sy)), DisplayListOpType::kSkew,
+                   sx, sy);
+  }
+
+  // clang-format off
+  void transform2DAffine(SkScalar mxx, SkScalar mxy, SkScalar mxt,
+                         SkScalar myx, SkScalar myy, SkScalar myt) override {
+    DeferTransform(SkM44(mxx, mxy, 0, mxt,
+                         myx, myy, 0, myt,
+                          0,   0,  1,  0,
+                          0,   0,  0,  1),
+                   DisplayListOpType::kTransform2DAffine, 0, 0);
+  }
+  void transformFullPerspective(
+      SkScalar mxx, SkScalar mxy, SkScalar mxz, SkScalar mxt,
+      SkScalar myx, SkScalar myy, SkScalar myz, SkScalar myt,
+      SkScalar mzx, SkScalar mzy, SkScalar mzz, SkScalar mzt,
+      SkScalar mwx, SkScalar mwy, SkScalar mwz, SkScalar mwt) override {
+    DeferTransform(SkM44(mxx, mxy, mxz, mxt,
+                         myx, myy, myz, myt,
+                         mzx, mzy, mzz, mzt,
+                         mwx, mwy, mwz, mwt),
+                   DisplayListOpType::kTransformFullPerspective, 0, 0);
+  }
+  // clang-format on
+
+  void clipRect(const SkRect& rect, SkClipOp clip_op, bool is_aa) override {
+    op_index_++;
+    PendingOp op{PendingOp::kClipRect};
+    op.rect = rect;
+    op.clip_op = clip_op;
+    op.is_aa = is_aa;
+    pending_.push_back(std::move(op));
+  }
+  void clipRRect(const SkRRect& rrect, SkClipOp clip_op, bool is_aa) override {
+    op_index_++;
+    PendingOp op{PendingOp::kClipRRect};
+    op.rrect = rrect;
+    op.clip_op = clip_op;
+    op.is_aa = is_aa;
+    pending_.push_back(std::move(op));
+  }
+  void clipPath(const SkPath& path, SkClipOp clip_op, bool is_aa) override {
+    op_index_++;
+    PendingOp op{PendingOp::kClipPath};
+    op.path = path;
+    op.clip_op = clip_op;
+    op.is_aa = is_aa;
+    pending_.push_back(std::move(op));
+  }
+
+  void drawPaint() override {
+    if (Keep()) {
+      builder_.drawPaint();
+    }
+  }
+  void drawColor(SkColor color, SkBlendMode mode) override {
+    if (Keep()) {
+      builder_.drawColor(color, mode);
+    }
+  }
+  void drawLine(const SkPoint& p0, const SkPoint& p1) override {
+    if (Keep()) {
+      builder_.drawLine(p0, p1);
+    }
+  }
+  void drawRect(const SkRect& rect) override {
+    if (Keep()) {
+      builder_.drawRect(rect);
+    }
+  }
+  void drawOval(const SkRect& bounds) override {
+    if (Keep()) {
+      builder_.drawOval(bounds);
+    }
+  }
+  void drawCircle(const SkPoint& center, SkScalar radius) override {
+    if (Keep()) {
+      builder_.drawCircle(center, radius);
+    }
+  }
+  void drawRRect(const SkRRect& rrect) override {
+    if (Keep()) {
+      builder_.drawRRect(rrect);
+    }
+  }
+  void drawDRRect(const SkRRect& outer, const SkRRect& inner) override {
+    if (Keep()) {
+      builder_.drawDRRect(outer, inner);
+    }
+  }
+  void drawPath(const SkPath& path) override {
+    if (Keep()) {
+      builder_.drawPath(path);
+    }
+  }
+  void drawArc(const SkRect& oval_bounds,
+               SkScalar start_degrees,
+               SkScalar sweep_degrees,
+               bool use_center) override {
+    if (Keep()) {
+      builder_.drawArc(oval_bounds, start_degrees, sweep_degrees, use_center);
+    }
+  }
+  void drawPoints(SkCanvas::PointMode mode,
+                  uint32_t count,
+                  const SkPoint points[]) override {
+    if (Keep()) {
+      builder_.drawPoints(mode, count, points);
+    }
+  }
+  void drawVertices(const sk_sp<SkVertices> vertices,
+                    SkBlendMode mode) override {
+    if (Keep()) {
+      builder_.drawVertices(vertices, mode);
+    }
+  }
+  void drawImage(const sk_sp<SkImage> image,
+                 const SkPoint point,
+                 const SkSamplingOptions& sampling,
+                 bool render_with_attributes) override {
+    if (Keep()) {
+      builder_.drawImage(image, point, sampling, render_with_attributes);
+    }
+  }
+  void drawImageRect(const sk_sp<SkImage> image,
+                     const SkRect& src,
+                     const SkRect& dst,
+                     const SkSamplingOptions& sampling,
+                     bool render_with_attributes,
+                     SkCanvas::SrcRectConstraint constraint) override {
+    if (Keep()) {
+      builder_.drawImageRect(image, src, dst, sampling, render_with_attributes,
+                             constraint);
+    }
+  }
+  void drawImageNine(const sk_sp<SkImage> image,
+                     const SkIRect& center,
+                     const SkRect& dst,
+                     SkFilterMode filter,
+                     bool render_with_attributes) override {
+    if (Keep()) {
+      builder_.drawImageNine(image, center, dst, filter,
+                             render_with_attributes);
+    }
+  }
+  void drawImageLattice(const sk_sp<SkImage> image,
+                        const SkCanvas::Lattice& lattice,
+                        const SkRect& dst,
+                        SkFilterMode filter,
+                        bool render_with_attributes) override {
+    if (Keep()) {
+      builder_.drawImageLattice(image, lattice, dst, filter,
+                                render_with_attributes);
+    }
+  }
+  void drawAtlas(const sk_sp<SkImage> atlas,
+                 const SkRSXform xform[],
+                 const SkRect tex[],
+                 const SkColor colors[],
+                 int count,
+                 SkBlendMode mode,
+                 const SkSamplingOptions& sampling,
+                 const SkRect* cull_rect,
+                 bool render_with_attributes) override {
+    if (Keep()) {
+      builder_.drawAtlas(atlas, xform, tex, colors, count, mode, sampling,
+                         cull_rect, render_with_attributes);
+    }
+  }
+  void drawPicture(const sk_sp<SkPicture> picture,
+                   const SkMatrix* matrix,
+                   bool render_with_attributes) override {
+    if (Keep()) {
+      builder_.drawPicture(picture, matrix, render_with_attributes);
+    }
+  }
+  void drawDisplayList(const sk_sp<DisplayList> display_list) override {
+    if (Keep()) {
+      builder_.drawDisplayList(display_list);
+    }
+  }
+  void drawTextBlob(const sk_sp<SkTextBlob> blob,
+                    SkScalar x,
+                    SkScalar y) override {
+    if (Keep()) {
+      builder_.drawTextBlob(blob, x, y);
+    }
+  }
+  void drawShadow(const SkPath& path,
+                  const SkColor color,
+                  const SkScalar elevation,
+                  bool transparent_occluder,
+                  SkScalar dpr) override {
+    if (Keep()) {
+      builder_.drawShadow(path, color, elevation, transparent_occluder, dpr);
+    }
+  }
+
+ private:
+  struct PendingOp {
+    enum Kind { kSave, kTransform, kClipRect, kClipRRect, kClipPath } kind;
+
+    // For kTransform, the combined matrix of all of the folded ops along
+    // with the type and arguments of the first op so that a lone rotate
+    // or skew can be sent as is.
+    SkM44 matrix;
+    int transform_count = 0;
+    DisplayListOpType transform_type = DisplayListOpType::kTranslate;
+    SkScalar transform_args[2] = {0, 0};
+
+    // For the clip kinds.
+    SkRect rect;
+    SkRRect rrect;
+    SkPath path;
+    SkClipOp clip_op = SkClipOp::kIntersect;
+    bool is_aa = false;
+  };
+
+  DisplayListBuilder& builder_;
+  const std::vector<bool> visible_ops_;
+  DisplayListOptimizer::Stats& stats_;
+  int op_index_ = 0;
+  std::vector<PendingOp> pending_;
+
+  std::optional<bool> anti_alias_;
+  std::optional<bool> dither_;
+  std::optional<bool> invert_colors_;
+  std::optional<SkPaint::Cap> stroke_cap_;
+  std::optional<SkPaint::Join> stroke_join_;
+  std::optional<SkPaint::Style> style_;
+  std::optional<SkScalar> stroke_width_;
+  std::optional<SkScalar> stroke_miter_;
+  std::optional<SkColor> color_;
+  std::optional<SkBlendMode> blend_mode_;
+  std::optional<sk_sp<SkBlender>> blender_;
+  std::optional<sk_sp<SkShader>> shader_;
+  std::optional<sk_sp<SkImageFilter>> image_filter_;
+  std::optional<sk_sp<SkColorFilter>> color_filter_;
+  std::optional<sk_sp<SkPathEffect>> path_effect_;
+  std::optional<sk_sp<SkMaskFilter>> mask_filter_;
+  std::optional<std::pair<SkBlurStyle, SkScalar>> mask_blur_;
+
+  // Each attribute op is counted as dropped until it is flushed.
+  template <typename T, typename V>
+  void Defer(std::optional<T>& attribute, V&& value) {
+    op_index_++;
+    stats_.attribute_ops_dropped++;
+    attribute = std::forward<V>(value);
+  }
+
+  template <typename T, typename Apply>
+  void Flush(std::optional<T>& attribute, Apply apply) {
+    if (attribute.has_value()) {
+      apply(std::move(attribute.value()));
+      attribute.reset();
+      stats_.attribute_ops_dropped--;
+    }
+  }
+
+  void FlushAttributes() {
+    auto& b = builder_;
+    Flush(anti_alias_, [&b](bool aa) { b.setAntiAlias(aa); });
+    Flush(dither_, [&b](bool dither) { b.setDither(dither); });
+    Flush(invert_colors_, [&b](bool invert) { b.setInvertColors(invert); });
+    Flush(stroke_cap_, [&b](SkPaint::Cap cap) { b.setStrokeCap(cap); });
+    Flush(stroke_join_, [&b](SkPaint::Join join) { b.setStrokeJoin(join); });
+    Flush(style_, [&b](SkPaint::Style style) { b.setStyle(style); });
+    Flush(stroke_width_, [&b](SkScalar width) { b.setStrokeWidth(width); });
+    Flush(stroke_miter_, [&b](SkScalar limit) { b.setStrokeMiter(limit); });
+    Flush(color_, [&b](SkColor color) { b.setColor(color); });
+    Flush(blend_mode_, [&b](SkBlendMode mode) { b.setBlendMode(mode); });
+    Flush(blender_, [&b](sk_sp<SkBlender> blender) {
+      b.setBlender(std::move(blender));
+    });
+    Flush(shader_, [&b](sk_sp<SkShader> shader) {
+      b.setShader(std::move(shader));
+    });
+    Flush(image_filter_, [&b](sk_sp<SkImageFilter> filter) {
+      b.setImageFilter(std::move(filter));
+    });
+    Flush(color_filter_, [&b](sk_sp<SkColorFilter> filter) {
+      b.setColorFilter(std::move(filter));
+    });
+    Flush(path_effect_, [&b](sk_sp<SkPathEffect> effect) {
+      b.setPathEffect(std::move(effect));
+    });
+    Flush(mask_filter_, [&b](sk_sp<SkMaskFilter> filter) {
+      b.setMaskFilter(std::move(filter));
+    });
+    Flush(mask_blur_, [&b](std::pair<SkBlurStyle, SkScalar> blur) {
+      b.setMaskBlurFilter(blur.first, blur.second);
+    });
+  }
+
+  void DeferTransform(const SkM44& matrix,
+                      DisplayListOpType type,
+                      SkScalar arg0,
+                      SkScalar arg1) {
+    op_index_++;
+    if (!pending_.empty() && pending_.back().kind == PendingOp::kTransform) {
+      PendingOp& op = pending_.back();
+      op.matrix.preConcat(matrix);
+      op.transform_count++;
+      stats_.transform_ops_folded++;
+      return;
+    }
+    PendingOp op{PendingOp::kTransform};
+    op.matrix = matrix;
+    op.transform_count = 1;
+    op.transform_type = type;
+    op.transform_args[0] = arg0;
+    op.transform_args[1] = arg1;
+    pending_.push_back(std::move(op));
+  }
+
+  void FlushTransform(const PendingOp& op) {
+    if (op.transform_count == 1) {
+      if (op.transform_type == DisplayListOpType::kRotate) {
+        builder_.rotate(op.transform_args[0]);
+        return;
+      }
+      if (op.transform_type == DisplayListOpType::kSkew) {
+        builder_.skew(op.transform_args[0], op.transform_args[1]);
+        return;
+      }
+    }
+    const SkM44& m = op.matrix;
+    if (m == SkM44()) {
+      return;
+    }
+    // clang-format off
+    bool is_2d_affine =
+        m.rc(0, 2) == 0 && m.rc(1, 2) == 0 &&
+        m.rc(2, 0) == 0 && m.rc(2, 1) == 0 &&
+        m.rc(2, 2) == 1 && m.rc(2, 3) == 0 &&
+        m.rc(3, 0) == 0 && m.rc(3, 1) == 0 &&
+        m.rc(3, 2) == 0 && m.rc(3, 3) == 1;
+    if (!is_2d_affine) {
+      builder_.transformFullPerspective(
+          m.rc(0, 0), m.rc(0, 1), m.rc(0, 2), m.rc(0, 3),
+          m.rc(1, 0), m.rc(1, 1), m.rc(1, 2), m.rc(1, 3),
+          m.rc(2, 0), m.rc(2, 1), m.rc(2, 2), m.rc(2, 3),
+          m.rc(3, 0), m.rc(3, 1), m.rc(3, 2), m.rc(3, 3));
+      return;
+    }
+    // clang-format on
+    SkScalar mxx = m.rc(0, 0), mxy = m.rc(0, 1), mxt = m.rc(0, 3);
+    SkScalar myx = m.rc(1, 0), myy = m.rc(1, 1), myt = m.rc(1, 3);
+    if (mxy == 0 && myx == 0) {
+      if (mxx == 1 && myy == 1) {
+        builder_.translate(mxt, myt);
+        return;
+      }
+      if (mxt == 0 && myt == 0) {
+        builder_.scale(mxx, myy);
+        return;
+      }
+    }
+    builder_.transform2DAffine(mxx, mxy, mxt, myx, myy, myt);
+  }
+
+  void FlushState() {
+    for (const PendingOp& op : pending_) {
+      switch (op.kind) {
+        case PendingOp::kSave:
+          builder_.save();
+          break;
+        case PendingOp::kTransform:
+          FlushTransform(op);
+          break;
+        case PendingOp::kClipRect:
+          builder_.clipRect(op.rect, op.clip_op, op.is_aa);
+          break;
+        case PendingOp::kClipRRect:
+          builder_.clipRRect(op.rrect, op.clip_op, op.is_aa);
+          break;
+        case PendingOp::kClipPath:
+          builder_.clipPath(op.path, op.clip_op, op.is_aa);
+          break;
+      }
+    }
+    pending_.clear();
+  }
+
+  // Returns true if the current rendering op should be sent to the
+  // builder, after first sending it any state that the op depends on.
+  bool Keep() {
+    int index = op_index_++;
+    if (index >= static_cast<int>(visible_ops_.size()) ||
+        !visible_ops_[index]) {
+      stats_.rendering_ops_culled++;
+      return false;
+    }
+    FlushState();
+    FlushAttributes();
+    return true;
+  }
+};
+
+}  // namespace
+
+sk_sp<DisplayList> DisplayListOptimizer::Optimize(
+    const sk_sp<DisplayList>& display_list,
+    Stats* stats) {
+  std::vector<SkRect> op_rects;
+  std::vector<int> op_indices;
+  display_list->ComputeOpBounds(op_rects, op_indices);
+  std::vector<bool> visible_ops;
+  for (size_t i = 0; i < op_indices.size(); i++) {
+    if (op_rects[i].isEmpty()) {
+      continue;
+    }
+    size_t index = static_cast<size_t>(op_indices[i]);
+    if (index >= visible_ops.size()) {
+      visible_ops.resize(index + 1, false);
+    }
+    visible_ops[index] = true;
+  }
+
+  Stats local_stats;
+  Stats& s = stats ? *stats : local_stats;
+  s = Stats();
+
+  DisplayListBuilder builder(display_list->cull_rect(),
+                             display_list->rtree() != nullptr);
+  OptimizingDispatcher dispatcher(builder, std::move(visible_ops), s);
+  display_list->Dispatch(dispatcher);
+  sk_sp<DisplayList> optimized = builder.Build();
+
+  s.original_bytes = display_list->bytes(false);
+  s.optimized_bytes = optimized->bytes(false);
+  s.original_op_count = display_list->op_count();
+  s.optimized_op_count = optimized->op_count();
+  return optimized;
+}
+
+}  // namespace flutter
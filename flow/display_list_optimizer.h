@@ -0,0 +1,54 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FLOW_DISPLAY_LIST_OPTIMIZER_H_
+#define FLUTTER_FLOW_DISPLAY_LIST_OPTIMIZER_H_
+
+#include "flutter/flow/display_list.h"
+#include "flutter/fml/macros.h"
+
+// A pass over a completed DisplayList that produces an equivalent
+// DisplayList with fewer ops, for use with DisplayLists that will be
+// dispatched many times, such as those rendered on every raster cache
+// miss.
+//
+// The pass:
+//   - defers attribute ops until a rendering op needs them, dropping those
+//     that are overwritten or never used,
+//   - drops save/restore pairs that contain no rendering ops along with
+//     any transform and clip ops inside them,
+//   - folds consecutive transform ops into a single op, and
+//   - drops rendering ops whose bounds are entirely clipped out.
+
+namespace flutter {
+
+class DisplayListOptimizer {
+ public:
+  struct Stats {
+    size_t original_bytes = 0;
+    size_t optimized_bytes = 0;
+    // The op counts as reported by |DisplayList::op_count|, which does
+    // not include the attribute ops.
+    int original_op_count = 0;
+    int optimized_op_count = 0;
+
+    int attribute_ops_dropped = 0;
+    int save_restore_pairs_dropped = 0;
+    int transform_ops_folded = 0;
+    int rendering_ops_culled = 0;
+  };
+
+  // Returns an optimized copy of the DisplayList, which will have an
+  // RTree if the original had one. If |stats| is not null it will be
+  // filled in with the savings achieved by the pass.
+  static sk_sp<DisplayList> Optimize(const sk_sp<DisplayList>& display_list,
+                                     Stats* stats = nullptr);
+
+ private:
+  FML_DISALLOW_IMPLICIT_CONSTRUCTORS(DisplayListOptimizer);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_FLOW_DISPLAY_LIST_OPTIMIZER_H_
@@ -0,0 +1,165 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/display_list_optimizer.h"
+
+#include <cstring>
+
+#include "third_party/skia/include/core/SkSurface.h"
+#include "third_party/skia/include/effects/SkImageFilters.h"
+
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+static SkBitmap Render(const DisplayList& display_list) {
+  sk_sp<SkSurface> surface = SkSurface::MakeRasterN32Premul(100, 100);
+  display_list.RenderTo(surface->getCanvas());
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(100, 100);
+  surface->readPixels(bitmap, 0, 0);
+  return bitmap;
+}
+
+TEST(DisplayListOptimizer, DropsUnusedAttributes) {
+  DisplayListBuilder builder;
+  builder.setColor(SK_ColorRED);
+  builder.setAntiAlias(true);
+  builder.setColor(SK_ColorBLUE);
+  builder.drawRect({10, 10, 20, 20});
+  builder.setColor(SK_ColorGREEN);
+  DisplayListOptimizer::Stats stats;
+  auto optimized = DisplayListOptimizer::Optimize(builder.Build(), &stats);
+
+  DisplayListBuilder expected;
+  expected.setAntiAlias(true);
+  expected.setColor(SK_ColorBLUE);
+  expected.drawRect({10, 10, 20, 20});
+  EXPECT_TRUE(optimized->Equals(*expected.Build()));
+  EXPECT_EQ(stats.attribute_ops_dropped, 2);
+  EXPECT_LT(stats.optimized_bytes, stats.original_bytes);
+}
+
+TEST(DisplayListOptimizer, DropsEmptySaveRestore) {
+  DisplayListBuilder builder;
+  builder.save();
+  builder.translate(10, 10);
+  builder.save();
+  builder.clipRect({0, 0, 50, 50}, SkClipOp::kIntersect, false);
+  builder.restore();
+  builder.restore();
+  builder.drawRect({10, 10, 20, 20});
+  DisplayListOptimizer::Stats stats;
+  auto optimized = DisplayListOptimizer::Optimize(builder.Build(), &stats);
+
+  DisplayListBuilder expected;
+  expected.drawRect({10, 10, 20, 20});
+  EXPECT_TRUE(optimized->Equals(*expected.Build()));
+  EXPECT_EQ(stats.save_restore_pairs_dropped, 2);
+  EXPECT_EQ(stats.original_op_count, 7);
+  EXPECT_EQ(stats.optimized_op_count, 1);
+}
+
+TEST(DisplayListOptimizer, KeepsSaveRestoreAroundRendering) {
+  DisplayListBuilder builder;
+  builder.save();
+  builder.translate(10, 10);
+  builder.drawRect({10, 10, 20, 20});
+  builder.clipRect({0, 0, 5, 5}, SkClipOp::kIntersect, false);
+  builder.restore();
+  builder.drawRect({10, 10, 20, 20});
+  auto optimized = DisplayListOptimizer::Optimize(builder.Build());
+
+  DisplayListBuilder expected;
+  expected.save();
+  expected.translate(10, 10);
+  expected.drawRect({10, 10, 20, 20});
+  expected.restore();
+  expected.drawRect({10, 10, 20, 20});
+  EXPECT_TRUE(optimized->Equals(*expected.Build()));
+}
+
+TEST(DisplayListOptimizer, FoldsConsecutiveTransforms) {
+  DisplayListBuilder builder;
+  builder.translate(1, 2);
+  builder.translate(3, 4);
+  builder.drawRect({10, 10, 20, 20});
+  builder.translate(10, 10);
+  builder.scale(2, 2);
+  builder.translate(5, 5);
+  builder.drawRect({10, 10, 20, 20});
+  DisplayListOptimizer::Stats stats;
+  auto optimized = DisplayListOptimizer::Optimize(builder.Build(), &stats);
+
+  DisplayListBuilder expected;
+  expected.translate(4, 6);
+  expected.drawRect({10, 10, 20, 20});
+  expected.transform2DAffine(2, 0, 20,  //
+                             0, 2, 20);
+  expected.drawRect({10, 10, 20, 20});
+  EXPECT_TRUE(optimized->Equals(*expected.Build()));
+  EXPECT_EQ(stats.transform_ops_folded, 3);
+}
+
+TEST(DisplayListOptimizer, CullsClippedOutDraws) {
+  DisplayListBuilder builder(SkRect::MakeWH(100, 100));
+  builder.clipRect({0, 0, 10, 10}, SkClipOp::kIntersect, false);
+  builder.setColor(SK_ColorRED);
+  builder.drawRect({20, 20, 30, 30});
+  builder.setColor(SK_ColorBLUE);
+  builder.drawRect({0, 0, 5, 5});
+  builder.drawRect({200, 200, 300, 300});
+  DisplayListOptimizer::Stats stats;
+  auto optimized = DisplayListOptimizer::Optimize(builder.Build(), &stats);
+
+  DisplayListBuilder expected(SkRect::MakeWH(100, 100));
+  expected.clipRect({0, 0, 10, 10}, SkClipOp::kIntersect, false);
+  expected.setColor(SK_ColorBLUE);
+  expected.drawRect({0, 0, 5, 5});
+  EXPECT_TRUE(optimized->Equals(*expected.Build()));
+  EXPECT_EQ(stats.rendering_ops_culled, 2);
+  EXPECT_EQ(stats.attribute_ops_dropped, 1);
+}
+
+TEST(DisplayListOptimizer, RendersTheSameAsOriginal) {
+  DisplayListBuilder builder(SkRect::MakeWH(100, 100), true);
+  builder.setColor(SK_ColorRED);
+  builder.save();
+  builder.translate(10, 10);
+  builder.scale(2, 2);
+  builder.setAntiAlias(true);
+  builder.drawRect({0, 0, 15, 15});
+  builder.restore();
+  builder.setImageFilter(SkImageFilters::Offset(50, 50, nullptr));
+  builder.saveLayer(nullptr, true);
+  builder.setImageFilter(nullptr);
+  builder.setColor(SK_ColorGREEN);
+  builder.drawCircle({10, 10}, 10);
+  builder.restore();
+  builder.save();
+  builder.clipRect({60, 0, 100, 40}, SkClipOp::kIntersect, true);
+  builder.drawOval({0, 0, 30, 30});
+  builder.setColor(SK_ColorBLUE);
+  builder.drawOval({50, 0, 90, 30});
+  builder.restore();
+  sk_sp<DisplayList> display_list = builder.Build();
+
+  DisplayListOptimizer::Stats stats;
+  auto optimized = DisplayListOptimizer::Optimize(display_list, &stats);
+  EXPECT_NE(optimized->rtree(), nullptr);
+  EXPECT_EQ(stats.rendering_ops_culled, 1);
+  EXPECT_LT(stats.optimized_op_count, stats.original_op_count);
+
+  SkBitmap original_pixels = Render(*display_list);
+  SkBitmap optimized_pixels = Render(*optimized);
+  ASSERT_EQ(original_pixels.computeByteSize(),
+            optimized_pixels.computeByteSize());
+  EXPECT_EQ(memcmp(original_pixels.getPixels(), optimized_pixels.getPixels(),
+                   original_pixels.computeByteSize()),
+            0);
+}
+
+}  // namespace testing
+}  // namespace flutter
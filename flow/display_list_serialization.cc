@@ -0,0 +1,1222 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/display_list_serialization.h"
+
+#include <cstring>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "flutter/fml/file.h"
+#include "flutter/fml/logging.h"
+
+#include "third_party/skia/include/core/SkFlattenable.h"
+#include "third_party/skia/include/core/SkPath.h"
+#include "third_party/skia/include/core/SkRRect.h"
+#include "third_party/skia/include/core/SkRSXform.h"
+#include "third_party/skia/include/core/SkSerialProcs.h"
+#include "third_party/skia/include/core/SkTextBlob.h"
+
+namespace flutter {
+
+namespace {
+
+// The kinds of objects that are stored in the side table rather than
+// inline in the records.
+enum class ObjectKind : uint32_t {
+  kPath,
+  kTextBlob,
+  kImage,
+  kPicture,
+  kDisplayList,
+  kShader,
+  kColorFilter,
+  kImageFilter,
+  kMaskFilter,
+  kPathEffect,
+  kBlender,
+};
+
+// Every record and every side table object starts on a 4 byte boundary.
+constexpr size_t kAlignment = 4;
+
+size_t AlignUp(size_t size) {
+  return (size + kAlignment - 1) & ~(kAlignment - 1);
+}
+
+// A Dispatcher that writes a record for each method call along with any
+// objects referenced by those calls into a side table.
+class SerializingDispatcher final : public virtual Dispatcher {
+ public:
+  bool is_valid() const { return valid_; }
+  uint32_t record_count() const { return record_count_; }
+  uint32_t object_count() const { return object_count_; }
+  const std::vector<uint8_t>& records() const { return records_; }
+  const std::vector<uint8_t>& objects() const { return objects_; }
+
+  void setAntiAlias(bool aa) override {
+    Record(DisplayListOpType::kSetAntiAlias, static_cast<uint32_t>(aa));
+  }
+  void setDither(bool dither) override {
+    Record(DisplayListOpType::kSetDither, static_cast<uint32_t>(dither));
+  }
+  void setInvertColors(bool invert) override {
+    Record(DisplayListOpType::kSetInvertColors, static_cast<uint32_t>(invert));
+  }
+  void setStrokeCap(SkPaint::Cap cap) override {
+    Record(DisplayListOpType::kSetStrokeCap, static_cast<uint32_t>(cap));
+  }
+  void setStrokeJoin(SkPaint::Join join) override {
+    Record(DisplayListOpType::kSetStrokeJoin, static_cast<uint32_t>(join));
+  }
+  void setStyle(SkPaint::Style style) override {
+    Record(DisplayListOpType::kSetStyle, static_cast<uint32_t>(style));
+  }
+  void setStrokeWidth(SkScalar width) override {
+    Record(DisplayListOpType::kSetStrokeWidth, width);
+  }
+  void setStrokeMiter(SkScalar limit) override {
+    Record(DisplayListOpType::kSetStrokeMiter, limit);
+  }
+  void setColor(SkColor color) override {
+    Record(DisplayListOpType::kSetColor, color);
+  }
+  void setBlendMode(SkBlendMode mode) override {
+    Record(DisplayListOpType::kSetBlendMode, static_cast<uint32_t>(mode));
+  }
+  void setBlender(sk_sp<SkBlender> blender) override {
+    blender ? Record(DisplayListOpType::kSetBlender,
+                     AddFlattenable(ObjectKind::kBlender, blender.get()))
+            : Record(DisplayListOpType::kClearBlender);
+  }
+  void setShader(sk_sp<SkShader> shader) override {
+    shader ? Record(DisplayListOpType::kSetShader,
+                    AddFlattenable(ObjectKind::kShader, shader.get()))
+           : Record(DisplayListOpType::kClearShader);
+  }
+  void setColorFilter(sk_sp<SkColorFilter> filter) override {
+    filter ? Record(DisplayListOpType::kSetColorFilter,
+                    AddFlattenable(ObjectKind::kColorFilter, filter.get()))
+           : Record(DisplayListOpType::kClearColorFilter);
+  }
+  void setImageFilter(sk_sp<SkImageFilter> filter) override {
+    filter ? Record(DisplayListOpType::kSetImageFilter,
+                    AddFlattenable(ObjectKind::kImageFilter, filter.get()))
+           : Record(DisplayListOpType::kClearImageFilter);
+  }
+  void setPathEffect(sk_sp<SkPathEffect> effect) override {
+    effect ? Record(DisplayListOpType::kSetPathEffect,
+                    AddFlattenable(ObjectKind::kPathEffect, effect.get()))
+           : Record(DisplayListOpType::kClearPathEffect);
+  }
+  void setMaskFilter(sk_sp<SkMaskFilter> filter) override {
+    filter ? Record(DisplayListOpType::kSetMaskFilter,
+                    AddFlattenable(ObjectKind::kMaskFilter, filter.get()))
+           : Record(DisplayListOpType::kClearMaskFilter);
+  }
+  void setMaskBlurFilter(SkBlurStyle style, SkScalar sigma) override {
+    switch (style) {
+      case kNormal_SkBlurStyle:
+        Record(DisplayListOpType::kSetMaskBlurFilterNormal, sigma);
+        break;
+      case kSolid_SkBlurStyle:
+        Record(DisplayListOpType::kSetMaskBlurFilterSolid, sigma);
+        break;
+      case kOuter_SkBlurStyle:
+        Record(DisplayListOpType::kSetMaskBlurFilterOuter, sigma);
+        break;
+      case kInner_SkBlurStyle:
+        Record(DisplayListOpType::kSetMaskBlurFilterInner, sigma);
+        break;
+    }
+  }
+
+  void save() override { Record(DisplayListOpType::kSave); }
+  void saveLayer(const SkRect* bounds, bool restore_with_paint) override {
+    bounds ? Record(DisplayListOpType::kSaveLayerBounds, *bounds,
+                    static_cast<uint32_t>(restore_with_paint))
+           : Record(DisplayListOpType::kSaveLayer,
+                    static_cast<uint32_t>(restore_with_paint));
+  }
+  void restore() override { Record(DisplayListOpType::kRestore); }
+
+  void translate(SkScalar tx, SkScalar ty) override {
+    Record(DisplayListOpType::kTranslate, tx, ty);
+  }
+  void scale(SkScalar sx, SkScalar sy) override {
+    Record(DisplayListOpType::kScale, sx, sy);
+  }
+  void rotate(SkScalar degrees) override {
+    Record(DisplayListOpType::kRotate, degrees);
+  }
+  void skew(SkScalar sx, SkScalar sy) override {
+    Record(DisplayListOpType::kSkew, sx, sy);
+  }
+
+  // clang-format off
+  void transform2DAffine(SkScalar mxx, SkScalar mxy, SkScalar mxt,
+                         SkScalar myx, SkScalar myy, SkScalar myt) override {
+    Record(DisplayListOpType::kTransform2DAffine,
+           mxx, mxy, mxt,
+           myx, myy, myt);
+  }
+  void transformFullPerspective(
+      SkScalar mxx, SkScalar mxy, SkScalar mxz, SkScalar mxt,
+      SkScalar myx, SkScalar myy, SkScalar myz, SkScalar myt,
+      SkScalar mzx, SkScalar mzy, SkScalar mzz, SkScalar mzt,
+      SkScalar mwx, SkScalar mwy, SkScalar mwz, SkScalar mwt) override {
+    Record(DisplayListOpType::kTransformFullPerspective,
+           mxx, mxy, mxz, mxt,
+           myx, myy, myz, myt,
+           mzx, mzy, mzz, mzt,
+           mwx, mwy, mwz, mwt);
+  }
+  // clang-format on
+
+  void clipRect(const SkRect& rect, SkClipOp clip_op, bool is_aa) override {
+    Record(clip_op == SkClipOp::kIntersect
+               ? DisplayListOpType::kClipIntersectRect
+               : DisplayListOpType::kClipDifferenceRect,
+           rect, static_cast<uint32_t>(is_aa));
+  }
+  void clipRRect(const SkRRect& rrect, SkClipOp clip_op, bool is_aa) override {
+    BeginRecord(clip_op == SkClipOp::kIntersect
+                    ? DisplayListOpType::kClipIntersectRRect
+                    : DisplayListOpType::kClipDifferenceRRect);
+    WriteRRect(rrect);
+    Write(static_cast<uint32_t>(is_aa));
+    EndRecord();
+  }
+  void clipPath(const SkPath& path, SkClipOp clip_op, bool is_aa) override {
+    Record(clip_op == SkClipOp::kIntersect
+               ? DisplayListOpType::kClipIntersectPath
+               : DisplayListOpType::kClipDifferencePath,
+           AddPath(path), static_cast<uint32_t>(is_aa));
+  }
+
+  void drawColor(SkColor color, SkBlendMode mode) override {
+    Record(DisplayListOpType::kDrawColor, color, static_cast<uint32_t>(mode));
+  }
+  void drawPaint() override { Record(DisplayListOpType::kDrawPaint); }
+  void drawLine(const SkPoint& p0, const SkPoint& p1) override {
+    Record(DisplayListOpType::kDrawLine, p0, p1);
+  }
+  void drawRect(const SkRect& rect) override {
+    Record(DisplayListOpType::kDrawRect, rect);
+  }
+  void drawOval(const SkRect& bounds) override {
+    Record(DisplayListOpType::kDrawOval, bounds);
+  }
+  void drawCircle(const SkPoint& center, SkScalar radius) override {
+    Record(DisplayListOpType::kDrawCircle, center, radius);
+  }
+  void drawRRect(const SkRRect& rrect) override {
+    BeginRecord(DisplayListOpType::kDrawRRect);
+    WriteRRect(rrect);
+    EndRecord();
+  }
+  void drawDRRect(const SkRRect& outer, const SkRRect& inner) override {
+    BeginRecord(DisplayListOpType::kDrawDRRect);
+    WriteRRect(outer);
+    WriteRRect(inner);
+    EndRecord();
+  }
+  void drawPath(const SkPath& path) override {
+    Record(DisplayListOpType::kDrawPath, AddPath(path));
+  }
+  void drawArc(const SkRect& oval_bounds,
+               SkScalar start_degrees,
+               SkScalar sweep_degrees,
+               bool use_center) override {
+    Record(DisplayListOpType::kDrawArc, oval_bounds, start_degrees,
+           sweep_degrees, static_cast<uint32_t>(use_center));
+  }
+  void drawPoints(SkCanvas::PointMode mode,
+                  uint32_t count,
+                  const SkPoint points[]) override {
+    switch (mode) {
+      case SkCanvas::PointMode::kPoints_PointMode:
+        BeginRecord(DisplayListOpType::kDrawPoints);
+        break;
+      case SkCanvas::PointMode::kLines_PointMode:
+        BeginRecord(DisplayListOpType::kDrawLines);
+        break;
+      case SkCanvas::PointMode::kPolygon_PointMode:
+        BeginRecord(DisplayListOpType::kDrawPolygon);
+        break;
+    }
+    Write(count);
+    WriteArray(points, count);
+    EndRecord();
+  }
+  void drawVertices(const sk_sp<SkVertices> vertices,
+                    SkBlendMode mode) override {
+    // SkVertices does not offer a public serialization mechanism.
+    Fail("SkVertices");
+  }
+  void drawImage(const sk_sp<SkImage> image,
+                 const SkPoint point,
+                 const SkSamplingOptions& sampling,
+                 bool render_with_attributes) override {
+    BeginRecord(render_with_attributes ? DisplayListOpType::kDrawImageWithAttr
+                                       : DisplayListOpType::kDrawImage);
+    Write(AddImage(image.get()));
+    Write(point);
+    WriteSampling(sampling);
+    EndRecord();
+  }
+  void drawImageRect(const sk_sp<SkImage> image,
+                     const SkRect& src,
+                     const SkRect& dst,
+                     const SkSamplingOptions& sampling,
+                     bool render_with_attributes,
+                     SkCanvas::SrcRectConstraint constraint) override {
+    BeginRecord(DisplayListOpType::kDrawImageRect);
+    Write(AddImage(image.get()));
+    Write(src);
+    Write(dst);
+    WriteSampling(sampling);
+    Write(static_cast<uint32_t>(render_with_attributes));
+    Write(static_cast<uint32_t>(constraint));
+    EndRecord();
+  }
+  void drawImageNine(const sk_sp<SkImage> image,
+                     const SkIRect& center,
+                     const SkRect& dst,
+                     SkFilterMode filter,
+                     bool render_with_attributes) override {
+    Record(render_with_attributes ? DisplayListOpType::kDrawImageNineWithAttr
+                                  : DisplayListOpType::kDrawImageNine,
+           AddImage(image.get()), center, dst, static_cast<uint32_t>(filter));
+  }
+  void drawImageLattice(const sk_sp<SkImage> image,
+                        const SkCanvas::Lattice& lattice,
+                        const SkRect& dst,
+                        SkFilterMode filter,
+                        bool render_with_attributes) override {
+    uint32_t x_count = lattice.fXCount;
+    uint32_t y_count = lattice.fYCount;
+    uint32_t cell_count = lattice.fRectTypes && lattice.fColors
+                              ? (x_count + 1) * (y_count + 1)
+                              : 0;
+    SkIRect src = lattice.fBounds ? *lattice.fBounds : image->bounds();
+    BeginRecord(DisplayListOpType::kDrawImageLattice);
+    Write(AddImage(image.get()));
+    Write(x_count);
+    Write(y_count);
+    Write(cell_count);
+    WriteArray(lattice.fXDivs, x_count);
+    WriteArray(lattice.fYDivs, y_count);
+    WriteArray(lattice.fColors, cell_count);
+    for (uint32_t i = 0; i < cell_count; i++) {
+      Write(static_cast<uint32_t>(lattice.fRectTypes[i]));
+    }
+    Write(src);
+    Write(dst);
+    Write(static_cast<uint32_t>(filter));
+    Write(static_cast<uint32_t>(render_with_attributes));
+    EndRecord();
+  }
+  void drawAtlas(const sk_sp<SkImage> atlas,
+                 const SkRSXform xform[],
+                 const SkRect tex[],
+                 const SkColor colors[],
+                 int count,
+                 SkBlendMode mode,
+                 const SkSamplingOptions& sampling,
+                 const SkRect* cull_rect,
+                 bool render_with_attributes) override {
+    BeginRecord(cull_rect ? DisplayListOpType::kDrawAtlasCulled
+                          : DisplayListOpType::kDrawAtlas);
+    Write(AddImage(atlas.get()));
+    Write(static_cast<uint32_t>(count));
+    Write(static_cast<uint32_t>(mode));
+    WriteSampling(sampling);
+    Write(static_cast<uint32_t>(colors != nullptr));
+    Write(static_cast<uint32_t>(render_with_attributes));
+    if (cull_rect) {
+      Write(*cull_rect);
+    }
+    WriteArray(xform, count);
+    WriteArray(tex, count);
+    if (colors) {
+      WriteArray(colors, count);
+    }
+    EndRecord();
+  }
+  void drawPicture(const sk_sp<SkPicture> picture,
+                   const SkMatrix* matrix,
+                   bool render_with_attributes) override {
+    BeginRecord(matrix ? DisplayListOpType::kDrawSkPictureMatrix
+                       : DisplayListOpType::kDrawSkPicture);
+    Write(AddObject(ObjectKind::kPicture, picture.get(),
+                    [&picture]() { return picture->serialize(); }));
+    if (matrix) {
+      SkScalar values[9];
+      matrix->get9(values);
+      WriteArray(values, 9);
+    }
+    Write(static_cast<uint32_t>(render_with_attributes));
+    EndRecord();
+  }
+  void drawDisplayList(const sk_sp<DisplayList> display_list) override {
+    Record(DisplayListOpType::kDrawDisplayList,
+           AddObject(ObjectKind::kDisplayList, display_list.get(),
+                     [&display_list]() {
+                       return DisplayListSerializer::Serialize(*display_list);
+                     }));
+  }
+  void drawTextBlob(const sk_sp<SkTextBlob> blob,
+                    SkScalar x,
+                    SkScalar y) override {
+    Record(DisplayListOpType::kDrawTextBlob,
+           AddObject(ObjectKind::kTextBlob, blob.get(),
+                     [&blob]() { return blob->serialize(SkSerialProcs()); }),
+           x, y);
+  }
+  void drawShadow(const SkPath& path,
+                  const SkColor color,
+                  const SkScalar elevation,
+                  bool transparent_occluder,
+                  SkScalar dpr) override {
+    Record(transparent_occluder
+               ? DisplayListOpType::kDrawShadowTransparentOccluder
+               : DisplayListOpType::kDrawShadow,
+           AddPath(path), color, elevation, dpr);
+  }
+
+ private:
+  bool valid_ = true;
+  uint32_t record_count_ = 0;
+  uint32_t object_count_ = 0;
+  size_t record_start_ = 0;
+  std::vector<uint8_t> records_;
+  std::vector<uint8_t> objects_;
+  std::unordered_map<const void*, uint32_t> object_indices_;
+
+  void Fail(const char* what) {
+    if (valid_) {
+      FML_LOG(ERROR) << "Cannot serialize a DisplayList containing " << what;
+    }
+    valid_ = false;
+  }
+
+  // Each record starts with a 4 byte header holding the op type in the
+  // low 8 bits and the size of the record (including the header) in the
+  // upper 24 bits, as with the DLOp structures in the DisplayList itself.
+  void BeginRecord(DisplayListOpType type) {
+    record_start_ = records_.size();
+    Write(static_cast<uint32_t>(type));
+  }
+  void EndRecord() {
+    size_t size = records_.size() - record_start_;
+    if (size >= (1 << 24)) {
+      Fail("an op larger than 16MB");
+      return;
+    }
+    uint32_t header;
+    memcpy(&header, records_.data() + record_start_, sizeof(header));
+    header |= static_cast<uint32_t>(size) << 8;
+    memcpy(records_.data() + record_start_, &header, sizeof(header));
+    record_count_++;
+  }
+
+  template <typename... Args>
+  void Record(DisplayListOpType type, Args&&... args) {
+    BeginRecord(type);
+    (Write(args), ...);
+    EndRecord();
+  }
+
+  template <typename T>
+  void Write(const T& value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    static_assert(sizeof(T) % kAlignment == 0);
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+    records_.insert(records_.end(), bytes, bytes + sizeof(T));
+  }
+  template <typename T>
+  void WriteArray(const T* values, uint32_t count) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    static_assert(sizeof(T) % kAlignment == 0);
+    if (count > 0) {
+      const uint8_t* bytes = reinterpret_cast<const uint8_t*>(values);
+      records_.insert(records_.end(), bytes, bytes + count * sizeof(T));
+    }
+  }
+  void WriteRRect(const SkRRect& rrect) {
+    uint8_t bytes[SkRRect::kSizeInMemory];
+    rrect.writeToMemory(bytes);
+    records_.insert(records_.end(), bytes, bytes + SkRRect::kSizeInMemory);
+  }
+  void WriteSampling(const SkSamplingOptions& sampling) {
+    Write(static_cast<uint32_t>(sampling.useCubic));
+    Write(sampling.cubic.B);
+    Write(sampling.cubic.C);
+    Write(static_cast<uint32_t>(sampling.filter));
+    Write(static_cast<uint32_t>(sampling.mipmap));
+  }
+
+  // Objects are stored once no matter how many records refer to them.
+  template <typename Serialize>
+  uint32_t AddObject(ObjectKind kind, const void* key, Serialize serialize) {
+    auto found = object_indices_.find(key);
+    if (found != object_indices_.end()) {
+      return found->second;
+    }
+    sk_sp<SkData> data = serialize();
+    if (!data) {
+      Fail("an object that failed to serialize");
+      return 0;
+    }
+    AppendObject(kind, data->bytes(), data->size());
+    object_indices_[key] = object_count_;
+    return object_count_++;
+  }
+  uint32_t AddFlattenable(ObjectKind kind, SkFlattenable* flattenable) {
+    return AddObject(kind, flattenable,
+                     [flattenable]() { return flattenable->serialize(); });
+  }
+  uint32_t AddImage(SkImage* image) {
+    return AddObject(ObjectKind::kImage, image, [image]() {
+      sk_sp<SkData> encoded = image->refEncodedData();
+      return encoded ? encoded : image->encodeToData();
+    });
+  }
+  // Paths are values rather than references so they are not shared.
+  uint32_t AddPath(const SkPath& path) {
+    std::vector<uint8_t> bytes(path.writeToMemory(nullptr));
+    path.writeToMemory(bytes.data());
+    AppendObject(ObjectKind::kPath, bytes.data(), bytes.size());
+    return object_count_++;
+  }
+  void AppendObject(ObjectKind kind, const uint8_t* bytes, size_t size) {
+    uint32_t header[2] = {static_cast<uint32_t>(kind),
+                          static_cast<uint32_t>(size)};
+    const uint8_t* header_bytes = reinterpret_cast<const uint8_t*>(header);
+    objects_.insert(objects_.end(), header_bytes,
+                    header_bytes + sizeof(header));
+    objects_.insert(objects_.end(), bytes, bytes + size);
+    objects_.resize(AlignUp(objects_.size()), 0);
+  }
+};
+
+// A bounds checked cursor over a range of serialized bytes. Any attempt
+// to read past the end marks the reader as invalid and returns zeroed
+// values so that callers can check validity once after a sequence of
+// reads.
+class ByteReader {
+ public:
+  ByteReader(const uint8_t* ptr, size_t size) : ptr_(ptr), end_(ptr + size) {}
+
+  bool is_valid() const { return valid_; }
+  bool is_done() const { return ptr_ == end_; }
+  const uint8_t* position() const { return ptr_; }
+
+  template <typename T>
+  T Read() {
+    static_assert(std::is_trivially_copyable_v<T>);
+    T value;
+    const uint8_t* bytes = Skip(sizeof(T));
+    if (bytes) {
+      memcpy(&value, bytes, sizeof(T));
+    } else {
+      memset(&value, 0, sizeof(T));
+    }
+    return value;
+  }
+  bool ReadBool() { return Read<uint32_t>() != 0; }
+  // Reads an enum value, marking the reader as invalid if the value is
+  // beyond the last member of the enum.
+  template <typename E>
+  E ReadEnum(E last) {
+    uint32_t value = Read<uint32_t>();
+    if (value > static_cast<uint32_t>(last)) {
+      valid_ = false;
+      return E{};
+    }
+    return static_cast<E>(value);
+  }
+  template <typename T>
+  std::vector<T> ReadArray(uint32_t count) {
+    std::vector<T> values;
+    const uint8_t* bytes = Skip(static_cast<size_t>(count) * sizeof(T));
+    if (bytes && count > 0) {
+      values.resize(count);
+      memcpy(values.data(), bytes, count * sizeof(T));
+    }
+    return values;
+  }
+  SkRRect ReadRRect() {
+    SkRRect rrect;
+    const uint8_t* bytes = Skip(SkRRect::kSizeInMemory);
+    if (bytes && rrect.readFromMemory(bytes, SkRRect::kSizeInMemory) == 0) {
+      valid_ = false;
+    }
+    return rrect;
+  }
+  SkSamplingOptions ReadSampling() {
+    bool use_cubic = ReadBool();
+    SkCubicResampler cubic{Read<float>(), Read<float>()};
+    SkFilterMode filter = ReadEnum(SkFilterMode::kLast);
+    SkMipmapMode mipmap = ReadEnum(SkMipmapMode::kLast);
+    return use_cubic ? SkSamplingOptions(cubic)
+                     : SkSamplingOptions(filter, mipmap);
+  }
+
+  const uint8_t* Skip(size_t size) {
+    if (!valid_ || static_cast<size_t>(end_ - ptr_) < size) {
+      valid_ = false;
+      return nullptr;
+    }
+    const uint8_t* bytes = ptr_;
+    ptr_ += size;
+    return bytes;
+  }
+
+ private:
+  const uint8_t* ptr_;
+  const uint8_t* end_;
+  bool valid_ = true;
+};
+
+// Reads the side table of objects and materializes each object the first
+// time that a record refers to it.
+class ObjectTable {
+ public:
+  bool Parse(ByteReader reader, uint32_t count) {
+    entries_.reserve(count);
+    for (uint32_t i = 0; i < count; i++) {
+      ObjectKind kind = static_cast<ObjectKind>(reader.Read<uint32_t>());
+      uint32_t size = reader.Read<uint32_t>();
+      const uint8_t* bytes = reader.Skip(AlignUp(size));
+      if (!reader.is_valid()) {
+        return false;
+      }
+      entries_.push_back({kind, bytes, size});
+    }
+    return true;
+  }
+
+  std::optional<SkPath> GetPath(uint32_t index) {
+    const Entry* entry = Find(index, ObjectKind::kPath);
+    SkPath path;
+    if (!entry || path.readFromMemory(entry->bytes, entry->size) == 0) {
+      return std::nullopt;
+    }
+    return path;
+  }
+
+  sk_sp<SkTextBlob> GetTextBlob(uint32_t index) {
+    auto found = text_blobs_.find(index);
+    if (found != text_blobs_.end()) {
+      return found->second;
+    }
+    const Entry* entry = Find(index, ObjectKind::kTextBlob);
+    if (!entry) {
+      return nullptr;
+    }
+    sk_sp<SkTextBlob> blob =
+        SkTextBlob::Deserialize(entry->bytes, entry->size, SkDeserialProcs());
+    text_blobs_[index] = blob;
+    return blob;
+  }
+
+  sk_sp<SkImage> GetImage(uint32_t index) {
+    return Get<SkImage>(index, ObjectKind::kImage, [](const Entry& entry) {
+      return SkImage::MakeFromEncoded(
+          SkData::MakeWithCopy(entry.bytes, entry.size));
+    });
+  }
+
+  sk_sp<SkPicture> GetPicture(uint32_t index) {
+    return Get<SkPicture>(index, ObjectKind::kPicture, [](const Entry& entry) {
+      return SkPicture::MakeFromData(entry.bytes, entry.size);
+    });
+  }
+
+  sk_sp<DisplayList> GetDisplayList(uint32_t index) {
+    return Get<DisplayList>(
+        index, ObjectKind::kDisplayList, [](const Entry& entry) {
+          return DisplayListSerializer::Deserialize(entry.bytes, entry.size);
+        });
+  }
+
+  template <typename T>
+  sk_sp<T> GetFlattenable(uint32_t index, ObjectKind kind) {
+    return Get<T>(index, kind, [kind](const Entry& entry) {
+      sk_sp<SkFlattenable> flattenable = SkFlattenable::Deserialize(
+          FlattenableType(kind), entry.bytes, entry.size);
+      return sk_sp<T>(static_cast<T*>(flattenable.release()));
+    });
+  }
+
+ private:
+  struct Entry {
+    ObjectKind kind;
+    const uint8_t* bytes;
+    uint32_t size;
+  };
+
+  std::vector<Entry> entries_;
+  std::unordered_map<uint32_t, sk_sp<SkRefCnt>> objects_;
+  std::unordered_map<uint32_t, sk_sp<SkTextBlob>> text_blobs_;
+
+  static SkFlattenable::Type FlattenableType(ObjectKind kind) {
+    switch (kind) {
+      case ObjectKind::kColorFilter:
+        return SkFlattenable::kSkColorFilter_Type;
+      case ObjectKind::kImageFilter:
+        return SkFlattenable::kSkImageFilter_Type;
+      case ObjectKind::kMaskFilter:
+        return SkFlattenable::kSkMaskFilter_Type;
+      case ObjectKind::kPathEffect:
+        return SkFlattenable::kSkPathEffect_Type;
+      case ObjectKind::kBlender:
+        return SkFlattenable::kSkBlender_Type;
+      default:
+        return SkFlattenable::kSkShaderBase_Type;
+    }
+  }
+
+  const Entry* Find(uint32_t index, ObjectKind kind) const {
+    if (index >= entries_.size() || entries_[index].kind != kind) {
+      return nullptr;
+    }
+    return &entries_[index];
+  }
+
+  template <typename T, typename Make>
+  sk_sp<T> Get(uint32_t index, ObjectKind kind, Make make) {
+    auto found = objects_.find(index);
+    if (found != objects_.end()) {
+      return sk_ref_sp(static_cast<T*>(found->second.get()));
+    }
+    const Entry* entry = Find(index, kind);
+    if (!entry) {
+      return nullptr;
+    }
+    sk_sp<T> object = make(*entry);
+    objects_[index] = object;
+    return object;
+  }
+};
+
+// Replays a single record into the builder, returning false if the
+// record is malformed or refers to an object that cannot be restored.
+bool ReplayRecord(DisplayListOpType type,
+                  ByteReader& reader,
+                  ObjectTable& objects,
+                  DisplayListBuilder& builder) {
+  switch (type) {
+    case DisplayListOpType::kSetAntiAlias:
+      builder.setAntiAlias(reader.ReadBool());
+      break;
+    case DisplayListOpType::kSetDither:
+      builder.setDither(reader.ReadBool());
+      break;
+    case DisplayListOpType::kSetInvertColors:
+      builder.setInvertColors(reader.ReadBool());
+      break;
+    case DisplayListOpType::kSetStrokeCap:
+      builder.setStrokeCap(reader.ReadEnum(SkPaint::kLast_Cap));
+      break;
+    case DisplayListOpType::kSetStrokeJoin:
+      builder.setStrokeJoin(reader.ReadEnum(SkPaint::kLast_Join));
+      break;
+    case DisplayListOpType::kSetStyle:
+      builder.setStyle(reader.ReadEnum(
+          static_cast<SkPaint::Style>(SkPaint::kStyleCount - 1)));
+      break;
+    case DisplayListOpType::kSetStrokeWidth:
+      builder.setStrokeWidth(reader.Read<SkScalar>());
+      break;
+    case DisplayListOpType::kSetStrokeMiter:
+      builder.setStrokeMiter(reader.Read<SkScalar>());
+      break;
+    case DisplayListOpType::kSetColor:
+      builder.setColor(reader.Read<SkColor>());
+      break;
+    case DisplayListOpType::kSetBlendMode:
+      builder.setBlendMode(reader.ReadEnum(SkBlendMode::kLastMode));
+      break;
+
+#define DL_REPLAY_SET_CLEAR(name, kind)                                     \
+  case DisplayListOpType::kSet##name: {                                     \
+    auto object =                                                           \
+        objects.GetFlattenable<Sk##name>(reader.Read<uint32_t>(), kind);    \
+    if (!object) {                                                          \
+      return false;                                                         \
+    }                                                                       \
+    builder.set##name(std::move(object));                                   \
+    break;                                                                  \
+  }                                                                         \
+  case DisplayListOpType::kClear##name:                                     \
+    builder.set##name(nullptr);                                             \
+    break;
+
+      DL_REPLAY_SET_CLEAR(Blender, ObjectKind::kBlender)
+      DL_REPLAY_SET_CLEAR(Shader, ObjectKind::kShader)
+      DL_REPLAY_SET_CLEAR(ColorFilter, ObjectKind::kColorFilter)
+      DL_REPLAY_SET_CLEAR(ImageFilter, ObjectKind::kImageFilter)
+      DL_REPLAY_SET_CLEAR(PathEffect, ObjectKind::kPathEffect)
+      DL_REPLAY_SET_CLEAR(MaskFilter, ObjectKind::kMaskFilter)
+
+#undef DL_REPLAY_SET_CLEAR
+
+    case DisplayListOpType::kSetMaskBlurFilterNormal:
+      builder.setMaskBlurFilter(kNormal_SkBlurStyle, reader.Read<SkScalar>());
+      break;
+    case DisplayListOpType::kSetMaskBlurFilterSolid:
+      builder.setMaskBlurFilter(kSolid_SkBlurStyle, reader.Read<SkScalar>());
+      break;
+    case DisplayListOpType::kSetMaskBlurFilterOuter:
+      builder.setMaskBlurFilter(kOuter_SkBlurStyle, reader.Read<SkScalar>());
+      break;
+    case DisplayListOpType::kSetMaskBlurFilterInner:
+      builder.setMaskBlurFilter(kInner_SkBlurStyle, reader.Read<SkScalar>());
+      break;
+
+    case DisplayListOpType::kSave:
+      builder.save();
+      break;
+    case DisplayListOpType::kSaveLayer:
+      builder.saveLayer(nullptr, reader.ReadBool());
+      break;
+    case DisplayListOpType::kSaveLayerBounds: {
+      SkRect bounds = reader.Read<SkRect>();
+      builder.saveLayer(&bounds, reader.ReadBool());
+      break;
+    }
+    case DisplayListOpType::kRestore:
+      builder.restore();
+      break;
+
+    case DisplayListOpType::kTranslate: {
+      SkScalar tx = reader.Read<SkScalar>();
+      builder.translate(tx, reader.Read<SkScalar>());
+      break;
+    }
+    case DisplayListOpType::kScale: {
+      SkScalar sx = reader.Read<SkScalar>();
+      builder.scale(sx, reader.Read<SkScalar>());
+      break;
+    }
+    case DisplayListOpType::kRotate:
+      builder.rotate(reader.Read<SkScalar>());
+      break;
+    case DisplayListOpType::kSkew: {
+      SkScalar sx = reader.Read<SkScalar>();
+      builder.skew(sx, reader.Read<SkScalar>());
+      break;
+    }
+    case DisplayListOpType::kTransform2DAffine: {
+      std::vector<SkScalar> m = reader.ReadArray<SkScalar>(6);
+      if (!reader.is_valid()) {
+        return false;
+      }
+      builder.transform2DAffine(m[0], m[1], m[2],  //
+                                m[3], m[4], m[5]);
+      break;
+    }
+    case DisplayListOpType::kTransformFullPerspective: {
+      std::vector<SkScalar> m = reader.ReadArray<SkScalar>(16);
+      if (!reader.is_valid()) {
+        return false;
+      }
+      builder.transformFullPerspective(m[0], m[1], m[2], m[3],    //
+                                       m[4], m[5], m[6], m[7],    //
+                                       m[8], m[9], m[10], m[11],  //
+                                       m[12], m[13], m[14], m[15]);
+      break;
+    }
+
+    case DisplayListOpType::kClipIntersectRect:
+    case DisplayListOpType::kClipDifferenceRect: {
+      SkRect rect = reader.Read<SkRect>();
+      builder.clipRect(rect,
+                       type == DisplayListOpType::kClipIntersectRect
+                           ? SkClipOp::kIntersect
+                           : SkClipOp::kDifference,
+                       reader.ReadBool());
+      break;
+    }
+    case DisplayListOpType::kClipIntersectRRect:
+    case DisplayListOpType::kClipDifferenceRRect: {
+      SkRRect rrect = reader.ReadRRect();
+      builder.clipRRect(rrect,
+                        type == DisplayListOpType::kClipIntersectRRect
+                            ? SkClipOp::kIntersect
+                            : SkClipOp::kDifference,
+                        reader.ReadBool());
+      break;
+    }
+    case DisplayListOpType::kClipIntersectPath:
+    case DisplayListOpType::kClipDifferencePath: {
+      std::optional<SkPath> path = objects.GetPath(reader.Read<uint32_t>());
+      if (!path) {
+        return false;
+      }
+      builder.clipPath(path.value(),
+                       type == DisplayListOpType::kClipIntersectPath
+                           ? SkClipOp::kIntersect
+                           : SkClipOp::kDifference,
+                       reader.ReadBool());
+      break;
+    }
+
+    case DisplayListOpType::kDrawPaint:
+      builder.drawPaint();
+      break;
+    case DisplayListOpType::kDrawColor: {
+      SkColor color = reader.Read<SkColor>();
+      builder.drawColor(color, reader.ReadEnum(SkBlendMode::kLastMode));
+      break;
+    }
+    case DisplayListOpType::kDrawLine: {
+      SkPoint p0 = reader.Read<SkPoint>();
+      builder.drawLine(p0, reader.Read<SkPoint>());
+      break;
+    }
+    case DisplayListOpType::kDrawRect:
+      builder.drawRect(reader.Read<SkRect>());
+      break;
+    case DisplayListOpType::kDrawOval:
+      builder.drawOval(reader.Read<SkRect>());
+      break;
+    case DisplayListOpType::kDrawCircle: {
+      SkPoint center = reader.Read<SkPoint>();
+      builder.drawCircle(center, reader.Read<SkScalar>());
+      break;
+    }
+    case DisplayListOpType::kDrawRRect:
+      builder.drawRRect(reader.ReadRRect());
+      break;
+    case DisplayListOpType::kDrawDRRect: {
+      SkRRect outer = reader.ReadRRect();
+      builder.drawDRRect(outer, reader.ReadRRect());
+      break;
+    }
+    case DisplayListOpType::kDrawArc: {
+      SkRect bounds = reader.Read<SkRect>();
+      SkScalar start = reader.Read<SkScalar>();
+      SkScalar sweep = reader.Read<SkScalar>();
+      builder.drawArc(bounds, start, sweep, reader.ReadBool());
+      break;
+    }
+    case DisplayListOpType::kDrawPath: {
+      std::optional<SkPath> path = objects.GetPath(reader.Read<uint32_t>());
+      if (!path) {
+        return false;
+      }
+      builder.drawPath(path.value());
+      break;
+    }
+
+    case DisplayListOpType::kDrawPoints:
+    case DisplayListOpType::kDrawLines:
+    case DisplayListOpType::kDrawPolygon: {
+      uint32_t count = reader.Read<uint32_t>();
+      if (count >= Dispatcher::kMaxDrawPointsCount) {
+        return false;
+      }
+      std::vector<SkPoint> points = reader.ReadArray<SkPoint>(count);
+      if (!reader.is_valid()) {
+        return false;
+      }
+      SkCanvas::PointMode mode =
+          type == DisplayListOpType::kDrawPoints
+              ? SkCanvas::PointMode::kPoints_PointMode
+              : (type == DisplayListOpType::kDrawLines
+                     ? SkCanvas::PointMode::kLines_PointMode
+                     : SkCanvas::PointMode::kPolygon_PointMode);
+      builder.drawPoints(mode, count, points.data());
+      break;
+    }
+    case DisplayListOpType::kDrawVertices:
+      return false;
+
+    case DisplayListOpType::kDrawImage:
+    case DisplayListOpType::kDrawImageWithAttr: {
+      sk_sp<SkImage> image = objects.GetImage(reader.Read<uint32_t>());
+      SkPoint point = reader.Read<SkPoint>();
+      SkSamplingOptions sampling = reader.ReadSampling();
+      if (!image) {
+        return false;
+      }
+      builder.drawImage(std::move(image), point, sampling,
+                        type == DisplayListOpType::kDrawImageWithAttr);
+      break;
+    }
+    case DisplayListOpType::kDrawImageRect: {
+      sk_sp<SkImage> image = objects.GetImage(reader.Read<uint32_t>());
+      SkRect src = reader.Read<SkRect>();
+      SkRect dst = reader.Read<SkRect>();
+      SkSamplingOptions sampling = reader.ReadSampling();
+      bool render_with_attributes = reader.ReadBool();
+      auto constraint = reader.ReadEnum(SkCanvas::kFast_SrcRectConstraint);
+      if (!image) {
+        return false;
+      }
+      builder.drawImageRect(std::move(image), src, dst, sampling,
+                            render_with_attributes, constraint);
+      break;
+    }
+    case DisplayListOpType::kDrawImageNine:
+    case DisplayListOpType::kDrawImageNineWithAttr: {
+      sk_sp<SkImage> image = objects.GetImage(reader.Read<uint32_t>());
+      SkIRect center = reader.Read<SkIRect>();
+      SkRect dst = reader.Read<SkRect>();
+      auto filter = reader.ReadEnum(SkFilterMode::kLast);
+      if (!image) {
+        return false;
+      }
+      builder.drawImageNine(std::move(image), center, dst, filter,
+                            type == DisplayListOpType::kDrawImageNineWithAttr);
+      break;
+    }
+    case DisplayListOpType::kDrawImageLattice: {
+      sk_sp<SkImage> image = objects.GetImage(reader.Read<uint32_t>());
+      uint32_t x_count = reader.Read<uint32_t>();
+      uint32_t y_count = reader.Read<uint32_t>();
+      uint32_t cell_count = reader.Read<uint32_t>();
+      if (!image || !reader.is_valid() ||
+          (cell_count != 0 && cell_count != (x_count + 1) * (y_count + 1))) {
+        return false;
+      }
+      std::vector<int> x_divs = reader.ReadArray<int>(x_count);
+      std::vector<int> y_divs = reader.ReadArray<int>(y_count);
+      std::vector<SkColor> colors = reader.ReadArray<SkColor>(cell_count);
+      std::vector<SkCanvas::Lattice::RectType> rect_types;
+      for (uint32_t i = 0; i < cell_count && reader.is_valid(); i++) {
+        rect_types.push_back(reader.ReadEnum(SkCanvas::Lattice::kFixedColor));
+      }
+      SkIRect src = reader.Read<SkIRect>();
+      SkRect dst = reader.Read<SkRect>();
+      auto filter = reader.ReadEnum(SkFilterMode::kLast);
+      bool render_with_attributes = reader.ReadBool();
+      if (!reader.is_valid()) {
+        return false;
+      }
+      SkCanvas::Lattice lattice = {
+          x_divs.data(),
+          y_divs.data(),
+          cell_count ? rect_types.data() : nullptr,
+          static_cast<int>(x_count),
+          static_cast<int>(y_count),
+          &src,
+          cell_count ? colors.data() : nullptr,
+      };
+      builder.drawImageLattice(std::move(image), lattice, dst, filter,
+                               render_with_attributes);
+      break;
+    }
+    case DisplayListOpType::kDrawAtlas:
+    case DisplayListOpType::kDrawAtlasCulled: {
+      sk_sp<SkImage> atlas = objects.GetImage(reader.Read<uint32_t>());
+      uint32_t count = reader.Read<uint32_t>();
+      auto mode = reader.ReadEnum(SkBlendMode::kLastMode);
+      SkSamplingOptions sampling = reader.ReadSampling();
+      bool has_colors = reader.ReadBool();
+      bool render_with_attributes = reader.ReadBool();
+      std::optional<SkRect> cull_rect;
+      if (type == DisplayListOpType::kDrawAtlasCulled) {
+        cull_rect = reader.Read<SkRect>();
+      }
+      std::vector<SkRSXform> xforms = reader.ReadArray<SkRSXform>(count);
+      std::vector<SkRect> tex = reader.ReadArray<SkRect>(count);
+      std::vector<SkColor> colors;
+      if (has_colors) {
+        colors = reader.ReadArray<SkColor>(count);
+      }
+      if (!atlas || !reader.is_valid()) {
+        return false;
+      }
+      builder.drawAtlas(std::move(atlas), xforms.data(), tex.data(),
+                        has_colors ? colors.data() : nullptr, count, mode,
+                        sampling, cull_rect ? &cull_rect.value() : nullptr,
+                        render_with_attributes);
+      break;
+    }
+    case DisplayListOpType::kDrawSkPicture:
+    case DisplayListOpType::kDrawSkPictureMatrix: {
+      sk_sp<SkPicture> picture = objects.GetPicture(reader.Read<uint32_t>());
+      std::optional<SkMatrix> matrix;
+      if (type == DisplayListOpType::kDrawSkPictureMatrix) {
+        std::vector<SkScalar> values = reader.ReadArray<SkScalar>(9);
+        if (reader.is_valid()) {
+          matrix.emplace();
+          matrix->set9(values.data());
+        }
+      }
+      bool render_with_attributes = reader.ReadBool();
+      if (!picture || !reader.is_valid()) {
+        return false;
+      }
+      builder.drawPicture(std::move(picture),
+                          matrix ? &matrix.value() : nullptr,
+                          render_with_attributes);
+      break;
+    }
+    case DisplayListOpType::kDrawDisplayList: {
+      sk_sp<DisplayList> display_list =
+          objects.GetDisplayList(reader.Read<uint32_t>());
+      if (!display_list) {
+        return false;
+      }
+      builder.drawDisplayList(std::move(display_list));
+      break;
+    }
+    case DisplayListOpType::kDrawTextBlob: {
+      sk_sp<SkTextBlob> blob = objects.GetTextBlob(reader.Read<uint32_t>());
+      SkScalar x = reader.Read<SkScalar>();
+      SkScalar y = reader.Read<SkScalar>();
+      if (!blob) {
+        return false;
+      }
+      builder.drawTextBlob(std::move(blob), x, y);
+      break;
+    }
+    case DisplayListOpType::kDrawShadow:
+    case DisplayListOpType::kDrawShadowTransparentOccluder: {
+      std::optional<SkPath> path = objects.GetPath(reader.Read<uint32_t>());
+      SkColor color = reader.Read<SkColor>();
+      SkScalar elevation = reader.Read<SkScalar>();
+      SkScalar dpr = reader.Read<SkScalar>();
+      if (!path) {
+        return false;
+      }
+      builder.drawShadow(
+          path.value(), color, elevation,
+          type == DisplayListOpType::kDrawShadowTransparentOccluder, dpr);
+      break;
+    }
+
+    default:
+      return false;
+  }
+  return reader.is_valid() && reader.is_done();
+}
+
+}  // namespace
+
+sk_sp<SkData> DisplayListSerializer::Serialize(
+    const DisplayList& display_list) {
+  SerializingDispatcher dispatcher;
+  display_list.Dispatch(dispatcher);
+  if (!dispatcher.is_valid()) {
+    return nullptr;
+  }
+
+  const std::vector<uint8_t>& records = dispatcher.records();
+  const std::vector<uint8_t>& objects = dispatcher.objects();
+  Header header;
+  header.record_count = dispatcher.record_count();
+  header.records_offset = static_cast<uint32_t>(AlignUp(sizeof(Header)));
+  header.records_size = static_cast<uint32_t>(records.size());
+  header.object_count = dispatcher.object_count();
+  header.objects_offset = header.records_offset + header.records_size;
+  header.objects_size = static_cast<uint32_t>(objects.size());
+  if (display_list.rtree()) {
+    header.flags |= Header::kHasRTree;
+  }
+  header.cull_rect = display_list.cull_rect();
+
+  size_t total_size = header.objects_offset + header.objects_size;
+  sk_sp<SkData> data = SkData::MakeZeroInitialized(total_size);
+  uint8_t* bytes = static_cast<uint8_t*>(data->writable_data());
+  memcpy(bytes, &header, sizeof(Header));
+  if (!records.empty()) {
+    memcpy(bytes + header.records_offset, records.data(), records.size());
+  }
+  if (!objects.empty()) {
+    memcpy(bytes + header.objects_offset, objects.data(), objects.size());
+  }
+  return data;
+}
+
+sk_sp<DisplayList> DisplayListSerializer::Deserialize(const uint8_t* data,
+                                                      size_t size) {
+  if (data == nullptr) {
+    return nullptr;
+  }
+  ByteReader header_reader(data, size);
+  Header header = header_reader.Read<Header>();
+  if (!header_reader.is_valid() || header.signature != Header::kSignature) {
+    FML_LOG(ERROR) << "Data is not a serialized DisplayList.";
+    return nullptr;
+  }
+  if (header.version != Header::kVersion) {
+    FML_LOG(ERROR) << "Serialized DisplayList version " << header.version
+                   << " does not match the expected version "
+                   << Header::kVersion << ".";
+    return nullptr;
+  }
+  if (static_cast<uint64_t>(header.records_offset) + header.records_size >
+          size ||
+      static_cast<uint64_t>(header.objects_offset) + header.objects_size >
+          size) {
+    FML_LOG(ERROR) << "Serialized DisplayList is truncated.";
+    return nullptr;
+  }
+
+  ObjectTable objects;
+  if (!objects.Parse(
+          ByteReader(data + header.objects_offset, header.objects_size),
+          header.object_count)) {
+    FML_LOG(ERROR) << "Serialized DisplayList has a malformed object table.";
+    return nullptr;
+  }
+
+  DisplayListBuilder builder(header.cull_rect,
+                             (header.flags & Header::kHasRTree) != 0);
+  ByteReader records(data + header.records_offset, header.records_size);
+  for (uint32_t i = 0; i < header.record_count; i++) {
+    uint32_t record_header = records.Read<uint32_t>();
+    uint32_t record_size = record_header >> 8;
+    const uint8_t* record = records.position();
+    if (!records.is_valid() || record_size < sizeof(uint32_t) ||
+        !records.Skip(record_size - sizeof(uint32_t))) {
+      FML_LOG(ERROR) << "Serialized DisplayList is truncated.";
+      return nullptr;
+    }
+    auto type = static_cast<DisplayListOpType>(record_header & 0xFF);
+    ByteReader payload(record, record_size - sizeof(uint32_t));
+    if (!ReplayRecord(type, payload, objects, builder)) {
+      FML_LOG(ERROR) << "Serialized DisplayList has a malformed record.";
+      return nullptr;
+    }
+  }
+  return builder.Build();
+}
+
+sk_sp<DisplayList> DisplayListSerializer::Deserialize(
+    const fml::Mapping& mapping) {
+  return Deserialize(mapping.GetMapping(), mapping.GetSize());
+}
+
+bool DisplayListSerializer::WriteToFile(const DisplayList& display_list,
+                                        const fml::UniqueFD& directory,
+                                        const std::string& file_name) {
+  sk_sp<SkData> data = Serialize(display_list);
+  if (!data) {
+    return false;
+  }
+  fml::NonOwnedMapping mapping(data->bytes(), data->size());
+  return fml::WriteAtomically(directory, file_name.c_str(), mapping);
+}
+
+sk_sp<DisplayList> DisplayListSerializer::ReadFromFile(
+    const fml::UniqueFD& directory,
+    const std::string& file_name) {
+  std::unique_ptr<fml::FileMapping> mapping =
+      fml::FileMapping::CreateReadOnly(directory, file_name);
+  if (!mapping) {
+    return nullptr;
+  }
+  return Deserialize(*mapping);
+}
+
+}  // namespace flutter
@@ -0,0 +1,87 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FLOW_DISPLAY_LIST_SERIALIZATION_H_
+#define FLUTTER_FLOW_DISPLAY_LIST_SERIALIZATION_H_
+
+#include <string>
+
+#include "flutter/flow/display_list.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/mapping.h"
+#include "flutter/fml/unique_fd.h"
+
+#include "third_party/skia/include/core/SkData.h"
+
+// Support for persisting a DisplayList as a sequence of bytes and for
+// rebuilding an equivalent DisplayList from those bytes, such as from an
+// fml::FileMapping of a file that was written in an earlier run.
+//
+// The format consists of a fixed header followed by a stream of records,
+// one per Dispatcher method call, and a side table of the objects that
+// cannot be stored inline in the records (paths, text blobs, images,
+// shaders, filters and other flattenables, and nested pictures or
+// display lists). Records refer to the objects by their index in the
+// side table and all offsets are relative to the start of the data so
+// the bytes can be read from wherever they are mapped into memory.
+//
+// The record opcodes are the values of |DisplayListOpType|, so the
+// |kVersion| in the header must be incremented whenever the
+// |FOR_EACH_DISPLAY_LIST_OP| list or the layout of any record changes.
+// Data with a different signature or version is rejected.
+
+namespace flutter {
+
+class DisplayListSerializer {
+ public:
+  struct Header {
+    // A prefix used to identify the serialized DisplayList format, also
+    // used to reject data written on a machine of a different endianness.
+    static const uint32_t kSignature = 0x46444C53;  // "FDLS"
+    static const uint32_t kVersion = 2;
+
+    // Set in |flags| if the DisplayList was built with an RTree, which is
+    // then rebuilt when the DisplayList is deserialized.
+    static const uint32_t kHasRTree = 1 << 0;
+
+    uint32_t signature = kSignature;
+    uint32_t version = kVersion;
+    uint32_t record_count = 0;
+    uint32_t records_offset = 0;
+    uint32_t records_size = 0;
+    uint32_t object_count = 0;
+    uint32_t objects_offset = 0;
+    uint32_t objects_size = 0;
+    uint32_t flags = 0;
+    SkRect cull_rect = SkRect::MakeEmpty();
+  };
+
+  // Serializes the DisplayList, returning null if it contains an object
+  // that cannot be serialized (such as an SkVertices object).
+  static sk_sp<SkData> Serialize(const DisplayList& display_list);
+
+  // Rebuilds a DisplayList from data produced by |Serialize|, returning
+  // null if the data is malformed or was written by a different version.
+  // The RTree is recomputed from the rebuilt ops if the serialized
+  // DisplayList had one.
+  static sk_sp<DisplayList> Deserialize(const uint8_t* data, size_t size);
+  static sk_sp<DisplayList> Deserialize(const fml::Mapping& mapping);
+
+  // Writes the serialized DisplayList to the named file in the directory.
+  static bool WriteToFile(const DisplayList& display_list,
+                          const fml::UniqueFD& directory,
+                          const std::string& file_name);
+
+  // Maps the named file in the directory and rebuilds the DisplayList
+  // from it without first copying the file contents.
+  static sk_sp<DisplayList> ReadFromFile(const fml::UniqueFD& directory,
+                                         const std::string& file_name);
+
+ private:
+  FML_DISALLOW_IMPLICIT_CONSTRUCTORS(DisplayListSerializer);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_FLOW_DISPLAY_LIST_SERIALIZATION_H_
@@ -0,0 +1,228 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/display_list_serialization.h"
+
+#include <cstring>
+#include <vector>
+
+#include "flutter/fml/file.h"
+#include "third_party/skia/include/core/SkPath.h"
+#include "third_party/skia/include/core/SkRRect.h"
+#include "third_party/skia/include/core/SkSurface.h"
+#include "third_party/skia/include/core/SkVertices.h"
+#include "third_party/skia/include/effects/SkGradientShader.h"
+#include "third_party/skia/include/effects/SkImageFilters.h"
+
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+static sk_sp<DisplayList> MakeSimpleDisplayList() {
+  DisplayListBuilder builder(SkRect::MakeLTRB(0, 0, 100, 100));
+  builder.setAntiAlias(true);
+  builder.setColor(SK_ColorRED);
+  builder.save();
+  builder.translate(10, 10);
+  builder.clipRRect(SkRRect::MakeRectXY({0, 0, 50, 50}, 5, 5),
+                    SkClipOp::kIntersect, true);
+  builder.drawRect({0, 0, 40, 40});
+  builder.restore();
+  builder.setStyle(SkPaint::kStroke_Style);
+  builder.setStrokeWidth(3);
+  SkPoint points[] = {{10, 10}, {90, 10}, {90, 90}};
+  builder.drawPoints(SkCanvas::kPolygon_PointMode, 3, points);
+  builder.drawArc({20, 20, 80, 80}, 0, 90, true);
+  return builder.Build();
+}
+
+static sk_sp<DisplayList> MakeDisplayListWithObjects() {
+  SkPoint end_points[] = {{0, 0}, {100, 100}};
+  SkColor colors[] = {SK_ColorGREEN, SK_ColorBLUE};
+  SkPath path;
+  path.moveTo(10, 10);
+  path.lineTo(90, 50);
+  path.quadTo(50, 90, 10, 50);
+  path.close();
+
+  DisplayListBuilder builder(SkRect::MakeLTRB(0, 0, 100, 100));
+  builder.setShader(SkGradientShader::MakeLinear(
+      end_points, colors, nullptr, 2, SkTileMode::kClamp));
+  builder.drawPath(path);
+  builder.setShader(nullptr);
+  builder.setImageFilter(SkImageFilters::Blur(2, 2, nullptr));
+  builder.saveLayer(nullptr, true);
+  builder.drawCircle({50, 50}, 20);
+  builder.restore();
+  builder.drawShadow(path, SK_ColorBLACK, 4, false, 1);
+  return builder.Build();
+}
+
+static SkBitmap Render(const DisplayList& display_list) {
+  sk_sp<SkSurface> surface = SkSurface::MakeRasterN32Premul(100, 100);
+  display_list.RenderTo(surface->getCanvas());
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(100, 100);
+  surface->readPixels(bitmap, 0, 0);
+  return bitmap;
+}
+
+static bool SamePixels(const SkBitmap& a, const SkBitmap& b) {
+  return a.computeByteSize() == b.computeByteSize() &&
+         memcmp(a.getPixels(), b.getPixels(), a.computeByteSize()) == 0;
+}
+
+TEST(DisplayListSerialization, RoundTripWithoutObjects) {
+  sk_sp<DisplayList> display_list = MakeSimpleDisplayList();
+  sk_sp<SkData> data = DisplayListSerializer::Serialize(*display_list);
+  ASSERT_NE(data, nullptr);
+
+  sk_sp<DisplayList> restored =
+      DisplayListSerializer::Deserialize(data->bytes(), data->size());
+  ASSERT_NE(restored, nullptr);
+  EXPECT_TRUE(restored->Equals(*display_list));
+  EXPECT_EQ(restored->bounds(), display_list->bounds());
+  EXPECT_EQ(restored->cull_rect(), display_list->cull_rect());
+}
+
+TEST(DisplayListSerialization, RoundTripWithObjectsRendersTheSame) {
+  sk_sp<DisplayList> display_list = MakeDisplayListWithObjects();
+  sk_sp<SkData> data = DisplayListSerializer::Serialize(*display_list);
+  ASSERT_NE(data, nullptr);
+
+  sk_sp<DisplayList> restored =
+      DisplayListSerializer::Deserialize(data->bytes(), data->size());
+  ASSERT_NE(restored, nullptr);
+  EXPECT_EQ(restored->op_count(), display_list->op_count());
+  EXPECT_EQ(restored->bounds(), display_list->bounds());
+  EXPECT_TRUE(SamePixels(Render(*restored), Render(*display_list)));
+}
+
+TEST(DisplayListSerialization, RoundTripNestedDisplayList) {
+  sk_sp<DisplayList> nested = MakeSimpleDisplayList();
+  DisplayListBuilder builder;
+  builder.drawDisplayList(nested);
+  builder.translate(5, 5);
+  builder.drawDisplayList(nested);
+  sk_sp<DisplayList> display_list = builder.Build();
+
+  sk_sp<SkData> data = DisplayListSerializer::Serialize(*display_list);
+  ASSERT_NE(data, nullptr);
+  sk_sp<DisplayList> restored =
+      DisplayListSerializer::Deserialize(data->bytes(), data->size());
+  ASSERT_NE(restored, nullptr);
+  EXPECT_EQ(restored->op_count(), display_list->op_count());
+  EXPECT_TRUE(SamePixels(Render(*restored), Render(*display_list)));
+}
+
+TEST(DisplayListSerialization, VerticesAreNotSupported) {
+  SkPoint points[] = {{0, 0}, {10, 0}, {0, 10}};
+  DisplayListBuilder builder;
+  builder.drawVertices(SkVertices::MakeCopy(SkVertices::kTriangles_VertexMode,
+                                            3, points, nullptr, nullptr),
+                       SkBlendMode::kSrcOver);
+  EXPECT_EQ(DisplayListSerializer::Serialize(*builder.Build()), nullptr);
+}
+
+TEST(DisplayListSerialization, RejectsMalformedData) {
+  sk_sp<SkData> data =
+      DisplayListSerializer::Serialize(*MakeDisplayListWithObjects());
+  ASSERT_NE(data, nullptr);
+  const uint8_t* bytes = data->bytes();
+
+  EXPECT_EQ(DisplayListSerializer::Deserialize(nullptr, 0), nullptr);
+  EXPECT_EQ(DisplayListSerializer::Deserialize(bytes, 4), nullptr);
+  for (size_t size = sizeof(DisplayListSerializer::Header);
+       size < data->size(); size += 16) {
+    EXPECT_EQ(DisplayListSerializer::Deserialize(bytes, size), nullptr);
+  }
+
+  std::vector<uint8_t> copy(bytes, bytes + data->size());
+  DisplayListSerializer::Header header;
+  memcpy(&header, copy.data(), sizeof(header));
+  header.version++;
+  memcpy(copy.data(), &header, sizeof(header));
+  EXPECT_EQ(DisplayListSerializer::Deserialize(copy.data(), copy.size()),
+            nullptr);
+
+  header.version--;
+  header.signature = 0;
+  memcpy(copy.data(), &header, sizeof(header));
+  EXPECT_EQ(DisplayListSerializer::Deserialize(copy.data(), copy.size()),
+            nullptr);
+}
+
+TEST(DisplayListSerialization, RejectsOutOfRangeEnums) {
+  DisplayListBuilder builder;
+  builder.setBlendMode(SkBlendMode::kSrcIn);
+  builder.drawPaint();
+  sk_sp<SkData> data = DisplayListSerializer::Serialize(*builder.Build());
+  ASSERT_NE(data, nullptr);
+  ASSERT_NE(DisplayListSerializer::Deserialize(data->bytes(), data->size()),
+            nullptr);
+
+  // The first record is the blend mode, whose payload follows the
+  // record header.
+  std::vector<uint8_t> copy(data->bytes(), data->bytes() + data->size());
+  DisplayListSerializer::Header header;
+  memcpy(&header, copy.data(), sizeof(header));
+  size_t mode_offset = header.records_offset + sizeof(uint32_t);
+  uint32_t mode;
+  memcpy(&mode, copy.data() + mode_offset, sizeof(mode));
+  ASSERT_EQ(mode, static_cast<uint32_t>(SkBlendMode::kSrcIn));
+
+  copy[mode_offset] = 0xFF;
+  EXPECT_EQ(DisplayListSerializer::Deserialize(copy.data(), copy.size()),
+            nullptr);
+}
+
+TEST(DisplayListSerialization, RebuildsRTree) {
+  DisplayListBuilder builder(SkRect::MakeLTRB(0, 0, 100, 100),
+                             /*prepare_rtree=*/true);
+  builder.drawRect({10, 10, 20, 20});
+  builder.drawRect({60, 60, 70, 70});
+  sk_sp<DisplayList> display_list = builder.Build();
+  ASSERT_NE(display_list->rtree(), nullptr);
+
+  sk_sp<SkData> data = DisplayListSerializer::Serialize(*display_list);
+  ASSERT_NE(data, nullptr);
+  sk_sp<DisplayList> restored =
+      DisplayListSerializer::Deserialize(data->bytes(), data->size());
+  ASSERT_NE(restored, nullptr);
+  ASSERT_NE(restored->rtree(), nullptr);
+
+  std::vector<int> expected;
+  std::vector<int> actual;
+  const SkRect query = SkRect::MakeLTRB(50, 50, 100, 100);
+  display_list->rtree()->search(query, &expected);
+  restored->rtree()->search(query, &actual);
+  EXPECT_EQ(actual, expected);
+  EXPECT_EQ(actual.size(), 1u);
+
+  // Display lists built without an RTree are restored without one.
+  data = DisplayListSerializer::Serialize(*MakeSimpleDisplayList());
+  ASSERT_NE(data, nullptr);
+  restored = DisplayListSerializer::Deserialize(data->bytes(), data->size());
+  ASSERT_NE(restored, nullptr);
+  EXPECT_EQ(restored->rtree(), nullptr);
+}
+
+TEST(DisplayListSerialization, RoundTripThroughFile) {
+  fml::ScopedTemporaryDirectory dir;
+  sk_sp<DisplayList> display_list = MakeSimpleDisplayList();
+  ASSERT_TRUE(DisplayListSerializer::WriteToFile(*display_list, dir.fd(),
+                                                 "test.dlist"));
+
+  sk_sp<DisplayList> restored =
+      DisplayListSerializer::ReadFromFile(dir.fd(), "test.dlist");
+  ASSERT_NE(restored, nullptr);
+  EXPECT_TRUE(restored->Equals(*display_list));
+  EXPECT_EQ(DisplayListSerializer::ReadFromFile(dir.fd(), "missing.dlist"),
+            nullptr);
+  ASSERT_TRUE(fml::UnlinkFile(dir.fd(), "test.dlist"));
+}
+
+}  // namespace testing
+}  // namespace flutter
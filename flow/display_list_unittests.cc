@@ -1372,5 +1372,124 @@ TEST(DisplayList, DisplayListFullPerspectiveTransformHandling) {
   }
 }
 
+TEST(DisplayList, RTreeOfSimpleScene) {
+  DisplayListBuilder builder(SkRect::MakeLTRB(0, 0, 100, 100), true);
+  builder.drawRect({10, 10, 20, 20});
+  builder.drawRect({50, 50, 60, 60});
+  sk_sp<DisplayList> display_list = builder.Build();
+  sk_sp<const RTree> rtree = display_list->rtree();
+  ASSERT_NE(rtree, nullptr);
+  std::vector<int> rects;
+
+  // Missing all drawRect calls
+  rtree->search(SkRect::MakeLTRB(5, 5, 10, 10), &rects);
+  EXPECT_TRUE(rects.empty());
+  rtree->search(SkRect::MakeLTRB(20, 20, 25, 25), &rects);
+  EXPECT_TRUE(rects.empty());
+
+  // Hitting just 1 of the drawRects
+  rtree->search(SkRect::MakeLTRB(5, 5, 11, 11), &rects);
+  EXPECT_EQ(rects.size(), 1u);
+  rects.clear();
+  rtree->search(SkRect::MakeLTRB(55, 55, 65, 65), &rects);
+  EXPECT_EQ(rects.size(), 1u);
+  rects.clear();
+
+  // Hitting both drawRect calls
+  rtree->search(SkRect::MakeLTRB(19, 19, 51, 51), &rects);
+  EXPECT_EQ(rects.size(), 2u);
+}
+
+TEST(DisplayList, NoRTreeUnlessRequested) {
+  DisplayListBuilder builder;
+  builder.drawRect({10, 10, 20, 20});
+  sk_sp<DisplayList> display_list = builder.Build();
+  EXPECT_EQ(display_list->rtree(), nullptr);
+}
+
+TEST(DisplayList, RTreeOfSaveLayerFilterScene) {
+  DisplayListBuilder builder(SkRect::MakeLTRB(0, 0, 100, 100), true);
+  builder.setImageFilter(SkImageFilters::Blur(5.0, 5.0, nullptr));
+  builder.saveLayer(nullptr, true);
+  builder.setImageFilter(nullptr);
+  builder.drawRect({10, 10, 20, 20});
+  builder.restore();
+  sk_sp<DisplayList> display_list = builder.Build();
+  sk_sp<const RTree> rtree = display_list->rtree();
+  std::vector<int> rects;
+
+  // The blur filter on the layer expands the bounds of the rect
+  // by 3 sigma, so the query just outside the rect still hits it.
+  rtree->search(SkRect::MakeLTRB(22, 22, 30, 30), &rects);
+  EXPECT_EQ(rects.size(), 1u);
+  rects.clear();
+  rtree->search(SkRect::MakeLTRB(40, 40, 50, 50), &rects);
+  EXPECT_TRUE(rects.empty());
+}
+
+TEST(DisplayList, CulledDispatchSkipsOnlyRenderingOpsOutsideCull) {
+  DisplayListBuilder builder(SkRect::MakeLTRB(0, 0, 100, 100), true);
+  builder.setColor(SK_ColorBLUE);
+  builder.save();
+  builder.translate(50, 50);
+  builder.drawRect({0, 0, 10, 10});
+  builder.restore();
+  builder.drawRect({10, 10, 20, 20});
+  sk_sp<DisplayList> display_list = builder.Build();
+  ASSERT_EQ(display_list->op_count(), 5);
+
+  {  // Cull rect covering only the second drawRect
+    DisplayListBuilder culled_builder;
+    display_list->Dispatch(culled_builder, SkRect::MakeLTRB(0, 0, 30, 30));
+    sk_sp<DisplayList> culled = culled_builder.Build();
+    EXPECT_EQ(culled->op_count(), 4);
+    EXPECT_EQ(culled_builder.getColor(), SK_ColorBLUE);
+  }
+  {  // Cull rect covering only the translated drawRect
+    DisplayListBuilder culled_builder;
+    display_list->Dispatch(culled_builder, SkRect::MakeLTRB(45, 45, 55, 55));
+    sk_sp<DisplayList> culled = culled_builder.Build();
+    EXPECT_EQ(culled->op_count(), 4);
+  }
+  {  // Cull rect covering everything produces an identical DisplayList
+    DisplayListBuilder culled_builder;
+    display_list->Dispatch(culled_builder, SkRect::MakeLTRB(0, 0, 100, 100));
+    sk_sp<DisplayList> culled = culled_builder.Build();
+    EXPECT_TRUE(culled->Equals(*display_list));
+  }
+}
+
+TEST(DisplayList, CulledRenderToMatchesFullRenderInsideClip) {
+  DisplayListBuilder builder(SkRect::MakeLTRB(0, 0, 100, 100), true);
+  for (int i = 0; i < 10; i++) {
+    builder.setColor(i % 2 == 0 ? SK_ColorRED : SK_ColorGREEN);
+    builder.drawRect(SkRect::MakeXYWH(0, i * 10, 100, 10));
+  }
+  sk_sp<DisplayList> display_list = builder.Build();
+
+  DisplayListBuilder no_rtree_builder(SkRect::MakeLTRB(0, 0, 100, 100));
+  display_list->Dispatch(no_rtree_builder);
+  sk_sp<DisplayList> no_rtree_list = no_rtree_builder.Build();
+
+  SkRect clip = SkRect::MakeLTRB(0, 25, 100, 45);
+  sk_sp<SkSurface> culled_surface = SkSurface::MakeRasterN32Premul(100, 100);
+  culled_surface->getCanvas()->clipRect(clip);
+  display_list->RenderTo(culled_surface->getCanvas());
+  sk_sp<SkSurface> full_surface = SkSurface::MakeRasterN32Premul(100, 100);
+  full_surface->getCanvas()->clipRect(clip);
+  no_rtree_list->RenderTo(full_surface->getCanvas());
+
+  SkPixmap culled_pixels;
+  SkPixmap full_pixels;
+  ASSERT_TRUE(culled_surface->peekPixels(&culled_pixels));
+  ASSERT_TRUE(full_surface->peekPixels(&full_pixels));
+  for (int y = 0; y < 100; y++) {
+    for (int x = 0; x < 100; x++) {
+      ASSERT_EQ(culled_pixels.getColor(x, y), full_pixels.getColor(x, y))
+          << "at (" << x << ", " << y << ")";
+    }
+  }
+}
+
 }  // namespace testing
 }  // namespace flutter
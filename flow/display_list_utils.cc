@@ -222,8 +222,9 @@ void ClipBoundsDispatchHelper::reset(const SkRect* cull_rect) {
 }
 
 DisplayListBoundsCalculator::DisplayListBoundsCalculator(
-    const SkRect* cull_rect)
-    : ClipBoundsDispatchHelper(cull_rect) {
+    const SkRect* cull_rect,
+    bool record_op_bounds)
+    : ClipBoundsDispatchHelper(cull_rect), record_op_bounds_(record_op_bounds) {
   layer_infos_.emplace_back(std::make_unique<RootLayerData>());
   accumulator_ = layer_infos_.back()->layer_accumulator();
 }
@@ -278,12 +279,15 @@ void DisplayListBoundsCalculator::saveLayer(const SkRect* bounds,
                                             bool with_paint) {
   SkMatrixDispatchHelper::save();
   ClipBoundsDispatchHelper::save();
+  int op_bounds_start =
+      record_op_bounds_ ? static_cast<int>(op_rects_.size()) : -1;
   if (with_paint) {
     layer_infos_.emplace_back(std::make_unique<SaveLayerData>(
-        accumulator_, image_filter_, paint_nops_on_transparency()));
+        accumulator_, image_filter_, paint_nops_on_transparency(),
+        op_bounds_start));
   } else {
-    layer_infos_.emplace_back(
-        std::make_unique<SaveLayerData>(accumulator_, nullptr, true));
+    layer_infos_.emplace_back(std::make_unique<SaveLayerData>(
+        accumulator_, nullptr, true, op_bounds_start));
   }
   accumulator_ = layer_infos_.back()->layer_accumulator();
   // Accumulate the layer in its own coordinate system and then
@@ -301,8 +305,14 @@ void DisplayListBoundsCalculator::restore() {
     SkRect layer_bounds = layer_infos_.back()->layer_bounds();
     // Must read unbounded state after layer_bounds
     bool layer_unbounded = layer_infos_.back()->is_unbounded();
+    int op_bounds_start = layer_infos_.back()->op_bounds_start();
+    sk_sp<SkImageFilter> layer_filter = layer_infos_.back()->layer_filter();
     layer_infos_.pop_back();
 
+    if (op_bounds_start >= 0) {
+      RestoreOpBounds(op_bounds_start, layer_filter.get());
+    }
+
     // We accumulate the bounds even if the layer was unbounded because
     // the unbounded state may be contained at a higher level, so we at
     // least accumulate our best estimate about what we have.
@@ -566,11 +576,38 @@ bool DisplayListBoundsCalculator::AdjustBoundsForPaint(
   return true;
 }
 
+void DisplayListBoundsCalculator::RecordOpBounds(const SkRect& rect) {
+  if (record_op_bounds_ && op_index_ >= 0) {
+    op_rects_.push_back(rect);
+    op_indices_.push_back(op_index_);
+  }
+}
+
+void DisplayListBoundsCalculator::RestoreOpBounds(int start,
+                                                  SkImageFilter* filter) {
+  // The ops inside the layer were recorded in the coordinate system of
+  // the layer and must now be filtered, transformed and clipped in the
+  // same way as the bounds of the layer itself.
+  for (size_t i = start; i < op_rects_.size(); i++) {
+    SkRect& rect = op_rects_[i];
+    if (!ComputeFilteredBounds(rect, filter)) {
+      rect = has_clip() ? clip_bounds() : kUnboundedOpRect;
+      continue;
+    }
+    matrix().mapRect(&rect);
+    if (has_clip() && !rect.intersect(clip_bounds())) {
+      rect.setEmpty();
+    }
+  }
+}
+
 void DisplayListBoundsCalculator::AccumulateUnbounded() {
   if (has_clip()) {
     accumulator_->accumulate(clip_bounds());
+    RecordOpBounds(clip_bounds());
   } else {
     layer_infos_.back()->set_unbounded();
+    RecordOpBounds(kUnboundedOpRect);
   }
 }
 void DisplayListBoundsCalculator::AccumulateRect(
@@ -580,6 +617,7 @@ void DisplayListBoundsCalculator::AccumulateRect(
     matrix().mapRect(&rect);
     if (!has_clip() || rect.intersect(clip_bounds())) {
       accumulator_->accumulate(rect);
+      RecordOpBounds(rect);
     }
   } else {
     AccumulateUnbounded();
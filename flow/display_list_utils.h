@@ -279,7 +279,11 @@ class DisplayListBoundsCalculator final
   // queried using |isUnbounded| if an alternate plan is available
   // for such cases.
   // The flag should never be set if a cull_rect is provided.
-  DisplayListBoundsCalculator(const SkRect* cull_rect = nullptr);
+  // If |record_op_bounds| is true then the Calculator will also record
+  // the bounds of each individual rendering op, tagged with the index
+  // most recently supplied to |set_op_index|, for building an RTree.
+  DisplayListBoundsCalculator(const SkRect* cull_rect = nullptr,
+                              bool record_op_bounds = false);
 
   void setStrokeCap(SkPaint::Cap cap) override;
   void setStrokeJoin(SkPaint::Join join) override;
@@ -380,6 +384,18 @@ class DisplayListBoundsCalculator final
     return accumulator_->bounds();
   }
 
+  // Associates the bounds accumulated by the following rendering calls
+  // with the given op index when recording op bounds. A negative index
+  // indicates that the following calls are not rendering ops.
+  void set_op_index(int op_index) { op_index_ = op_index; }
+
+  // The bounds of each rendering op that was recorded and the index
+  // of the associated op. Should only be used after the stream is
+  // fully dispatched so that the bounds of any ops recorded inside
+  // a |saveLayer| have been mapped into the root coordinate system.
+  const std::vector<SkRect>& op_rects() const { return op_rects_; }
+  const std::vector<int>& op_indices() const { return op_indices_; }
+
  private:
   // current accumulator based on saveLayer history
   BoundsAccumulator* accumulator_;
@@ -449,6 +465,12 @@ class DisplayListBoundsCalculator final
     // the layer will have one last chance to flag an unbounded state.
     bool is_unbounded() const { return is_unbounded_; }
 
+    // The index of the first op bounds recorded inside this layer
+    // if the op bounds must be mapped through the filter and outer
+    // transform of the layer when it is restored, or -1 otherwise.
+    virtual int op_bounds_start() const { return -1; }
+    virtual sk_sp<SkImageFilter> layer_filter() const { return nullptr; }
+
    private:
     BoundsAccumulator* outer_;
     bool is_unbounded_;
@@ -508,8 +530,11 @@ class DisplayListBoundsCalculator final
    public:
     SaveLayerData(BoundsAccumulator* outer,
                   sk_sp<SkImageFilter> filter,
-                  bool paint_nops_on_transparency)
-        : AccumulatorLayerData(outer), layer_filter_(std::move(filter)) {
+                  bool paint_nops_on_transparency,
+                  int op_bounds_start)
+        : AccumulatorLayerData(outer),
+          layer_filter_(std::move(filter)),
+          op_bounds_start_(op_bounds_start) {
       if (!paint_nops_on_transparency) {
         set_unbounded();
       }
@@ -524,14 +549,27 @@ class DisplayListBoundsCalculator final
       return bounds;
     }
 
+    int op_bounds_start() const override { return op_bounds_start_; }
+    sk_sp<SkImageFilter> layer_filter() const override { return layer_filter_; }
+
    private:
     sk_sp<SkImageFilter> layer_filter_;
+    int op_bounds_start_;
 
     FML_DISALLOW_COPY_AND_ASSIGN(SaveLayerData);
   };
 
   std::vector<std::unique_ptr<LayerData>> layer_infos_;
 
+  // The bounds recorded for an unbounded op with no clip to contain it.
+  static constexpr SkRect kUnboundedOpRect =
+      SkRect::MakeLTRB(-1E9F, -1E9F, 1E9F, 1E9F);
+
+  bool record_op_bounds_;
+  int op_index_ = -1;
+  std::vector<SkRect> op_rects_;
+  std::vector<int> op_indices_;
+
   static constexpr SkScalar kMinStrokeWidth = 0.01;
 
   skstd::optional<SkBlendMode> blend_mode_ = SkBlendMode::kSrcOver;
@@ -552,6 +590,9 @@ class DisplayListBoundsCalculator final
   static bool ComputeFilteredBounds(SkRect& rect, SkImageFilter* filter);
   bool AdjustBoundsForPaint(SkRect& bounds, DisplayListAttributeFlags flags);
 
+  void RecordOpBounds(const SkRect& rect);
+  void RestoreOpBounds(int start, SkImageFilter* filter);
+
   void AccumulateUnbounded();
   void AccumulateRect(const SkRect& rect, DisplayListAttributeFlags flags) {
     SkRect bounds = rect;
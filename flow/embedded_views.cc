@@ -64,6 +64,14 @@ bool ExternalViewEmbedder::SupportsDynamicThreadMerging() {
   return false;
 }
 
+bool ExternalViewEmbedder::SupportsPartialRepaint() {
+  return false;
+}
+
+bool ExternalViewEmbedder::ReleaseUnusedResources() {
+  return false;
+}
+
 void ExternalViewEmbedder::Teardown() {}
 
 }  // namespace flutter
@@ -337,6 +337,23 @@ class ExternalViewEmbedder {
   // |RasterThreadMerger| instance.
   virtual bool SupportsDynamicThreadMerging();
 
+  // Whether the embedder repaints its render targets only where they need to
+  // be, given the frame damage in the |SurfaceFrame::SubmitInfo| of the frame
+  // passed to |SubmitFrame|.
+  //
+  // Returning `true` makes the rasterizer compute the frame damage against the
+  // previous frame. The layer tree is still painted in full, as the render
+  // targets may each lag behind by a different amount.
+  virtual bool SupportsPartialRepaint();
+
+  // Releases the resources kept between frames that are not needed to
+  // present the last frame, such as render targets kept for reuse. Called on
+  // the raster thread when the platform is low on memory, and once no frame
+  // has been rendered for a while. Returns true if any resources were
+  // released, in which case the embedder may have changed the rendering
+  // context state.
+  virtual bool ReleaseUnusedResources();
+
   // Called when the rasterizer is being torn down.
   // This method provides a way to release resources associated with the current
   // embedder.
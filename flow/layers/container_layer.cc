@@ -105,6 +105,7 @@ void ContainerLayer::DiffChildren(DiffContext* context,
 
 void ContainerLayer::Add(std::shared_ptr<Layer> layer) {
   layers_.emplace_back(std::move(layer));
+  preroll_memo_.reset();
 }
 
 void ContainerLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
@@ -135,7 +136,12 @@ void ContainerLayer::PrerollChildren(PrerollContext* context,
     // sibling tree.
     context->has_platform_view = false;
 
-    layer->Preroll(context, child_matrix);
+    ContainerLayer* container = layer->as_container_layer();
+    if (container) {
+      container->PrerollRetained(context, child_matrix);
+    } else {
+      layer->Preroll(context, child_matrix);
+    }
     child_paint_bounds->join(layer->paint_bounds());
 
     child_has_platform_view =
@@ -149,6 +155,69 @@ void ContainerLayer::PrerollChildren(PrerollContext* context,
   set_subtree_has_platform_view(child_has_platform_view);
 }
 
+void ContainerLayer::PrerollRetained(PrerollContext* context,
+                                     const SkMatrix& matrix) {
+  if (CanReusePreroll(context, matrix) &&
+      (!context->raster_cache || context->raster_cache->TouchPrerollEntries(
+                                     preroll_memo_->raster_cache_entries))) {
+    context->surface_needs_readback =
+        preroll_memo_->result_surface_needs_readback;
+    context->has_texture_layer = preroll_memo_->result_has_texture_layer;
+    return;
+  }
+
+  PrerollMemo memo;
+  memo.matrix = matrix;
+  memo.cull_rect = context->cull_rect;
+  memo.raster_cache = context->raster_cache;
+  memo.gr_context = context->gr_context;
+  memo.dst_color_space = sk_ref_sp(context->dst_color_space);
+  memo.frame_device_pixel_ratio = context->frame_device_pixel_ratio;
+  memo.checkerboard_offscreen_layers = context->checkerboard_offscreen_layers;
+  memo.surface_needs_readback = context->surface_needs_readback;
+  memo.has_texture_layer = context->has_texture_layer;
+  bool has_volatile_preroll = context->has_volatile_preroll;
+  context->has_volatile_preroll = false;
+  if (context->raster_cache) {
+    context->raster_cache->BeginRecordingPrerollEntries(
+        &memo.raster_cache_entries);
+  }
+  Preroll(context, matrix);
+  if (context->raster_cache) {
+    context->raster_cache->EndRecordingPrerollEntries();
+  }
+
+  // Subtrees with platform views are not reused because the preroll of a
+  // platform view also composites it into the current frame.
+  if (context->has_platform_view || context->has_volatile_preroll ||
+      memo.raster_cache_entries.incomplete) {
+    preroll_memo_.reset();
+  } else {
+    memo.result_surface_needs_readback = context->surface_needs_readback;
+    memo.result_has_texture_layer = context->has_texture_layer;
+    preroll_memo_ = std::move(memo);
+  }
+  context->has_volatile_preroll =
+      has_volatile_preroll || context->has_volatile_preroll;
+}
+
+bool ContainerLayer::CanReusePreroll(const PrerollContext* context,
+                                     const SkMatrix& matrix) const {
+  return preroll_memo_ && preroll_memo_->matrix == matrix &&
+         preroll_memo_->cull_rect == context->cull_rect &&
+         preroll_memo_->raster_cache == context->raster_cache &&
+         preroll_memo_->gr_context == context->gr_context &&
+         SkColorSpace::Equals(preroll_memo_->dst_color_space.get(),
+                              context->dst_color_space) &&
+         preroll_memo_->frame_device_pixel_ratio ==
+             context->frame_device_pixel_ratio &&
+         preroll_memo_->checkerboard_offscreen_layers ==
+             context->checkerboard_offscreen_layers &&
+         preroll_memo_->surface_needs_readback ==
+             context->surface_needs_readback &&
+         preroll_memo_->has_texture_layer == context->has_texture_layer;
+}
+
 void ContainerLayer::PaintChildren(PaintContext& context) const {
   // We can no longer call FML_DCHECK here on the needs_painting(context)
   // condition as that test is only valid for the PaintContext that
@@ -5,9 +5,11 @@
 #ifndef FLUTTER_FLOW_LAYERS_CONTAINER_LAYER_H_
 #define FLUTTER_FLOW_LAYERS_CONTAINER_LAYER_H_
 
+#include <optional>
 #include <vector>
 
 #include "flutter/flow/layers/layer.h"
+#include "third_party/skia/include/core/SkColorSpace.h"
 
 namespace flutter {
 
@@ -28,6 +30,15 @@ class ContainerLayer : public Layer {
   virtual void DiffChildren(DiffContext* context,
                             const ContainerLayer* old_layer);
 
+  ContainerLayer* as_container_layer() override { return this; }
+
+  // Prerolls this layer unless it was prerolled in an earlier frame under the
+  // same conditions, in which case the results of that preroll are reused.
+  // Layers are immutable once they are added to a scene, so a retained layer
+  // that is prerolled again with the same matrix, cull rect and raster cache
+  // entries ends up with the same paint bounds in its whole subtree.
+  void PrerollRetained(PrerollContext* context, const SkMatrix& matrix);
+
  protected:
   void PrerollChildren(PrerollContext* context,
                        const SkMatrix& child_matrix,
@@ -49,7 +60,28 @@ class ContainerLayer : public Layer {
                                       const SkMatrix& matrix);
 
  private:
+  // The conditions of the last preroll of this layer and its results.
+  struct PrerollMemo {
+    SkMatrix matrix;
+    SkRect cull_rect;
+    RasterCache* raster_cache;
+    GrDirectContext* gr_context;
+    sk_sp<SkColorSpace> dst_color_space;
+    float frame_device_pixel_ratio;
+    bool checkerboard_offscreen_layers;
+    bool surface_needs_readback;
+    bool has_texture_layer;
+
+    bool result_surface_needs_readback = false;
+    bool result_has_texture_layer = false;
+    RasterCache::PrerollEntries raster_cache_entries;
+  };
+
+  bool CanReusePreroll(const PrerollContext* context,
+                       const SkMatrix& matrix) const;
+
   std::vector<std::shared_ptr<Layer>> layers_;
+  std::optional<PrerollMemo> preroll_memo_;
 
   FML_DISALLOW_COPY_AND_ASSIGN(ContainerLayer);
 };
@@ -251,6 +251,127 @@ TEST_F(ContainerLayerTest, MergedMultipleChildren) {
                                                child_path2, child_paint2}}}));
 }
 
+// The mutators stack only matters to platform views, so it is not one of the
+// conditions under which a preroll can be reused. The tests below use it to
+// tell whether the children of a retained layer were prerolled again.
+TEST_F(ContainerLayerTest, RetainedPrerollIsReused) {
+  SkPath child_path;
+  child_path.addRect(5.0f, 6.0f, 20.5f, 21.5f);
+  SkMatrix initial_transform = SkMatrix::Translate(-0.5f, -0.5f);
+
+  auto mock_layer = std::make_shared<MockLayer>(child_path);
+  auto retained_layer = std::make_shared<ContainerLayer>();
+  retained_layer->Add(mock_layer);
+  auto layer = std::make_shared<ContainerLayer>();
+  layer->Add(retained_layer);
+
+  layer->Preroll(preroll_context(), initial_transform);
+  EXPECT_TRUE(mock_layer->parent_mutators().is_empty());
+
+  preroll_context()->mutators_stack.PushOpacity(128);
+  layer->Preroll(preroll_context(), initial_transform);
+  EXPECT_TRUE(mock_layer->parent_mutators().is_empty());
+  EXPECT_EQ(retained_layer->paint_bounds(), child_path.getBounds());
+  EXPECT_EQ(layer->paint_bounds(), child_path.getBounds());
+
+  // A different matrix prerolls the children again.
+  SkMatrix other_transform = SkMatrix::Translate(1.0f, 1.0f);
+  layer->Preroll(preroll_context(), other_transform);
+  EXPECT_FALSE(mock_layer->parent_mutators().is_empty());
+  EXPECT_EQ(mock_layer->parent_matrix(), other_transform);
+  preroll_context()->mutators_stack.Pop();
+}
+
+TEST_F(ContainerLayerTest, RetainedPrerollIsNotReusedForOtherCullRects) {
+  SkPath child_path;
+  child_path.addRect(5.0f, 6.0f, 20.5f, 21.5f);
+
+  auto mock_layer = std::make_shared<MockLayer>(child_path);
+  auto retained_layer = std::make_shared<ContainerLayer>();
+  retained_layer->Add(mock_layer);
+  auto layer = std::make_shared<ContainerLayer>();
+  layer->Add(retained_layer);
+
+  layer->Preroll(preroll_context(), SkMatrix());
+
+  SkRect cull_rect = SkRect::MakeLTRB(0, 0, 10, 10);
+  preroll_context()->cull_rect = cull_rect;
+  preroll_context()->mutators_stack.PushOpacity(128);
+  layer->Preroll(preroll_context(), SkMatrix());
+  EXPECT_FALSE(mock_layer->parent_mutators().is_empty());
+  EXPECT_EQ(mock_layer->parent_cull_rect(), cull_rect);
+  preroll_context()->mutators_stack.Pop();
+}
+
+TEST_F(ContainerLayerTest, RetainedPrerollIsNotReusedAfterAddingChildren) {
+  SkPath child_path1;
+  child_path1.addRect(5.0f, 6.0f, 20.5f, 21.5f);
+  SkPath child_path2;
+  child_path2.addRect(8.0f, 2.0f, 16.5f, 34.5f);
+
+  auto mock_layer1 = std::make_shared<MockLayer>(child_path1);
+  auto retained_layer = std::make_shared<ContainerLayer>();
+  retained_layer->Add(mock_layer1);
+  auto layer = std::make_shared<ContainerLayer>();
+  layer->Add(retained_layer);
+  layer->Preroll(preroll_context(), SkMatrix());
+
+  auto mock_layer2 = std::make_shared<MockLayer>(child_path2);
+  retained_layer->Add(mock_layer2);
+  layer->Preroll(preroll_context(), SkMatrix());
+
+  SkRect expected_total_bounds = child_path1.getBounds();
+  expected_total_bounds.join(child_path2.getBounds());
+  EXPECT_EQ(mock_layer2->paint_bounds(), child_path2.getBounds());
+  EXPECT_EQ(retained_layer->paint_bounds(), expected_total_bounds);
+  EXPECT_EQ(layer->paint_bounds(), expected_total_bounds);
+}
+
+TEST_F(ContainerLayerTest, RetainedPrerollWithPlatformViewIsNotReused) {
+  SkPath child_path;
+  child_path.addRect(5.0f, 6.0f, 20.5f, 21.5f);
+
+  auto mock_layer = std::make_shared<MockLayer>(
+      child_path, SkPaint(), true /* fake_has_platform_view */);
+  auto retained_layer = std::make_shared<ContainerLayer>();
+  retained_layer->Add(mock_layer);
+  auto layer = std::make_shared<ContainerLayer>();
+  layer->Add(retained_layer);
+
+  layer->Preroll(preroll_context(), SkMatrix());
+  EXPECT_TRUE(preroll_context()->has_platform_view);
+
+  preroll_context()->has_platform_view = false;
+  preroll_context()->mutators_stack.PushOpacity(128);
+  layer->Preroll(preroll_context(), SkMatrix());
+  EXPECT_TRUE(preroll_context()->has_platform_view);
+  EXPECT_FALSE(mock_layer->parent_mutators().is_empty());
+  preroll_context()->mutators_stack.Pop();
+}
+
+TEST_F(ContainerLayerTest, RetainedPrerollRestoresSurfaceReadback) {
+  SkPath child_path;
+  child_path.addRect(5.0f, 6.0f, 20.5f, 21.5f);
+
+  auto mock_layer = std::make_shared<MockLayer>(
+      child_path, SkPaint(), false /* fake_has_platform_view */,
+      true /* fake_reads_surface */);
+  auto retained_layer = std::make_shared<ContainerLayer>();
+  retained_layer->Add(mock_layer);
+  auto layer = std::make_shared<ContainerLayer>();
+  layer->Add(retained_layer);
+
+  layer->Preroll(preroll_context(), SkMatrix());
+  EXPECT_TRUE(preroll_context()->surface_needs_readback);
+
+  preroll_context()->surface_needs_readback = false;
+  preroll_context()->mutators_stack.PushOpacity(128);
+  layer->Preroll(preroll_context(), SkMatrix());
+  EXPECT_TRUE(mock_layer->parent_mutators().is_empty());
+  EXPECT_TRUE(preroll_context()->surface_needs_readback);
+  preroll_context()->mutators_stack.Pop();
+}
+
 using ContainerLayerDiffTest = DiffContextTest;
 
 // Insert PictureLayer amongst container layers
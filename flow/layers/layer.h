@@ -61,8 +61,14 @@ struct PrerollContext {
   // These allow us to track properties like elevation, opacity, and the
   // prescence of a texture layer during Preroll.
   bool has_texture_layer = false;
+
+  // Set by layers whose Preroll depends on state that changes from frame to
+  // frame, so that the results of the Preroll of their ancestors are not
+  // reused in the next frame.
+  bool has_volatile_preroll = false;
 };
 
+class ContainerLayer;
 class PictureLayer;
 class DisplayListLayer;
 class PerformanceOverlayLayer;
@@ -267,6 +273,7 @@ class Layer {
 
   uint64_t unique_id() const { return unique_id_; }
 
+  virtual ContainerLayer* as_container_layer() { return nullptr; }
   virtual const PictureLayer* as_picture_layer() const { return nullptr; }
   virtual const DisplayListLayer* as_display_list_layer() const {
     return nullptr;
@@ -4,12 +4,14 @@
 
 #include "flutter/flow/raster_cache.h"
 
+#include <algorithm>
 #include <vector>
 
 #include "flutter/common/constants.h"
 #include "flutter/flow/layers/layer.h"
 #include "flutter/flow/paint_utils.h"
 #include "flutter/fml/logging.h"
+#include "flutter/fml/time/time_point.h"
 #include "flutter/fml/trace_event.h"
 #include "third_party/skia/include/core/SkCanvas.h"
 #include "third_party/skia/include/core/SkImage.h"
@@ -39,12 +41,21 @@ void RasterCacheResult::draw(SkCanvas& canvas, const SkPaint* paint) const {
 }
 
 RasterCache::RasterCache(size_t access_threshold,
-                         size_t picture_and_display_list_cache_limit_per_frame)
+                         size_t picture_and_display_list_cache_limit_per_frame,
+                         size_t max_bytes)
     : access_threshold_(access_threshold),
       picture_and_display_list_cache_limit_per_frame_(
           picture_and_display_list_cache_limit_per_frame),
+      max_bytes_(max_bytes),
       checkerboard_images_(false) {}
 
+// The number of bytes of an image rasterized from |rect| under |ctm|.
+static size_t EstimateImageBytes(const SkRect& rect, const SkMatrix& ctm) {
+  SkIRect bounds = RasterCache::GetDeviceBounds(rect, ctm);
+  return static_cast<size_t>(bounds.width()) * bounds.height() *
+         SkColorTypeBytesPerPixel(kN32_SkColorType);
+}
+
 static bool CanRasterizeRect(const SkRect& cull_rect) {
   if (cull_rect.isEmpty()) {
     // No point in ever rasterizing an empty display list.
@@ -179,8 +190,15 @@ void RasterCache::Prepare(PrerollContext* context,
   Entry& entry = layer_cache_[cache_key];
   entry.access_count++;
   entry.used_this_frame = true;
-  if (!entry.image) {
-    entry.image = RasterizeLayer(context, layer, ctm, checkerboard_images_);
+  if (!entry.image &&
+      ReserveBytes(EstimateImageBytes(layer->paint_bounds(), ctm))) {
+    SetEntryImage(entry,
+                  RasterizeLayer(context, layer, ctm, checkerboard_images_));
+  }
+  if (entry.image) {
+    RecordPrerollEntry(&PrerollEntries::layers, cache_key);
+  } else {
+    RecordIncompletePrerollEntry();
   }
 }
 
@@ -223,6 +241,7 @@ bool RasterCache::Prepare(PrerollContext* context,
                           const SkMatrix& untranslated_matrix,
                           const SkPoint& offset) {
   if (!GenerateNewCacheInThisFrame()) {
+    RecordIncompletePrerollEntry();
     return false;
   }
 
@@ -245,21 +264,46 @@ bool RasterCache::Prepare(PrerollContext* context,
   Entry& entry = picture_cache_[cache_key];
   if (entry.access_count < access_threshold_) {
     // Frame threshold has not yet been reached.
+    RecordIncompletePrerollEntry();
     return false;
   }
 
   if (!entry.image) {
+    if (entry.pending) {
+      // The image is still being rasterized on a worker thread.
+      RecordIncompletePrerollEntry();
+      return false;
+    }
+    if (!ReserveBytes(
+            EstimateImageBytes(picture->cullRect(), transformation_matrix))) {
+      // The image would not fit in the budget.
+      RecordIncompletePrerollEntry();
+      return false;
+    }
     // GetIntegralTransCTM effect for matrix which only contains scale,
     // translate, so it won't affect result of matrix decomposition and cache
     // key.
 #ifndef SUPPORT_FRACTIONAL_TRANSLATION
     transformation_matrix = GetIntegralTransCTM(transformation_matrix);
 #endif
-    entry.image =
-        RasterizePicture(picture, context->gr_context, transformation_matrix,
-                         context->dst_color_space, checkerboard_images_);
+    entry.cost = picture->approximateOpCount(true);
     picture_cached_this_frame_++;
+    if (CanRasterizeInBackground(context)) {
+      entry.pending = RasterizeInBackground(
+          transformation_matrix, context->dst_color_space, picture->cullRect(),
+          "RasterCacheFlow::SkPicture",
+          [picture = sk_ref_sp(picture)](SkCanvas* canvas) {
+            canvas->drawPicture(picture);
+          });
+      RecordIncompletePrerollEntry();
+      return false;
+    }
+    SetEntryImage(entry, RasterizePicture(picture, context->gr_context,
+                                          transformation_matrix,
+                                          context->dst_color_space,
+                                          checkerboard_images_));
   }
+  RecordPrerollEntry(&PrerollEntries::pictures, cache_key);
   return true;
 }
 
@@ -270,6 +314,7 @@ bool RasterCache::Prepare(PrerollContext* context,
                           const SkMatrix& untranslated_matrix,
                           const SkPoint& offset) {
   if (!GenerateNewCacheInThisFrame()) {
+    RecordIncompletePrerollEntry();
     return false;
   }
 
@@ -293,21 +338,46 @@ bool RasterCache::Prepare(PrerollContext* context,
   Entry& entry = display_list_cache_[cache_key];
   if (entry.access_count < access_threshold_) {
     // Frame threshold has not yet been reached.
+    RecordIncompletePrerollEntry();
     return false;
   }
 
   if (!entry.image) {
+    if (entry.pending) {
+      // The image is still being rasterized on a worker thread.
+      RecordIncompletePrerollEntry();
+      return false;
+    }
+    if (!ReserveBytes(EstimateImageBytes(display_list->bounds(),
+                                         transformation_matrix))) {
+      // The image would not fit in the budget.
+      RecordIncompletePrerollEntry();
+      return false;
+    }
     // GetIntegralTransCTM effect for matrix which only contains scale,
     // translate, so it won't affect result of matrix decomposition and cache
     // key.
 #ifndef SUPPORT_FRACTIONAL_TRANSLATION
     transformation_matrix = GetIntegralTransCTM(transformation_matrix);
 #endif
-    entry.image = RasterizeDisplayList(
-        display_list, context->gr_context, transformation_matrix,
-        context->dst_color_space, checkerboard_images_);
+    entry.cost = display_list->op_count(true);
     display_list_cached_this_frame_++;
+    if (CanRasterizeInBackground(context)) {
+      entry.pending = RasterizeInBackground(
+          transformation_matrix, context->dst_color_space,
+          display_list->bounds(), "RasterCacheFlow::DisplayList",
+          [display_list = sk_ref_sp(display_list)](SkCanvas* canvas) {
+            display_list->RenderTo(canvas);
+          });
+      RecordIncompletePrerollEntry();
+      return false;
+    }
+    SetEntryImage(entry, RasterizeDisplayList(display_list, context->gr_context,
+                                              transformation_matrix,
+                                              context->dst_color_space,
+                                              checkerboard_images_));
   }
+  RecordPrerollEntry(&PrerollEntries::display_lists, cache_key);
   return true;
 }
 
@@ -317,6 +387,11 @@ void RasterCache::Touch(Layer* layer, const SkMatrix& ctm) {
   if (it != layer_cache_.end()) {
     it->second.used_this_frame = true;
     it->second.access_count++;
+    if (it->second.image) {
+      RecordPrerollEntry(&PrerollEntries::layers, cache_key);
+    } else {
+      RecordIncompletePrerollEntry();
+    }
   }
 }
 
@@ -327,6 +402,11 @@ void RasterCache::Touch(SkPicture* picture,
   if (it != picture_cache_.end()) {
     it->second.used_this_frame = true;
     it->second.access_count++;
+    if (it->second.image) {
+      RecordPrerollEntry(&PrerollEntries::pictures, cache_key);
+    } else {
+      RecordIncompletePrerollEntry();
+    }
   }
 }
 
@@ -338,7 +418,50 @@ void RasterCache::Touch(DisplayList* display_list,
   if (it != display_list_cache_.end()) {
     it->second.used_this_frame = true;
     it->second.access_count++;
+    if (it->second.image) {
+      RecordPrerollEntry(&PrerollEntries::display_lists, cache_key);
+    } else {
+      RecordIncompletePrerollEntry();
+    }
+  }
+}
+
+void RasterCache::BeginRecordingPrerollEntries(PrerollEntries* entries) {
+  FML_DCHECK(entries);
+  preroll_entries_recordings_.push_back(entries);
+}
+
+void RasterCache::EndRecordingPrerollEntries() {
+  FML_DCHECK(!preroll_entries_recordings_.empty());
+  PrerollEntries* entries = preroll_entries_recordings_.back();
+  preroll_entries_recordings_.pop_back();
+  RecordPrerollEntries(*entries);
+}
+
+bool RasterCache::TouchPrerollEntries(const PrerollEntries& entries) {
+  if (entries.incomplete ||
+      !TouchEntries(picture_cache_, entries.pictures) ||
+      !TouchEntries(display_list_cache_, entries.display_lists) ||
+      !TouchEntries(layer_cache_, entries.layers)) {
+    return false;
+  }
+  RecordPrerollEntries(entries);
+  return true;
+}
+
+void RasterCache::RecordPrerollEntries(const PrerollEntries& entries) {
+  if (preroll_entries_recordings_.empty()) {
+    return;
   }
+  PrerollEntries* recording = preroll_entries_recordings_.back();
+  recording->pictures.insert(recording->pictures.end(),
+                             entries.pictures.begin(), entries.pictures.end());
+  recording->display_lists.insert(recording->display_lists.end(),
+                                  entries.display_lists.begin(),
+                                  entries.display_lists.end());
+  recording->layers.insert(recording->layers.end(), entries.layers.begin(),
+                           entries.layers.end());
+  recording->incomplete |= entries.incomplete;
 }
 
 bool RasterCache::Draw(const SkPicture& picture, SkCanvas& canvas) const {
@@ -353,10 +476,15 @@ bool RasterCache::Draw(const SkPicture& picture, SkCanvas& canvas) const {
   entry.used_this_frame = true;
 
   if (entry.image) {
+    picture_frame_metrics_.hit_count++;
+    if (entry.rasterized_in_background) {
+      picture_frame_metrics_.background_hit_count++;
+    }
     entry.image->draw(canvas, nullptr);
     return true;
   }
 
+  picture_frame_metrics_.miss_count++;
   return false;
 }
 
@@ -374,10 +502,15 @@ bool RasterCache::Draw(const DisplayList& display_list,
   entry.used_this_frame = true;
 
   if (entry.image) {
+    picture_frame_metrics_.hit_count++;
+    if (entry.rasterized_in_background) {
+      picture_frame_metrics_.background_hit_count++;
+    }
     entry.image->draw(canvas, nullptr);
     return true;
   }
 
+  picture_frame_metrics_.miss_count++;
   return false;
 }
 
@@ -395,21 +528,34 @@ bool RasterCache::Draw(const Layer* layer,
   entry.used_this_frame = true;
 
   if (entry.image) {
+    layer_frame_metrics_.hit_count++;
     entry.image->draw(canvas, paint);
     return true;
   }
 
+  layer_frame_metrics_.miss_count++;
   return false;
 }
 
 void RasterCache::PrepareNewFrame() {
+  FML_DCHECK(preroll_entries_recordings_.empty());
   picture_cached_this_frame_ = 0;
   display_list_cached_this_frame_ = 0;
+  if (worker_task_runner_) {
+    AddBackgroundResults(picture_cache_, picture_frame_metrics_);
+    AddBackgroundResults(display_list_cache_, picture_frame_metrics_);
+  }
 }
 
 void RasterCache::CleanupAfterFrame() {
-  picture_metrics_ = {};
-  layer_metrics_ = {};
+  {
+    TRACE_EVENT0("flutter", "RasterCache::EnforceBudget");
+    EvictUnusedEntries(max_bytes_);
+  }
+  picture_metrics_ = picture_frame_metrics_;
+  layer_metrics_ = layer_frame_metrics_;
+  picture_frame_metrics_ = {};
+  layer_frame_metrics_ = {};
   {
     TRACE_EVENT0("flutter", "RasterCache::SweepCaches");
     SweepOneCacheAfterFrame(picture_cache_, picture_metrics_);
@@ -423,8 +569,163 @@ void RasterCache::Clear() {
   picture_cache_.clear();
   display_list_cache_.clear();
   layer_cache_.clear();
+  cached_bytes_ = 0;
   picture_metrics_ = {};
   layer_metrics_ = {};
+  picture_frame_metrics_ = {};
+  layer_frame_metrics_ = {};
+}
+
+template <class Cache, class Key>
+bool RasterCache::TouchEntries(Cache& cache, const std::vector<Key>& keys) {
+  for (const auto& key : keys) {
+    auto it = cache.find(key);
+    if (it == cache.end() || !it->second.image) {
+      return false;
+    }
+    it->second.used_this_frame = true;
+    it->second.access_count++;
+  }
+  return true;
+}
+
+double RasterCache::RetentionScore(const Entry& entry) {
+  // Layers have no cost estimate and are ranked by recency and size alone.
+  double cost = std::max<size_t>(entry.cost, 1);
+  double bytes = std::max<int64_t>(entry.image->image_bytes(), 1);
+  return cost / (bytes * (entry.unused_frames + 1));
+}
+
+template <class Cache>
+void RasterCache::CollectEvictionCandidates(
+    const Cache& cache,
+    std::vector<std::pair<double, size_t>>& candidates) {
+  for (const auto& item : cache) {
+    const Entry& entry = item.second;
+    if (!entry.used_this_frame && entry.image) {
+      candidates.emplace_back(RetentionScore(entry),
+                              entry.image->image_bytes());
+    }
+  }
+}
+
+template <class Cache>
+size_t RasterCache::EvictEntriesScoringAtMost(Cache& cache,
+                                              double max_score,
+                                              RasterCacheMetrics& metrics) {
+  size_t evicted_bytes = 0;
+  for (auto it = cache.begin(); it != cache.end();) {
+    const Entry& entry = it->second;
+    if (!entry.used_this_frame && entry.image &&
+        RetentionScore(entry) <= max_score) {
+      size_t bytes = entry.image->image_bytes();
+      metrics.eviction_count++;
+      metrics.eviction_bytes += bytes;
+      evicted_bytes += bytes;
+      it = cache.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  return evicted_bytes;
+}
+
+bool RasterCache::EvictUnusedEntries(size_t max_bytes) {
+  if (cached_bytes_ <= max_bytes) {
+    return true;
+  }
+
+  std::vector<std::pair<double, size_t>> candidates;
+  CollectEvictionCandidates(picture_cache_, candidates);
+  CollectEvictionCandidates(display_list_cache_, candidates);
+  CollectEvictionCandidates(layer_cache_, candidates);
+  if (candidates.empty()) {
+    return false;
+  }
+  std::sort(candidates.begin(), candidates.end());
+
+  // Find the lowest score that frees enough memory, then evict every unused
+  // entry scoring at most that much. Entries that tie with that score are all
+  // evicted.
+  size_t bytes = cached_bytes_;
+  double max_score = candidates.front().first;
+  for (const auto& candidate : candidates) {
+    if (bytes <= max_bytes) {
+      break;
+    }
+    max_score = candidate.first;
+    bytes -= candidate.second;
+  }
+
+  cached_bytes_ -= EvictEntriesScoringAtMost(picture_cache_, max_score,
+                                             picture_frame_metrics_);
+  cached_bytes_ -= EvictEntriesScoringAtMost(display_list_cache_, max_score,
+                                             picture_frame_metrics_);
+  cached_bytes_ -= EvictEntriesScoringAtMost(layer_cache_, max_score,
+                                             layer_frame_metrics_);
+  return cached_bytes_ <= max_bytes;
+}
+
+bool RasterCache::ReserveBytes(size_t bytes) {
+  if (bytes > max_bytes_) {
+    return false;
+  }
+  return EvictUnusedEntries(max_bytes_ - bytes);
+}
+
+void RasterCache::SetEntryImage(Entry& entry,
+                                std::unique_ptr<RasterCacheResult> image) {
+  entry.image = std::move(image);
+  if (entry.image) {
+    cached_bytes_ += entry.image->image_bytes();
+  }
+}
+
+bool RasterCache::CanRasterizeInBackground(
+    const PrerollContext* context) const {
+  // Textures belong to the GrDirectContext of the raster thread so only
+  // software frames can be rasterized elsewhere.
+  return worker_task_runner_ && context->gr_context == nullptr;
+}
+
+std::shared_ptr<RasterCache::PendingResult> RasterCache::RasterizeInBackground(
+    const SkMatrix& ctm,
+    SkColorSpace* dst_color_space,
+    const SkRect& logical_rect,
+    const char* type,
+    std::function<void(SkCanvas*)> draw_function) const {
+  auto pending = std::make_shared<PendingResult>();
+  worker_task_runner_->PostTask(
+      [pending, ctm, color_space = sk_ref_sp(dst_color_space),
+       checkerboard = checkerboard_images_, logical_rect, type,
+       draw_function = std::move(draw_function)]() {
+        TRACE_EVENT0("flutter", "RasterCache::RasterizeInBackground");
+        const auto start = fml::TimePoint::Now();
+        pending->image = Rasterize(nullptr, ctm, color_space.get(),
+                                   checkerboard, logical_rect, type,
+                                   draw_function);
+        pending->raster_time = fml::TimePoint::Now() - start;
+        pending->ready.store(true, std::memory_order_release);
+      });
+  return pending;
+}
+
+template <class Cache>
+void RasterCache::AddBackgroundResults(Cache& cache,
+                                       RasterCacheMetrics& metrics) {
+  for (auto& item : cache) {
+    Entry& entry = item.second;
+    if (!entry.pending ||
+        !entry.pending->ready.load(std::memory_order_acquire)) {
+      continue;
+    }
+    metrics.background_count++;
+    metrics.background_time =
+        metrics.background_time + entry.pending->raster_time;
+    entry.rasterized_in_background = true;
+    SetEntryImage(entry, std::move(entry.pending->image));
+    entry.pending.reset();
+  }
 }
 
 size_t RasterCache::GetCachedEntriesCount() const {
@@ -455,12 +756,14 @@ void RasterCache::SetCheckboardCacheImages(bool checkerboard) {
 void RasterCache::TraceStatsToTimeline() const {
 #if !FLUTTER_RELEASE
   FML_TRACE_COUNTER(
-      "flutter",                                                           //
-      "RasterCache", reinterpret_cast<int64_t>(this),                      //
-      "LayerCount", layer_metrics_.total_count(),                          //
-      "LayerMBytes", layer_metrics_.total_bytes() / kMegaByteSizeInBytes,  //
-      "PictureCount", picture_metrics_.total_count(),                      //
-      "PictureMBytes", picture_metrics_.total_bytes() / kMegaByteSizeInBytes);
+      "flutter",                                                            //
+      "RasterCache", reinterpret_cast<int64_t>(this),                       //
+      "LayerCount", layer_metrics_.total_count(),                           //
+      "LayerMBytes", layer_metrics_.total_bytes() / kMegaByteSizeInBytes,   //
+      "PictureCount", picture_metrics_.total_count(),                       //
+      "PictureMBytes", picture_metrics_.total_bytes() / kMegaByteSizeInBytes,
+      "Hits", picture_metrics_.hit_count + layer_metrics_.hit_count,        //
+      "Misses", picture_metrics_.miss_count + layer_metrics_.miss_count);
 
 #endif  // !FLUTTER_RELEASE
 }
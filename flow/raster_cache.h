@@ -5,13 +5,19 @@
 #ifndef FLUTTER_FLOW_RASTER_CACHE_H_
 #define FLUTTER_FLOW_RASTER_CACHE_H_
 
+#include <atomic>
+#include <functional>
 #include <memory>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "flutter/flow/display_list.h"
 #include "flutter/flow/raster_cache_key.h"
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/memory/weak_ptr.h"
+#include "flutter/fml/time/time_delta.h"
 #include "flutter/fml/trace_event.h"
 #include "third_party/skia/include/core/SkImage.h"
 #include "third_party/skia/include/core/SkSize.h"
@@ -65,19 +71,64 @@ struct RasterCacheMetrics {
    */
   size_t in_use_bytes = 0;
 
+  /**
+   * The number of cache entries with images that were not used in this frame
+   * but were kept for use in later frames.
+   */
+  size_t retained_count = 0;
+
+  /**
+   * The size of all of the images retained but not used in this frame.
+   */
+  size_t retained_bytes = 0;
+
+  /**
+   * The number of times a cached image was drawn in this frame.
+   */
+  size_t hit_count = 0;
+
+  /**
+   * The number of times a draw found no cached image in this frame for an
+   * entry that was prepared to be cached. Draws of pictures and layers that
+   * are not cache candidates are not counted.
+   */
+  size_t miss_count = 0;
+
+  /**
+   * The number of cache entries whose images were rasterized on a worker
+   * thread and added to the cache at the start of this frame.
+   */
+  size_t background_count = 0;
+
+  /**
+   * The time worker threads spent rasterizing the images added at the start
+   * of this frame, which would otherwise have been spent on the raster thread.
+   */
+  fml::TimeDelta background_time;
+
+  /**
+   * The number of times an image rasterized on a worker thread was drawn in
+   * this frame.
+   */
+  size_t background_hit_count = 0;
+
   /**
    * The total cache entries that had images during this frame whether
-   * they were used in the frame or held memory during the frame and then
-   * were evicted after it ended.
+   * they were used in the frame, held memory for later frames, or held
+   * memory during the frame and then were evicted.
    */
-  size_t total_count() const { return in_use_count + eviction_count; }
+  size_t total_count() const {
+    return in_use_count + retained_count + eviction_count;
+  }
 
   /**
    * The size of all of the cached images during this frame whether
-   * they were used in the frame or held memory during the frame and then
-   * were evicted after it ended.
+   * they were used in the frame, held memory for later frames, or held
+   * memory during the frame and then were evicted.
    */
-  size_t total_bytes() const { return in_use_bytes + eviction_bytes; }
+  size_t total_bytes() const {
+    return in_use_bytes + retained_bytes + eviction_bytes;
+  }
 };
 
 class RasterCache {
@@ -88,9 +139,19 @@ class RasterCache {
   // the work across multiple frames.
   static constexpr int kDefaultPictureAndDispLayListCacheLimitPerFrame = 3;
 
+  // The default limit on the size of all of the images held by the cache.
+  static constexpr size_t kDefaultMaxBytes = 64 << 20;
+
+  // The number of consecutive frames an entry may go unused before it is
+  // evicted regardless of the byte budget. Keeping entries across a few idle
+  // frames avoids re-rasterizing pictures that are briefly hidden, such as
+  // during a route transition.
+  static constexpr size_t kMaxUnusedFrames = 60;
+
   explicit RasterCache(size_t access_threshold = 3,
                        size_t picture_and_display_list_cache_limit_per_frame =
-                           kDefaultPictureAndDispLayListCacheLimitPerFrame);
+                           kDefaultPictureAndDispLayListCacheLimitPerFrame,
+                       size_t max_bytes = kDefaultMaxBytes);
 
   virtual ~RasterCache() = default;
 
@@ -179,6 +240,7 @@ class RasterCache {
   // 2. The picture is not worth rasterizing
   // 3. The matrix is singular
   // 4. The picture is accessed too few times
+  // 5. The rasterized picture would not fit in the byte budget
   bool Prepare(PrerollContext* context,
                SkPicture* picture,
                bool is_complex,
@@ -202,6 +264,31 @@ class RasterCache {
 
   void Prepare(PrerollContext* context, Layer* layer, const SkMatrix& ctm);
 
+  // The entries that the preroll of a layer subtree prepared or touched, so
+  // that a later frame that reuses the results of that preroll instead of
+  // running it again can keep them in the cache.
+  struct PrerollEntries {
+    std::vector<PictureRasterCacheKey> pictures;
+    std::vector<DisplayListRasterCacheKey> display_lists;
+    std::vector<LayerRasterCacheKey> layers;
+    // Whether the preroll asked for an entry that is not rasterized yet. The
+    // preroll must run again in later frames for the entry to be rasterized.
+    bool incomplete = false;
+  };
+
+  // Records the entries that Prepare and Touch use into |entries| until the
+  // matching EndRecordingPrerollEntries. Recordings may be nested, in which
+  // case the entries of the inner recording are added to the outer one once
+  // the inner recording ends.
+  void BeginRecordingPrerollEntries(PrerollEntries* entries);
+  void EndRecordingPrerollEntries();
+
+  // Marks the recorded entries as used in this frame, like Touch does, and
+  // adds them to the current recording. Returns false if the recording was
+  // incomplete or if any of its entries is no longer rasterized, in which
+  // case the preroll must run again.
+  bool TouchPrerollEntries(const PrerollEntries& entries);
+
   // Find the raster cache for the picture and draw it to the canvas.
   //
   // Return true if it's found and drawn.
@@ -278,25 +365,81 @@ class RasterCache {
    */
   int access_threshold() const { return access_threshold_; }
 
+  /**
+   * @brief Return the limit on the size of all of the images held by the
+   * cache.
+   *
+   * Images are not rasterized if they would not fit in the budget after
+   * evicting every entry that has not been used in the current frame. Once a
+   * frame ends, unused entries are evicted until the cache fits in the budget,
+   * preferring to evict the entries that are the least recently used, the
+   * cheapest to rasterize again and the largest.
+   */
+  size_t max_bytes() const { return max_bytes_; }
+
+  /**
+   * @brief Change the limit on the size of all of the images held by the
+   * cache. The new limit is enforced once the current frame ends.
+   */
+  void SetMaxBytes(size_t max_bytes) { max_bytes_ = max_bytes; }
+
+  /**
+   * @brief Rasterize pictures and display lists on the given task runner
+   * instead of during Prepare on the raster thread, or pass nullptr to
+   * rasterize them synchronously again.
+   *
+   * Only frames rendered without a GrDirectContext (the software backend)
+   * are rasterized in the background. Prepare returns false until the image
+   * is ready and the caller draws the picture or display list uncached in
+   * the meantime. Finished images are added to the cache by PrepareNewFrame.
+   * Layers are always rasterized synchronously as the layer tree may change
+   * once the frame is done.
+   */
+  void SetWorkerTaskRunner(
+      std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner) {
+    worker_task_runner_ = std::move(worker_task_runner);
+  }
+
  private:
+  // An image being rasterized on a worker thread. The worker fills in
+  // |image| and |raster_time| before setting |ready|.
+  struct PendingResult {
+    std::atomic_bool ready = false;
+    std::unique_ptr<RasterCacheResult> image;
+    fml::TimeDelta raster_time;
+  };
+
   struct Entry {
     bool used_this_frame = false;
     size_t access_count = 0;
+    // The number of consecutive frames that ended without the entry being
+    // used.
+    size_t unused_frames = 0;
+    // An estimate of the cost of rasterizing the entry again, in ops.
+    size_t cost = 0;
+    // Whether |image| was rasterized on a worker thread.
+    bool rasterized_in_background = false;
     std::unique_ptr<RasterCacheResult> image;
+    std::shared_ptr<PendingResult> pending;
   };
 
   template <class Cache>
-  static void SweepOneCacheAfterFrame(Cache& cache,
-                                      RasterCacheMetrics& metrics) {
+  void SweepOneCacheAfterFrame(Cache& cache, RasterCacheMetrics& metrics) {
     std::vector<typename Cache::iterator> dead;
 
     for (auto it = cache.begin(); it != cache.end(); ++it) {
       Entry& entry = it->second;
-      if (!entry.used_this_frame) {
+      if (entry.used_this_frame) {
+        entry.unused_frames = 0;
+        if (entry.image) {
+          metrics.in_use_count++;
+          metrics.in_use_bytes += entry.image->image_bytes();
+        }
+      } else if (!entry.image || ++entry.unused_frames > kMaxUnusedFrames) {
         dead.push_back(it);
-      } else if (entry.image) {
-        metrics.in_use_count++;
-        metrics.in_use_bytes += entry.image->image_bytes();
+      } else {
+        metrics.retained_count++;
+        metrics.retained_bytes += entry.image->image_bytes();
       }
       entry.used_this_frame = false;
     }
@@ -305,11 +448,78 @@ class RasterCache {
       if (it->second.image) {
         metrics.eviction_count++;
         metrics.eviction_bytes += it->second.image->image_bytes();
+        cached_bytes_ -= it->second.image->image_bytes();
       }
       cache.erase(it);
     }
   }
 
+  // How valuable it is to keep an unused entry in the cache. Entries that
+  // were used recently, that are expensive to rasterize and that are small
+  // score the highest.
+  static double RetentionScore(const Entry& entry);
+
+  template <class Cache>
+  static void CollectEvictionCandidates(
+      const Cache& cache,
+      std::vector<std::pair<double, size_t>>& candidates);
+
+  template <class Cache>
+  size_t EvictEntriesScoringAtMost(Cache& cache,
+                                   double max_score,
+                                   RasterCacheMetrics& metrics);
+
+  // Evicts entries that have not been used in this frame, lowest retention
+  // score first, until all of the cached images fit in |max_bytes|.
+  //
+  // Returns whether the cached images fit in |max_bytes|.
+  bool EvictUnusedEntries(size_t max_bytes);
+
+  // Makes room in the budget for an image of |bytes| bytes.
+  //
+  // Returns false if the image would not fit in the budget.
+  bool ReserveBytes(size_t bytes);
+
+  // Stores a newly rasterized image in |entry|.
+  void SetEntryImage(Entry& entry, std::unique_ptr<RasterCacheResult> image);
+
+  bool CanRasterizeInBackground(const PrerollContext* context) const;
+
+  // Rasterizes |logical_rect| of the output of |draw_function| on a worker
+  // thread. |draw_function| must hold references to everything it draws.
+  std::shared_ptr<PendingResult> RasterizeInBackground(
+      const SkMatrix& ctm,
+      SkColorSpace* dst_color_space,
+      const SkRect& logical_rect,
+      const char* type,
+      std::function<void(SkCanvas*)> draw_function) const;
+
+  // Adds the images that finished rasterizing on worker threads to |cache|.
+  template <class Cache>
+  void AddBackgroundResults(Cache& cache, RasterCacheMetrics& metrics);
+
+  // Adds |key| to the current recording of preroll entries, if any.
+  template <class Key>
+  void RecordPrerollEntry(std::vector<Key> PrerollEntries::*entries,
+                          const Key& key) {
+    if (!preroll_entries_recordings_.empty()) {
+      (preroll_entries_recordings_.back()->*entries).push_back(key);
+    }
+  }
+
+  // Adds |entries| to the current recording of preroll entries, if any.
+  void RecordPrerollEntries(const PrerollEntries& entries);
+
+  // Marks the current recording of preroll entries, if any, as incomplete.
+  void RecordIncompletePrerollEntry() {
+    if (!preroll_entries_recordings_.empty()) {
+      preroll_entries_recordings_.back()->incomplete = true;
+    }
+  }
+
+  template <class Cache, class Key>
+  static bool TouchEntries(Cache& cache, const std::vector<Key>& keys);
+
   bool GenerateNewCacheInThisFrame() const {
     // Disabling caching when access_threshold is zero is historic behavior.
     return access_threshold_ != 0 &&
@@ -319,14 +529,22 @@ class RasterCache {
 
   const size_t access_threshold_;
   const size_t picture_and_display_list_cache_limit_per_frame_;
+  size_t max_bytes_;
+  size_t cached_bytes_ = 0;
   size_t picture_cached_this_frame_ = 0;
   size_t display_list_cached_this_frame_ = 0;
   RasterCacheMetrics layer_metrics_;
   RasterCacheMetrics picture_metrics_;
+  // Hits, misses and evictions counted while the current frame is built,
+  // reported through the metrics above once the frame ends.
+  mutable RasterCacheMetrics layer_frame_metrics_;
+  mutable RasterCacheMetrics picture_frame_metrics_;
   mutable PictureRasterCacheKey::Map<Entry> picture_cache_;
   mutable DisplayListRasterCacheKey::Map<Entry> display_list_cache_;
   mutable LayerRasterCacheKey::Map<Entry> layer_cache_;
+  std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner_;
   bool checkerboard_images_;
+  std::vector<PrerollEntries*> preroll_entries_recordings_;
 
   void TraceStatsToTimeline() const;
 
@@ -6,6 +6,8 @@
 #include "flutter/flow/raster_cache.h"
 
 #include "flutter/flow/testing/mock_raster_cache.h"
+#include "flutter/fml/concurrent_message_loop.h"
+#include "flutter/fml/synchronization/count_down_latch.h"
 #include "gtest/gtest.h"
 #include "third_party/skia/include/core/SkCanvas.h"
 #include "third_party/skia/include/core/SkPaint.h"
@@ -64,6 +66,16 @@ sk_sp<DisplayList> GetSampleNestedDisplayList() {
   return outer_builder.Build();
 }
 
+// A 100x100 display list whose rasterized image takes 40000 bytes.
+sk_sp<DisplayList> GetDisplayListWithOpCount(int op_count) {
+  DisplayListBuilder builder(SkRect::MakeWH(100, 100));
+  for (int i = 0; i < op_count; i++) {
+    builder.setColor((i % 2) == 0 ? SK_ColorRED : SK_ColorBLUE);
+    builder.drawRect(SkRect::MakeWH(100, 100));
+  }
+  return builder.Build();
+}
+
 }  // namespace
 
 TEST(RasterCache, SimpleInitialization) {
@@ -298,8 +310,16 @@ TEST(RasterCache, SweepsRemoveUnusedSkPictures) {
 
   cache.CleanupAfterFrame();
 
+  // Frames without a Get image access.
+  for (size_t i = 0; i < RasterCache::kMaxUnusedFrames; i++) {
+    cache.PrepareNewFrame();
+    cache.CleanupAfterFrame();
+  }
+  ASSERT_EQ(cache.GetPictureCachedEntriesCount(), 1u);
+
   cache.PrepareNewFrame();
-  cache.CleanupAfterFrame();  // Extra frame without a Get image access.
+  cache.CleanupAfterFrame();  // One unused frame too many.
+  ASSERT_EQ(cache.GetPictureCachedEntriesCount(), 0u);
 
   cache.PrepareNewFrame();
 
@@ -333,8 +353,16 @@ TEST(RasterCache, SweepsRemoveUnusedDisplayLists) {
 
   cache.CleanupAfterFrame();
 
+  // Frames without a Get image access.
+  for (size_t i = 0; i < RasterCache::kMaxUnusedFrames; i++) {
+    cache.PrepareNewFrame();
+    cache.CleanupAfterFrame();
+  }
+  ASSERT_EQ(cache.GetPictureCachedEntriesCount(), 1u);
+
   cache.PrepareNewFrame();
-  cache.CleanupAfterFrame();  // Extra frame without a Get image access.
+  cache.CleanupAfterFrame();  // One unused frame too many.
+  ASSERT_EQ(cache.GetPictureCachedEntriesCount(), 0u);
 
   cache.PrepareNewFrame();
 
@@ -541,6 +569,362 @@ TEST(RasterCache, DisplayListWithSingularMatrixIsNotCached) {
   }
 }
 
+TEST(RasterCache, DoesNotCountMissesForDrawsThatAreNotCacheCandidates) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+
+  auto display_list = GetSampleDisplayList();
+
+  SkCanvas dummy_canvas;
+
+  cache.PrepareNewFrame();
+  ASSERT_FALSE(cache.Draw(*display_list, dummy_canvas));
+  cache.CleanupAfterFrame();
+  ASSERT_EQ(cache.picture_metrics().miss_count, 0u);
+  ASSERT_EQ(cache.picture_metrics().hit_count, 0u);
+}
+
+TEST(RasterCache, EvictsUnusedEntriesToStayWithinByteBudget) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(
+      threshold, RasterCache::kDefaultPictureAndDispLayListCacheLimitPerFrame,
+      80000);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto display_list_1 = GetDisplayListWithOpCount(10);
+  auto display_list_2 = GetDisplayListWithOpCount(10);
+  auto display_list_3 = GetDisplayListWithOpCount(10);
+
+  SkCanvas dummy_canvas;
+
+  PrerollContextHolder preroll_context_holder = GetSamplePrerollContextHolder();
+
+  cache.PrepareNewFrame();
+  ASSERT_FALSE(cache.Prepare(&preroll_context_holder.preroll_context,
+                             display_list_1.get(), true, false, matrix));
+  ASSERT_FALSE(cache.Prepare(&preroll_context_holder.preroll_context,
+                             display_list_2.get(), true, false, matrix));
+  ASSERT_FALSE(cache.Prepare(&preroll_context_holder.preroll_context,
+                             display_list_3.get(), true, false, matrix));
+  ASSERT_FALSE(cache.Draw(*display_list_1, dummy_canvas));
+  ASSERT_FALSE(cache.Draw(*display_list_2, dummy_canvas));
+  ASSERT_FALSE(cache.Draw(*display_list_3, dummy_canvas));
+  cache.CleanupAfterFrame();
+  ASSERT_EQ(cache.picture_metrics().miss_count, 3u);
+  ASSERT_EQ(cache.picture_metrics().hit_count, 0u);
+
+  // The first two display lists fill the budget.
+  cache.PrepareNewFrame();
+  ASSERT_TRUE(cache.Prepare(&preroll_context_holder.preroll_context,
+                            display_list_1.get(), true, false, matrix));
+  ASSERT_TRUE(cache.Prepare(&preroll_context_holder.preroll_context,
+                            display_list_2.get(), true, false, matrix));
+  ASSERT_TRUE(cache.Draw(*display_list_1, dummy_canvas));
+  ASSERT_TRUE(cache.Draw(*display_list_2, dummy_canvas));
+  ASSERT_FALSE(cache.Draw(*display_list_3, dummy_canvas));
+  cache.CleanupAfterFrame();
+  ASSERT_EQ(cache.picture_metrics().hit_count, 2u);
+  ASSERT_EQ(cache.picture_metrics().miss_count, 1u);
+  ASSERT_EQ(cache.picture_metrics().in_use_count, 2u);
+  ASSERT_EQ(cache.EstimatePictureCacheByteSize(), 80000u);
+
+  // The first display list is not used, so it makes room for the third.
+  cache.PrepareNewFrame();
+  ASSERT_TRUE(cache.Draw(*display_list_2, dummy_canvas));
+  ASSERT_TRUE(cache.Prepare(&preroll_context_holder.preroll_context,
+                            display_list_3.get(), true, false, matrix));
+  ASSERT_TRUE(cache.Draw(*display_list_3, dummy_canvas));
+  cache.CleanupAfterFrame();
+  ASSERT_EQ(cache.picture_metrics().eviction_count, 1u);
+  ASSERT_EQ(cache.picture_metrics().eviction_bytes, 40000u);
+  ASSERT_EQ(cache.picture_metrics().in_use_count, 2u);
+  ASSERT_EQ(cache.EstimatePictureCacheByteSize(), 80000u);
+
+  cache.PrepareNewFrame();
+  ASSERT_FALSE(cache.Draw(*display_list_1, dummy_canvas));
+}
+
+TEST(RasterCache, RetainsUnusedEntriesWithinByteBudget) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto display_list = GetDisplayListWithOpCount(10);
+
+  SkCanvas dummy_canvas;
+
+  PrerollContextHolder preroll_context_holder = GetSamplePrerollContextHolder();
+
+  cache.PrepareNewFrame();
+  ASSERT_FALSE(cache.Prepare(&preroll_context_holder.preroll_context,
+                             display_list.get(), true, false, matrix));
+  ASSERT_FALSE(cache.Draw(*display_list, dummy_canvas));
+  cache.CleanupAfterFrame();
+
+  cache.PrepareNewFrame();
+  ASSERT_TRUE(cache.Prepare(&preroll_context_holder.preroll_context,
+                            display_list.get(), true, false, matrix));
+  ASSERT_TRUE(cache.Draw(*display_list, dummy_canvas));
+  cache.CleanupAfterFrame();
+
+  // A frame without the display list.
+  cache.PrepareNewFrame();
+  cache.CleanupAfterFrame();
+  ASSERT_EQ(cache.picture_metrics().in_use_count, 0u);
+  ASSERT_EQ(cache.picture_metrics().retained_count, 1u);
+  ASSERT_EQ(cache.picture_metrics().retained_bytes, 40000u);
+  ASSERT_EQ(cache.picture_metrics().total_bytes(), 40000u);
+
+  cache.PrepareNewFrame();
+  ASSERT_TRUE(cache.Draw(*display_list, dummy_canvas));
+}
+
+TEST(RasterCache, PrefersEvictingEntriesThatAreCheaperToRasterize) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(
+      threshold, RasterCache::kDefaultPictureAndDispLayListCacheLimitPerFrame,
+      80000);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto cheap_display_list = GetDisplayListWithOpCount(1);
+  auto expensive_display_list = GetDisplayListWithOpCount(20);
+  auto new_display_list = GetDisplayListWithOpCount(10);
+
+  SkCanvas dummy_canvas;
+
+  PrerollContextHolder preroll_context_holder = GetSamplePrerollContextHolder();
+
+  cache.PrepareNewFrame();
+  for (const auto& display_list : {cheap_display_list, expensive_display_list,
+                                   new_display_list}) {
+    ASSERT_FALSE(cache.Prepare(&preroll_context_holder.preroll_context,
+                               display_list.get(), true, false, matrix));
+    ASSERT_FALSE(cache.Draw(*display_list, dummy_canvas));
+  }
+  cache.CleanupAfterFrame();
+
+  cache.PrepareNewFrame();
+  ASSERT_TRUE(cache.Prepare(&preroll_context_holder.preroll_context,
+                            cheap_display_list.get(), true, false, matrix));
+  ASSERT_TRUE(cache.Prepare(&preroll_context_holder.preroll_context,
+                            expensive_display_list.get(), true, false, matrix));
+  ASSERT_TRUE(cache.Draw(*cheap_display_list, dummy_canvas));
+  ASSERT_TRUE(cache.Draw(*expensive_display_list, dummy_canvas));
+  ASSERT_FALSE(cache.Draw(*new_display_list, dummy_canvas));
+  cache.CleanupAfterFrame();
+
+  // Neither cached display list has been used in this frame.
+  cache.PrepareNewFrame();
+  ASSERT_TRUE(cache.Prepare(&preroll_context_holder.preroll_context,
+                            new_display_list.get(), true, false, matrix));
+  ASSERT_TRUE(cache.Draw(*new_display_list, dummy_canvas));
+  ASSERT_TRUE(cache.Draw(*expensive_display_list, dummy_canvas));
+  ASSERT_FALSE(cache.Draw(*cheap_display_list, dummy_canvas));
+}
+
+TEST(RasterCache, PrefersEvictingLeastRecentlyUsedEntries) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(
+      threshold, RasterCache::kDefaultPictureAndDispLayListCacheLimitPerFrame,
+      80000);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto old_display_list = GetDisplayListWithOpCount(10);
+  auto recent_display_list = GetDisplayListWithOpCount(10);
+  auto new_display_list = GetDisplayListWithOpCount(10);
+
+  SkCanvas dummy_canvas;
+
+  PrerollContextHolder preroll_context_holder = GetSamplePrerollContextHolder();
+
+  cache.PrepareNewFrame();
+  for (const auto& display_list : {old_display_list, recent_display_list,
+                                   new_display_list}) {
+    ASSERT_FALSE(cache.Prepare(&preroll_context_holder.preroll_context,
+                               display_list.get(), true, false, matrix));
+    ASSERT_FALSE(cache.Draw(*display_list, dummy_canvas));
+  }
+  cache.CleanupAfterFrame();
+
+  cache.PrepareNewFrame();
+  ASSERT_TRUE(cache.Prepare(&preroll_context_holder.preroll_context,
+                            old_display_list.get(), true, false, matrix));
+  ASSERT_TRUE(cache.Prepare(&preroll_context_holder.preroll_context,
+                            recent_display_list.get(), true, false, matrix));
+  ASSERT_TRUE(cache.Draw(*old_display_list, dummy_canvas));
+  ASSERT_TRUE(cache.Draw(*recent_display_list, dummy_canvas));
+  ASSERT_FALSE(cache.Draw(*new_display_list, dummy_canvas));
+  cache.CleanupAfterFrame();
+
+  cache.PrepareNewFrame();
+  ASSERT_TRUE(cache.Draw(*recent_display_list, dummy_canvas));
+  ASSERT_FALSE(cache.Draw(*new_display_list, dummy_canvas));
+  cache.CleanupAfterFrame();
+
+  // Neither cached display list has been used in this frame.
+  cache.PrepareNewFrame();
+  ASSERT_TRUE(cache.Prepare(&preroll_context_holder.preroll_context,
+                            new_display_list.get(), true, false, matrix));
+  ASSERT_TRUE(cache.Draw(*new_display_list, dummy_canvas));
+  ASSERT_TRUE(cache.Draw(*recent_display_list, dummy_canvas));
+  ASSERT_FALSE(cache.Draw(*old_display_list, dummy_canvas));
+}
+
+TEST(RasterCache, DisplayListLargerThanByteBudgetIsNotCached) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(
+      threshold, RasterCache::kDefaultPictureAndDispLayListCacheLimitPerFrame,
+      30000);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto display_list = GetDisplayListWithOpCount(10);
+
+  SkCanvas dummy_canvas;
+
+  PrerollContextHolder preroll_context_holder = GetSamplePrerollContextHolder();
+
+  for (int i = 0; i < 3; i++) {
+    cache.PrepareNewFrame();
+    ASSERT_FALSE(cache.Prepare(&preroll_context_holder.preroll_context,
+                               display_list.get(), true, false, matrix));
+    ASSERT_FALSE(cache.Draw(*display_list, dummy_canvas));
+    cache.CleanupAfterFrame();
+  }
+  ASSERT_EQ(cache.EstimatePictureCacheByteSize(), 0u);
+}
+
+TEST(RasterCache, DisplayListIsRasterizedInBackground) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+
+  // A single worker runs tasks in the order they are posted.
+  auto worker_loop = fml::ConcurrentMessageLoop::Create(1);
+  auto worker_task_runner = worker_loop->GetTaskRunner();
+  cache.SetWorkerTaskRunner(worker_task_runner);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto display_list = GetDisplayListWithOpCount(10);
+
+  SkCanvas dummy_canvas;
+
+  PrerollContextHolder preroll_context_holder = GetSamplePrerollContextHolder();
+
+  cache.PrepareNewFrame();
+  ASSERT_FALSE(cache.Prepare(&preroll_context_holder.preroll_context,
+                             display_list.get(), true, false, matrix));
+  ASSERT_FALSE(cache.Draw(*display_list, dummy_canvas));
+  cache.CleanupAfterFrame();
+
+  // The display list is rasterized on the worker while it is drawn uncached.
+  cache.PrepareNewFrame();
+  ASSERT_FALSE(cache.Prepare(&preroll_context_holder.preroll_context,
+                             display_list.get(), true, false, matrix));
+  ASSERT_FALSE(cache.Draw(*display_list, dummy_canvas));
+  cache.CleanupAfterFrame();
+  ASSERT_EQ(cache.EstimatePictureCacheByteSize(), 0u);
+
+  fml::CountDownLatch latch(1);
+  worker_task_runner->PostTask([&latch]() { latch.CountDown(); });
+  latch.Wait();
+
+  cache.PrepareNewFrame();
+  ASSERT_TRUE(cache.Prepare(&preroll_context_holder.preroll_context,
+                            display_list.get(), true, false, matrix));
+  ASSERT_TRUE(cache.Draw(*display_list, dummy_canvas));
+  cache.CleanupAfterFrame();
+  ASSERT_EQ(cache.picture_metrics().background_count, 1u);
+  ASSERT_EQ(cache.picture_metrics().background_hit_count, 1u);
+  ASSERT_EQ(cache.picture_metrics().in_use_bytes, 40000u);
+}
+
+TEST(RasterCache, TouchingRecordedPrerollEntriesKeepsThemCached) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto display_list = GetSampleDisplayList();
+
+  SkCanvas dummy_canvas;
+
+  PrerollContextHolder preroll_context_holder = GetSamplePrerollContextHolder();
+
+  // The first preroll only counts the access, so it is incomplete.
+  cache.PrepareNewFrame();
+  RasterCache::PrerollEntries first_entries;
+  cache.BeginRecordingPrerollEntries(&first_entries);
+  ASSERT_FALSE(cache.Prepare(&preroll_context_holder.preroll_context,
+                             display_list.get(), true, false, matrix));
+  cache.EndRecordingPrerollEntries();
+  ASSERT_TRUE(first_entries.incomplete);
+  ASSERT_FALSE(cache.TouchPrerollEntries(first_entries));
+  cache.CleanupAfterFrame();
+
+  cache.PrepareNewFrame();
+  RasterCache::PrerollEntries entries;
+  cache.BeginRecordingPrerollEntries(&entries);
+  ASSERT_TRUE(cache.Prepare(&preroll_context_holder.preroll_context,
+                            display_list.get(), true, false, matrix));
+  cache.EndRecordingPrerollEntries();
+  ASSERT_FALSE(entries.incomplete);
+  ASSERT_EQ(entries.display_lists.size(), 1u);
+  cache.CleanupAfterFrame();
+
+  // Frames that reuse the preroll instead of preparing the display list.
+  for (size_t i = 0; i < 2 * RasterCache::kMaxUnusedFrames; i++) {
+    cache.PrepareNewFrame();
+    ASSERT_TRUE(cache.TouchPrerollEntries(entries));
+    cache.CleanupAfterFrame();
+  }
+  ASSERT_EQ(cache.GetPictureCachedEntriesCount(), 1u);
+
+  cache.PrepareNewFrame();
+  ASSERT_TRUE(cache.Draw(*display_list, dummy_canvas));
+  cache.CleanupAfterFrame();
+
+  cache.Clear();
+  cache.PrepareNewFrame();
+  ASSERT_FALSE(cache.TouchPrerollEntries(entries));
+}
+
+TEST(RasterCache, NestedPrerollEntriesAreRecordedInTheOuterRecording) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto display_list = GetSampleDisplayList();
+
+  PrerollContextHolder preroll_context_holder = GetSamplePrerollContextHolder();
+
+  cache.PrepareNewFrame();
+  ASSERT_FALSE(cache.Prepare(&preroll_context_holder.preroll_context,
+                             display_list.get(), true, false, matrix));
+  cache.CleanupAfterFrame();
+
+  cache.PrepareNewFrame();
+  RasterCache::PrerollEntries outer_entries;
+  RasterCache::PrerollEntries inner_entries;
+  cache.BeginRecordingPrerollEntries(&outer_entries);
+  cache.BeginRecordingPrerollEntries(&inner_entries);
+  ASSERT_TRUE(cache.Prepare(&preroll_context_holder.preroll_context,
+                            display_list.get(), true, false, matrix));
+  cache.EndRecordingPrerollEntries();
+  ASSERT_EQ(inner_entries.display_lists.size(), 1u);
+  // Reusing the inner preroll also records its entries in the outer one.
+  ASSERT_TRUE(cache.TouchPrerollEntries(inner_entries));
+  cache.EndRecordingPrerollEntries();
+  ASSERT_FALSE(outer_entries.incomplete);
+  ASSERT_EQ(outer_entries.display_lists.size(), 2u);
+  cache.CleanupAfterFrame();
+}
+
 }  // namespace testing
 
 }  // namespace flutter
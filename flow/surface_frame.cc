@@ -28,6 +28,17 @@ SurfaceFrame::SurfaceFrame(sk_sp<SkSurface> surface,
   FML_DCHECK(submit_callback_);
 }
 
+SurfaceFrame::SurfaceFrame(sk_sp<SkSurface> surface,
+                           SkCanvas* canvas,
+                           FramebufferInfo framebuffer_info,
+                           const SubmitCallback& submit_callback)
+    : surface_(surface),
+      canvas_(canvas),
+      framebuffer_info_(std::move(framebuffer_info)),
+      submit_callback_(submit_callback) {
+  FML_DCHECK(submit_callback_);
+}
+
 SurfaceFrame::~SurfaceFrame() {
   if (submit_callback_ && !submitted_) {
     // Dropping without a Submit.
@@ -50,6 +61,9 @@ bool SurfaceFrame::IsSubmitted() const {
 }
 
 SkCanvas* SurfaceFrame::SkiaCanvas() {
+  if (canvas_ != nullptr) {
+    return canvas_;
+  }
   return surface_ != nullptr ? surface_->getCanvas() : nullptr;
 }
 
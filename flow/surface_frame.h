@@ -7,6 +7,7 @@
 
 #include <memory>
 #include <optional>
+#include <vector>
 
 #include "flutter/common/graphics/gl_context_switch.h"
 #include "flutter/fml/macros.h"
@@ -28,6 +29,11 @@ class SurfaceFrame {
     // circumstances such as a BackdropFilter.
     bool supports_readback = false;
 
+    // Indicates whether the surface keeps the pixels outside of each of the
+    // buffer damage rects, so that painting can be clipped to the rects
+    // rather than to their bounds.
+    bool supports_multiple_damage_rects = false;
+
     // This is the area of framebuffer that lags behind the front buffer.
     //
     // Correctly providing exiting_damage is necessary for supporting double and
@@ -51,6 +57,14 @@ class SurfaceFrame {
                const SubmitCallback& submit_callback,
                std::unique_ptr<GLContextResult> context_result);
 
+  // Creates a frame that is painted into |canvas| rather than the canvas of
+  // the |surface|, such as a canvas that records the frame so that the
+  // |submit_callback| can later rasterize the recording into the |surface|.
+  SurfaceFrame(sk_sp<SkSurface> surface,
+               SkCanvas* canvas,
+               FramebufferInfo framebuffer_info,
+               const SubmitCallback& submit_callback);
+
   ~SurfaceFrame();
 
   struct SubmitInfo {
@@ -66,6 +80,12 @@ class SurfaceFrame {
     //
     // Corresponds to EGL_KHR_partial_update
     std::optional<SkIRect> buffer_damage;
+
+    // The frame damage and buffer damage split into several rects, for
+    // surfaces that accept more than one damage rect. Set whenever the
+    // corresponding bounds above are set.
+    std::optional<std::vector<SkIRect>> frame_damage_rects;
+    std::optional<std::vector<SkIRect>> buffer_damage_rects;
   };
 
   bool Submit();
@@ -86,6 +106,7 @@ class SurfaceFrame {
  private:
   bool submitted_ = false;
   sk_sp<SkSurface> surface_;
+  SkCanvas* canvas_ = nullptr;
   FramebufferInfo framebuffer_info_;
   SubmitInfo submit_info_;
   SubmitCallback submit_callback_;
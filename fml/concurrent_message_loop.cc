@@ -6,11 +6,31 @@
 
 #include <algorithm>
 
+#include "flutter/fml/synchronization/count_down_latch.h"
 #include "flutter/fml/thread.h"
+#include "flutter/fml/thread_local.h"
 #include "flutter/fml/trace_event.h"
 
 namespace fml {
 
+namespace {
+
+// iOS prior to version 9 prevents c++11 thread_local and __thread specifier,
+// having us resort to boxed containers.
+class WorkerIdentity {
+ public:
+  const ConcurrentMessageLoop* loop;
+  size_t index;
+
+  WorkerIdentity(const ConcurrentMessageLoop* loop_arg, size_t index_arg)
+      : loop(loop_arg), index(index_arg) {}
+};
+
+}  // namespace
+
+// The loop and worker index of each worker thread.
+FML_THREAD_LOCAL ThreadLocalUniquePtr<WorkerIdentity> tls_worker_identity;
+
 std::shared_ptr<ConcurrentMessageLoop> ConcurrentMessageLoop::Create(
     size_t worker_count) {
   return std::shared_ptr<ConcurrentMessageLoop>{
@@ -19,17 +39,21 @@ std::shared_ptr<ConcurrentMessageLoop> ConcurrentMessageLoop::Create(
 
 ConcurrentMessageLoop::ConcurrentMessageLoop(size_t worker_count)
     : worker_count_(std::max<size_t>(worker_count, 1ul)) {
+  // The queues must all exist before any worker starts looking for tasks to
+  // steal.
+  for (size_t i = 0; i < worker_count_; ++i) {
+    worker_queues_.emplace_back(std::make_unique<WorkerQueue>());
+  }
+
   for (size_t i = 0; i < worker_count_; ++i) {
     workers_.emplace_back([i, this]() {
       fml::Thread::SetCurrentThreadName(
           std::string{"io.worker." + std::to_string(i + 1)});
-      WorkerMain();
+      tls_worker_identity.reset(new WorkerIdentity(this, i));
+      WorkerMain(i);
+      tls_worker_identity.reset(nullptr);
     });
   }
-
-  for (const auto& worker : workers_) {
-    worker_thread_ids_.emplace_back(worker.get_id());
-  }
 }
 
 ConcurrentMessageLoop::~ConcurrentMessageLoop() {
@@ -47,80 +71,148 @@ std::shared_ptr<ConcurrentTaskRunner> ConcurrentMessageLoop::GetTaskRunner() {
   return std::make_shared<ConcurrentTaskRunner>(weak_from_this());
 }
 
+size_t ConcurrentMessageLoop::SelectWorker() {
+  // Tasks posted by a worker are most likely to share its caches, and leaving
+  // them on its own queue keeps the other queues free of contention. Idle
+  // workers will steal them if this one falls behind.
+  const WorkerIdentity* identity = tls_worker_identity.get();
+  if (identity != nullptr && identity->loop == this) {
+    return identity->index;
+  }
+  return next_worker_.fetch_add(1) % worker_count_;
+}
+
 void ConcurrentMessageLoop::PostTask(const fml::closure& task) {
+  PostTask(task, SelectWorker());
+}
+
+void ConcurrentMessageLoop::PostTask(const fml::closure& task,
+                                     size_t worker_index) {
   if (!task) {
     return;
   }
 
-  std::unique_lock lock(tasks_mutex_);
-
   // Don't just drop tasks on the floor in case of shutdown.
   if (shutdown_) {
     FML_DLOG(WARNING)
         << "Tried to post a task to shutdown concurrent message "
            "loop. The task will be executed on the callers thread.";
-    lock.unlock();
     task();
     return;
   }
 
-  tasks_.push(task);
-
-  // Unlock the mutex before notifying the condition variable because that mutex
-  // has to be acquired on the other thread anyway. Waiting in this scope till
-  // it is acquired there is a pessimization.
-  lock.unlock();
+  {
+    WorkerQueue& queue = *worker_queues_[worker_index % worker_count_];
+    std::scoped_lock lock(queue.mutex);
+    queue.tasks.push_back(task);
+    ++pending_task_count_;
+  }
 
-  tasks_condition_.notify_one();
+  WakeIdleWorker();
 }
 
-void ConcurrentMessageLoop::WorkerMain() {
-  while (true) {
-    std::unique_lock lock(tasks_mutex_);
-    tasks_condition_.wait(lock, [&]() {
-      return tasks_.size() > 0 || shutdown_ || HasThreadTasksLocked();
-    });
+void ConcurrentMessageLoop::WakeIdleWorker() {
+  // Workers announce that they are idle before checking the pending task count
+  // one last time, and posters publish the task before checking for idle
+  // workers, so at least one side always sees the other. This keeps the common
+  // case of every worker being busy free of the idle mutex.
+  if (idle_worker_count_ == 0) {
+    return;
+  }
 
-    // Shutdown cannot be read with the task mutex unlocked.
-    bool shutdown_now = shutdown_;
-    fml::closure task;
-    std::vector<fml::closure> thread_tasks;
+  // Acquiring the mutex makes sure a worker that is about to sleep either sees
+  // the new task or is already waiting for this notification.
+  { std::scoped_lock lock(idle_mutex_); }
+  idle_condition_.notify_one();
+}
 
-    if (tasks_.size() != 0) {
-      task = tasks_.front();
-      tasks_.pop();
+fml::closure ConcurrentMessageLoop::TakeTask(size_t worker_index) {
+  {
+    WorkerQueue& queue = *worker_queues_[worker_index];
+    std::scoped_lock lock(queue.mutex);
+    if (!queue.tasks.empty()) {
+      fml::closure task = std::move(queue.tasks.front());
+      queue.tasks.pop_front();
+      --pending_task_count_;
+      return task;
     }
+  }
+
+  if (pending_task_count_ == 0) {
+    return nullptr;
+  }
 
-    if (HasThreadTasksLocked()) {
-      thread_tasks = GetThreadTasksLocked();
-      FML_DCHECK(!HasThreadTasksLocked());
+  // Steal from the back of the other queues, starting with the next worker so
+  // that thieves don't all converge on the first queue.
+  for (size_t i = 1; i < worker_count_; ++i) {
+    WorkerQueue& queue = *worker_queues_[(worker_index + i) % worker_count_];
+    std::scoped_lock lock(queue.mutex);
+    if (!queue.tasks.empty()) {
+      fml::closure task = std::move(queue.tasks.back());
+      queue.tasks.pop_back();
+      --pending_task_count_;
+      return task;
     }
+  }
 
-    // Don't hold onto the mutex while tasks are being executed as they could
-    // themselves try to post more tasks to the message loop.
-    lock.unlock();
+  return nullptr;
+}
 
-    TRACE_EVENT0("flutter", "ConcurrentWorkerWake");
-    // Execute the primary task we woke up for.
-    if (task) {
-      task();
-    }
+std::vector<fml::closure> ConcurrentMessageLoop::TakeThreadTasks(
+    size_t worker_index) {
+  WorkerQueue& queue = *worker_queues_[worker_index];
+  std::vector<fml::closure> thread_tasks;
+  if (queue.thread_task_count == 0) {
+    return thread_tasks;
+  }
+  std::scoped_lock lock(queue.mutex);
+  std::swap(thread_tasks, queue.thread_tasks);
+  queue.thread_task_count = 0;
+  return thread_tasks;
+}
 
-    // Execute any thread tasks.
-    for (const auto& thread_task : thread_tasks) {
-      thread_task();
+void ConcurrentMessageLoop::WorkerMain(size_t worker_index) {
+  WorkerQueue& queue = *worker_queues_[worker_index];
+  while (true) {
+    // Read shutdown before looking for work so that any task posted before
+    // termination that is found here is still run.
+    bool shutdown_now = shutdown_;
+    std::vector<fml::closure> thread_tasks = TakeThreadTasks(worker_index);
+    fml::closure task = TakeTask(worker_index);
+
+    if (task || !thread_tasks.empty()) {
+      TRACE_EVENT0("flutter", "ConcurrentWorkerWake");
+      if (task) {
+        task();
+      }
+
+      for (const auto& thread_task : thread_tasks) {
+        thread_task();
+      }
     }
 
     if (shutdown_now) {
       break;
     }
+
+    if (task || !thread_tasks.empty()) {
+      continue;
+    }
+
+    std::unique_lock lock(idle_mutex_);
+    ++idle_worker_count_;
+    idle_condition_.wait(lock, [&]() {
+      return pending_task_count_ > 0 || shutdown_ ||
+             queue.thread_task_count > 0;
+    });
+    --idle_worker_count_;
   }
 }
 
 void ConcurrentMessageLoop::Terminate() {
-  std::scoped_lock lock(tasks_mutex_);
+  std::scoped_lock lock(idle_mutex_);
   shutdown_ = true;
-  tasks_condition_.notify_all();
+  idle_condition_.notify_all();
 }
 
 void ConcurrentMessageLoop::PostTaskToAllWorkers(fml::closure task) {
@@ -128,24 +220,14 @@ void ConcurrentMessageLoop::PostTaskToAllWorkers(fml::closure task) {
     return;
   }
 
-  std::scoped_lock lock(tasks_mutex_);
-  for (const auto& worker_thread_id : worker_thread_ids_) {
-    thread_tasks_[worker_thread_id].emplace_back(task);
+  for (const auto& queue : worker_queues_) {
+    std::scoped_lock lock(queue->mutex);
+    queue->thread_tasks.emplace_back(task);
+    ++queue->thread_task_count;
   }
-  tasks_condition_.notify_all();
-}
 
-bool ConcurrentMessageLoop::HasThreadTasksLocked() const {
-  return thread_tasks_.count(std::this_thread::get_id()) > 0;
-}
-
-std::vector<fml::closure> ConcurrentMessageLoop::GetThreadTasksLocked() {
-  auto found = thread_tasks_.find(std::this_thread::get_id());
-  FML_DCHECK(found != thread_tasks_.end());
-  std::vector<fml::closure> pending_tasks;
-  std::swap(pending_tasks, found->second);
-  thread_tasks_.erase(found);
-  return pending_tasks;
+  std::scoped_lock lock(idle_mutex_);
+  idle_condition_.notify_all();
 }
 
 ConcurrentTaskRunner::ConcurrentTaskRunner(
@@ -170,4 +252,75 @@ void ConcurrentTaskRunner::PostTask(const fml::closure& task) {
   task();
 }
 
+void ConcurrentTaskRunner::PostTaskWithAffinity(size_t affinity,
+                                                const fml::closure& task) {
+  if (!task) {
+    return;
+  }
+
+  if (auto loop = weak_loop_.lock()) {
+    loop->PostTask(task, affinity);
+    return;
+  }
+
+  FML_DLOG(WARNING)
+      << "Tried to post to a concurrent message loop that has already died. "
+         "Executing the task on the callers thread.";
+  task();
+}
+
+namespace {
+
+struct ParallelForState {
+  ParallelForState(size_t count_arg,
+                   const std::function<void(size_t)>& body_arg)
+      : count(count_arg), body(body_arg), latch(count_arg) {}
+
+  // Runs the body for unclaimed indices until there are none left. Helpers
+  // that start after every index has been claimed return without touching
+  // |body|, which is only guaranteed to live until the latch is released.
+  void Run() {
+    for (size_t index = next_index.fetch_add(1); index < count;
+         index = next_index.fetch_add(1)) {
+      body(index);
+      latch.CountDown();
+    }
+  }
+
+  const size_t count;
+  const std::function<void(size_t)>& body;
+  std::atomic_size_t next_index = 0;
+  CountDownLatch latch;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(ParallelForState);
+};
+
+}  // namespace
+
+void ConcurrentTaskRunner::ParallelFor(
+    size_t count,
+    const std::function<void(size_t)>& body) {
+  auto loop = weak_loop_.lock();
+  if (!loop || count <= 1) {
+    for (size_t i = 0; i < count; ++i) {
+      body(i);
+    }
+    return;
+  }
+
+  auto state = std::make_shared<ParallelForState>(count, body);
+
+  // The calling thread works on the loop as well, so one fewer helper than
+  // there are indices is enough. Helpers are spread across the workers so
+  // that they can start without having to be stolen first.
+  const size_t helper_count = std::min(count - 1, loop->GetWorkerCount());
+  const size_t first_worker = loop->SelectWorker();
+  for (size_t i = 0; i < helper_count; ++i) {
+    loop->PostTask([state]() { state->Run(); }, first_worker + i);
+  }
+
+  state->Run();
+  state->latch.Wait();
+}
+
 }  // namespace fml
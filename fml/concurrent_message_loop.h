@@ -5,10 +5,14 @@
 #ifndef FLUTTER_FML_CONCURRENT_MESSAGE_LOOP_H_
 #define FLUTTER_FML_CONCURRENT_MESSAGE_LOOP_H_
 
+#include <atomic>
 #include <condition_variable>
-#include <map>
-#include <queue>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <thread>
+#include <vector>
 
 #include "flutter/fml/closure.h"
 #include "flutter/fml/macros.h"
@@ -18,6 +22,10 @@ namespace fml {
 
 class ConcurrentTaskRunner;
 
+// A pool of worker threads. Each worker has its own queue of tasks, and
+// workers that run out of tasks steal them from the other queues. Tasks posted
+// from a worker are queued on that worker, other tasks are spread across the
+// workers.
 class ConcurrentMessageLoop
     : public std::enable_shared_from_this<ConcurrentMessageLoop> {
  public:
@@ -37,24 +45,45 @@ class ConcurrentMessageLoop
  private:
   friend ConcurrentTaskRunner;
 
+  struct WorkerQueue {
+    std::mutex mutex;
+    // The worker takes tasks from the front, thieves from the back.
+    std::deque<fml::closure> tasks;
+    // Tasks that must run on this worker.
+    std::vector<fml::closure> thread_tasks;
+    std::atomic_size_t thread_task_count = 0;
+  };
+
   size_t worker_count_ = 0;
+  std::vector<std::unique_ptr<WorkerQueue>> worker_queues_;
   std::vector<std::thread> workers_;
-  std::mutex tasks_mutex_;
-  std::condition_variable tasks_condition_;
-  std::queue<fml::closure> tasks_;
-  std::vector<std::thread::id> worker_thread_ids_;
-  std::map<std::thread::id, std::vector<fml::closure>> thread_tasks_;
-  bool shutdown_ = false;
+  std::atomic_size_t next_worker_ = 0;
+  // Tasks queued on any worker that can be stolen.
+  std::atomic_size_t pending_task_count_ = 0;
+  // Guards sleeping and waking workers.
+  std::mutex idle_mutex_;
+  std::condition_variable idle_condition_;
+  std::atomic_size_t idle_worker_count_ = 0;
+  std::atomic_bool shutdown_ = false;
 
   ConcurrentMessageLoop(size_t worker_count);
 
-  void WorkerMain();
+  void WorkerMain(size_t worker_index);
 
   void PostTask(const fml::closure& task);
 
-  bool HasThreadTasksLocked() const;
+  void PostTask(const fml::closure& task, size_t worker_index);
+
+  // The worker calling this, if any, or else the next worker in turn.
+  size_t SelectWorker();
+
+  // Takes a task from the queue of the worker or, failing that, steals one
+  // from another worker.
+  fml::closure TakeTask(size_t worker_index);
 
-  std::vector<fml::closure> GetThreadTasksLocked();
+  std::vector<fml::closure> TakeThreadTasks(size_t worker_index);
+
+  void WakeIdleWorker();
 
   FML_DISALLOW_COPY_AND_ASSIGN(ConcurrentMessageLoop);
 };
@@ -67,6 +96,26 @@ class ConcurrentTaskRunner : public BasicTaskRunner {
 
   void PostTask(const fml::closure& task) override;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Posts a task to the queue of the worker selected by
+  ///             |affinity| modulo the number of workers. Tasks posted with
+  ///             the same affinity tend to run on the same thread, but a
+  ///             busy worker's tasks may be stolen by idle workers.
+  ///
+  void PostTaskWithAffinity(size_t affinity, const fml::closure& task);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Calls |body| once for each index in [0, |count|), spread
+  ///             across the workers and the calling thread, and returns once
+  ///             every call has returned. Indices are handed out in order to
+  ///             whichever thread is free, so |body| should do a similar
+  ///             amount of work for each index.
+  ///
+  ///             The calling thread takes part in the work, so this may be
+  ///             called from a task running on one of the workers.
+  ///
+  void ParallelFor(size_t count, const std::function<void(size_t)>& body);
+
  private:
   friend ConcurrentMessageLoop;
 
@@ -0,0 +1,141 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/concurrent_message_loop.h"
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/fml/synchronization/count_down_latch.h"
+#include "flutter/fml/time/time_point.h"
+
+namespace fml {
+namespace benchmarking {
+
+static constexpr size_t kWorkerCount = 4;
+
+// A small amount of work that the compiler can't elide, standing in for the
+// short tasks that make up most of the concurrent loop's load.
+static void SpinBriefly() {
+  static std::atomic_size_t sink = 0;
+  size_t value = 0;
+  for (size_t i = 0; i < 256; i++) {
+    value += i * i;
+  }
+  sink += value;
+}
+
+// Posts a burst of small tasks from a thread outside the loop and waits for
+// all of them to finish.
+static void BM_ConcurrentLoopBurstThroughput(benchmark::State& state) {
+  auto loop = ConcurrentMessageLoop::Create(kWorkerCount);
+  auto task_runner = loop->GetTaskRunner();
+  const size_t task_count = state.range(0);
+  while (state.KeepRunning()) {
+    CountDownLatch latch(task_count);
+    for (size_t i = 0; i < task_count; i++) {
+      task_runner->PostTask([&latch]() {
+        SpinBriefly();
+        latch.CountDown();
+      });
+    }
+    latch.Wait();
+  }
+  state.SetItemsProcessed(state.iterations() * task_count);
+}
+
+// Measures how long each task in a burst waits between being posted and
+// starting to run, and reports the median and tail.
+static void BM_ConcurrentLoopBurstLatency(benchmark::State& state) {
+  auto loop = ConcurrentMessageLoop::Create(kWorkerCount);
+  auto task_runner = loop->GetTaskRunner();
+  const size_t task_count = state.range(0);
+  std::vector<double> latencies;
+  while (state.KeepRunning()) {
+    std::vector<double> burst_latencies(task_count);
+    CountDownLatch latch(task_count);
+    for (size_t i = 0; i < task_count; i++) {
+      const TimePoint posted = TimePoint::Now();
+      task_runner->PostTask([&burst_latencies, &latch, posted, i]() {
+        burst_latencies[i] = (TimePoint::Now() - posted).ToMicrosecondsF();
+        SpinBriefly();
+        latch.CountDown();
+      });
+    }
+    latch.Wait();
+    latencies.insert(latencies.end(), burst_latencies.begin(),
+                     burst_latencies.end());
+  }
+  if (latencies.empty()) {
+    return;
+  }
+  std::sort(latencies.begin(), latencies.end());
+  state.counters["p50_us"] = latencies[latencies.size() / 2];
+  state.counters["p99_us"] = latencies[latencies.size() * 99 / 100];
+  state.counters["max_us"] = latencies.back();
+}
+
+// Posts a burst of small tasks from one of the workers, which queues them all
+// on that worker and leaves the others to steal them.
+static void BM_ConcurrentLoopNestedBurst(benchmark::State& state) {
+  auto loop = ConcurrentMessageLoop::Create(kWorkerCount);
+  auto task_runner = loop->GetTaskRunner();
+  const size_t task_count = state.range(0);
+  while (state.KeepRunning()) {
+    CountDownLatch latch(task_count);
+    task_runner->PostTask([&task_runner, &latch, task_count]() {
+      for (size_t i = 0; i < task_count; i++) {
+        task_runner->PostTask([&latch]() {
+          SpinBriefly();
+          latch.CountDown();
+        });
+      }
+    });
+    latch.Wait();
+  }
+  state.SetItemsProcessed(state.iterations() * task_count);
+}
+
+static void BM_ConcurrentLoopParallelFor(benchmark::State& state) {
+  auto loop = ConcurrentMessageLoop::Create(kWorkerCount);
+  auto task_runner = loop->GetTaskRunner();
+  const size_t count = state.range(0);
+  while (state.KeepRunning()) {
+    task_runner->ParallelFor(count, [](size_t) { SpinBriefly(); });
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+}
+
+BENCHMARK(BM_ConcurrentLoopBurstThroughput)
+    ->Arg(1024)
+    ->Arg(4096)
+    ->Arg(16384)
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(BM_ConcurrentLoopBurstLatency)
+    ->Arg(1024)
+    ->Arg(4096)
+    ->Arg(16384)
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(BM_ConcurrentLoopNestedBurst)
+    ->Arg(1024)
+    ->Arg(4096)
+    ->Arg(16384)
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(BM_ConcurrentLoopParallelFor)
+    ->Arg(16)
+    ->Arg(256)
+    ->Arg(4096)
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace benchmarking
+}  // namespace fml
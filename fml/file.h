@@ -7,6 +7,7 @@
 
 #include <functional>
 #include <initializer_list>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -72,6 +73,24 @@ bool IsFile(const std::string& path);
 
 bool TruncateFile(const fml::UniqueFD& file, size_t size);
 
+/// Returns the size of |file|, or std::nullopt if it could not be read.
+std::optional<size_t> GetFileSize(const fml::UniqueFD& file);
+
+/// Writes |size| bytes of |data| to |file| at |offset|, growing the file if
+/// needed. Returns whether all of them were written.
+bool WriteFileAt(const fml::UniqueFD& file,
+                 size_t offset,
+                 const uint8_t* data,
+                 size_t size);
+
+/// Blocks until |file| is locked for exclusive use. The lock is advisory: it
+/// only excludes other descriptors of the file, in this process or in others,
+/// that also lock it. It is released by |UnlockFile|, or when the file is
+/// closed.
+bool LockFile(const fml::UniqueFD& file);
+
+bool UnlockFile(const fml::UniqueFD& file);
+
 bool FileExists(const fml::UniqueFD& base_directory, const char* path);
 
 bool UnlinkDirectory(const char* path);
@@ -326,3 +326,46 @@ TEST(FileTest, FileTestsSupportsUnicode) {
       fml::IsFile(fml::paths::JoinPaths({dir.path(), filename}).c_str()));
   ASSERT_TRUE(fml::UnlinkFile(dir.fd(), filename));
 }
+
+TEST(FileTest, CanWriteAtOffsets) {
+  fml::ScopedTemporaryDirectory dir;
+  auto file = fml::OpenFile(dir.fd(), "my_contents", true,
+                            fml::FilePermission::kReadWrite);
+  ASSERT_EQ(fml::GetFileSize(file), 0u);
+
+  const std::string first = "Hello";
+  const std::string second = ", world";
+  ASSERT_TRUE(fml::WriteFileAt(
+      file, 0, reinterpret_cast<const uint8_t*>(first.data()), first.size()));
+  ASSERT_TRUE(fml::WriteFileAt(
+      file, first.size(), reinterpret_cast<const uint8_t*>(second.data()),
+      second.size()));
+  ASSERT_EQ(fml::GetFileSize(file), first.size() + second.size());
+  ASSERT_EQ(ReadStringFromFile(file), "Hello, world");
+
+  // Writing in the middle does not change the size.
+  ASSERT_TRUE(
+      fml::WriteFileAt(file, 1, reinterpret_cast<const uint8_t*>("E"), 1));
+  ASSERT_EQ(ReadStringFromFile(file), "HEllo, world");
+
+  file.reset();
+  ASSERT_TRUE(fml::UnlinkFile(dir.fd(), "my_contents"));
+}
+
+TEST(FileTest, CanLockAndUnlockFiles) {
+  fml::ScopedTemporaryDirectory dir;
+  auto file = fml::OpenFile(dir.fd(), "my_contents", true,
+                            fml::FilePermission::kReadWrite);
+  ASSERT_TRUE(fml::LockFile(file));
+  ASSERT_TRUE(fml::UnlockFile(file));
+
+  // Another descriptor of the file can lock it once it is unlocked.
+  auto other_file = fml::OpenFile(dir.fd(), "my_contents", false,
+                                  fml::FilePermission::kReadWrite);
+  ASSERT_TRUE(fml::LockFile(other_file));
+  ASSERT_TRUE(fml::UnlockFile(other_file));
+
+  file.reset();
+  other_file.reset();
+  ASSERT_TRUE(fml::UnlinkFile(dir.fd(), "my_contents"));
+}
@@ -6,9 +6,11 @@
 
 #include "flutter/fml/message_loop_task_queues.h"
 
+#include <algorithm>
 #include <iostream>
 #include <memory>
 #include <optional>
+#include <utility>
 
 #include "flutter/fml/make_copyable.h"
 #include "flutter/fml/task_source.h"
@@ -36,10 +38,45 @@ class TaskSourceGradeHolder {
 };
 }  // namespace
 
-// Guarded by creation_mutex_.
+// The grade of the task most recently run on each thread.
 FML_THREAD_LOCAL ThreadLocalUniquePtr<TaskSourceGradeHolder>
     tls_task_source_grade;
 
+// Locks the task sources of a queue and of every queue it has subsumed. The
+// caller must hold |queue_meta_mutex_| so that the merge state cannot change.
+class MessageLoopTaskQueues::TaskSourcesLock {
+ public:
+  TaskSourcesLock(const MessageLoopTaskQueues& queues, TaskQueueId queue_id) {
+    const auto& entry = queues.queue_entries_.at(queue_id);
+    std::vector<std::pair<TaskQueueId, std::mutex*>> mutexes;
+    mutexes.reserve(entry->owner_of.size() + 1);
+    mutexes.emplace_back(queue_id, &entry->task_source_mutex);
+    for (TaskQueueId subsumed : entry->owner_of) {
+      mutexes.emplace_back(
+          subsumed, &queues.queue_entries_.at(subsumed)->task_source_mutex);
+    }
+    // A consistent order prevents deadlocks between overlapping groups.
+    std::sort(mutexes.begin(), mutexes.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+    locked_.reserve(mutexes.size());
+    for (const auto& mutex : mutexes) {
+      mutex.second->lock();
+      locked_.push_back(mutex.second);
+    }
+  }
+
+  ~TaskSourcesLock() {
+    for (auto it = locked_.rbegin(); it != locked_.rend(); ++it) {
+      (*it)->unlock();
+    }
+  }
+
+ private:
+  std::vector<std::mutex*> locked_;
+
+  FML_DISALLOW_COPY_ASSIGN_AND_MOVE(TaskSourcesLock);
+};
+
 TaskQueueEntry::TaskQueueEntry(TaskQueueId created_for_arg)
     : subsumed_by(_kUnmerged), created_for(created_for_arg) {
   wakeable = NULL;
@@ -58,7 +95,7 @@ fml::RefPtr<MessageLoopTaskQueues> MessageLoopTaskQueues::GetInstance() {
 }
 
 TaskQueueId MessageLoopTaskQueues::CreateTaskQueue() {
-  std::lock_guard guard(queue_mutex_);
+  fml::UniqueLock lock(*queue_meta_mutex_);
   TaskQueueId loop_id = TaskQueueId(task_queue_id_counter_);
   ++task_queue_id_counter_;
   queue_entries_[loop_id] = std::make_unique<TaskQueueEntry>(loop_id);
@@ -66,12 +103,14 @@ TaskQueueId MessageLoopTaskQueues::CreateTaskQueue() {
 }
 
 MessageLoopTaskQueues::MessageLoopTaskQueues()
-    : task_queue_id_counter_(0), order_(0) {}
+    : queue_meta_mutex_(fml::SharedMutex::Create()),
+      task_queue_id_counter_(0),
+      order_(0) {}
 
 MessageLoopTaskQueues::~MessageLoopTaskQueues() = default;
 
 void MessageLoopTaskQueues::Dispose(TaskQueueId queue_id) {
-  std::lock_guard guard(queue_mutex_);
+  fml::UniqueLock lock(*queue_meta_mutex_);
   const auto& queue_entry = queue_entries_.at(queue_id);
   FML_DCHECK(queue_entry->subsumed_by == _kUnmerged);
   auto& subsumed_set = queue_entry->owner_of;
@@ -83,7 +122,7 @@ void MessageLoopTaskQueues::Dispose(TaskQueueId queue_id) {
 }
 
 void MessageLoopTaskQueues::DisposeTasks(TaskQueueId queue_id) {
-  std::lock_guard guard(queue_mutex_);
+  fml::UniqueLock lock(*queue_meta_mutex_);
   const auto& queue_entry = queue_entries_.at(queue_id);
   FML_DCHECK(queue_entry->subsumed_by == _kUnmerged);
   auto& subsumed_set = queue_entry->owner_of;
@@ -103,15 +142,16 @@ void MessageLoopTaskQueues::RegisterTask(
     const fml::closure& task,
     fml::TimePoint target_time,
     fml::TaskSourceGrade task_source_grade) {
-  std::lock_guard guard(queue_mutex_);
   size_t order = order_++;
+  fml::SharedLock lock(*queue_meta_mutex_);
   const auto& queue_entry = queue_entries_.at(queue_id);
-  queue_entry->task_source->RegisterTask(
-      {order, task, target_time, task_source_grade});
   TaskQueueId loop_to_wake = queue_id;
   if (queue_entry->subsumed_by != _kUnmerged) {
     loop_to_wake = queue_entry->subsumed_by;
   }
+  TaskSourcesLock task_sources_lock(*this, loop_to_wake);
+  queue_entry->task_source->RegisterTask(
+      {order, task, target_time, task_source_grade});
 
   // This can happen when the secondary tasks are paused.
   if (HasPendingTasksUnlocked(loop_to_wake)) {
@@ -120,13 +160,15 @@ void MessageLoopTaskQueues::RegisterTask(
 }
 
 bool MessageLoopTaskQueues::HasPendingTasks(TaskQueueId queue_id) const {
-  std::lock_guard guard(queue_mutex_);
+  fml::SharedLock lock(*queue_meta_mutex_);
+  TaskSourcesLock task_sources_lock(*this, queue_id);
   return HasPendingTasksUnlocked(queue_id);
 }
 
 fml::closure MessageLoopTaskQueues::GetNextTaskToRun(TaskQueueId queue_id,
                                                      fml::TimePoint from_time) {
-  std::lock_guard guard(queue_mutex_);
+  fml::SharedLock lock(*queue_meta_mutex_);
+  TaskSourcesLock task_sources_lock(*this, queue_id);
   if (!HasPendingTasksUnlocked(queue_id)) {
     return nullptr;
   }
@@ -142,13 +184,10 @@ fml::closure MessageLoopTaskQueues::GetNextTaskToRun(TaskQueueId queue_id,
     return nullptr;
   }
   fml::closure invocation = top.task.GetTask();
-  queue_entries_.at(top.task_queue_id)
-      ->task_source->PopTask(top.task.GetTaskSourceGrade());
-  {
-    std::scoped_lock creation(creation_mutex_);
-    const auto task_source_grade = top.task.GetTaskSourceGrade();
-    tls_task_source_grade.reset(new TaskSourceGradeHolder{task_source_grade});
-  }
+  const auto task_source_grade = top.task.GetTaskSourceGrade();
+  queue_entries_.at(top.task_queue_id)->task_source->PopTask(task_source_grade);
+  // The holder is thread local so updating it needs no lock.
+  tls_task_source_grade.reset(new TaskSourceGradeHolder{task_source_grade});
   return invocation;
 }
 
@@ -160,7 +199,8 @@ void MessageLoopTaskQueues::WakeUpUnlocked(TaskQueueId queue_id,
 }
 
 size_t MessageLoopTaskQueues::GetNumPendingTasks(TaskQueueId queue_id) const {
-  std::lock_guard guard(queue_mutex_);
+  fml::SharedLock lock(*queue_meta_mutex_);
+  TaskSourcesLock task_sources_lock(*this, queue_id);
   const auto& queue_entry = queue_entries_.at(queue_id);
   if (queue_entry->subsumed_by != _kUnmerged) {
     return 0;
@@ -180,20 +220,20 @@ size_t MessageLoopTaskQueues::GetNumPendingTasks(TaskQueueId queue_id) const {
 void MessageLoopTaskQueues::AddTaskObserver(TaskQueueId queue_id,
                                             intptr_t key,
                                             const fml::closure& callback) {
-  std::lock_guard guard(queue_mutex_);
+  fml::UniqueLock lock(*queue_meta_mutex_);
   FML_DCHECK(callback != nullptr) << "Observer callback must be non-null.";
   queue_entries_.at(queue_id)->task_observers[key] = callback;
 }
 
 void MessageLoopTaskQueues::RemoveTaskObserver(TaskQueueId queue_id,
                                                intptr_t key) {
-  std::lock_guard guard(queue_mutex_);
+  fml::UniqueLock lock(*queue_meta_mutex_);
   queue_entries_.at(queue_id)->task_observers.erase(key);
 }
 
 std::vector<fml::closure> MessageLoopTaskQueues::GetObserversToNotify(
     TaskQueueId queue_id) const {
-  std::lock_guard guard(queue_mutex_);
+  fml::SharedLock lock(*queue_meta_mutex_);
   std::vector<fml::closure> observers;
 
   if (queue_entries_.at(queue_id)->subsumed_by != _kUnmerged) {
@@ -216,7 +256,7 @@ std::vector<fml::closure> MessageLoopTaskQueues::GetObserversToNotify(
 
 void MessageLoopTaskQueues::SetWakeable(TaskQueueId queue_id,
                                         fml::Wakeable* wakeable) {
-  std::lock_guard guard(queue_mutex_);
+  fml::UniqueLock lock(*queue_meta_mutex_);
   FML_CHECK(!queue_entries_.at(queue_id)->wakeable)
       << "Wakeable can only be set once.";
   queue_entries_.at(queue_id)->wakeable = wakeable;
@@ -226,7 +266,7 @@ bool MessageLoopTaskQueues::Merge(TaskQueueId owner, TaskQueueId subsumed) {
   if (owner == subsumed) {
     return true;
   }
-  std::lock_guard guard(queue_mutex_);
+  fml::UniqueLock lock(*queue_meta_mutex_);
   auto& owner_entry = queue_entries_.at(owner);
   auto& subsumed_entry = queue_entries_.at(subsumed);
   auto& subsumed_set = owner_entry->owner_of;
@@ -274,7 +314,7 @@ bool MessageLoopTaskQueues::Merge(TaskQueueId owner, TaskQueueId subsumed) {
 }
 
 bool MessageLoopTaskQueues::Unmerge(TaskQueueId owner, TaskQueueId subsumed) {
-  std::lock_guard guard(queue_mutex_);
+  fml::UniqueLock lock(*queue_meta_mutex_);
   const auto& owner_entry = queue_entries_.at(owner);
   if (owner_entry->owner_of.empty()) {
     FML_LOG(WARNING)
@@ -318,7 +358,7 @@ bool MessageLoopTaskQueues::Unmerge(TaskQueueId owner, TaskQueueId subsumed) {
 
 bool MessageLoopTaskQueues::Owns(TaskQueueId owner,
                                  TaskQueueId subsumed) const {
-  std::lock_guard guard(queue_mutex_);
+  fml::SharedLock lock(*queue_meta_mutex_);
   if (owner == _kUnmerged || subsumed == _kUnmerged) {
     return false;
   }
@@ -328,17 +368,19 @@ bool MessageLoopTaskQueues::Owns(TaskQueueId owner,
 
 std::set<TaskQueueId> MessageLoopTaskQueues::GetSubsumedTaskQueueId(
     TaskQueueId owner) const {
-  std::lock_guard guard(queue_mutex_);
+  fml::SharedLock lock(*queue_meta_mutex_);
   return queue_entries_.at(owner)->owner_of;
 }
 
 void MessageLoopTaskQueues::PauseSecondarySource(TaskQueueId queue_id) {
-  std::lock_guard guard(queue_mutex_);
+  fml::SharedLock lock(*queue_meta_mutex_);
+  TaskSourcesLock task_sources_lock(*this, queue_id);
   queue_entries_.at(queue_id)->task_source->PauseSecondary();
 }
 
 void MessageLoopTaskQueues::ResumeSecondarySource(TaskQueueId queue_id) {
-  std::lock_guard guard(queue_mutex_);
+  fml::SharedLock lock(*queue_meta_mutex_);
+  TaskSourcesLock task_sources_lock(*this, queue_id);
   queue_entries_.at(queue_id)->task_source->ResumeSecondary();
   // Schedule a wake as needed.
   if (HasPendingTasksUnlocked(queue_id)) {
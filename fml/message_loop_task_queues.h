@@ -45,6 +45,11 @@ class TaskQueueEntry {
 
   TaskQueueId created_for;
 
+  /// Guards \p task_source. When the task sources of merged TaskQueues are
+  /// used together, these mutexes are acquired in ascending TaskQueueId
+  /// order.
+  std::mutex task_source_mutex;
+
   explicit TaskQueueEntry(TaskQueueId created_for);
 
  private:
@@ -139,6 +144,7 @@ class MessageLoopTaskQueues
 
  private:
   class MergedQueuesRunner;
+  class TaskSourcesLock;
 
   MessageLoopTaskQueues();
 
@@ -155,7 +161,14 @@ class MessageLoopTaskQueues
   static std::mutex creation_mutex_;
   static fml::RefPtr<MessageLoopTaskQueues> instance_;
 
-  mutable std::mutex queue_mutex_;
+  // Guards the set of queues and everything about them except for their task
+  // sources: merge state, wakeables and observers. Registering and running
+  // tasks only takes this lock shared, along with the |task_source_mutex| of
+  // the queues involved, so loops on unrelated queues do not contend.
+  //
+  // The methods suffixed with "Unlocked" require either an exclusive lock of
+  // this mutex or a shared lock along with a |TaskSourcesLock| for the queue.
+  std::unique_ptr<fml::SharedMutex> queue_meta_mutex_;
   std::map<TaskQueueId, std::unique_ptr<TaskQueueEntry>> queue_entries_;
 
   size_t task_queue_id_counter_;
@@ -66,5 +66,67 @@ static void BM_RegisterAndGetTasks(benchmark::State& state) {  // NOLINT
 
 BENCHMARK(BM_RegisterAndGetTasks);
 
+// Each benchmark thread posts to and drains its own task queue, as the loops
+// of several engines in one process do. Only the bookkeeping shared by all of
+// the queues is contended.
+static void BM_RegisterAndGetTasksOnIndependentQueues(
+    benchmark::State& state) {  // NOLINT
+  auto task_queues = fml::MessageLoopTaskQueues::GetInstance();
+  const TaskQueueId queue_id = task_queues->CreateTaskQueue();
+  const fml::TimePoint past = fml::TimePoint::Now();
+  while (state.KeepRunning()) {
+    task_queues->RegisterTask(
+        queue_id, [] {}, past);
+    fml::closure invocation =
+        task_queues->GetNextTaskToRun(queue_id, fml::TimePoint::Now());
+    benchmark::DoNotOptimize(invocation);
+  }
+  task_queues->Dispose(queue_id);
+}
+
+BENCHMARK(BM_RegisterAndGetTasksOnIndependentQueues)
+    ->ThreadRange(1, 16)
+    ->UseRealTime();
+
+// All of the benchmark threads post to one task queue, as platform channel
+// traffic from several threads to the platform thread does, while the queue
+// is drained.
+static void BM_RegisterTasksOnSharedQueue(benchmark::State& state) {  // NOLINT
+  static const auto task_queues = fml::MessageLoopTaskQueues::GetInstance();
+  static const TaskQueueId queue_id = task_queues->CreateTaskQueue();
+  const fml::TimePoint past = fml::TimePoint::Now();
+  while (state.KeepRunning()) {
+    task_queues->RegisterTask(
+        queue_id, [] {}, past);
+    fml::closure invocation =
+        task_queues->GetNextTaskToRun(queue_id, fml::TimePoint::Now());
+    benchmark::DoNotOptimize(invocation);
+  }
+}
+
+BENCHMARK(BM_RegisterTasksOnSharedQueue)->ThreadRange(1, 16)->UseRealTime();
+
+// Benchmark threads post to queues that are merged into one owner, like the
+// platform and raster queues when platform views are present, while each
+// thread also drains the owner.
+static void BM_RegisterTasksOnMergedQueues(benchmark::State& state) {  // NOLINT
+  static const auto task_queues = fml::MessageLoopTaskQueues::GetInstance();
+  static const TaskQueueId owner = task_queues->CreateTaskQueue();
+  const TaskQueueId subsumed = task_queues->CreateTaskQueue();
+  task_queues->Merge(owner, subsumed);
+  const fml::TimePoint past = fml::TimePoint::Now();
+  while (state.KeepRunning()) {
+    task_queues->RegisterTask(
+        subsumed, [] {}, past);
+    fml::closure invocation =
+        task_queues->GetNextTaskToRun(owner, fml::TimePoint::Now());
+    benchmark::DoNotOptimize(invocation);
+  }
+  task_queues->Unmerge(owner, subsumed);
+  task_queues->Dispose(subsumed);
+}
+
+BENCHMARK(BM_RegisterTasksOnMergedQueues)->ThreadRange(1, 16)->UseRealTime();
+
 }  // namespace benchmarking
 }  // namespace fml
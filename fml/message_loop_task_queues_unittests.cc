@@ -411,6 +411,64 @@ TEST(MessageLoopTaskQueue, ConcurrentQueueAndTaskCreatingCounts) {
   ASSERT_EQ(pending_tasks, kThreadCount * kThreadTaskCount);
 }
 
+//------------------------------------------------------------------------------
+/// Verifies that tasks posted concurrently to merged task queues while the
+/// owner drains them run in the order each thread posted them.
+///
+TEST(MessageLoopTaskQueue, ConcurrentRegisterTaskKeepsOrdering) {
+  auto task_queues = fml::MessageLoopTaskQueues::GetInstance();
+  auto owner = task_queues->CreateTaskQueue();
+  auto subsumed = task_queues->CreateTaskQueue();
+  ASSERT_TRUE(task_queues->Merge(owner, subsumed));
+
+  constexpr size_t kThreadCount = 4;
+  constexpr size_t kThreadTaskCount = 500;
+
+  // Only the draining thread runs the tasks, so these need no locking.
+  std::vector<std::vector<size_t>> ran_tasks(kThreadCount);
+  size_t ran_task_count = 0;
+
+  const auto task_timepoint = ChronoTicksSinceEpoch();
+  auto thread_main = [&](size_t thread_index) {
+    const auto queue_id = thread_index % 2 == 0 ? owner : subsumed;
+    for (size_t i = 0; i < kThreadTaskCount; i++) {
+      task_queues->RegisterTask(
+          queue_id,
+          [&ran_tasks, &ran_task_count, thread_index, i]() {
+            ran_tasks[thread_index].push_back(i);
+            ran_task_count++;
+          },
+          task_timepoint);
+    }
+  };
+
+  std::thread drain_thread([&]() {
+    while (ran_task_count < kThreadCount * kThreadTaskCount) {
+      auto invocation =
+          task_queues->GetNextTaskToRun(owner, ChronoTicksSinceEpoch());
+      if (invocation) {
+        invocation();
+      }
+    }
+  });
+
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < kThreadCount; i++) {
+    threads.emplace_back(thread_main, i);
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  drain_thread.join();
+
+  for (const auto& thread_tasks : ran_tasks) {
+    ASSERT_EQ(thread_tasks.size(), kThreadTaskCount);
+    ASSERT_TRUE(std::is_sorted(thread_tasks.begin(), thread_tasks.end()));
+  }
+  ASSERT_FALSE(task_queues->HasPendingTasks(owner));
+  ASSERT_TRUE(task_queues->Unmerge(owner, subsumed));
+}
+
 TEST(MessageLoopTaskQueue, RegisterTaskWakesUpOwnerQueue) {
   auto task_queue = fml::MessageLoopTaskQueues::GetInstance();
   auto platform_queue = task_queue->CreateTaskQueue();
@@ -6,8 +6,12 @@
 
 #include "flutter/fml/message_loop.h"
 
+#include <atomic>
 #include <iostream>
+#include <mutex>
+#include <set>
 #include <thread>
+#include <vector>
 
 #include "flutter/fml/build_config.h"
 #include "flutter/fml/concurrent_message_loop.h"
@@ -317,3 +321,73 @@ TEST(MessageLoop, CanCreateConcurrentMessageLoop) {
   latch.Wait();
   ASSERT_GE(thread_ids.size(), 1u);
 }
+
+TEST(MessageLoop, ConcurrentParallelForVisitsEveryIndexOnce) {
+  auto loop = fml::ConcurrentMessageLoop::Create(4);
+  auto task_runner = loop->GetTaskRunner();
+  const size_t kCount = 1000;
+  std::vector<std::atomic_size_t> visits(kCount);
+  task_runner->ParallelFor(kCount, [&](size_t index) { visits[index]++; });
+  for (size_t i = 0; i < kCount; ++i) {
+    ASSERT_EQ(visits[i], 1u);
+  }
+}
+
+TEST(MessageLoop, ConcurrentParallelForCanBeCalledFromWorker) {
+  auto loop = fml::ConcurrentMessageLoop::Create(2);
+  auto task_runner = loop->GetTaskRunner();
+  const size_t kCount = 100;
+  std::atomic_size_t sum = 0;
+  fml::AutoResetWaitableEvent done;
+  task_runner->PostTask([&]() {
+    // Every worker is busy with a nested loop, which must still finish.
+    task_runner->ParallelFor(2, [&](size_t) {
+      task_runner->ParallelFor(kCount, [&](size_t index) { sum += index; });
+    });
+    done.Signal();
+  });
+  done.Wait();
+  ASSERT_EQ(sum, 2 * kCount * (kCount - 1) / 2);
+}
+
+TEST(MessageLoop, ConcurrentTasksWithAffinityAllRun) {
+  auto loop = fml::ConcurrentMessageLoop::Create(3);
+  auto task_runner = loop->GetTaskRunner();
+  const size_t kCount = 100;
+  fml::CountDownLatch latch(kCount);
+  for (size_t i = 0; i < kCount; ++i) {
+    task_runner->PostTaskWithAffinity(i, [&latch]() { latch.CountDown(); });
+  }
+  latch.Wait();
+}
+
+TEST(MessageLoop, ConcurrentTasksPostedFromWorkerCanBeStolen) {
+  auto loop = fml::ConcurrentMessageLoop::Create(4);
+  auto task_runner = loop->GetTaskRunner();
+  const size_t kCount = 16;
+  fml::CountDownLatch latch(kCount);
+  fml::ManualResetWaitableEvent stolen;
+  std::thread::id poster_id;
+  std::mutex thread_ids_mutex;
+  std::set<std::thread::id> thread_ids;
+  task_runner->PostTask([&]() {
+    poster_id = std::this_thread::get_id();
+    // These are all queued on this worker, which is blocked until another
+    // worker has run one of them.
+    for (size_t i = 0; i < kCount; ++i) {
+      task_runner->PostTask([&]() {
+        {
+          std::scoped_lock lock(thread_ids_mutex);
+          thread_ids.insert(std::this_thread::get_id());
+        }
+        stolen.Signal();
+        latch.CountDown();
+      });
+    }
+    stolen.Wait();
+  });
+  latch.Wait();
+  std::scoped_lock lock(thread_ids_mutex);
+  thread_ids.erase(poster_id);
+  ASSERT_GE(thread_ids.size(), 1u);
+}
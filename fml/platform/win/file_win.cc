@@ -378,6 +378,55 @@ bool TruncateFile(const fml::UniqueFD& file, size_t size) {
   return true;
 }
 
+std::optional<size_t> GetFileSize(const fml::UniqueFD& file) {
+  LARGE_INTEGER large_size;
+  if (!::GetFileSizeEx(file.get(), &large_size)) {
+    FML_DLOG(ERROR) << "Could not get file size. " << GetLastErrorMessage();
+    return std::nullopt;
+  }
+  return static_cast<size_t>(large_size.QuadPart);
+}
+
+bool WriteFileAt(const fml::UniqueFD& file,
+                 size_t offset,
+                 const uint8_t* data,
+                 size_t size) {
+  while (size > 0) {
+    OVERLAPPED overlapped = {};
+    LARGE_INTEGER large_offset;
+    large_offset.QuadPart = offset;
+    overlapped.Offset = large_offset.LowPart;
+    overlapped.OffsetHigh = large_offset.HighPart;
+    DWORD written = 0;
+    if (!::WriteFile(file.get(), data,
+                     static_cast<DWORD>(std::min<size_t>(size, MAXDWORD)),
+                     &written, &overlapped) ||
+        written == 0) {
+      FML_DLOG(ERROR) << "Could not write to file. " << GetLastErrorMessage();
+      return false;
+    }
+    data += written;
+    size -= written;
+    offset += written;
+  }
+  return true;
+}
+
+bool LockFile(const fml::UniqueFD& file) {
+  OVERLAPPED overlapped = {};
+  if (!::LockFileEx(file.get(), LOCKFILE_EXCLUSIVE_LOCK, 0, MAXDWORD, MAXDWORD,
+                    &overlapped)) {
+    FML_DLOG(ERROR) << "Could not lock file. " << GetLastErrorMessage();
+    return false;
+  }
+  return true;
+}
+
+bool UnlockFile(const fml::UniqueFD& file) {
+  OVERLAPPED overlapped = {};
+  return ::UnlockFileEx(file.get(), 0, MAXDWORD, MAXDWORD, &overlapped);
+}
+
 bool FileExists(const fml::UniqueFD& base_directory, const char* path) {
   return GetFileAttributesForUtf8Path(base_directory, path) !=
          INVALID_FILE_ATTRIBUTES;
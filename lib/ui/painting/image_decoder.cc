@@ -5,6 +5,7 @@
 #include "flutter/lib/ui/painting/image_decoder.h"
 
 #include <algorithm>
+#include <mutex>
 
 #include "flutter/fml/make_copyable.h"
 #include "third_party/skia/include/codec/SkCodec.h"
@@ -216,6 +217,48 @@ static SkiaGPUObject<SkImage> UploadRasterImage(
   return result;
 }
 
+using UploadResult =
+    std::function<void(SkiaGPUObject<SkImage>, fml::tracing::TraceFlow)>;
+
+// Uploads |image| to the GPU on the IO thread, if there is a resource context
+// to upload it with, and hands the result, or an empty image on failure, to
+// |result| on the IO thread.
+static void UploadOnIOThread(const fml::RefPtr<fml::TaskRunner>& io_runner,
+                             fml::WeakPtr<IOManager> io_manager,
+                             sk_sp<SkImage> image,
+                             UploadResult result,
+                             fml::tracing::TraceFlow flow) {
+  io_runner->PostTask(fml::MakeCopyable(
+      [io_manager = std::move(io_manager), image = std::move(image),
+       result = std::move(result), flow = std::move(flow)]() mutable {
+        if (!io_manager) {
+          FML_DLOG(ERROR) << "Could not acquire IO manager.";
+          result({}, std::move(flow));
+          return;
+        }
+
+        // If the IO manager does not have a resource context, the caller
+        // might not have set one or a software backend could be in use.
+        // Either way, just return the image as-is.
+        if (!io_manager->GetResourceContext()) {
+          result({std::move(image), io_manager->GetSkiaUnrefQueue()},
+                 std::move(flow));
+          return;
+        }
+
+        auto uploaded = UploadRasterImage(std::move(image), io_manager, flow);
+
+        if (!uploaded.skia_object()) {
+          FML_DLOG(ERROR) << "Could not upload image to the GPU.";
+          result({}, std::move(flow));
+          return;
+        }
+
+        // Finally, all done.
+        result(std::move(uploaded), std::move(flow));
+      }));
+}
+
 void ImageDecoder::Decode(fml::RefPtr<ImageDescriptor> descriptor_ref_ptr,
                           uint32_t target_width,
                           uint32_t target_height,
@@ -293,38 +336,313 @@ void ImageDecoder::Decode(fml::RefPtr<ImageDescriptor> descriptor_ref_ptr,
 
         // Step 2: Update the image to the GPU.
         // On IO Thread.
+        UploadOnIOThread(io_runner, io_manager, std::move(decompressed), result,
+                         std::move(flow));
+      }));
+}
+
+// Decodes an image from an |IncrementalImageSource| as its bytes arrive. Each
+// time the source changes, a decode step is scheduled on a worker. Steps never
+// overlap. Images are uploaded on the IO thread in the order they are decoded,
+// and |result| receives them on the IO thread.
+class IncrementalImageDecode
+    : public std::enable_shared_from_this<IncrementalImageDecode> {
+ public:
+  IncrementalImageDecode(
+      std::shared_ptr<IncrementalImageSource> source,
+      SkISize target_size,
+      std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner,
+      fml::RefPtr<fml::TaskRunner> io_runner,
+      fml::WeakPtr<IOManager> io_manager,
+      ImageDecoder::ProgressiveImageResult result)
+      : source_(std::move(source)),
+        target_size_(target_size),
+        concurrent_task_runner_(std::move(concurrent_task_runner)),
+        io_runner_(std::move(io_runner)),
+        io_manager_(std::move(io_manager)),
+        result_(std::move(result)) {}
+
+  void Start() {
+    // The source keeps this decode alive until it completes, at which point
+    // the observer is cleared.
+    source_->SetObserver(
+        [decode = shared_from_this()]() { decode->ScheduleStep(); });
+    ScheduleStep();
+  }
+
+ private:
+  // Incremental codecs are decoded into at most this many partial images.
+  static constexpr int kMaxPartialImages = 8;
+
+  // Codecs that cannot decode incrementally only produce a partial image once
+  // at least this many bytes have arrived.
+  static constexpr size_t kMinPartialDecodeSize = 16 * 1024;
+
+  const std::shared_ptr<IncrementalImageSource> source_;
+  const SkISize target_size_;
+  const std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner_;
+  const fml::RefPtr<fml::TaskRunner> io_runner_;
+  const fml::WeakPtr<IOManager> io_manager_;
+  const ImageDecoder::ProgressiveImageResult result_;
+
+  std::mutex step_mutex_;
+  bool step_scheduled_ = false;
+  bool step_requested_ = false;
+
+  // Only accessed by decode steps.
+  bool done_ = false;
+  std::unique_ptr<SkCodec> codec_;
+  bool incremental_decode_started_ = false;
+  bool codec_is_incremental_ = true;
+  SkBitmap bitmap_;
+  int delivered_rows_ = 0;
+  size_t last_partial_decode_size_ = 0;
+
+  void ScheduleStep() {
+    {
+      std::scoped_lock lock(step_mutex_);
+      if (step_scheduled_) {
+        // The running step will go around again.
+        step_requested_ = true;
+        return;
+      }
+      step_scheduled_ = true;
+    }
+    concurrent_task_runner_->PostTask(
+        [decode = shared_from_this()]() { decode->RunSteps(); });
+  }
+
+  void RunSteps() {
+    while (true) {
+      {
+        std::scoped_lock lock(step_mutex_);
+        step_requested_ = false;
+      }
+      if (!done_) {
+        Step();
+      }
+      std::scoped_lock lock(step_mutex_);
+      if (!step_requested_ || done_) {
+        step_scheduled_ = false;
+        return;
+      }
+    }
+  }
+
+  void Step() {
+    TRACE_EVENT0("flutter", "IncrementalImageDecode::Step");
+    // Read before decoding so that bytes arriving during the step schedule
+    // another one.
+    const auto state = source_->GetState();
+    if (state == IncrementalImageSource::State::kAbandoned) {
+      Fail("The image source was abandoned.");
+      return;
+    }
+
+    if (codec_is_incremental_) {
+      StepIncrementalCodec(state);
+    } else {
+      StepNonIncrementalCodec(state);
+    }
+  }
+
+  void StepIncrementalCodec(IncrementalImageSource::State state) {
+    const bool receiving = state == IncrementalImageSource::State::kReceiving;
+
+    if (!codec_) {
+      if (receiving &&
+          source_->GetReceivedSize() < SkCodec::MinBufferedBytesNeeded()) {
+        return;
+      }
+      SkCodec::Result codec_result;
+      codec_ = SkCodec::MakeFromStream(source_->CreateStream(), &codec_result);
+      if (!codec_) {
+        if (!receiving || codec_result != SkCodec::kIncompleteInput) {
+          Fail("Could not create a codec for the image.");
+        }
+        return;
+      }
+    }
+
+    if (!incremental_decode_started_) {
+      SkImageInfo info = codec_->getInfo().makeColorType(kN32_SkColorType);
+      if (info.alphaType() == kUnpremul_SkAlphaType) {
+        info = info.makeAlphaType(kPremul_SkAlphaType);
+      }
+      if (!bitmap_.tryAllocPixels(info)) {
+        Fail("Failed to allocate memory for the decoded image.");
+        return;
+      }
+      // Rows that haven't been decoded yet are shown as transparent.
+      bitmap_.eraseColor(SK_ColorTRANSPARENT);
+
+      const auto start_result = codec_->startIncrementalDecode(
+          bitmap_.info(), bitmap_.getPixels(), bitmap_.rowBytes());
+      if (start_result == SkCodec::kUnimplemented) {
+        codec_.reset();
+        bitmap_.reset();
+        codec_is_incremental_ = false;
+        StepNonIncrementalCodec(state);
+        return;
+      }
+      if (start_result == SkCodec::kIncompleteInput && receiving) {
+        return;
+      }
+      if (start_result != SkCodec::kSuccess) {
+        Fail("Could not start decoding the image.");
+        return;
+      }
+      incremental_decode_started_ = true;
+      // The codec reads each byte once from here on, so the bytes it has
+      // consumed are no longer needed.
+      source_->DiscardConsumedBytes();
+    }
+
+    int rows_decoded = 0;
+    const auto decode_result = codec_->incrementalDecode(&rows_decoded);
+    if (decode_result == SkCodec::kSuccess) {
+      // The partial images were copies, so the pixels can be handed over
+      // as they are.
+      bitmap_.setImmutable();
+      Deliver(SkImage::MakeFromBitmap(bitmap_), true);
+      return;
+    }
+
+    if (decode_result != SkCodec::kIncompleteInput &&
+        decode_result != SkCodec::kErrorInInput) {
+      Fail("Could not decode the image.");
+      return;
+    }
+
+    if (!receiving) {
+      // Like |SkCodec::getPixels|, treat a truncated image as complete.
+      bitmap_.setImmutable();
+      Deliver(SkImage::MakeFromBitmap(bitmap_), true);
+      return;
+    }
+
+    const int row_step = std::max(bitmap_.height() / kMaxPartialImages, 1);
+    if (rows_decoded >= delivered_rows_ + row_step) {
+      delivered_rows_ = rows_decoded;
+      Deliver(SkImage::MakeRasterCopy(bitmap_.pixmap()), false);
+    }
+  }
+
+  void StepNonIncrementalCodec(IncrementalImageSource::State state) {
+    if (state == IncrementalImageSource::State::kComplete) {
+      sk_sp<SkImage> image =
+          SkImage::MakeFromEncoded(source_->CopyReceivedBytes());
+      image = image ? image->makeRasterImage() : nullptr;
+      if (!image) {
+        Fail("Could not decode the image.");
+        return;
+      }
+      Deliver(std::move(image), true);
+      return;
+    }
+
+    // Decoding from the start each time the received size doubles keeps the
+    // total decode cost within twice that of decoding once.
+    const size_t received_size = source_->GetReceivedSize();
+    if (received_size <
+        std::max(kMinPartialDecodeSize, 2 * last_partial_decode_size_)) {
+      return;
+    }
+    last_partial_decode_size_ = received_size;
+
+    auto codec = SkCodec::MakeFromData(source_->CopyReceivedBytes());
+    // The complete image is oriented by |SkImage::MakeFromEncoded|. Rather
+    // than orient partial images by hand, skip them for rotated images.
+    if (!codec || codec->getOrigin() != kTopLeft_SkEncodedOrigin) {
+      return;
+    }
+    SkImageInfo info = codec->getInfo().makeColorType(kN32_SkColorType);
+    if (info.alphaType() == kUnpremul_SkAlphaType) {
+      info = info.makeAlphaType(kPremul_SkAlphaType);
+    }
+    SkBitmap bitmap;
+    if (!bitmap.tryAllocPixels(info)) {
+      return;
+    }
+    const auto decode_result =
+        codec->getPixels(bitmap.info(), bitmap.getPixels(), bitmap.rowBytes());
+    if (decode_result != SkCodec::kSuccess &&
+        decode_result != SkCodec::kIncompleteInput &&
+        decode_result != SkCodec::kErrorInInput) {
+      return;
+    }
+    bitmap.setImmutable();
+    Deliver(SkImage::MakeFromBitmap(bitmap), false);
+  }
+
+  void Deliver(sk_sp<SkImage> image, bool is_final) {
+    fml::tracing::TraceFlow flow("IncrementalImageDecode");
+    if (image && !target_size_.isEmpty()) {
+      image = ResizeRasterImage(std::move(image), target_size_, flow);
+    }
+    if (!image) {
+      Fail("Could not resize the image.");
+      return;
+    }
+    if (is_final) {
+      Complete();
+    }
+    UploadOnIOThread(
+        io_runner_, io_manager_, std::move(image),
+        [result = result_, is_final](SkiaGPUObject<SkImage> uploaded,
+                                     fml::tracing::TraceFlow upload_flow) {
+          upload_flow.End();
+          result(std::move(uploaded), is_final);
+        },
+        std::move(flow));
+  }
+
+  void Fail(const char* reason) {
+    FML_DLOG(ERROR) << reason;
+    Complete();
+    // Deliver the error through the IO thread so that it arrives after any
+    // partial images that are still being uploaded.
+    io_runner_->PostTask([result = result_]() { result({}, true); });
+  }
+
+  void Complete() {
+    done_ = true;
+    codec_.reset();
+    source_->SetObserver(nullptr);
+  }
+
+  FML_DISALLOW_COPY_AND_ASSIGN(IncrementalImageDecode);
+};
 
-        io_runner->PostTask(fml::MakeCopyable([io_manager, decompressed, result,
-                                               flow =
-                                                   std::move(flow)]() mutable {
-          if (!io_manager) {
-            FML_DLOG(ERROR) << "Could not acquire IO manager.";
-            result({}, std::move(flow));
-            return;
-          }
-
-          // If the IO manager does not have a resource context, the caller
-          // might not have set one or a software backend could be in use.
-          // Either way, just return the image as-is.
-          if (!io_manager->GetResourceContext()) {
-            result({std::move(decompressed), io_manager->GetSkiaUnrefQueue()},
-                   std::move(flow));
-            return;
-          }
-
-          auto uploaded =
-              UploadRasterImage(std::move(decompressed), io_manager, flow);
-
-          if (!uploaded.skia_object()) {
-            FML_DLOG(ERROR) << "Could not upload image to the GPU.";
-            result({}, std::move(flow));
-            return;
-          }
-
-          // Finally, all done.
-          result(std::move(uploaded), std::move(flow));
+void ImageDecoder::DecodeIncremental(
+    std::shared_ptr<IncrementalImageSource> source,
+    uint32_t target_width,
+    uint32_t target_height,
+    const ProgressiveImageResult& callback) {
+  TRACE_EVENT0("flutter", __FUNCTION__);
+  FML_DCHECK(callback);
+  FML_DCHECK(runners_.GetUITaskRunner()->RunsTasksOnCurrentThread());
+
+  // Always service the callback on the UI thread.
+  auto result = [callback, ui_runner = runners_.GetUITaskRunner()](
+                    SkiaGPUObject<SkImage> image, bool is_final) {
+    ui_runner->PostTask(fml::MakeCopyable(
+        [callback, image = std::move(image), is_final]() mutable {
+          TRACE_EVENT0("flutter", "ImageDecodeCallback");
+          callback(std::move(image), is_final);
         }));
-      }));
+  };
+
+  if (!source) {
+    result({}, true);
+    return;
+  }
+
+  auto decode = std::make_shared<IncrementalImageDecode>(
+      std::move(source), SkISize::Make(target_width, target_height),
+      concurrent_task_runner_, runners_.GetIOTaskRunner(), io_manager_,
+      std::move(result));
+  decode->Start();
 }
 
 fml::WeakPtr<ImageDecoder> ImageDecoder::GetWeakPtr() const {
@@ -16,6 +16,7 @@
 #include "flutter/fml/trace_event.h"
 #include "flutter/lib/ui/io_manager.h"
 #include "flutter/lib/ui/painting/image_descriptor.h"
+#include "flutter/lib/ui/painting/incremental_image_source.h"
 #include "third_party/skia/include/core/SkData.h"
 #include "third_party/skia/include/core/SkImage.h"
 #include "third_party/skia/include/core/SkImageInfo.h"
@@ -50,6 +51,28 @@ class ImageDecoder {
               uint32_t target_height,
               const ImageResult& result);
 
+  // Receives the images produced by |DecodeIncremental|. Partially decoded
+  // images are delivered with |is_final| set to false. The last image has
+  // |is_final| set to true and is either the complete image or, on error,
+  // null.
+  using ProgressiveImageResult =
+      std::function<void(SkiaGPUObject<SkImage> image, bool is_final)>;
+
+  // Decodes an image while its encoded bytes are still arriving through
+  // |source|, delivering partially decoded images along the way. The threads
+  // involved are the same as for |Decode|, and every image is delivered on the
+  // UI thread.
+  //
+  // Formats with incremental codecs, such as PNG and GIF, decode each byte once
+  // as it arrives. The final image is the buffer that the partial images were
+  // copied from, and bytes are freed once decoded. Other formats are decoded
+  // from the start each time the received size doubles, and once more when
+  // the source completes.
+  void DecodeIncremental(std::shared_ptr<IncrementalImageSource> source,
+                         uint32_t target_width,
+                         uint32_t target_height,
+                         const ProgressiveImageResult& result);
+
   fml::WeakPtr<ImageDecoder> GetWeakPtr() const;
 
  private:
@@ -4,9 +4,13 @@
 
 #include "flutter/lib/ui/painting/image_decoder.h"
 
+#include <algorithm>
+#include <cstring>
+
 #include "flutter/common/task_runners.h"
 #include "flutter/fml/mapping.h"
 #include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/lib/ui/painting/incremental_image_source.h"
 #include "flutter/lib/ui/painting/multi_frame_codec.h"
 #include "flutter/runtime/dart_vm.h"
 #include "flutter/runtime/dart_vm_lifecycle.h"
@@ -450,6 +454,176 @@ TEST_F(ImageDecoderFixtureTest, CanDecodeWithResizes) {
   PostTaskSync(runners.GetUITaskRunner(), [&]() { image_decoder.reset(); });
 }
 
+TEST(IncrementalImageSourceTest, StreamsReadBytesAsTheyArrive) {
+  auto source = std::make_shared<IncrementalImageSource>();
+  auto stream = source->CreateStream();
+  uint8_t buffer[8] = {};
+
+  ASSERT_EQ(stream->read(buffer, sizeof(buffer)), 0u);
+  ASSERT_FALSE(stream->isAtEnd());
+
+  source->Append(SkData::MakeWithCString("abc"));
+  source->Append(SkData::MakeWithCString("de"));
+  ASSERT_EQ(stream->peek(buffer, 2), 2u);
+  ASSERT_EQ(memcmp(buffer, "ab", 2), 0);
+  // Each chunk includes the null terminator.
+  ASSERT_EQ(stream->read(buffer, sizeof(buffer)), 7u);
+  ASSERT_EQ(memcmp(buffer, "abc\0de\0", 7), 0);
+  ASSERT_FALSE(stream->isAtEnd());
+
+  source->Finish();
+  ASSERT_TRUE(stream->isAtEnd());
+  ASSERT_TRUE(stream->rewind());
+  ASSERT_EQ(source->CopyReceivedBytes()->size(), 7u);
+}
+
+TEST(IncrementalImageSourceTest, DiscardsConsumedChunks) {
+  auto source = std::make_shared<IncrementalImageSource>();
+  auto stream = source->CreateStream();
+  source->DiscardConsumedBytes();
+  source->Append(SkData::MakeWithCString("abc"));
+  source->Append(SkData::MakeWithCString("de"));
+
+  uint8_t buffer[8] = {};
+  ASSERT_EQ(stream->read(buffer, 5), 5u);
+  ASSERT_FALSE(stream->rewind());
+  ASSERT_EQ(source->CopyReceivedBytes(), nullptr);
+  ASSERT_EQ(stream->read(buffer, sizeof(buffer)), 2u);
+  ASSERT_EQ(memcmp(buffer, "e\0", 2), 0);
+}
+
+namespace {
+
+struct IncrementalDecodeResult {
+  SkISize final_size = SkISize::MakeEmpty();
+  bool has_final_image = false;
+  size_t partial_image_count = 0;
+  bool final_image_was_last = true;
+};
+
+}  // namespace
+
+// Decodes the fixture while appending it to an incremental source in chunks,
+// then either finishes or abandons the source. Each chunk is decoded before
+// the next one is appended, so that partial images are always produced.
+static IncrementalDecodeResult DecodeIncrementally(const TaskRunners& runners,
+                                                   const char* fixture,
+                                                   size_t chunk_size,
+                                                   bool finish) {
+  // A single worker runs the decode steps in the order they were posted.
+  auto loop = fml::ConcurrentMessageLoop::Create(1);
+  std::unique_ptr<IOManager> io_manager;
+  std::unique_ptr<ImageDecoder> image_decoder;
+
+  PostTaskSync(runners.GetIOTaskRunner(), [&]() {
+    io_manager = std::make_unique<TestIOManager>(runners.GetIOTaskRunner());
+  });
+  PostTaskSync(runners.GetUITaskRunner(), [&]() {
+    image_decoder = std::make_unique<ImageDecoder>(
+        runners, loop->GetTaskRunner(), io_manager->GetWeakIOManager());
+  });
+
+  auto data = OpenFixtureAsSkData(fixture);
+  FML_CHECK(data);
+  auto source = std::make_shared<IncrementalImageSource>();
+  IncrementalDecodeResult result;
+  bool received_final_image = false;
+  fml::AutoResetWaitableEvent latch;
+
+  PostTaskSync(runners.GetUITaskRunner(), [&]() {
+    image_decoder->DecodeIncremental(
+        source, 0, 0, [&](SkiaGPUObject<SkImage> image, bool is_final) {
+          EXPECT_TRUE(runners.GetUITaskRunner()->RunsTasksOnCurrentThread());
+          if (received_final_image) {
+            result.final_image_was_last = false;
+            return;
+          }
+          if (!is_final) {
+            EXPECT_TRUE(image.skia_object());
+            result.partial_image_count++;
+            return;
+          }
+          received_final_image = true;
+          if (image.skia_object()) {
+            result.has_final_image = true;
+            result.final_size = image.skia_object()->dimensions();
+          }
+          latch.Signal();
+        });
+  });
+
+  for (size_t offset = 0; offset < data->size(); offset += chunk_size) {
+    if (!finish && offset + chunk_size >= data->size()) {
+      break;
+    }
+    const size_t size = std::min(chunk_size, data->size() - offset);
+    source->Append(SkData::MakeSubset(data.get(), offset, size));
+    // Wait for the step scheduled by the append to finish.
+    fml::AutoResetWaitableEvent step_latch;
+    loop->GetTaskRunner()->PostTask([&step_latch]() { step_latch.Signal(); });
+    step_latch.Wait();
+  }
+  if (finish) {
+    source->Finish();
+  } else {
+    source->Abandon();
+  }
+  latch.Wait();
+
+  // Flush any images delivered after the final one.
+  PostTaskSync(runners.GetIOTaskRunner(), []() {});
+  PostTaskSync(runners.GetUITaskRunner(), [&]() { image_decoder.reset(); });
+  PostTaskSync(runners.GetIOTaskRunner(), [&]() { io_manager.reset(); });
+  return result;
+}
+
+TEST_F(ImageDecoderFixtureTest, CanDecodeIncrementalCodecsIncrementally) {
+  TaskRunners runners(GetCurrentTestName(),         // label
+                      CreateNewThread("platform"),  // platform
+                      CreateNewThread("raster"),    // raster
+                      CreateNewThread("ui"),        // ui
+                      CreateNewThread("io")         // io
+  );
+  const auto expected_size =
+      SkImage::MakeFromEncoded(OpenFixtureAsSkData("Horizontal.png"))
+          ->dimensions();
+
+  auto result = DecodeIncrementally(runners, "Horizontal.png", 1024, true);
+  ASSERT_TRUE(result.has_final_image);
+  ASSERT_EQ(result.final_size, expected_size);
+  ASSERT_TRUE(result.final_image_was_last);
+  EXPECT_GT(result.partial_image_count, 0u);
+}
+
+TEST_F(ImageDecoderFixtureTest, CanDecodeNonIncrementalCodecsIncrementally) {
+  TaskRunners runners(GetCurrentTestName(),         // label
+                      CreateNewThread("platform"),  // platform
+                      CreateNewThread("raster"),    // raster
+                      CreateNewThread("ui"),        // ui
+                      CreateNewThread("io")         // io
+  );
+
+  auto result =
+      DecodeIncrementally(runners, "DashInNooglerHat.jpg", 64 * 1024, true);
+  ASSERT_TRUE(result.has_final_image);
+  ASSERT_EQ(result.final_size, SkISize::Make(3024, 4032));
+  ASSERT_TRUE(result.final_image_was_last);
+  EXPECT_GT(result.partial_image_count, 0u);
+}
+
+TEST_F(ImageDecoderFixtureTest, AbandonedIncrementalDecodeResultsInError) {
+  TaskRunners runners(GetCurrentTestName(),         // label
+                      CreateNewThread("platform"),  // platform
+                      CreateNewThread("raster"),    // raster
+                      CreateNewThread("ui"),        // ui
+                      CreateNewThread("io")         // io
+  );
+
+  auto result = DecodeIncrementally(runners, "Horizontal.png", 1024, false);
+  ASSERT_FALSE(result.has_final_image);
+  ASSERT_TRUE(result.final_image_was_last);
+}
+
 // TODO(https://github.com/flutter/flutter/issues/81232) - disabled due to
 // flakiness
 TEST_F(ImageDecoderFixtureTest, DISABLED_CanResizeWithoutDecode) {
@@ -0,0 +1,197 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/incremental_image_source.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "flutter/fml/logging.h"
+
+namespace flutter {
+
+class IncrementalImageSource::Stream final : public SkStream {
+ public:
+  explicit Stream(std::shared_ptr<IncrementalImageSource> source)
+      : source_(std::move(source)) {}
+
+  ~Stream() override = default;
+
+  // |SkStream|
+  size_t read(void* buffer, size_t size) override {
+    size_t read_size;
+    if (buffer == nullptr) {
+      // Skipping ahead is limited to the bytes received so far.
+      read_size = std::min(size, source_->GetReceivedSize() - position_);
+    } else {
+      read_size = source_->Read(position_, buffer, size);
+    }
+    position_ += read_size;
+    source_->DidConsume(position_);
+    return read_size;
+  }
+
+  // |SkStream|
+  size_t peek(void* buffer, size_t size) const override {
+    return source_->Read(position_, buffer, size);
+  }
+
+  // |SkStream|
+  bool isAtEnd() const override {
+    return source_->GetState() != State::kReceiving &&
+           position_ >= source_->GetReceivedSize();
+  }
+
+  // |SkStream|
+  bool rewind() override {
+    if (!source_->CanRewind()) {
+      return false;
+    }
+    position_ = 0;
+    return true;
+  }
+
+ private:
+  const std::shared_ptr<IncrementalImageSource> source_;
+  size_t position_ = 0;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(Stream);
+};
+
+IncrementalImageSource::IncrementalImageSource() = default;
+
+IncrementalImageSource::~IncrementalImageSource() = default;
+
+void IncrementalImageSource::Append(sk_sp<SkData> bytes) {
+  if (!bytes || bytes->size() == 0) {
+    return;
+  }
+  {
+    std::scoped_lock lock(mutex_);
+    if (state_ != State::kReceiving) {
+      FML_DLOG(ERROR) << "Bytes appended to a finished image source.";
+      return;
+    }
+    received_size_ += bytes->size();
+    chunks_.emplace_back(std::move(bytes));
+  }
+  NotifyObserver();
+}
+
+void IncrementalImageSource::Finish() {
+  {
+    std::scoped_lock lock(mutex_);
+    if (state_ != State::kReceiving) {
+      return;
+    }
+    state_ = State::kComplete;
+  }
+  NotifyObserver();
+}
+
+void IncrementalImageSource::Abandon() {
+  {
+    std::scoped_lock lock(mutex_);
+    if (state_ != State::kReceiving) {
+      return;
+    }
+    state_ = State::kAbandoned;
+  }
+  NotifyObserver();
+}
+
+IncrementalImageSource::State IncrementalImageSource::GetState() const {
+  std::scoped_lock lock(mutex_);
+  return state_;
+}
+
+size_t IncrementalImageSource::GetReceivedSize() const {
+  std::scoped_lock lock(mutex_);
+  return received_size_;
+}
+
+void IncrementalImageSource::SetObserver(fml::closure observer) {
+  std::scoped_lock lock(mutex_);
+  observer_ = std::move(observer);
+}
+
+std::unique_ptr<SkStream> IncrementalImageSource::CreateStream() {
+  FML_DCHECK(CanRewind())
+      << "Bytes of this image source have already been discarded.";
+  return std::make_unique<Stream>(shared_from_this());
+}
+
+void IncrementalImageSource::DiscardConsumedBytes() {
+  std::scoped_lock lock(mutex_);
+  discard_consumed_bytes_ = true;
+}
+
+sk_sp<SkData> IncrementalImageSource::CopyReceivedBytes() const {
+  std::scoped_lock lock(mutex_);
+  if (discarded_size_ != 0) {
+    return nullptr;
+  }
+  sk_sp<SkData> data = SkData::MakeUninitialized(received_size_);
+  uint8_t* destination = static_cast<uint8_t*>(data->writable_data());
+  for (const auto& chunk : chunks_) {
+    memcpy(destination, chunk->data(), chunk->size());
+    destination += chunk->size();
+  }
+  return data;
+}
+
+size_t IncrementalImageSource::Read(size_t offset,
+                                    void* buffer,
+                                    size_t size) const {
+  std::scoped_lock lock(mutex_);
+  FML_DCHECK(offset >= discarded_size_);
+  size_t chunk_offset = discarded_size_;
+  size_t copied = 0;
+  for (const auto& chunk : chunks_) {
+    if (copied == size) {
+      break;
+    }
+    const size_t chunk_end = chunk_offset + chunk->size();
+    if (chunk_end > offset) {
+      const size_t start = offset - chunk_offset;
+      const size_t length = std::min(chunk->size() - start, size - copied);
+      memcpy(static_cast<uint8_t*>(buffer) + copied, chunk->bytes() + start,
+             length);
+      copied += length;
+      offset += length;
+    }
+    chunk_offset = chunk_end;
+  }
+  return copied;
+}
+
+void IncrementalImageSource::DidConsume(size_t offset) {
+  std::scoped_lock lock(mutex_);
+  if (!discard_consumed_bytes_) {
+    return;
+  }
+  while (!chunks_.empty() &&
+         discarded_size_ + chunks_.front()->size() <= offset) {
+    discarded_size_ += chunks_.front()->size();
+    chunks_.pop_front();
+  }
+}
+
+bool IncrementalImageSource::CanRewind() const {
+  std::scoped_lock lock(mutex_);
+  return discarded_size_ == 0;
+}
+
+void IncrementalImageSource::NotifyObserver() {
+  fml::closure observer;
+  {
+    std::scoped_lock lock(mutex_);
+    observer = observer_;
+  }
+  if (observer) {
+    observer();
+  }
+}
+
+}  // namespace flutter
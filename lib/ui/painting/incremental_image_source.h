@@ -0,0 +1,113 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_PAINTING_INCREMENTAL_IMAGE_SOURCE_H_
+#define FLUTTER_LIB_UI_PAINTING_INCREMENTAL_IMAGE_SOURCE_H_
+
+#include <deque>
+#include <memory>
+#include <mutex>
+
+#include "flutter/fml/closure.h"
+#include "flutter/fml/macros.h"
+#include "third_party/skia/include/core/SkData.h"
+#include "third_party/skia/include/core/SkStream.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      The encoded bytes of an image that arrive over time, for
+///             instance while the image is being downloaded. Bytes may be
+///             appended on any thread while a decoder reads them on another.
+///
+///             Whoever appends the bytes must eventually call either
+///             |Finish| or |Abandon|, which lets a pending decode complete.
+///             Sources must be owned by a |std::shared_ptr|.
+///
+class IncrementalImageSource
+    : public std::enable_shared_from_this<IncrementalImageSource> {
+ public:
+  enum class State {
+    // More bytes may still be appended.
+    kReceiving,
+    // All of the bytes of the image have been appended.
+    kComplete,
+    // No more bytes will arrive, and the image is incomplete.
+    kAbandoned,
+  };
+
+  IncrementalImageSource();
+
+  ~IncrementalImageSource();
+
+  void Append(sk_sp<SkData> bytes);
+
+  void Finish();
+
+  void Abandon();
+
+  State GetState() const;
+
+  size_t GetReceivedSize() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Sets the callback invoked after bytes are appended or the
+  ///             state changes. The callback is invoked on the thread that
+  ///             made the change.
+  ///
+  void SetObserver(fml::closure observer);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Creates a stream that reads the image from the start. Reads
+  ///             only return the bytes received so far, and later reads
+  ///             return bytes appended in the meantime. The stream keeps this
+  ///             source alive.
+  ///
+  std::unique_ptr<SkStream> CreateStream();
+
+  //----------------------------------------------------------------------------
+  /// @brief      From now on, frees each appended chunk once a stream has read
+  ///             past it, so that the whole image is never held in memory at
+  ///             once. This is only safe while a single stream reads from the
+  ///             source, and that stream can no longer be rewound.
+  ///
+  void DiscardConsumedBytes();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Copies all of the bytes received so far into a single
+  ///             buffer, or returns null if some of them have already been
+  ///             discarded.
+  ///
+  sk_sp<SkData> CopyReceivedBytes() const;
+
+ private:
+  class Stream;
+
+  mutable std::mutex mutex_;
+  std::deque<sk_sp<SkData>> chunks_;
+  // The offset in the image of the first chunk in |chunks_|.
+  size_t discarded_size_ = 0;
+  size_t received_size_ = 0;
+  bool discard_consumed_bytes_ = false;
+  State state_ = State::kReceiving;
+  fml::closure observer_;
+
+  // Copies up to |size| bytes starting at |offset| into |buffer|, returning
+  // the number of bytes copied.
+  size_t Read(size_t offset, void* buffer, size_t size) const;
+
+  // Called as a stream reads past |offset|. Frees the chunks that end at or
+  // before it if consumed bytes are being discarded.
+  void DidConsume(size_t offset);
+
+  bool CanRewind() const;
+
+  void NotifyObserver();
+
+  FML_DISALLOW_COPY_AND_ASSIGN(IncrementalImageSource);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_LIB_UI_PAINTING_INCREMENTAL_IMAGE_SOURCE_H_
@@ -41,7 +41,10 @@ PictureRecorder::~PictureRecorder() {}
 SkCanvas* PictureRecorder::BeginRecording(SkRect bounds) {
   bool enable_display_list = UIDartState::Current()->enable_display_list();
   if (enable_display_list) {
-    display_list_recorder_ = sk_make_sp<DisplayListCanvasRecorder>(bounds);
+    // Like the SkPicture recorded below with an RTree, the DisplayList
+    // indexes its ops so they can be culled against the clip on playback.
+    display_list_recorder_ =
+        sk_make_sp<DisplayListCanvasRecorder>(bounds, true);
     return display_list_recorder_.get();
   } else {
     return picture_recorder_.beginRecording(bounds, &rtree_factory_);
@@ -3310,6 +3310,34 @@ class Paragraph extends NativeFieldWrapperClass1 {
   Float64List _computeLineMetrics() native 'Paragraph_computeLineMetrics';
 }
 
+/// A paragraph with a single [TextStyle], to be measured by
+/// [ParagraphBuilder.layoutBatch].
+class ParagraphLayoutRequest {
+  /// Creates a request to lay out `text` at `width`.
+  const ParagraphLayoutRequest({
+    required this.paragraphStyle,
+    required this.textStyle,
+    required this.text,
+    required this.width,
+  });
+
+  /// The style of the paragraph.
+  ///
+  /// Strut styles are not supported by [ParagraphBuilder.layoutBatch].
+  final ParagraphStyle paragraphStyle;
+
+  /// The style of all of the text in the paragraph.
+  ///
+  /// Only the properties that affect the size of the text are used.
+  final TextStyle textStyle;
+
+  /// The text of the paragraph.
+  final String text;
+
+  /// The width at which to lay out the paragraph.
+  final double width;
+}
+
 /// Builds a [Paragraph] containing text with the given styling information.
 ///
 /// To set the paragraph's alignment, truncation, and ellipsizing behavior, pass
@@ -3543,6 +3571,102 @@ class ParagraphBuilder extends NativeFieldWrapperClass1 {
     return paragraph;
   }
   void _build(Paragraph outParagraph) native 'ParagraphBuilder_build';
+
+  /// Lays out each of the given paragraphs and returns their metrics, without
+  /// creating a [Paragraph] for each of them.
+  ///
+  /// This is intended for measuring many short paragraphs, such as the labels
+  /// of a list or a chart, in one call into the engine.
+  ///
+  /// The returned list has eight values per request, in order: [Paragraph.width],
+  /// [Paragraph.height], [Paragraph.longestLine], [Paragraph.minIntrinsicWidth],
+  /// [Paragraph.maxIntrinsicWidth], [Paragraph.alphabeticBaseline],
+  /// [Paragraph.ideographicBaseline], and 1.0 if the paragraph
+  /// [Paragraph.didExceedMaxLines] or 0.0 otherwise.
+  ///
+  /// If `parallel` is true, the engine may lay out the paragraphs on several
+  /// threads while the caller waits.
+  static Float64List layoutBatch(List<ParagraphLayoutRequest> requests, { bool parallel = true }) {
+    const int kIntsPerRequest = 18;
+    const int kDoublesPerRequest = 8;
+    const int kMetricsPerRequest = 8;
+
+    final int count = requests.length;
+    final Int32List ints = Int32List(count * kIntsPerRequest);
+    final Float64List doubles = Float64List(count * kDoublesPerRequest);
+    final List<String> strings = <String>[];
+    final List<String> texts = <String>[];
+    final List<FontFeature> fontFeatures = <FontFeature>[];
+    for (int i = 0; i < count; i++) {
+      final ParagraphLayoutRequest request = requests[i];
+      final ParagraphStyle paragraphStyle = request.paragraphStyle;
+      final TextStyle textStyle = request.textStyle;
+      assert(paragraphStyle._strutStyle == null || !paragraphStyle._strutStyle!._enabled,
+        'ParagraphBuilder.layoutBatch does not support strut styles.');
+
+      final int intOffset = i * kIntsPerRequest;
+      ints.setAll(intOffset, paragraphStyle._encoded);
+      ints.setAll(intOffset + 7, textStyle._encoded);
+      // ensure the enum can be represented using 1 bit.
+      assert(TextLeadingDistribution.values.length <= 2);
+      final TextLeadingDistribution leadingDistribution = textStyle._leadingDistribution
+        ?? paragraphStyle._leadingDistribution;
+      ints[intOffset + 7] |= leadingDistribution.index << 0;
+      final List<String>? fontFamilyFallback = textStyle._fontFamilyFallback;
+      ints[intOffset + 16] = 1 + (fontFamilyFallback?.length ?? 0);
+      ints[intOffset + 17] = textStyle._fontFeatures?.length ?? 0;
+
+      final int doubleOffset = i * kDoublesPerRequest;
+      doubles[doubleOffset] = request.width;
+      doubles[doubleOffset + 1] = paragraphStyle._fontSize ?? 0.0;
+      doubles[doubleOffset + 2] = paragraphStyle._height ?? 0.0;
+      doubles[doubleOffset + 3] = textStyle._fontSize ?? 0.0;
+      doubles[doubleOffset + 4] = textStyle._letterSpacing ?? 0.0;
+      doubles[doubleOffset + 5] = textStyle._wordSpacing ?? 0.0;
+      doubles[doubleOffset + 6] = textStyle._height ?? 0.0;
+      doubles[doubleOffset + 7] = textStyle._decorationThickness ?? 0.0;
+
+      strings
+        ..add(paragraphStyle._fontFamily ?? '')
+        ..add(_encodeLocale(paragraphStyle._locale))
+        ..add(_encodeLocale(textStyle._locale))
+        ..add(textStyle._fontFamily);
+      if (fontFamilyFallback != null)
+        strings.addAll(fontFamilyFallback);
+
+      texts
+        ..add(request.text)
+        ..add(paragraphStyle._ellipsis ?? '');
+
+      if (textStyle._fontFeatures != null)
+        fontFeatures.addAll(textStyle._fontFeatures!);
+    }
+
+    ByteData? encodedFontFeatures;
+    if (fontFeatures.isNotEmpty) {
+      encodedFontFeatures = ByteData(fontFeatures.length * FontFeature._kEncodedSize);
+      int byteOffset = 0;
+      for (final FontFeature feature in fontFeatures) {
+        feature._encode(ByteData.view(encodedFontFeatures.buffer, byteOffset, FontFeature._kEncodedSize));
+        byteOffset += FontFeature._kEncodedSize;
+      }
+    }
+
+    final Float64List metrics = Float64List(count * kMetricsPerRequest);
+    final String? error = _layoutBatch(ints, doubles, strings, texts, encodedFontFeatures, parallel, metrics);
+    if (error != null)
+      throw ArgumentError(error);
+    return metrics;
+  }
+  static String? _layoutBatch(
+    Int32List ints,
+    Float64List doubles,
+    List<dynamic> strings,
+    List<dynamic> texts,
+    ByteData? fontFeaturesData,
+    bool parallel,
+    Float64List metrics,
+  ) native 'ParagraphBuilder_layoutBatch';
 }
 
 /// Loads a font from a buffer and makes it available for rendering text.
@@ -0,0 +1,75 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/text/paragraph_batch.h"
+
+#include <algorithm>
+
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+namespace {
+
+// Paragraphs are handed to workers in chunks of this many, so that batches of
+// short labels are not dominated by the cost of handing out work.
+constexpr size_t kEntriesPerChunk = 16;
+
+void LayoutEntries(const std::vector<ParagraphBatchEntry>& entries,
+                   size_t start,
+                   size_t end,
+                   const std::shared_ptr<txt::FontCollection>& font_collection,
+                   ParagraphBuilderFactory factory,
+                   double* metrics) {
+  for (size_t i = start; i < end; ++i) {
+    const ParagraphBatchEntry& entry = entries[i];
+    std::unique_ptr<txt::ParagraphBuilder> builder =
+        factory(entry.paragraph_style, font_collection);
+    builder->PushStyle(entry.text_style);
+    builder->AddText(entry.text);
+    builder->Pop();
+    std::unique_ptr<txt::Paragraph> paragraph = builder->Build();
+    paragraph->Layout(entry.width);
+
+    double* result = metrics + i * kParagraphBatchMetricsCount;
+    result[0] = paragraph->GetMaxWidth();
+    result[1] = paragraph->GetHeight();
+    result[2] = paragraph->GetLongestLine();
+    result[3] = paragraph->GetMinIntrinsicWidth();
+    result[4] = paragraph->GetMaxIntrinsicWidth();
+    result[5] = paragraph->GetAlphabeticBaseline();
+    result[6] = paragraph->GetIdeographicBaseline();
+    result[7] = paragraph->DidExceedMaxLines() ? 1.0 : 0.0;
+  }
+}
+
+}  // namespace
+
+void LayoutParagraphBatch(
+    const std::vector<ParagraphBatchEntry>& entries,
+    const std::shared_ptr<txt::FontCollection>& font_collection,
+    ParagraphBuilderFactory factory,
+    const std::shared_ptr<fml::ConcurrentTaskRunner>& concurrent_task_runner,
+    double* metrics) {
+  TRACE_EVENT1("flutter", "LayoutParagraphBatch", "count",
+               std::to_string(entries.size()).c_str());
+
+  const size_t chunk_count =
+      (entries.size() + kEntriesPerChunk - 1) / kEntriesPerChunk;
+  if (!concurrent_task_runner || chunk_count <= 1) {
+    LayoutEntries(entries, 0, entries.size(), font_collection, factory,
+                  metrics);
+    return;
+  }
+
+  // Chunks are handed out in order to whichever thread is free, including the
+  // calling thread, so a chunk of long paragraphs does not hold up the others.
+  concurrent_task_runner->ParallelFor(chunk_count, [&](size_t chunk) {
+    size_t start = chunk * kEntriesPerChunk;
+    size_t end = std::min(start + kEntriesPerChunk, entries.size());
+    LayoutEntries(entries, start, end, font_collection, factory, metrics);
+  });
+}
+
+}  // namespace flutter
@@ -0,0 +1,56 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_TEXT_PARAGRAPH_BATCH_H_
+#define FLUTTER_LIB_UI_TEXT_PARAGRAPH_BATCH_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "flutter/fml/concurrent_message_loop.h"
+#include "flutter/third_party/txt/src/txt/font_collection.h"
+#include "flutter/third_party/txt/src/txt/paragraph_builder.h"
+#include "flutter/third_party/txt/src/txt/paragraph_style.h"
+#include "flutter/third_party/txt/src/txt/text_style.h"
+
+namespace flutter {
+
+// A paragraph with a single text style, to be laid out by
+// |LayoutParagraphBatch|.
+struct ParagraphBatchEntry {
+  txt::ParagraphStyle paragraph_style;
+  txt::TextStyle text_style;
+  std::u16string text;
+  double width;
+};
+
+using ParagraphBuilderFactory = std::unique_ptr<txt::ParagraphBuilder> (*)(
+    const txt::ParagraphStyle& style,
+    std::shared_ptr<txt::FontCollection> font_collection);
+
+// The number of metrics written for each paragraph by |LayoutParagraphBatch|.
+// In order, they are the width, height, longest line, min intrinsic width,
+// max intrinsic width, alphabetic baseline, ideographic baseline, and 1 if the
+// paragraph exceeded its max lines or 0 otherwise.
+constexpr size_t kParagraphBatchMetricsCount = 8;
+
+// Lays out each entry at its width and writes its metrics to |metrics|, which
+// must have room for |kParagraphBatchMetricsCount| values per entry.
+//
+// If |concurrent_task_runner| is not null, the entries are split into chunks
+// that are laid out on its workers and on the calling thread with
+// |fml::ConcurrentTaskRunner::ParallelFor|, and this waits for all of them to
+// be done. The paragraphs built by |factory| must then be
+// safe to lay out on several threads at once.
+void LayoutParagraphBatch(
+    const std::vector<ParagraphBatchEntry>& entries,
+    const std::shared_ptr<txt::FontCollection>& font_collection,
+    ParagraphBuilderFactory factory,
+    const std::shared_ptr<fml::ConcurrentTaskRunner>& concurrent_task_runner,
+    double* metrics);
+
+}  // namespace flutter
+
+#endif  // FLUTTER_LIB_UI_TEXT_PARAGRAPH_BATCH_H_
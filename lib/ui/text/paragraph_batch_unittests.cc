@@ -0,0 +1,85 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/text/paragraph_batch.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "flutter/fml/concurrent_message_loop.h"
+#include "flutter/testing/testing.h"
+
+namespace flutter {
+namespace testing {
+
+static std::vector<ParagraphBatchEntry> CreateEntries(size_t count) {
+  std::vector<ParagraphBatchEntry> entries(count);
+  for (size_t i = 0; i < count; ++i) {
+    ParagraphBatchEntry& entry = entries[i];
+    if (i % 2 == 0) {
+      entry.paragraph_style.max_lines = 1;
+    }
+    entry.text_style = entry.paragraph_style.GetTextStyle();
+    entry.text_style.font_size = 10 + i % 7;
+    std::string label;
+    for (size_t word = 0; word <= i % 4; ++word) {
+      label += "Label number " + std::to_string(i) + " ";
+    }
+    entry.text = std::u16string(label.begin(), label.end());
+    entry.width = 40 + 10 * (i % 5);
+  }
+  return entries;
+}
+
+static std::vector<double> LayoutEachParagraph(
+    const std::vector<ParagraphBatchEntry>& entries,
+    const std::shared_ptr<txt::FontCollection>& font_collection) {
+  std::vector<double> metrics;
+  for (const ParagraphBatchEntry& entry : entries) {
+    auto builder = txt::ParagraphBuilder::CreateTxtBuilder(
+        entry.paragraph_style, font_collection);
+    builder->PushStyle(entry.text_style);
+    builder->AddText(entry.text);
+    builder->Pop();
+    auto paragraph = builder->Build();
+    paragraph->Layout(entry.width);
+    metrics.insert(metrics.end(),
+                   {paragraph->GetMaxWidth(), paragraph->GetHeight(),
+                    paragraph->GetLongestLine(),
+                    paragraph->GetMinIntrinsicWidth(),
+                    paragraph->GetMaxIntrinsicWidth(),
+                    paragraph->GetAlphabeticBaseline(),
+                    paragraph->GetIdeographicBaseline(),
+                    paragraph->DidExceedMaxLines() ? 1.0 : 0.0});
+  }
+  return metrics;
+}
+
+TEST(ParagraphBatchTest, MatchesLayingOutEachParagraph) {
+  auto font_collection = std::make_shared<txt::FontCollection>();
+  font_collection->SetupDefaultFontManager(0);
+  auto loop = fml::ConcurrentMessageLoop::Create(4);
+
+  // Enough entries to be split into several chunks, the last of which is not
+  // full.
+  auto entries = CreateEntries(100);
+  auto expected = LayoutEachParagraph(entries, font_collection);
+  ASSERT_EQ(expected.size(), entries.size() * kParagraphBatchMetricsCount);
+
+  std::vector<double> serial(expected.size());
+  LayoutParagraphBatch(entries, font_collection,
+                       txt::ParagraphBuilder::CreateTxtBuilder, nullptr,
+                       serial.data());
+  EXPECT_EQ(serial, expected);
+
+  std::vector<double> parallel(expected.size());
+  LayoutParagraphBatch(entries, font_collection,
+                       txt::ParagraphBuilder::CreateTxtBuilder,
+                       loop->GetTaskRunner(), parallel.data());
+  EXPECT_EQ(parallel, expected);
+}
+
+}  // namespace testing
+}  // namespace flutter
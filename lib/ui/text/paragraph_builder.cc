@@ -11,6 +11,7 @@
 #include "flutter/fml/logging.h"
 #include "flutter/fml/task_runner.h"
 #include "flutter/lib/ui/text/font_collection.h"
+#include "flutter/lib/ui/text/paragraph_batch.h"
 #include "flutter/lib/ui/ui_dart_state.h"
 #include "flutter/lib/ui/window/platform_configuration.h"
 #include "flutter/third_party/txt/src/txt/font_style.h"
@@ -133,6 +134,36 @@ const int sHeightMask = 1 << sHeightIndex;
 const int sLeadingMask = 1 << sLeadingIndex;
 const int sForceStrutHeightMask = 1 << sForceStrutHeightIndex;
 
+// Batch layout decoding
+constexpr size_t kBatchIntsPerParagraph = 18;
+constexpr size_t kBatchParagraphStyleOffset = 0;
+constexpr size_t kBatchTextStyleOffset = 7;
+constexpr size_t kBatchFontFamilyCountOffset = 16;
+constexpr size_t kBatchFontFeatureCountOffset = 17;
+
+constexpr size_t kBatchDoublesPerParagraph = 8;
+constexpr size_t kBatchWidthOffset = 0;
+constexpr size_t kBatchParagraphFontSizeOffset = 1;
+constexpr size_t kBatchParagraphHeightOffset = 2;
+constexpr size_t kBatchFontSizeOffset = 3;
+constexpr size_t kBatchLetterSpacingOffset = 4;
+constexpr size_t kBatchWordSpacingOffset = 5;
+constexpr size_t kBatchHeightOffset = 6;
+constexpr size_t kBatchDecorationThicknessOffset = 7;
+
+constexpr size_t kBatchTextsPerParagraph = 2;
+constexpr size_t kBatchStringsPerParagraph = 3;
+
+// Use ICU to validate the UTF-16 input.  Calling u_strToUTF8 with a null
+// output buffer will return U_BUFFER_OVERFLOW_ERROR if the input is well
+// formed.
+bool IsWellFormedUTF16(const std::u16string& text) {
+  const UChar* text_ptr = reinterpret_cast<const UChar*>(text.data());
+  UErrorCode error_code = U_ZERO_ERROR;
+  u_strToUTF8(nullptr, 0, nullptr, text_ptr, text.size(), &error_code);
+  return error_code == U_BUFFER_OVERFLOW_ERROR;
+}
+
 }  // namespace
 
 static void ParagraphBuilder_constructor(Dart_NativeArguments args) {
@@ -140,6 +171,11 @@ static void ParagraphBuilder_constructor(Dart_NativeArguments args) {
   DartCallConstructor(&ParagraphBuilder::create, args);
 }
 
+static void ParagraphBuilder_layoutBatch(Dart_NativeArguments args) {
+  UIDartState::ThrowIfUIOperationsProhibited();
+  tonic::DartCallStatic(&ParagraphBuilder::layoutBatch, args);
+}
+
 IMPLEMENT_WRAPPERTYPEINFO(ui, ParagraphBuilder);
 
 #define FOR_EACH_BINDING(V)           \
@@ -154,6 +190,7 @@ FOR_EACH_BINDING(DART_NATIVE_CALLBACK)
 void ParagraphBuilder::RegisterNatives(tonic::DartLibraryNatives* natives) {
   natives->Register(
       {{"ParagraphBuilder_constructor", ParagraphBuilder_constructor, 9, true},
+       {"ParagraphBuilder_layoutBatch", ParagraphBuilder_layoutBatch, 7, true},
        FOR_EACH_BINDING(DART_REGISTER_NATIVE)});
 }
 
@@ -234,17 +271,14 @@ void decodeStrut(Dart_Handle strut_data,
   }
 }
 
-ParagraphBuilder::ParagraphBuilder(
-    tonic::Int32List& encoded,
-    Dart_Handle strutData,
-    const std::string& fontFamily,
-    const std::vector<std::string>& strutFontFamilies,
-    double fontSize,
-    double height,
-    const std::u16string& ellipsis,
-    const std::string& locale) {
+void decodeParagraphStyle(const int32_t* encoded,
+                          const std::string& fontFamily,
+                          double fontSize,
+                          double height,
+                          const std::u16string& ellipsis,
+                          const std::string& locale,
+                          txt::ParagraphStyle& style) {  // NOLINT
   int32_t mask = encoded[0];
-  txt::ParagraphStyle style;
 
   if (mask & psTextAlignMask) {
     style.text_align = txt::TextAlign(encoded[psTextAlignIndex]);
@@ -280,10 +314,6 @@ ParagraphBuilder::ParagraphBuilder(
     style.text_height_behavior = encoded[psTextHeightBehaviorIndex];
   }
 
-  if (mask & psStrutStyleMask) {
-    decodeStrut(strutData, strutFontFamilies, style);
-  }
-
   if (mask & psMaxLinesMask) {
     style.max_lines = encoded[psMaxLinesIndex];
   }
@@ -295,15 +325,9 @@ ParagraphBuilder::ParagraphBuilder(
   if (mask & psLocaleMask) {
     style.locale = locale;
   }
+}
 
-  FontCollection& font_collection = UIDartState::Current()
-                                        ->platform_configuration()
-                                        ->client()
-                                        ->GetFontCollection();
-
-  typedef std::unique_ptr<txt::ParagraphBuilder> (*ParagraphBuilderFactory)(
-      const txt::ParagraphStyle& style,
-      std::shared_ptr<txt::FontCollection> font_collection);
+ParagraphBuilderFactory GetParagraphBuilderFactory() {
   ParagraphBuilderFactory factory = txt::ParagraphBuilder::CreateTxtBuilder;
 
 #if FLUTTER_ENABLE_SKSHAPER
@@ -317,6 +341,32 @@ ParagraphBuilder::ParagraphBuilder(
   }
 #endif  // FLUTTER_ENABLE_SKSHAPER
 
+  return factory;
+}
+
+ParagraphBuilder::ParagraphBuilder(
+    tonic::Int32List& encoded,
+    Dart_Handle strutData,
+    const std::string& fontFamily,
+    const std::vector<std::string>& strutFontFamilies,
+    double fontSize,
+    double height,
+    const std::u16string& ellipsis,
+    const std::string& locale) {
+  txt::ParagraphStyle style;
+  decodeParagraphStyle(encoded.data(), fontFamily, fontSize, height, ellipsis,
+                       locale, style);
+
+  if (encoded[0] & psStrutStyleMask) {
+    decodeStrut(strutData, strutFontFamilies, style);
+  }
+
+  FontCollection& font_collection = UIDartState::Current()
+                                        ->platform_configuration()
+                                        ->client()
+                                        ->GetFontCollection();
+
+  ParagraphBuilderFactory factory = GetParagraphBuilderFactory();
   m_paragraphBuilder = factory(style, font_collection.GetFontCollection());
 }
 
@@ -347,17 +397,17 @@ void decodeTextShadows(
   }
 }
 
-void decodeFontFeatures(Dart_Handle font_features_data,
+void decodeFontFeatures(const uint8_t* data,
+                        size_t length,
                         txt::FontFeatures& font_features) {  // NOLINT
-  tonic::DartByteData byte_data(font_features_data);
-  FML_CHECK(byte_data.length_in_bytes() % kBytesPerFontFeature == 0);
+  FML_CHECK(length % kBytesPerFontFeature == 0);
 
-  size_t feature_count = byte_data.length_in_bytes() / kBytesPerFontFeature;
+  size_t feature_count = length / kBytesPerFontFeature;
   for (size_t feature_index = 0; feature_index < feature_count;
        ++feature_index) {
     size_t feature_offset = feature_index * kBytesPerFontFeature;
     const char* feature_bytes =
-        static_cast<const char*>(byte_data.data()) + feature_offset;
+        reinterpret_cast<const char*>(data) + feature_offset;
     std::string tag(feature_bytes, kFontFeatureTagLength);
     int32_t value = *(reinterpret_cast<const int32_t*>(feature_bytes +
                                                        kFontFeatureTagLength));
@@ -365,28 +415,27 @@ void decodeFontFeatures(Dart_Handle font_features_data,
   }
 }
 
-void ParagraphBuilder::pushStyle(tonic::Int32List& encoded,
-                                 const std::vector<std::string>& fontFamilies,
-                                 double fontSize,
-                                 double letterSpacing,
-                                 double wordSpacing,
-                                 double height,
-                                 double decorationThickness,
-                                 const std::string& locale,
-                                 Dart_Handle background_objects,
-                                 Dart_Handle background_data,
-                                 Dart_Handle foreground_objects,
-                                 Dart_Handle foreground_data,
-                                 Dart_Handle shadows_data,
-                                 Dart_Handle font_features_data) {
-  FML_DCHECK(encoded.num_elements() == 9);
+void decodeFontFeatures(Dart_Handle font_features_data,
+                        txt::FontFeatures& font_features) {  // NOLINT
+  tonic::DartByteData byte_data(font_features_data);
+  decodeFontFeatures(static_cast<const uint8_t*>(byte_data.data()),
+                     byte_data.length_in_bytes(), font_features);
+}
 
+// Decodes the properties of a text style that are passed as plain values,
+// on top of the properties already in |style|. Paints, shadows and font
+// features are left to the caller.
+void decodeTextStyle(const int32_t* encoded,
+                     const std::vector<std::string>& fontFamilies,
+                     double fontSize,
+                     double letterSpacing,
+                     double wordSpacing,
+                     double height,
+                     double decorationThickness,
+                     const std::string& locale,
+                     txt::TextStyle& style) {  // NOLINT
   int32_t mask = encoded[0];
 
-  // Set to use the properties of the previous style if the property is not
-  // explicitly given.
-  txt::TextStyle style = m_paragraphBuilder->PeekStyle();
-
   style.half_leading = mask & tsLeadingDistributionMask;
   // Only change the style property from the previous value if a new explicitly
   // set value is available
@@ -450,6 +499,38 @@ void ParagraphBuilder::pushStyle(tonic::Int32List& encoded,
     style.locale = locale;
   }
 
+  if (mask & tsFontFamilyMask) {
+    // The child style's font families override the parent's font families.
+    // If the child's fonts are not available, then the font collection will
+    // use the system fallback fonts (not the parent's fonts).
+    style.font_families = fontFamilies;
+  }
+}
+
+void ParagraphBuilder::pushStyle(tonic::Int32List& encoded,
+                                 const std::vector<std::string>& fontFamilies,
+                                 double fontSize,
+                                 double letterSpacing,
+                                 double wordSpacing,
+                                 double height,
+                                 double decorationThickness,
+                                 const std::string& locale,
+                                 Dart_Handle background_objects,
+                                 Dart_Handle background_data,
+                                 Dart_Handle foreground_objects,
+                                 Dart_Handle foreground_data,
+                                 Dart_Handle shadows_data,
+                                 Dart_Handle font_features_data) {
+  FML_DCHECK(encoded.num_elements() == 9);
+
+  int32_t mask = encoded[0];
+
+  // Set to use the properties of the previous style if the property is not
+  // explicitly given.
+  txt::TextStyle style = m_paragraphBuilder->PeekStyle();
+  decodeTextStyle(encoded.data(), fontFamilies, fontSize, letterSpacing,
+                  wordSpacing, height, decorationThickness, locale, style);
+
   if (mask & tsBackgroundMask) {
     Paint background(background_objects, background_data);
     if (background.isNotNull()) {
@@ -472,13 +553,6 @@ void ParagraphBuilder::pushStyle(tonic::Int32List& encoded,
     decodeTextShadows(shadows_data, style.text_shadows);
   }
 
-  if (mask & tsFontFamilyMask) {
-    // The child style's font families override the parent's font families.
-    // If the child's fonts are not available, then the font collection will
-    // use the system fallback fonts (not the parent's fonts).
-    style.font_families = fontFamilies;
-  }
-
   if (mask & tsFontFeaturesMask) {
     decodeFontFeatures(font_features_data, style.font_features);
   }
@@ -495,13 +569,7 @@ Dart_Handle ParagraphBuilder::addText(const std::u16string& text) {
     return Dart_Null();
   }
 
-  // Use ICU to validate the UTF-16 input.  Calling u_strToUTF8 with a null
-  // output buffer will return U_BUFFER_OVERFLOW_ERROR if the input is well
-  // formed.
-  const UChar* text_ptr = reinterpret_cast<const UChar*>(text.data());
-  UErrorCode error_code = U_ZERO_ERROR;
-  u_strToUTF8(nullptr, 0, nullptr, text_ptr, text.size(), &error_code);
-  if (error_code != U_BUFFER_OVERFLOW_ERROR) {
+  if (!IsWellFormedUTF16(text)) {
     return tonic::ToDart("string is not well-formed UTF-16");
   }
 
@@ -528,4 +596,108 @@ void ParagraphBuilder::build(Dart_Handle paragraph_handle) {
   Paragraph::Create(paragraph_handle, m_paragraphBuilder->Build());
 }
 
+Dart_Handle ParagraphBuilder::layoutBatch(
+    tonic::Int32List& ints,
+    tonic::Float64List& doubles,
+    const std::vector<std::string>& strings,
+    const std::vector<std::u16string>& texts,
+    Dart_Handle font_features_data,
+    bool parallel,
+    Dart_Handle metrics) {
+  size_t count = texts.size() / kBatchTextsPerParagraph;
+  if (texts.size() % kBatchTextsPerParagraph != 0 ||
+      static_cast<size_t>(ints.num_elements()) !=
+          count * kBatchIntsPerParagraph ||
+      static_cast<size_t>(doubles.num_elements()) !=
+          count * kBatchDoublesPerParagraph) {
+    return tonic::ToDart("malformed paragraph batch");
+  }
+
+  tonic::DartByteData font_features(font_features_data);
+  const uint8_t* font_features_bytes =
+      static_cast<const uint8_t*>(font_features.data());
+  size_t font_features_length = font_features.length_in_bytes();
+
+  std::vector<ParagraphBatchEntry> entries(count);
+  size_t string_index = 0;
+  size_t font_features_offset = 0;
+  for (size_t i = 0; i < count; ++i) {
+    const int32_t* encoded = ints.data() + i * kBatchIntsPerParagraph;
+    const double* values = doubles.data() + i * kBatchDoublesPerParagraph;
+    const std::u16string& text = texts[i * kBatchTextsPerParagraph];
+    const std::u16string& ellipsis = texts[i * kBatchTextsPerParagraph + 1];
+    size_t font_family_count = encoded[kBatchFontFamilyCountOffset];
+    size_t font_features_size =
+        encoded[kBatchFontFeatureCountOffset] * kBytesPerFontFeature;
+    if (string_index + kBatchStringsPerParagraph + font_family_count >
+            strings.size() ||
+        font_features_offset + font_features_size > font_features_length) {
+      return tonic::ToDart("malformed paragraph batch");
+    }
+    if (!text.empty() && !IsWellFormedUTF16(text)) {
+      return tonic::ToDart("string is not well-formed UTF-16");
+    }
+
+    ParagraphBatchEntry& entry = entries[i];
+    decodeParagraphStyle(encoded + kBatchParagraphStyleOffset,
+                         strings[string_index],
+                         values[kBatchParagraphFontSizeOffset],
+                         values[kBatchParagraphHeightOffset], ellipsis,
+                         strings[string_index + 1], entry.paragraph_style);
+
+    std::vector<std::string> font_families(
+        strings.begin() + string_index + kBatchStringsPerParagraph,
+        strings.begin() + string_index + kBatchStringsPerParagraph +
+            font_family_count);
+    entry.text_style = entry.paragraph_style.GetTextStyle();
+    decodeTextStyle(encoded + kBatchTextStyleOffset, font_families,
+                    values[kBatchFontSizeOffset],
+                    values[kBatchLetterSpacingOffset],
+                    values[kBatchWordSpacingOffset], values[kBatchHeightOffset],
+                    values[kBatchDecorationThicknessOffset],
+                    strings[string_index + 2], entry.text_style);
+    if (font_features_size > 0) {
+      decodeFontFeatures(font_features_bytes + font_features_offset,
+                         font_features_size, entry.text_style.font_features);
+    }
+
+    entry.text = text;
+    entry.width = values[kBatchWidthOffset];
+    string_index += kBatchStringsPerParagraph + font_family_count;
+    font_features_offset += font_features_size;
+  }
+
+  // Nothing below touches the Dart heap until the results are copied out, so
+  // let go of the arguments before the (possibly long) layout.
+  ints.Release();
+  doubles.Release();
+  font_features.Release();
+
+  UIDartState* dart_state = UIDartState::Current();
+  FontCollection& font_collection =
+      dart_state->platform_configuration()->client()->GetFontCollection();
+  ParagraphBuilderFactory factory = GetParagraphBuilderFactory();
+
+  // SkParagraph has not been audited for concurrent layout, so only libtxt
+  // paragraphs are spread across the workers.
+  std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner;
+  if (parallel && factory == txt::ParagraphBuilder::CreateTxtBuilder) {
+    concurrent_task_runner = dart_state->GetConcurrentTaskRunner();
+  }
+
+  std::vector<double> results(count * kParagraphBatchMetricsCount);
+  LayoutParagraphBatch(entries, font_collection.GetFontCollection(), factory,
+                       concurrent_task_runner, results.data());
+
+  tonic::Float64List metrics_list(metrics);
+  if (static_cast<size_t>(metrics_list.num_elements()) != results.size()) {
+    return tonic::ToDart("malformed paragraph batch");
+  }
+  for (size_t i = 0; i < results.size(); ++i) {
+    metrics_list[i] = results[i];
+  }
+
+  return Dart_Null();
+}
+
 }  // namespace flutter
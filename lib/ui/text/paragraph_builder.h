@@ -71,6 +71,25 @@ class ParagraphBuilder : public RefCountedDartWrappable<ParagraphBuilder> {
 
   void build(Dart_Handle paragraph_handle);
 
+  // Lays out a batch of single-style paragraphs and writes their metrics to
+  // |metrics|, a Float64List with |kParagraphBatchMetricsCount| values per
+  // paragraph. For each paragraph, |ints| holds the encoded paragraph style,
+  // the encoded text style and the counts of its font families and font
+  // features; |doubles| holds its width followed by the unencoded numeric
+  // style values; |strings| holds the paragraph font family and locale, the
+  // text locale and then the font families; and |texts| holds its text and
+  // ellipsis. The font features of all paragraphs are concatenated in
+  // |font_features_data|.
+  //
+  // Returns an error string if the arguments are malformed, or null.
+  static Dart_Handle layoutBatch(tonic::Int32List& ints,
+                                 tonic::Float64List& doubles,
+                                 const std::vector<std::string>& strings,
+                                 const std::vector<std::u16string>& texts,
+                                 Dart_Handle font_features_data,
+                                 bool parallel,
+                                 Dart_Handle metrics);
+
   static void RegisterNatives(tonic::DartLibraryNatives* natives);
 
  private:
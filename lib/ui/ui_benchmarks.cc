@@ -4,6 +4,8 @@
 
 #include "flutter/benchmarking/benchmarking.h"
 #include "flutter/common/settings.h"
+#include "flutter/fml/concurrent_message_loop.h"
+#include "flutter/lib/ui/text/paragraph_batch.h"
 #include "flutter/lib/ui/volatile_path_tracker.h"
 #include "flutter/lib/ui/window/platform_message_response_dart.h"
 #include "flutter/runtime/dart_vm_lifecycle.h"
@@ -67,6 +69,71 @@ static void BM_PlatformMessageResponseDartComplete(benchmark::State& state) {
   }
 }
 
+// Measures the throughput of handing a platform message response from the
+// embedder to a Dart callback, either copying it first as
+// |FlutterEngineSendPlatformMessageResponse| does or handing over the buffer
+// as |FlutterEngineSendPlatformMessageResponseNoCopy| does.
+static void RunPlatformMessageResponseThroughput(benchmark::State& state,
+                                                 bool copy) {
+  ThreadHost thread_host("test",
+                         ThreadHost::Type::Platform | ThreadHost::Type::RASTER |
+                             ThreadHost::Type::IO | ThreadHost::Type::UI);
+  TaskRunners task_runners("test", thread_host.platform_thread->GetTaskRunner(),
+                           thread_host.raster_thread->GetTaskRunner(),
+                           thread_host.ui_thread->GetTaskRunner(),
+                           thread_host.io_thread->GetTaskRunner());
+  Fixture fixture;
+  auto settings = fixture.CreateSettingsForFixture();
+  auto vm_ref = DartVMRef::Create(settings);
+  auto isolate =
+      testing::RunDartCodeInIsolate(vm_ref, settings, task_runners, "main", {},
+                                    testing::GetDefaultKernelFilePath(), {});
+
+  const size_t size = state.range(0);
+  std::vector<uint8_t> payload(size, 0);
+
+  while (state.KeepRunning()) {
+    state.PauseTiming();
+    fml::RefPtr<PlatformMessageResponseDart> response;
+    bool successful = isolate->RunInIsolateScope([&]() -> bool {
+      Dart_Handle library = Dart_RootLibrary();
+      Dart_Handle closure =
+          Dart_GetField(library, Dart_NewStringFromCString("messageCallback"));
+      response = fml::MakeRefCounted<PlatformMessageResponseDart>(
+          tonic::DartPersistentValue(isolate->get(), closure),
+          thread_host.ui_thread->GetTaskRunner());
+      return true;
+    });
+    FML_CHECK(successful);
+    state.ResumeTiming();
+
+    std::unique_ptr<fml::Mapping> mapping;
+    if (copy) {
+      mapping = std::make_unique<fml::DataMapping>(
+          std::vector<uint8_t>(payload.begin(), payload.end()));
+    } else {
+      mapping = std::make_unique<fml::NonOwnedMapping>(
+          payload.data(), payload.size(),
+          [](const uint8_t* data, size_t size) {});
+    }
+    response->Complete(std::move(mapping));
+
+    std::promise<bool> completed;
+    task_runners.GetUITaskRunner()->PostTask(
+        [&completed] { completed.set_value(true); });
+    completed.get_future().wait();
+  }
+  state.SetBytesProcessed(state.iterations() * size);
+}
+
+static void BM_PlatformMessageResponseCopy(benchmark::State& state) {
+  RunPlatformMessageResponseThroughput(state, true);
+}
+
+static void BM_PlatformMessageResponseNoCopy(benchmark::State& state) {
+  RunPlatformMessageResponseThroughput(state, false);
+}
+
 static void BM_PathVolatilityTracker(benchmark::State& state) {
   ThreadHost thread_host("test",
                          ThreadHost::Type::Platform | ThreadHost::Type::RASTER |
@@ -112,9 +179,61 @@ static void BM_PathVolatilityTracker(benchmark::State& state) {
   }
 }
 
+static void BM_LayoutParagraphBatch(benchmark::State& state, bool parallel) {
+  auto font_collection = std::make_shared<txt::FontCollection>();
+  font_collection->SetupDefaultFontManager(0);
+
+  std::shared_ptr<fml::ConcurrentMessageLoop> loop;
+  std::shared_ptr<fml::ConcurrentTaskRunner> task_runner;
+  if (parallel) {
+    loop = fml::ConcurrentMessageLoop::Create();
+    task_runner = loop->GetTaskRunner();
+  }
+
+  std::vector<ParagraphBatchEntry> entries(state.range(0));
+  for (size_t i = 0; i < entries.size(); ++i) {
+    ParagraphBatchEntry& entry = entries[i];
+    entry.paragraph_style.max_lines = 1;
+    entry.text_style = entry.paragraph_style.GetTextStyle();
+    entry.text_style.font_size = 14;
+    std::string label = "Label number " + std::to_string(i);
+    entry.text = std::u16string(label.begin(), label.end());
+    entry.width = 200;
+  }
+  std::vector<double> metrics(entries.size() * kParagraphBatchMetricsCount);
+
+  while (state.KeepRunning()) {
+    LayoutParagraphBatch(entries, font_collection,
+                         txt::ParagraphBuilder::CreateTxtBuilder, task_runner,
+                         metrics.data());
+  }
+}
+
+BENCHMARK_CAPTURE(BM_LayoutParagraphBatch, Serial, false)
+    ->RangeMultiplier(4)
+    ->Range(16, 1 << 10)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_CAPTURE(BM_LayoutParagraphBatch, Parallel, true)
+    ->RangeMultiplier(4)
+    ->Range(16, 1 << 10)
+    ->Unit(benchmark::kMicrosecond);
+
 BENCHMARK(BM_PlatformMessageResponseDartComplete)
     ->Unit(benchmark::kMicrosecond);
 
+BENCHMARK(BM_PlatformMessageResponseCopy)
+    ->Arg(64 << 10)
+    ->Arg(1 << 20)
+    ->Arg(8 << 20)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(BM_PlatformMessageResponseNoCopy)
+    ->Arg(64 << 10)
+    ->Arg(1 << 20)
+    ->Arg(8 << 20)
+    ->Unit(benchmark::kMicrosecond);
+
 BENCHMARK(BM_PathVolatilityTracker)->Unit(benchmark::kMillisecond);
 
 }  // namespace flutter
@@ -36,7 +36,8 @@ UIDartState::Context::Context(
     fml::WeakPtr<ImageGeneratorRegistry> image_generator_registry,
     std::string advisory_script_uri,
     std::string advisory_script_entrypoint,
-    std::shared_ptr<VolatilePathTracker> volatile_path_tracker)
+    std::shared_ptr<VolatilePathTracker> volatile_path_tracker,
+    std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner)
     : task_runners(task_runners),
       snapshot_delegate(snapshot_delegate),
       io_manager(io_manager),
@@ -45,7 +46,8 @@ UIDartState::Context::Context(
       image_generator_registry(image_generator_registry),
       advisory_script_uri(advisory_script_uri),
       advisory_script_entrypoint(advisory_script_entrypoint),
-      volatile_path_tracker(volatile_path_tracker) {}
+      volatile_path_tracker(volatile_path_tracker),
+      concurrent_task_runner(concurrent_task_runner) {}
 
 UIDartState::UIDartState(
     TaskObserverAdd add_callback,
@@ -137,6 +139,11 @@ std::shared_ptr<VolatilePathTracker> UIDartState::GetVolatilePathTracker()
   return context_.volatile_path_tracker;
 }
 
+std::shared_ptr<fml::ConcurrentTaskRunner>
+UIDartState::GetConcurrentTaskRunner() const {
+  return context_.concurrent_task_runner;
+}
+
 void UIDartState::ScheduleMicrotask(Dart_Handle closure) {
   if (tonic::LogIfError(closure) || !Dart_IsClosure(closure)) {
     return;
@@ -316,8 +316,9 @@ void PlatformConfiguration::DispatchPlatformMessage(
     return;
   }
   tonic::DartState::Scope scope(dart_state);
-  Dart_Handle data_handle =
-      (message->hasData()) ? ToByteData(message->data()) : Dart_Null();
+  Dart_Handle data_handle = (message->hasData())
+                                ? MappingToByteData(message->releaseMapping())
+                                : Dart_Null();
   if (Dart_IsError(data_handle)) {
     FML_DLOG(WARNING)
         << "Dropping platform message because of a Dart error on channel: "
@@ -5,9 +5,11 @@
 #ifndef FLUTTER_LIB_UI_PLATFORM_PLATFORM_MESSAGE_H_
 #define FLUTTER_LIB_UI_PLATFORM_PLATFORM_MESSAGE_H_
 
+#include <memory>
 #include <string>
 #include <vector>
 
+#include "flutter/fml/mapping.h"
 #include "flutter/fml/memory/ref_counted.h"
 #include "flutter/fml/memory/ref_ptr.h"
 #include "flutter/lib/ui/window/platform_message_response.h"
@@ -19,23 +21,38 @@ class PlatformMessage {
   PlatformMessage(std::string channel,
                   fml::MallocMapping data,
                   fml::RefPtr<PlatformMessageResponse> response);
+  // Creates a message that takes ownership of |data| without copying it.
+  PlatformMessage(std::string channel,
+                  std::unique_ptr<fml::Mapping> data,
+                  fml::RefPtr<PlatformMessageResponse> response);
   PlatformMessage(std::string channel,
                   fml::RefPtr<PlatformMessageResponse> response);
   ~PlatformMessage();
 
   const std::string& channel() const { return channel_; }
-  const fml::MallocMapping& data() const { return data_; }
+  const fml::Mapping& data() const {
+    return external_data_ ? *external_data_ : data_;
+  }
   bool hasData() { return hasData_; }
 
   const fml::RefPtr<PlatformMessageResponse>& response() const {
     return response_;
   }
 
-  fml::MallocMapping releaseData() { return std::move(data_); }
+  // Messages created with an external mapping are copied into the returned
+  // buffer, and the external mapping is released. Pointers obtained from
+  // |data()| are then no longer valid, so callers that need the bytes after
+  // this call must use those of the returned buffer.
+  fml::MallocMapping releaseData();
+
+  // Releases the data of the message without copying it, regardless of how
+  // the message was created.
+  std::unique_ptr<fml::Mapping> releaseMapping();
 
  private:
   std::string channel_;
   fml::MallocMapping data_;
+  std::unique_ptr<fml::Mapping> external_data_;
   bool hasData_;
   fml::RefPtr<PlatformMessageResponse> response_;
 };
@@ -14,6 +14,36 @@
 
 namespace flutter {
 
+namespace {
+
+// Smaller messages are cheaper to copy into the Dart heap than to track as
+// external data.
+constexpr size_t kExternalDataThreshold = 1000;
+
+void MappingFinalizer(void* isolate_callback_data, void* peer) {
+  delete reinterpret_cast<fml::Mapping*>(peer);
+}
+
+}  // namespace
+
+Dart_Handle MappingToByteData(std::unique_ptr<fml::Mapping> data) {
+  const size_t size = data->GetSize();
+  if (size < kExternalDataThreshold || data->GetMapping() == nullptr) {
+    return tonic::DartByteData::Create(data->GetMapping(), size);
+  }
+
+  // Dart may write to the ByteData, but nothing else reads the mapping once it
+  // has been handed over.
+  void* bytes = const_cast<uint8_t*>(data->GetMapping());
+  fml::Mapping* peer = data.release();
+  Dart_Handle byte_data = Dart_NewExternalTypedDataWithFinalizer(
+      Dart_TypedData_kByteData, bytes, size, peer, size, MappingFinalizer);
+  if (Dart_IsError(byte_data)) {
+    delete peer;
+  }
+  return byte_data;
+}
+
 PlatformMessageResponseDart::PlatformMessageResponseDart(
     tonic::DartPersistentValue callback,
     fml::RefPtr<fml::TaskRunner> ui_task_runner)
@@ -42,8 +72,7 @@ void PlatformMessageResponseDart::Complete(std::unique_ptr<fml::Mapping> data) {
         }
         tonic::DartState::Scope scope(dart_state);
 
-        Dart_Handle byte_buffer =
-            tonic::DartByteData::Create(data->GetMapping(), data->GetSize());
+        Dart_Handle byte_buffer = MappingToByteData(std::move(data));
         tonic::DartInvoke(callback.Release(), {byte_buffer});
       }));
 }
@@ -11,6 +11,11 @@
 
 namespace flutter {
 
+// Wraps |data| in a Dart ByteData. Large mappings are handed to Dart without
+// being copied and are released when the ByteData is garbage collected. Must
+// be called with an isolate scope entered.
+Dart_Handle MappingToByteData(std::unique_ptr<fml::Mapping> data);
+
 class PlatformMessageResponseDart : public PlatformMessageResponse {
   FML_FRIEND_MAKE_REF_COUNTED(PlatformMessageResponseDart);
 
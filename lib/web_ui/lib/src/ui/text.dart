@@ -702,6 +702,32 @@ abstract class Paragraph {
   List<LineMetrics> computeLineMetrics();
 }
 
+/// A paragraph with a single [TextStyle], to be measured by
+/// [ParagraphBuilder.layoutBatch].
+///
+/// On the web, [ParagraphBuilder.layoutBatch] builds and lays out a
+/// [Paragraph] for each request, one after the other.
+class ParagraphLayoutRequest {
+  /// Creates a request to lay out `text` at `width`.
+  const ParagraphLayoutRequest({
+    required this.paragraphStyle,
+    required this.textStyle,
+    required this.text,
+    required this.width,
+  });
+  /// The style of the paragraph.
+  final ParagraphStyle paragraphStyle;
+
+  /// The style of all of the text in the paragraph.
+  final TextStyle textStyle;
+
+  /// The text of the paragraph.
+  final String text;
+
+  /// The width at which to lay out the paragraph.
+  final double width;
+}
+
 abstract class ParagraphBuilder {
   factory ParagraphBuilder(ParagraphStyle style) {
     if (engine.useCanvasKit) {
@@ -723,6 +749,31 @@ abstract class ParagraphBuilder {
     double? baselineOffset,
     TextBaseline? baseline,
   });
+
+  static Float64List layoutBatch(List<ParagraphLayoutRequest> requests,
+      {bool parallel = true}) {
+    const int kMetricsPerRequest = 8;
+    final Float64List metrics =
+        Float64List(requests.length * kMetricsPerRequest);
+    for (int i = 0; i < requests.length; i++) {
+      final ParagraphLayoutRequest request = requests[i];
+      final ParagraphBuilder builder = ParagraphBuilder(request.paragraphStyle)
+        ..pushStyle(request.textStyle)
+        ..addText(request.text);
+      final Paragraph paragraph = builder.build()
+        ..layout(ParagraphConstraints(width: request.width));
+      final int offset = i * kMetricsPerRequest;
+      metrics[offset] = paragraph.width;
+      metrics[offset + 1] = paragraph.height;
+      metrics[offset + 2] = paragraph.longestLine;
+      metrics[offset + 3] = paragraph.minIntrinsicWidth;
+      metrics[offset + 4] = paragraph.maxIntrinsicWidth;
+      metrics[offset + 5] = paragraph.alphabeticBaseline;
+      metrics[offset + 6] = paragraph.ideographicBaseline;
+      metrics[offset + 7] = paragraph.didExceedMaxLines ? 1.0 : 0.0;
+    }
+    return metrics;
+  }
 }
 
 Future<void> loadFontFromList(Uint8List list, {String? fontFamily}) {
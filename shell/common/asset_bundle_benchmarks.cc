@@ -0,0 +1,97 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/assets/asset_manager.h"
+
+#include "flutter/assets/directory_asset_bundle.h"
+#include "flutter/assets/packed_asset_bundle.h"
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/fml/file.h"
+
+namespace flutter {
+
+namespace {
+
+// About the size of a small image.
+constexpr size_t kAssetSize = 8 * 1024;
+
+// Spread the assets over a few directories like the images and fonts of an
+// application are.
+constexpr size_t kAssetsPerDirectory = 64;
+
+enum class BundleLayout {
+  kDirectory,
+  kPack,
+};
+
+// Writes |count| assets under |assets_dir|, and a pack of them if |layout| is
+// |BundleLayout::kPack|. Returns the names of the assets.
+std::vector<std::string> FillAssets(const fml::UniqueFD& assets_dir,
+                                    size_t count,
+                                    BundleLayout layout) {
+  fml::DataMapping contents(std::vector<uint8_t>(kAssetSize, 0xA5));
+  std::vector<std::string> names;
+  for (size_t i = 0; i < count; ++i) {
+    std::string directory = "images" + std::to_string(i / kAssetsPerDirectory);
+    std::string file_name = "image" + std::to_string(i) + ".png";
+    fml::UniqueFD dir = fml::CreateDirectory(assets_dir, {directory},
+                                             fml::FilePermission::kReadWrite);
+    fml::WriteAtomically(dir, file_name.c_str(), contents);
+    names.push_back(directory + "/" + file_name);
+  }
+  if (layout == BundleLayout::kPack) {
+    fml::WriteAtomically(assets_dir, PackedAssetBundle::kFileName,
+                         *PackedAssetBundle::CreatePack(assets_dir));
+  }
+  return names;
+}
+
+// Sets up the asset manager of the application and looks up every asset, as
+// a cold start of an application with that many assets would. The files stay
+// in the OS page cache between iterations, so this measures the cost of the
+// file system calls rather than of the storage.
+void RunStartupBenchmark(benchmark::State& state, BundleLayout layout) {
+  fml::ScopedTemporaryDirectory assets_dir;
+  std::vector<std::string> names =
+      FillAssets(assets_dir.fd(), state.range(0), layout);
+
+  while (state.KeepRunning()) {
+    AssetManager asset_manager;
+    if (layout == BundleLayout::kPack) {
+      asset_manager.PushBack(std::make_unique<PackedAssetBundle>(
+          fml::OpenFileReadOnly(assets_dir.fd(), PackedAssetBundle::kFileName),
+          true));
+    }
+    asset_manager.PushBack(std::make_unique<DirectoryAssetBundle>(
+        fml::OpenDirectory(assets_dir.path().c_str(), false,
+                           fml::FilePermission::kRead),
+        true));
+    for (const std::string& name : names) {
+      std::unique_ptr<fml::Mapping> mapping = asset_manager.GetAsMapping(name);
+      benchmark::DoNotOptimize(mapping->GetMapping()[0]);
+    }
+  }
+}
+
+}  // namespace
+
+static void BM_AssetBundleStartupDirectory(benchmark::State& state) {
+  RunStartupBenchmark(state, BundleLayout::kDirectory);
+}
+
+static void BM_AssetBundleStartupPack(benchmark::State& state) {
+  RunStartupBenchmark(state, BundleLayout::kPack);
+}
+
+BENCHMARK(BM_AssetBundleStartupDirectory)
+    ->Arg(256)
+    ->Arg(2048)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_AssetBundleStartupPack)
+    ->Arg(256)
+    ->Arg(2048)
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace flutter
@@ -0,0 +1,102 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/diff_context.h"
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "third_party/skia/include/core/SkRegion.h"
+
+namespace flutter {
+
+namespace {
+
+// A phone sized frame.
+const SkISize kFrameSize = SkISize::Make(1080, 2340);
+
+struct Scene {
+  // The areas that changed since the last frame.
+  std::vector<SkRect> changes;
+  // The areas that backdrop filters read back from.
+  std::vector<SkIRect> readbacks;
+};
+
+Scene MakeScene(int64_t index) {
+  switch (index) {
+    case 0:
+      // The clock in the status bar and a progress spinner at the bottom.
+      return {{SkRect::MakeXYWH(960, 24, 96, 40),
+               SkRect::MakeXYWH(492, 2100, 96, 96)},
+              {}};
+    case 1:
+      // A blinking cursor in a text field and a spinner in a list item.
+      return {{SkRect::MakeXYWH(120, 400, 4, 48),
+               SkRect::MakeXYWH(900, 1500, 72, 72)},
+              {}};
+    case 2:
+      // Badges updating on icons spread over a grid.
+      return {{SkRect::MakeXYWH(100, 300, 40, 40),
+               SkRect::MakeXYWH(800, 300, 40, 40),
+               SkRect::MakeXYWH(450, 900, 40, 40),
+               SkRect::MakeXYWH(100, 1500, 40, 40),
+               SkRect::MakeXYWH(800, 1500, 40, 40),
+               SkRect::MakeXYWH(450, 2100, 40, 40)},
+              {}};
+    default:
+      // A spinner under a blurred app bar, and the clock above it.
+      return {{SkRect::MakeXYWH(960, 24, 96, 40),
+               SkRect::MakeXYWH(492, 200, 96, 96)},
+              {SkIRect::MakeXYWH(0, 0, 1080, 320)}};
+  }
+}
+
+int64_t CountPixels(const std::vector<SkIRect>& rects) {
+  SkRegion region;
+  region.setRects(rects.data(), rects.size());
+  int64_t pixels = 0;
+  for (SkRegion::Iterator i(region); !i.done(); i.next()) {
+    pixels += static_cast<int64_t>(i.rect().width()) * i.rect().height();
+  }
+  return pixels;
+}
+
+}  // namespace
+
+// Computes the damage of a frame with a few small changes far apart, and
+// reports the number of pixels that are repainted with at most the given
+// number of damage rects.
+static void BM_DiffContextRepaintedPixels(benchmark::State& state) {
+  Scene scene = MakeScene(state.range(0));
+  size_t max_rects = state.range(1);
+  Damage damage;
+  while (state.KeepRunning()) {
+    PaintRegionMap this_frame;
+    PaintRegionMap last_frame;
+    DiffContext context(kFrameSize, 1, this_frame, last_frame);
+    context.PushCullRect(SkRect::Make(kFrameSize));
+    DiffContext::AutoSubtreeRestore subtree(&context);
+    for (const auto& readback : scene.readbacks) {
+      context.AddReadbackRegion(readback);
+    }
+    context.MarkSubtreeDirty();
+    for (const auto& change : scene.changes) {
+      context.AddLayerBounds(change);
+    }
+    damage = context.ComputeDamage(SkIRect::MakeEmpty(), max_rects);
+    benchmark::DoNotOptimize(damage);
+  }
+  state.counters["RepaintedPixels"] = CountPixels(damage.buffer_damage_rects);
+  state.counters["DamageRects"] = damage.buffer_damage_rects.size();
+}
+
+static void DamageArguments(benchmark::internal::Benchmark* benchmark) {
+  for (int scene = 0; scene < 4; scene++) {
+    for (int max_rects : {1, 2, 4, 8}) {
+      benchmark->Args({scene, max_rects});
+    }
+  }
+}
+
+BENCHMARK(BM_DiffContextRepaintedPixels)->Apply(DamageArguments);
+
+}  // namespace flutter
@@ -0,0 +1,73 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/gpu/gpu_surface_software_tiles.h"
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "third_party/skia/include/core/SkPictureRecorder.h"
+#include "third_party/skia/include/effects/SkGradientShader.h"
+
+namespace flutter {
+
+// A frame with enough overlapping anti-aliased and shaded geometry to make
+// rasterization, rather than recording, dominate the cost.
+static sk_sp<SkPicture> MakeFrame(const SkISize& size) {
+  SkPictureRecorder recorder;
+  SkCanvas* canvas = recorder.beginRecording(SkRect::Make(size));
+  canvas->clear(SK_ColorWHITE);
+  SkPoint end_points[] = {{0, 0}, {SkIntToScalar(size.width()), 0}};
+  SkColor colors[] = {SK_ColorRED, SK_ColorBLUE};
+  SkPaint paint;
+  paint.setAntiAlias(true);
+  paint.setShader(SkGradientShader::MakeLinear(end_points, colors, nullptr, 2,
+                                               SkTileMode::kClamp));
+  for (int y = 0; y < size.height(); y += 32) {
+    for (int x = 0; x < size.width(); x += 32) {
+      canvas->drawCircle(x + 16, y + 16, 24, paint);
+    }
+  }
+  return recorder.finishRecordingAsPicture();
+}
+
+static void BM_SoftwareRasterizeSingleThread(benchmark::State& state) {
+  SkISize size = SkISize::Make(state.range(0), state.range(0) * 9 / 16);
+  sk_sp<SkPicture> frame = MakeFrame(size);
+  sk_sp<SkSurface> surface =
+      SkSurface::MakeRasterN32Premul(size.width(), size.height());
+  while (state.KeepRunning()) {
+    surface->getCanvas()->drawPicture(frame);
+  }
+}
+
+static void BM_SoftwareRasterizeTiles(benchmark::State& state) {
+  SkISize size = SkISize::Make(state.range(0), state.range(0) * 9 / 16);
+  sk_sp<SkPicture> frame = MakeFrame(size);
+  sk_sp<SkSurface> surface =
+      SkSurface::MakeRasterN32Premul(size.width(), size.height());
+  GPUSurfaceSoftwareTiles tiles(state.range(1));
+  while (state.KeepRunning()) {
+    tiles.Rasterize(frame, surface.get());
+  }
+}
+
+BENCHMARK(BM_SoftwareRasterizeSingleThread)
+    ->Arg(1280)
+    ->Arg(1920)
+    ->Arg(3840)
+    ->Unit(benchmark::kMillisecond);
+
+static void TileArguments(benchmark::internal::Benchmark* benchmark) {
+  for (int width : {1280, 1920, 3840}) {
+    for (int thread_count : {2, 4, 8, 16}) {
+      benchmark->Args({width, thread_count});
+    }
+  }
+}
+
+BENCHMARK(BM_SoftwareRasterizeTiles)
+    ->Apply(TileArguments)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace flutter
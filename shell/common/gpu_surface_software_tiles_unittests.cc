@@ -0,0 +1,152 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/gpu/gpu_surface_software_tiles.h"
+
+#include <cstdlib>
+#include <memory>
+
+#include "flutter/flow/compositor_context.h"
+#include "flutter/flow/layers/backdrop_filter_layer.h"
+#include "flutter/flow/layers/container_layer.h"
+#include "flutter/flow/layers/layer_tree.h"
+#include "flutter/flow/layers/physical_shape_layer.h"
+#include "gtest/gtest.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkSurface.h"
+#include "third_party/skia/include/effects/SkImageFilters.h"
+
+namespace flutter {
+namespace testing {
+
+// Smaller than the frames so that they are split into several tiles, the
+// last of which in each row and column are only partly covered.
+static constexpr int kTileSize = 64;
+static const SkISize kFrameSize = SkISize::Make(200, 150);
+
+static void AddShape(ContainerLayer& parent, SkColor color, SkPath path) {
+  parent.Add(std::make_shared<PhysicalShapeLayer>(
+      color, SK_ColorBLACK, 0.0f, path, Clip::antiAlias));
+}
+
+// A frame of anti-aliased shapes, with edges that cross the tile boundaries
+// at fractional offsets.
+static std::shared_ptr<ContainerLayer> CreateShapes() {
+  auto root = std::make_shared<ContainerLayer>();
+  AddShape(*root, SK_ColorWHITE, SkPath::Rect(SkRect::Make(kFrameSize)));
+  for (int y = 0; y <= kFrameSize.height(); y += kTileSize) {
+    for (int x = 0; x <= kFrameSize.width(); x += kTileSize) {
+      AddShape(*root, SK_ColorRED, SkPath::Circle(x + 0.3f, y + 0.7f, 21.5f));
+    }
+  }
+  AddShape(*root, SkColorSetARGB(0x80, 0x00, 0x00, 0xFF),
+           SkPath::Polygon({{3.5f, 140.25f}, {190.75f, 10.5f}, {196.0f, 20.0f}},
+                           true));
+  return root;
+}
+
+static void PaintLayerTree(const std::shared_ptr<Layer>& root_layer,
+                           SkCanvas* canvas) {
+  LayerTree layer_tree(kFrameSize, 1.0f);
+  layer_tree.set_root_layer(root_layer);
+  CompositorContext compositor_context;
+  auto frame = compositor_context.AcquireFrame(
+      nullptr, canvas, nullptr, SkMatrix::I(), false, true, nullptr);
+  layer_tree.Preroll(*frame, true);
+  layer_tree.Paint(*frame, true);
+}
+
+static SkBitmap RenderSingleThreaded(const std::shared_ptr<Layer>& root_layer) {
+  sk_sp<SkSurface> surface =
+      SkSurface::MakeRasterN32Premul(kFrameSize.width(), kFrameSize.height());
+  PaintLayerTree(root_layer, surface->getCanvas());
+  SkBitmap bitmap;
+  bitmap.allocPixels(surface->imageInfo());
+  EXPECT_TRUE(surface->readPixels(bitmap, 0, 0));
+  return bitmap;
+}
+
+static SkBitmap RenderTiles(const std::shared_ptr<Layer>& root_layer) {
+  sk_sp<SkSurface> surface =
+      SkSurface::MakeRasterN32Premul(kFrameSize.width(), kFrameSize.height());
+  GPUSurfaceSoftwareTiles tiles(4, kTileSize);
+  PaintLayerTree(root_layer, tiles.BeginRecording(kFrameSize));
+  EXPECT_TRUE(tiles.FinishRecordingAndRasterize(surface.get()));
+  SkBitmap bitmap;
+  bitmap.allocPixels(surface->imageInfo());
+  EXPECT_TRUE(surface->readPixels(bitmap, 0, 0));
+  return bitmap;
+}
+
+// Whether no channel of any pixel differs by more than one. Shading a tile
+// from a translated canvas may round differently, but anything more is a
+// seam.
+static bool PixelsMatch(const SkBitmap& expected, const SkBitmap& actual) {
+  if (expected.dimensions() != actual.dimensions()) {
+    return false;
+  }
+  for (int y = 0; y < expected.height(); y++) {
+    for (int x = 0; x < expected.width(); x++) {
+      SkColor a = expected.getColor(x, y);
+      SkColor b = actual.getColor(x, y);
+      if (std::abs(int{SkColorGetA(a)} - int{SkColorGetA(b)}) > 1 ||
+          std::abs(int{SkColorGetR(a)} - int{SkColorGetR(b)}) > 1 ||
+          std::abs(int{SkColorGetG(a)} - int{SkColorGetG(b)}) > 1 ||
+          std::abs(int{SkColorGetB(a)} - int{SkColorGetB(b)}) > 1) {
+        ADD_FAILURE() << "Pixels differ at (" << x << ", " << y << ")";
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+TEST(GPUSurfaceSoftwareTilesTest, ComputesTilesCoveringTheFrame) {
+  auto tiles = GPUSurfaceSoftwareTiles::ComputeTiles(kFrameSize, kTileSize);
+  ASSERT_EQ(tiles.size(), 12u);
+  EXPECT_EQ(tiles.front(), SkIRect::MakeLTRB(0, 0, 64, 64));
+  EXPECT_EQ(tiles[3], SkIRect::MakeLTRB(192, 0, 200, 64));
+  EXPECT_EQ(tiles.back(), SkIRect::MakeLTRB(192, 128, 200, 150));
+}
+
+TEST(GPUSurfaceSoftwareTilesTest, MatchesSingleThreadedRasterization) {
+  auto root = CreateShapes();
+  EXPECT_TRUE(PixelsMatch(RenderSingleThreaded(root), RenderTiles(root)));
+}
+
+TEST(GPUSurfaceSoftwareTilesTest, BackdropFiltersAreNotSplitIntoTiles) {
+  // The blur samples the pixels across the tile boundaries, so it only
+  // matches if the frame is rasterized in one piece.
+  auto root = CreateShapes();
+  auto backdrop = std::make_shared<BackdropFilterLayer>(
+      SkImageFilters::Blur(8, 8, SkTileMode::kClamp, nullptr),
+      SkBlendMode::kSrcOver);
+  AddShape(*backdrop, SkColorSetARGB(0x40, 0x00, 0xFF, 0x00),
+           SkPath::Rect(SkRect::MakeLTRB(10, 10, 150, 120)));
+  root->Add(backdrop);
+  EXPECT_TRUE(PixelsMatch(RenderSingleThreaded(root), RenderTiles(root)));
+}
+
+TEST(GPUSurfaceSoftwareTilesTest, OnlyRasterizesDamagedTiles) {
+  sk_sp<SkSurface> surface =
+      SkSurface::MakeRasterN32Premul(kFrameSize.width(), kFrameSize.height());
+  surface->getCanvas()->clear(SK_ColorBLACK);
+
+  GPUSurfaceSoftwareTiles tiles(4, kTileSize);
+  SkCanvas* canvas = tiles.BeginRecording(kFrameSize);
+  canvas->clear(SK_ColorWHITE);
+  std::vector<SkIRect> damage = {SkIRect::MakeXYWH(70, 70, 10, 10)};
+  ASSERT_TRUE(tiles.FinishRecordingAndRasterize(surface.get(), damage));
+
+  SkBitmap bitmap;
+  bitmap.allocPixels(surface->imageInfo());
+  ASSERT_TRUE(surface->readPixels(bitmap, 0, 0));
+  EXPECT_EQ(bitmap.getColor(75, 75), SK_ColorWHITE);
+  // Outside of the damage, in the same tile and in another one.
+  EXPECT_EQ(bitmap.getColor(65, 65), SK_ColorBLACK);
+  EXPECT_EQ(bitmap.getColor(10, 10), SK_ColorBLACK);
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -2,6 +2,9 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <cstring>
+
+#include "flutter/shell/common/pointer_data_dispatcher.h"
 #include "flutter/shell/common/shell_test.h"
 #include "flutter/testing/testing.h"
 
@@ -145,6 +148,7 @@ void CreateSimulatedPointerData(PointerData& data,
                                 PointerData::Change change,
                                 double dx,
                                 double dy) {
+  data.embedder_id = 0;
   data.time_stamp = 0;
   data.change = change;
   data.kind = PointerData::DeviceKind::kTouch;
@@ -412,5 +416,124 @@ TEST_F(ShellTest, CanCorrectlySynthesizePointerPacket) {
   ASSERT_FALSE(DartVMRef::IsInstanceRunning());
 }
 
+class FakePointerDataDispatcherDelegate
+    : public PointerDataDispatcher::Delegate {
+ public:
+  void DoDispatchPacket(std::unique_ptr<PointerDataPacket> packet,
+                        uint64_t trace_flow_id) override {
+    packets.push_back(std::move(packet));
+  }
+
+  void ScheduleSecondaryVsyncCallback(uintptr_t id,
+                                      const fml::closure& callback) override {
+    vsync_callback = callback;
+  }
+
+  // Runs the callback scheduled for the next vsync, if any.
+  void FireVsync() {
+    fml::closure callback = std::move(vsync_callback);
+    vsync_callback = nullptr;
+    if (callback) {
+      callback();
+    }
+  }
+
+  std::vector<std::unique_ptr<PointerDataPacket>> packets;
+  fml::closure vsync_callback;
+};
+
+static std::unique_ptr<PointerDataPacket> CreatePacket(
+    const std::vector<PointerData>& events) {
+  auto packet = std::make_unique<PointerDataPacket>(events.size());
+  for (size_t i = 0; i < events.size(); i++) {
+    packet->SetPointerData(i, events[i]);
+  }
+  return packet;
+}
+
+static std::vector<PointerData> UnpackPacket(const PointerDataPacket& packet) {
+  std::vector<PointerData> events(packet.data().size() / sizeof(PointerData));
+  memcpy(events.data(), packet.data().data(), packet.data().size());
+  return events;
+}
+
+static PointerData CreateMove(int64_t device, double x, double dx) {
+  PointerData data;
+  CreateSimulatedPointerData(data, PointerData::Change::kMove, x, 0.0);
+  data.device = device;
+  data.physical_delta_x = dx;
+  return data;
+}
+
+TEST(CoalescingPointerDataDispatcherTest, CoalescesMoveEventsPerFrame) {
+  FakePointerDataDispatcherDelegate delegate;
+  CoalescingPointerDataDispatcher dispatcher(delegate);
+
+  PointerData down;
+  CreateSimulatedPointerData(down, PointerData::Change::kDown, 0.0, 0.0);
+  dispatcher.DispatchPacket(CreatePacket({down}), 0);
+  // The first packet of a frame is not delayed.
+  ASSERT_EQ(delegate.packets.size(), 1u);
+
+  for (int i = 1; i <= 10; i++) {
+    dispatcher.DispatchPacket(CreatePacket({CreateMove(0, i, 1.0)}), i);
+    if (i == 5) {
+      dispatcher.DispatchPacket(CreatePacket({CreateMove(1, 50.0, 2.0)}), i);
+    }
+  }
+  ASSERT_EQ(delegate.packets.size(), 1u);
+
+  delegate.FireVsync();
+  ASSERT_EQ(delegate.packets.size(), 2u);
+  std::vector<PointerData> events = UnpackPacket(*delegate.packets[1]);
+  ASSERT_EQ(events.size(), 2u);
+  // The merged event takes the place of the latest one.
+  EXPECT_EQ(events[0].device, 1);
+  EXPECT_EQ(events[0].physical_x, 50.0);
+  EXPECT_EQ(events[1].device, 0);
+  EXPECT_EQ(events[1].physical_x, 10.0);
+  EXPECT_EQ(events[1].physical_delta_x, 10.0);
+  EXPECT_EQ(dispatcher.GetCoalescedEventCount(), 9u);
+
+  // Nothing is pending, so the next packet is dispatched right away.
+  delegate.FireVsync();
+  ASSERT_EQ(delegate.packets.size(), 2u);
+  dispatcher.DispatchPacket(CreatePacket({CreateMove(0, 11.0, 1.0)}), 11);
+  ASSERT_EQ(delegate.packets.size(), 3u);
+}
+
+TEST(CoalescingPointerDataDispatcherTest, KeepsOtherChanges) {
+  FakePointerDataDispatcherDelegate delegate;
+  CoalescingPointerDataDispatcher dispatcher(delegate);
+
+  PointerData down;
+  CreateSimulatedPointerData(down, PointerData::Change::kDown, 0.0, 0.0);
+  PointerData up;
+  CreateSimulatedPointerData(up, PointerData::Change::kUp, 2.0, 0.0);
+  PointerData platform_move = CreateMove(0, 3.0, 1.0);
+  platform_move.embedder_id = 1;
+  PointerData dragging_move = CreateMove(0, 4.0, 1.0);
+  dragging_move.buttons = kPointerButtonMousePrimary;
+
+  dispatcher.DispatchPacket(CreatePacket({down}), 0);
+  dispatcher.DispatchPacket(
+      CreatePacket({CreateMove(0, 1.0, 1.0), CreateMove(0, 2.0, 1.0), up, down,
+                    platform_move, CreateMove(0, 4.0, 1.0), dragging_move}),
+      1);
+  delegate.FireVsync();
+
+  ASSERT_EQ(delegate.packets.size(), 2u);
+  std::vector<PointerData> events = UnpackPacket(*delegate.packets[1]);
+  ASSERT_EQ(events.size(), 6u);
+  EXPECT_EQ(events[0].change, PointerData::Change::kMove);
+  EXPECT_EQ(events[0].physical_delta_x, 2.0);
+  EXPECT_EQ(events[1].change, PointerData::Change::kUp);
+  EXPECT_EQ(events[2].change, PointerData::Change::kDown);
+  EXPECT_EQ(events[3].embedder_id, 1);
+  EXPECT_EQ(events[4].buttons, 0);
+  EXPECT_EQ(events[5].buttons, kPointerButtonMousePrimary);
+  EXPECT_EQ(dispatcher.GetCoalescedEventCount(), 1u);
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -0,0 +1,83 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/common/graphics/texture.h"
+#include "flutter/flow/instrumentation.h"
+#include "flutter/flow/layers/clip_rect_layer.h"
+#include "flutter/flow/layers/container_layer.h"
+#include "flutter/flow/layers/transform_layer.h"
+
+namespace flutter {
+
+namespace {
+
+// Builds a tree of transforms with the given depth in which every layer has
+// four children, and with clips as its leaves.
+std::shared_ptr<ContainerLayer> MakeSubtree(int depth) {
+  if (depth == 0) {
+    return std::make_shared<ClipRectLayer>(SkRect::MakeWH(100, 40),
+                                           Clip::hardEdge);
+  }
+  auto layer = std::make_shared<TransformLayer>(
+      SkMatrix::Translate(depth * 10.0f, depth * 20.0f));
+  for (int i = 0; i < 4; i++) {
+    layer->Add(MakeSubtree(depth - 1));
+  }
+  return layer;
+}
+
+}  // namespace
+
+// Prerolls a frame whose root holds a retained subtree, as is the case for a
+// mostly static screen with a small animation elsewhere. When the subtree
+// moves, its preroll cannot be reused and runs again in every frame.
+static void BM_LayerTreePrerollRetainedSubtree(benchmark::State& state) {
+  auto subtree = MakeSubtree(state.range(0));
+  bool moves = state.range(1);
+  MutatorsStack mutators_stack;
+  Stopwatch raster_time;
+  Stopwatch ui_time;
+  TextureRegistry texture_registry;
+  int frame = 0;
+  while (state.KeepRunning()) {
+    auto root = std::make_shared<ContainerLayer>();
+    auto transform = std::make_shared<TransformLayer>(
+        SkMatrix::Translate(0, moves ? frame % 2 : 0));
+    transform->Add(subtree);
+    root->Add(transform);
+    PrerollContext context = {
+        nullptr,  // raster_cache
+        nullptr,  // gr_context
+        nullptr,  // view_embedder
+        mutators_stack,
+        nullptr,  // dst_color_space
+        kGiantRect,
+        false,  // surface_needs_readback
+        raster_time,
+        ui_time,
+        texture_registry,
+        false,  // checkerboard_offscreen_layers
+        1.0f,   // frame_device_pixel_ratio
+    };
+    root->Preroll(&context, SkMatrix::I());
+    benchmark::DoNotOptimize(root->paint_bounds());
+    frame++;
+  }
+}
+
+static void RetainedSubtreeArguments(
+    benchmark::internal::Benchmark* benchmark) {
+  for (int depth : {2, 4, 6}) {
+    for (int moves : {0, 1}) {
+      benchmark->Args({depth, moves});
+    }
+  }
+}
+
+BENCHMARK(BM_LayerTreePrerollRetainedSubtree)
+    ->Apply(RetainedSubtreeArguments)
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace flutter
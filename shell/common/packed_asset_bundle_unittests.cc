@@ -0,0 +1,155 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/assets/packed_asset_bundle.h"
+
+#include <memory>
+
+#include "flutter/assets/asset_manager.h"
+#include "flutter/assets/directory_asset_bundle.h"
+#include "flutter/common/settings.h"
+#include "flutter/fml/file.h"
+#include "flutter/shell/common/run_configuration.h"
+#include "flutter/testing/testing.h"
+
+namespace flutter {
+namespace testing {
+
+static void WriteAsset(const fml::UniqueFD& assets_dir,
+                       const std::vector<std::string>& directories,
+                       const std::string& file_name,
+                       const std::string& contents) {
+  fml::UniqueFD dir = fml::Duplicate(assets_dir.get());
+  if (!directories.empty()) {
+    dir = fml::CreateDirectory(assets_dir, directories,
+                               fml::FilePermission::kReadWrite);
+  }
+  if (contents.empty()) {
+    // There is nothing to write atomically.
+    ASSERT_TRUE(fml::OpenFile(dir, file_name.c_str(), true,
+                              fml::FilePermission::kReadWrite)
+                    .is_valid());
+    return;
+  }
+  ASSERT_TRUE(fml::WriteAtomically(dir, file_name.c_str(),
+                                   fml::DataMapping(contents)));
+}
+
+static void WritePack(const fml::UniqueFD& assets_dir) {
+  auto pack = PackedAssetBundle::CreatePack(assets_dir);
+  ASSERT_NE(pack, nullptr);
+  ASSERT_TRUE(fml::WriteAtomically(assets_dir, PackedAssetBundle::kFileName,
+                                   *pack));
+}
+
+static std::unique_ptr<AssetResolver> OpenPack(
+    const fml::UniqueFD& assets_dir) {
+  return std::make_unique<PackedAssetBundle>(
+      fml::OpenFileReadOnly(assets_dir, PackedAssetBundle::kFileName), true);
+}
+
+static std::string ToString(const std::unique_ptr<fml::Mapping>& mapping) {
+  return std::string(reinterpret_cast<const char*>(mapping->GetMapping()),
+                     mapping->GetSize());
+}
+
+TEST(PackedAssetBundleTest, ResolvesPackedAssets) {
+  fml::ScopedTemporaryDirectory assets_dir;
+  WriteAsset(assets_dir.fd(), {}, "AssetManifest.json", "{}");
+  WriteAsset(assets_dir.fd(), {"fonts"}, "Roboto.ttf", "font");
+  WriteAsset(assets_dir.fd(), {"shaders"}, "a.skp", "first");
+  WriteAsset(assets_dir.fd(), {"shaders", "nested"}, "b.skp", "second");
+  WriteAsset(assets_dir.fd(), {"shaders"}, "empty.skp", "");
+  WritePack(assets_dir.fd());
+
+  AssetManager asset_manager;
+  asset_manager.PushBack(OpenPack(assets_dir.fd()));
+  ASSERT_TRUE(asset_manager.IsValid());
+
+  EXPECT_EQ(ToString(asset_manager.GetAsMapping("AssetManifest.json")), "{}");
+  EXPECT_EQ(ToString(asset_manager.GetAsMapping("fonts/Roboto.ttf")), "font");
+  EXPECT_EQ(ToString(asset_manager.GetAsMapping("shaders/nested/b.skp")),
+            "second");
+  EXPECT_EQ(asset_manager.GetAsMapping("shaders/empty.skp")->GetSize(), 0u);
+  EXPECT_EQ(asset_manager.GetAsMapping("Roboto.ttf"), nullptr);
+  EXPECT_EQ(asset_manager.GetAsMapping("fonts/Missing.ttf"), nullptr);
+  EXPECT_EQ(asset_manager.GetAsMapping(PackedAssetBundle::kFileName), nullptr);
+
+  // Like the directory bundle, a search in a subdirectory is flat, and a
+  // search without one is recursive.
+  EXPECT_EQ(asset_manager.GetAsMappings(".*\\.skp$", "shaders").size(), 2u);
+  EXPECT_EQ(asset_manager.GetAsMappings(".*\\.skp$", std::nullopt).size(), 3u);
+  EXPECT_EQ(asset_manager.GetAsMappings(".*\\.skp$", "fonts").size(), 0u);
+}
+
+TEST(PackedAssetBundleTest, MappingsOutliveTheBundle) {
+  fml::ScopedTemporaryDirectory assets_dir;
+  WriteAsset(assets_dir.fd(), {}, "asset", "contents");
+  WritePack(assets_dir.fd());
+
+  std::unique_ptr<fml::Mapping> mapping;
+  {
+    AssetManager asset_manager;
+    asset_manager.PushBack(OpenPack(assets_dir.fd()));
+    mapping = asset_manager.GetAsMapping("asset");
+  }
+  EXPECT_EQ(ToString(mapping), "contents");
+}
+
+TEST(PackedAssetBundleTest, IsInvalidForCorruptPacks) {
+  fml::ScopedTemporaryDirectory assets_dir;
+  EXPECT_FALSE(OpenPack(assets_dir.fd())->IsValid());
+
+  WriteAsset(assets_dir.fd(), {}, PackedAssetBundle::kFileName,
+             "not an asset pack");
+  EXPECT_FALSE(OpenPack(assets_dir.fd())->IsValid());
+}
+
+TEST(PackedAssetBundleTest, RunConfigurationResolvesFromPackFirst) {
+  fml::ScopedTemporaryDirectory assets_dir;
+  WriteAsset(assets_dir.fd(), {}, "packed", "from pack");
+  WritePack(assets_dir.fd());
+  // The pack takes precedence over the directory, which still resolves the
+  // assets that are not in the pack.
+  WriteAsset(assets_dir.fd(), {}, "packed", "from directory");
+  WriteAsset(assets_dir.fd(), {}, "unpacked", "from directory");
+
+  Settings settings;
+  settings.assets_path = assets_dir.path();
+  auto config = RunConfiguration::InferFromSettings(settings);
+  auto asset_manager = config.GetAssetManager();
+  EXPECT_EQ(ToString(asset_manager->GetAsMapping("packed")), "from pack");
+  EXPECT_EQ(ToString(asset_manager->GetAsMapping("unpacked")),
+            "from directory");
+}
+
+TEST(PackedAssetBundleTest, RunConfigurationMapsEachAssetOnce) {
+  fml::ScopedTemporaryDirectory assets_dir;
+  WriteAsset(assets_dir.fd(), {"shaders"}, "a.skp", "packed");
+  WriteAsset(assets_dir.fd(), {"shaders", "nested"}, "b.skp", "packed");
+  WritePack(assets_dir.fd());
+  // The files that were packed are still in the directory, next to one that
+  // was not.
+  WriteAsset(assets_dir.fd(), {"shaders"}, "c.skp", "unpacked");
+
+  Settings settings;
+  settings.assets_path = assets_dir.path();
+  auto config = RunConfiguration::InferFromSettings(settings);
+  auto asset_manager = config.GetAssetManager();
+
+  auto mappings = asset_manager->GetAsMappings(".*\\.skp$", "shaders");
+  ASSERT_EQ(mappings.size(), 2u);
+  EXPECT_EQ(ToString(mappings[0]), "packed");
+  EXPECT_EQ(ToString(mappings[1]), "unpacked");
+  EXPECT_EQ(asset_manager->GetAsMappings(".*\\.skp$", std::nullopt).size(),
+            3u);
+
+  // The pack itself is not an asset.
+  EXPECT_EQ(asset_manager->GetAsMappings(".*", std::nullopt).size(), 3u);
+  EXPECT_EQ(asset_manager->GetAsMapping(PackedAssetBundle::kFileName),
+            nullptr);
+}
+
+}  // namespace testing
+}  // namespace flutter
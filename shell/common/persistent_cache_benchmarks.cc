@@ -0,0 +1,100 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/common/graphics/persistent_cache.h"
+
+#include <cstring>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/common/graphics/persistent_cache_pack.h"
+#include "flutter/fml/file.h"
+#include "flutter/shell/version/version.h"
+
+namespace flutter {
+
+namespace {
+
+// About the size of a compiled shader program.
+constexpr size_t kEntrySize = 4 * 1024;
+
+enum class CacheLayout {
+  // One file per entry, as written by earlier versions.
+  kFiles,
+  kPack,
+};
+
+// Stores |count| entries in the persistent cache under |base_dir| using
+// |layout|, and returns their keys.
+std::vector<sk_sp<SkData>> FillCache(const fml::UniqueFD& base_dir,
+                                     size_t count,
+                                     CacheLayout layout) {
+  auto cache_dir = std::make_shared<fml::UniqueFD>(fml::CreateDirectory(
+      base_dir,
+      {"flutter_engine", GetFlutterEngineVersion(), "skia", GetSkiaVersion()},
+      fml::FilePermission::kReadWrite));
+  PersistentCachePack pack(cache_dir, false);
+
+  sk_sp<SkData> value = SkData::MakeUninitialized(kEntrySize);
+  memset(value->writable_data(), 0xA5, value->size());
+
+  std::vector<sk_sp<SkData>> keys;
+  for (size_t i = 0; i < count; ++i) {
+    std::string name = "shader " + std::to_string(i);
+    sk_sp<SkData> key = SkData::MakeWithCopy(name.data(), name.size());
+    if (layout == CacheLayout::kPack) {
+      pack.Store(*key, *value);
+    } else {
+      fml::WriteAtomically(*cache_dir,
+                           PersistentCache::SkKeyToFilePath(*key).c_str(),
+                           *PersistentCache::BuildCacheObject(*key, *value));
+    }
+    keys.push_back(std::move(key));
+  }
+  return keys;
+}
+
+// Opens the persistent cache and loads every entry from it, as the first
+// frames after a cold start would. The files stay in the OS page cache between
+// iterations, so this measures the cost of the file system calls rather than
+// of the storage.
+void RunStartupBenchmark(benchmark::State& state, CacheLayout layout) {
+  fml::ScopedTemporaryDirectory base_dir;
+  std::vector<sk_sp<SkData>> keys =
+      FillCache(base_dir.fd(), state.range(0), layout);
+  PersistentCache::SetCacheDirectoryPath(base_dir.path());
+
+  while (state.KeepRunning()) {
+    PersistentCache::ResetCacheForProcess();
+    PersistentCache* cache = PersistentCache::GetCacheForProcess();
+    for (const sk_sp<SkData>& key : keys) {
+      sk_sp<SkData> value = cache->load(*key);
+      benchmark::DoNotOptimize(value);
+    }
+  }
+
+  PersistentCache::SetCacheDirectoryPath("");
+  PersistentCache::ResetCacheForProcess();
+}
+
+}  // namespace
+
+static void BM_PersistentCacheStartupFiles(benchmark::State& state) {
+  RunStartupBenchmark(state, CacheLayout::kFiles);
+}
+
+static void BM_PersistentCacheStartupPack(benchmark::State& state) {
+  RunStartupBenchmark(state, CacheLayout::kPack);
+}
+
+BENCHMARK(BM_PersistentCacheStartupFiles)
+    ->Arg(64)
+    ->Arg(512)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_PersistentCacheStartupPack)
+    ->Arg(64)
+    ->Arg(512)
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace flutter
@@ -3,8 +3,10 @@
 // found in the LICENSE file.
 
 #include "flutter/common/graphics/persistent_cache.h"
+#include "flutter/common/graphics/persistent_cache_pack.h"
 
 #include <memory>
+#include <mutex>
 
 #include "flutter/assets/directory_asset_bundle.h"
 #include "flutter/flow/layers/container_layer.h"
@@ -14,6 +16,7 @@
 #include "flutter/fml/command_line.h"
 #include "flutter/fml/file.h"
 #include "flutter/fml/log_settings.h"
+#include "flutter/fml/thread.h"
 #include "flutter/fml/unique_fd.h"
 #include "flutter/shell/common/shell_test.h"
 #include "flutter/shell/common/switches.h"
@@ -21,6 +24,10 @@
 #include "flutter/testing/testing.h"
 #include "include/core/SkPicture.h"
 
+#ifdef SHELL_ENABLE_GL
+#include "flutter/testing/test_gl_surface.h"
+#endif  // SHELL_ENABLE_GL
+
 namespace flutter {
 namespace testing {
 
@@ -402,5 +409,262 @@ TEST_F(PersistentCacheTest,
   DestroyShell(std::move(shell));
 }
 
+TEST_F(PersistentCacheTest,
+#if defined(WINUWP)
+       // TODO(cbracken): https://github.com/flutter/flutter/issues/90481
+       DISABLED_LoadsFromPackAndIndividualFiles
+#else
+       LoadsFromPackAndIndividualFiles
+#endif  // defined(WINUWP)
+) {
+  fml::ScopedTemporaryDirectory base_dir;
+  ASSERT_TRUE(base_dir.fd().is_valid());
+  auto cache_dir = fml::CreateDirectory(
+      base_dir.fd(),
+      {"flutter_engine", GetFlutterEngineVersion(), "skia", GetSkiaVersion()},
+      fml::FilePermission::kReadWrite);
+  PersistentCache::SetCacheDirectoryPath(base_dir.path());
+  PersistentCache::ResetCacheForProcess();
+
+  // There are no worker task runners, so this is written on this thread.
+  sk_sp<SkData> packed_key = SkData::MakeWithCopy("A", 1);
+  sk_sp<SkData> packed_value = SkData::MakeWithCopy("x", 1);
+  StorePersistentCache(PersistentCache::GetCacheForProcess(), *packed_key,
+                       *packed_value);
+  ASSERT_TRUE(fml::FileExists(cache_dir, PersistentCachePack::kFileName));
+
+  // An entry stored as an individual file by an earlier version.
+  sk_sp<SkData> file_key = SkData::MakeWithCopy("B", 1);
+  sk_sp<SkData> file_value = SkData::MakeWithCopy("y", 1);
+  auto file_data = PersistentCache::BuildCacheObject(*file_key, *file_value);
+  ASSERT_TRUE(fml::WriteAtomically(
+      cache_dir, PersistentCache::SkKeyToFilePath(*file_key).c_str(),
+      *file_data));
+
+  PersistentCache::ResetCacheForProcess();
+  PersistentCache* cache = PersistentCache::GetCacheForProcess();
+  CheckTextSkData(cache->load(*packed_key), "x");
+  CheckTextSkData(cache->load(*file_key), "y");
+  ASSERT_EQ(cache->load(*SkData::MakeWithCopy("C", 1)), nullptr);
+
+  // Cleanup
+  fml::RemoveFilesInDirectory(base_dir.fd());
+}
+
+static void StoreSkSLFile(const fml::UniqueFD& sksl_dir,
+                          const std::string& key,
+                          const std::string& value) {
+  auto key_data = SkData::MakeWithCString(key.c_str());
+  auto value_data = SkData::MakeWithCString(value.c_str());
+  auto file_data = PersistentCache::BuildCacheObject(*key_data, *value_data);
+  ASSERT_TRUE(fml::WriteAtomically(
+      sksl_dir, PersistentCache::SkKeyToFilePath(*key_data).c_str(),
+      *file_data));
+}
+
+TEST_F(PersistentCacheTest, PrecompileUsesPrefetchedSkSLs) {
+#if !SHELL_ENABLE_GL
+  // Precompilation needs a rendering context.
+  GTEST_SKIP();
+#else
+  fml::ScopedTemporaryDirectory base_dir;
+  ASSERT_TRUE(base_dir.fd().is_valid());
+  auto sksl_dir = fml::CreateDirectory(
+      base_dir.fd(),
+      {"flutter_engine", GetFlutterEngineVersion(), "skia", GetSkiaVersion(),
+       PersistentCache::kSkSLSubdirName},
+      fml::FilePermission::kReadWrite);
+  PersistentCache::SetCacheDirectoryPath(base_dir.path());
+  PersistentCache::ResetCacheForProcess();
+  PersistentCache* cache = PersistentCache::GetCacheForProcess();
+
+  StoreSkSLFile(sksl_dir, "A", "x");
+  StoreSkSLFile(sksl_dir, "B", "y");
+
+  fml::Thread worker("io.flutter.test.persistent_cache_worker");
+  cache->AddWorkerTaskRunner(worker.GetTaskRunner());
+  cache->PrefetchKnownSkSLs();
+  fml::AutoResetWaitableEvent latch;
+  worker.GetTaskRunner()->PostTask([&latch]() { latch.Signal(); });
+  latch.Wait();
+
+  // Not seen by the prefetch that has already completed.
+  StoreSkSLFile(sksl_dir, "C", "z");
+
+  // The prefetched SkSLs are kept while other shells are still alive.
+  fml::Thread other_worker("io.flutter.test.persistent_cache_other_worker");
+  cache->AddWorkerTaskRunner(other_worker.GetTaskRunner());
+  cache->RemoveWorkerTaskRunner(other_worker.GetTaskRunner());
+
+  TestGLSurface surface(SkISize::Make(1, 1));
+  auto context = surface.GetGrContext();
+  ASSERT_TRUE(context);
+
+  std::vector<std::pair<size_t, size_t>> progress;
+  auto progress_callback = [&progress](size_t precompiled_count,
+                                       size_t total_count) {
+    progress.emplace_back(precompiled_count, total_count);
+  };
+  cache->PrecompileKnownSkSLs(context.get(), progress_callback);
+  ASSERT_EQ(progress.size(), 2u);
+  ASSERT_EQ(progress[0], std::make_pair<size_t, size_t>(1, 2));
+  ASSERT_EQ(progress[1], std::make_pair<size_t, size_t>(2, 2));
+
+  // The prefetched SkSLs are only used once. They are loaded again on this
+  // thread afterwards.
+  progress.clear();
+  cache->PrecompileKnownSkSLs(context.get(), progress_callback);
+  ASSERT_EQ(progress.size(), 3u);
+  ASSERT_EQ(progress.back(), std::make_pair<size_t, size_t>(3, 3));
+
+  // Cleanup
+  cache->RemoveWorkerTaskRunner(worker.GetTaskRunner());
+  fml::RemoveFilesInDirectory(base_dir.fd());
+  PersistentCache::ResetCacheForProcess();
+#endif  // !SHELL_ENABLE_GL
+}
+
+TEST_F(PersistentCacheTest, PrecompileReportsCompletionWithNoSkSLs) {
+#if !SHELL_ENABLE_GL
+  // Precompilation needs a rendering context.
+  GTEST_SKIP();
+#else
+  fml::ScopedTemporaryDirectory base_dir;
+  ASSERT_TRUE(base_dir.fd().is_valid());
+  PersistentCache::SetCacheDirectoryPath(base_dir.path());
+  PersistentCache::ResetCacheForProcess();
+
+  TestGLSurface surface(SkISize::Make(1, 1));
+  auto context = surface.GetGrContext();
+  ASSERT_TRUE(context);
+
+  std::vector<std::pair<size_t, size_t>> progress;
+  PersistentCache::GetCacheForProcess()->PrecompileKnownSkSLs(
+      context.get(), [&progress](size_t precompiled_count,
+                                 size_t total_count) {
+        progress.emplace_back(precompiled_count, total_count);
+      });
+  ASSERT_EQ(progress.size(), 1u);
+  ASSERT_EQ(progress[0], std::make_pair<size_t, size_t>(0, 0));
+
+  // Cleanup
+  fml::RemoveFilesInDirectory(base_dir.fd());
+  PersistentCache::ResetCacheForProcess();
+#endif  // !SHELL_ENABLE_GL
+}
+
+TEST(PersistentCachePackTest, LaterRecordsReplaceEarlierOnes) {
+  fml::ScopedTemporaryDirectory dir;
+  auto dir_fd = std::make_shared<fml::UniqueFD>(fml::OpenDirectory(
+      dir.path().c_str(), false, fml::FilePermission::kReadWrite));
+
+  sk_sp<SkData> key = SkData::MakeWithCopy("A", 1);
+  sk_sp<SkData> large_value = SkData::MakeUninitialized(128 * 1024);
+  memset(large_value->writable_data(), 'x', large_value->size());
+  sk_sp<SkData> value = SkData::MakeWithCopy("y", 1);
+  {
+    PersistentCachePack pack(dir_fd, false);
+    ASSERT_TRUE(pack.Store(*key, *large_value));
+    ASSERT_FALSE(pack.ShouldCompact());
+    ASSERT_TRUE(pack.Store(*key, *value));
+    CheckTextSkData(pack.Load(*key), "y");
+  }
+
+  // The replaced record is still in the file until the pack is compacted.
+  PersistentCachePack pack(dir_fd, false);
+  ASSERT_EQ(pack.GetEntryCount(), 1u);
+  CheckTextSkData(pack.Load(*key), "y");
+  ASSERT_TRUE(pack.ShouldCompact());
+  ASSERT_TRUE(pack.Compact());
+  ASSERT_FALSE(pack.ShouldCompact());
+  CheckTextSkData(pack.Load(*key), "y");
+
+  auto file = fml::OpenFileReadOnly(*dir_fd, PersistentCachePack::kFileName);
+  ASSERT_LT(fml::FileMapping(file).GetSize(), 1024u);
+}
+
+TEST(PersistentCachePackTest, IgnoresIncompleteRecords) {
+  fml::ScopedTemporaryDirectory dir;
+  auto dir_fd = std::make_shared<fml::UniqueFD>(fml::OpenDirectory(
+      dir.path().c_str(), false, fml::FilePermission::kReadWrite));
+
+  sk_sp<SkData> first_key = SkData::MakeWithCopy("A", 1);
+  sk_sp<SkData> second_key = SkData::MakeWithCopy("B", 1);
+  {
+    PersistentCachePack pack(dir_fd, false);
+    ASSERT_TRUE(pack.Store(*first_key, *SkData::MakeWithCopy("x", 1)));
+    ASSERT_TRUE(pack.Store(*second_key, *SkData::MakeWithCopy("y", 1)));
+  }
+
+  // Cut the last record short, as if the process died while appending it.
+  {
+    auto file = fml::OpenFile(*dir_fd, PersistentCachePack::kFileName, false,
+                              fml::FilePermission::kReadWrite);
+    size_t size = fml::FileMapping(file).GetSize();
+    ASSERT_TRUE(fml::TruncateFile(file, size - 1));
+  }
+
+  PersistentCachePack pack(dir_fd, false);
+  ASSERT_EQ(pack.GetEntryCount(), 1u);
+  CheckTextSkData(pack.Load(*first_key), "x");
+  ASSERT_EQ(pack.Load(*second_key), nullptr);
+
+  // The next record is written over the incomplete one.
+  ASSERT_TRUE(pack.Store(*second_key, *SkData::MakeWithCopy("z", 1)));
+  PersistentCachePack reopened(dir_fd, true);
+  CheckTextSkData(reopened.Load(*first_key), "x");
+  CheckTextSkData(reopened.Load(*second_key), "z");
+}
+
+TEST(PersistentCachePackTest, KeepsRecordsAppendedByOtherWriters) {
+  fml::ScopedTemporaryDirectory dir;
+  auto dir_fd = std::make_shared<fml::UniqueFD>(fml::OpenDirectory(
+      dir.path().c_str(), false, fml::FilePermission::kReadWrite));
+
+  // Two packs of the same file, like those of two processes sharing a cache.
+  PersistentCachePack first(dir_fd, false);
+  PersistentCachePack second(dir_fd, false);
+  ASSERT_TRUE(first.Store(*SkData::MakeWithCopy("A", 1),
+                          *SkData::MakeWithCopy("x", 1)));
+  ASSERT_TRUE(second.Store(*SkData::MakeWithCopy("B", 1),
+                           *SkData::MakeWithCopy("y", 1)));
+  ASSERT_TRUE(first.Store(*SkData::MakeWithCopy("C", 1),
+                          *SkData::MakeWithCopy("z", 1)));
+
+  // A pack reads the records it stored, and those appended before its last
+  // store.
+  CheckTextSkData(first.Load(*SkData::MakeWithCopy("B", 1)), "y");
+  CheckTextSkData(first.Load(*SkData::MakeWithCopy("C", 1)), "z");
+
+  PersistentCachePack reopened(dir_fd, true);
+  ASSERT_EQ(reopened.GetEntryCount(), 3u);
+  CheckTextSkData(reopened.Load(*SkData::MakeWithCopy("A", 1)), "x");
+  CheckTextSkData(reopened.Load(*SkData::MakeWithCopy("B", 1)), "y");
+  CheckTextSkData(reopened.Load(*SkData::MakeWithCopy("C", 1)), "z");
+}
+
+TEST(PersistentCachePackTest, VisitsEntriesInStoreOrder) {
+  fml::ScopedTemporaryDirectory dir;
+  auto dir_fd = std::make_shared<fml::UniqueFD>(fml::OpenDirectory(
+      dir.path().c_str(), false, fml::FilePermission::kReadWrite));
+
+  const std::vector<std::string> keys = {"D", "A", "C", "B", "E"};
+  PersistentCachePack pack(dir_fd, false);
+  for (const std::string& key : keys) {
+    ASSERT_TRUE(pack.Store(*SkData::MakeWithCopy(key.data(), key.size()),
+                           *SkData::MakeWithCopy("x", 1)));
+  }
+  // A replaced entry moves to the end.
+  ASSERT_TRUE(pack.Store(*SkData::MakeWithCopy("A", 1),
+                         *SkData::MakeWithCopy("y", 1)));
+
+  std::vector<std::string> visited;
+  PersistentCachePack reopened(dir_fd, true);
+  reopened.VisitEntries([&visited](sk_sp<SkData> key, sk_sp<SkData> value) {
+    visited.emplace_back(static_cast<const char*>(key->data()), key->size());
+  });
+  ASSERT_EQ(visited, (std::vector<std::string>{"D", "C", "B", "E", "A"}));
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -4,6 +4,8 @@
 
 #include "flutter/shell/common/pointer_data_dispatcher.h"
 
+#include <cstring>
+
 #include "flutter/fml/trace_event.h"
 
 namespace flutter {
@@ -68,4 +70,119 @@ void SmoothPointerDataDispatcher::DispatchPendingPacket() {
   ScheduleSecondaryVsyncCallback();
 }
 
+namespace {
+
+// Whether |data| may be merged with other events of its device.
+bool IsCoalescable(const PointerData& data) {
+  return (data.change == PointerData::Change::kMove ||
+          data.change == PointerData::Change::kHover) &&
+         data.signal_kind == PointerData::SignalKind::kNone &&
+         data.embedder_id == 0;
+}
+
+// Whether |next| may replace |previous|, given that both are coalescable
+// events of the same device.
+bool CanCoalesce(const PointerData& previous, const PointerData& next) {
+  return previous.change == next.change && previous.kind == next.kind &&
+         previous.pointer_identifier == next.pointer_identifier &&
+         previous.buttons == next.buttons &&
+         previous.synthesized == next.synthesized;
+}
+
+}  // namespace
+
+CoalescingPointerDataDispatcher::CoalescingPointerDataDispatcher(
+    Delegate& delegate)
+    : DefaultPointerDataDispatcher(delegate), weak_factory_(this) {}
+CoalescingPointerDataDispatcher::~CoalescingPointerDataDispatcher() = default;
+
+void CoalescingPointerDataDispatcher::DispatchPacket(
+    std::unique_ptr<PointerDataPacket> packet,
+    uint64_t trace_flow_id) {
+  TRACE_EVENT0("flutter", "CoalescingPointerDataDispatcher::DispatchPacket");
+  TRACE_FLOW_STEP("flutter", "PointerEvent", trace_flow_id);
+
+  AddPendingPacket(*packet, trace_flow_id);
+  if (!is_pointer_data_in_progress_) {
+    DispatchPendingEvents();
+  }
+}
+
+void CoalescingPointerDataDispatcher::AddPendingPacket(
+    const PointerDataPacket& packet,
+    uint64_t trace_flow_id) {
+  // Only the flow of the last packet is carried on to the dispatched one.
+  if (pending_trace_flow_id_) {
+    TRACE_FLOW_END("flutter", "PointerEvent", *pending_trace_flow_id_);
+  }
+  pending_trace_flow_id_ = trace_flow_id;
+
+  const size_t count = packet.data().size() / sizeof(PointerData);
+  for (size_t i = 0; i < count; i++) {
+    PointerData data;
+    memcpy(&data, packet.data().data() + i * sizeof(PointerData),
+           sizeof(PointerData));
+    auto previous = coalescable_events_.find(data.device);
+    if (!IsCoalescable(data)) {
+      if (previous != coalescable_events_.end()) {
+        coalescable_events_.erase(previous);
+      }
+    } else if (previous != coalescable_events_.end() &&
+               CanCoalesce(pending_events_[previous->second], data)) {
+      const PointerData& previous_data = pending_events_[previous->second];
+      data.physical_delta_x += previous_data.physical_delta_x;
+      data.physical_delta_y += previous_data.physical_delta_y;
+      pending_events_coalesced_[previous->second] = true;
+      coalesced_event_count_++;
+      previous->second = pending_events_.size();
+    } else {
+      coalescable_events_[data.device] = pending_events_.size();
+    }
+    pending_events_.push_back(data);
+    pending_events_coalesced_.push_back(false);
+  }
+}
+
+void CoalescingPointerDataDispatcher::DispatchPendingEvents() {
+  FML_DCHECK(pending_trace_flow_id_);
+  size_t count = 0;
+  for (bool coalesced : pending_events_coalesced_) {
+    count += coalesced ? 0 : 1;
+  }
+  auto packet = std::make_unique<PointerDataPacket>(count);
+  size_t index = 0;
+  for (size_t i = 0; i < pending_events_.size(); i++) {
+    if (!pending_events_coalesced_[i]) {
+      packet->SetPointerData(index++, pending_events_[i]);
+    }
+  }
+  uint64_t trace_flow_id = *pending_trace_flow_id_;
+  pending_events_.clear();
+  pending_events_coalesced_.clear();
+  coalescable_events_.clear();
+  pending_trace_flow_id_.reset();
+
+  FML_TRACE_COUNTER("flutter", "CoalescingPointerDataDispatcher",
+                    reinterpret_cast<int64_t>(this),  // Trace Counter ID
+                    "CoalescedEvents", coalesced_event_count_);
+  is_pointer_data_in_progress_ = true;
+  DefaultPointerDataDispatcher::DispatchPacket(std::move(packet),
+                                               trace_flow_id);
+  ScheduleSecondaryVsyncCallback();
+}
+
+void CoalescingPointerDataDispatcher::ScheduleSecondaryVsyncCallback() {
+  delegate_.ScheduleSecondaryVsyncCallback(
+      reinterpret_cast<uintptr_t>(this),
+      [dispatcher = weak_factory_.GetWeakPtr()]() {
+        if (dispatcher && dispatcher->is_pointer_data_in_progress_) {
+          if (dispatcher->pending_trace_flow_id_) {
+            dispatcher->DispatchPendingEvents();
+          } else {
+            dispatcher->is_pointer_data_in_progress_ = false;
+          }
+        }
+      });
+}
+
 }  // namespace flutter
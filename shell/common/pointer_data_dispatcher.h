@@ -5,6 +5,10 @@
 #ifndef POINTER_DATA_DISPATCHER_H_
 #define POINTER_DATA_DISPATCHER_H_
 
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
 #include "flutter/runtime/runtime_controller.h"
 #include "flutter/shell/common/animator.h"
 
@@ -162,6 +166,63 @@ class SmoothPointerDataDispatcher : public DefaultPointerDataDispatcher {
   FML_DISALLOW_COPY_AND_ASSIGN(SmoothPointerDataDispatcher);
 };
 
+//------------------------------------------------------------------------------
+/// A dispatcher that merges the move and hover events of each pointer device
+/// received during a frame, so that the cost of handling input on the UI
+/// thread does not grow with the rate of the input device (e.g. 1000Hz mice
+/// and pen tablets).
+///
+/// Like `SmoothPointerDataDispatcher`, a packet received while no pointer data
+/// dispatch is in progress is dispatched right away. Packets received after
+/// that are held until the next VSYNC, where they are dispatched as a single
+/// packet. Before a packet is dispatched, a move or hover event replaces the
+/// previous event of its device if that event is the same kind of change with
+/// the same buttons pressed. The replacing event carries the sum of the deltas
+/// of both, and is dispatched in place of the latest event, so that events
+/// stay in time order.
+///
+/// Events that carry an `embedder_id` are never merged, since the platform
+/// may need to be handed back each of them (e.g. for platform views). Neither
+/// are down, up, add, remove, cancel, or signal events.
+///
+/// The framework still resamples the events it receives to the frame time.
+///
+/// See also input_events_unittests.cc.
+class CoalescingPointerDataDispatcher : public DefaultPointerDataDispatcher {
+ public:
+  CoalescingPointerDataDispatcher(Delegate& delegate);
+
+  // |PointerDataDispatcer|
+  void DispatchPacket(std::unique_ptr<PointerDataPacket> packet,
+                      uint64_t trace_flow_id) override;
+
+  virtual ~CoalescingPointerDataDispatcher();
+
+  /// The number of events that were merged into later events so far.
+  size_t GetCoalescedEventCount() const { return coalesced_event_count_; }
+
+ private:
+  void AddPendingPacket(const PointerDataPacket& packet,
+                        uint64_t trace_flow_id);
+  void DispatchPendingEvents();
+  void ScheduleSecondaryVsyncCallback();
+
+  // The events to dispatch at the next VSYNC. The events that were merged
+  // into later ones are marked in `pending_events_coalesced_`.
+  std::vector<PointerData> pending_events_;
+  std::vector<bool> pending_events_coalesced_;
+  // The index in `pending_events_` of the last event of each device, if it
+  // can be merged with later events.
+  std::unordered_map<int64_t, size_t> coalescable_events_;
+  std::optional<uint64_t> pending_trace_flow_id_;
+  size_t coalesced_event_count_ = 0;
+  bool is_pointer_data_in_progress_ = false;
+
+  // WeakPtrFactory must be the last member.
+  fml::WeakPtrFactory<CoalescingPointerDataDispatcher> weak_factory_;
+  FML_DISALLOW_COPY_AND_ASSIGN(CoalescingPointerDataDispatcher);
+};
+
 //--------------------------------------------------------------------------
 /// @brief      Signature for constructing PointerDataDispatcher.
 ///
@@ -28,6 +28,11 @@ namespace flutter {
 // used within this interval.
 static constexpr std::chrono::milliseconds kSkiaCleanupExpiration(15000);
 
+// The external view embedder is told to release the resources it keeps for
+// later frames once no frame has been drawn within this interval.
+static constexpr fml::TimeDelta kUnusedResourcesReleaseDelay =
+    fml::TimeDelta::FromSeconds(1);
+
 Rasterizer::Rasterizer(Delegate& delegate)
     : delegate_(delegate),
       compositor_context_(std::make_unique<flutter::CompositorContext>(
@@ -116,6 +121,7 @@ void Rasterizer::DisableThreadMergerIfNeeded() {
 }
 
 void Rasterizer::NotifyLowMemoryWarning() const {
+  ReleaseUnusedExternalViewResources();
   if (!surface_) {
     FML_DLOG(INFO)
         << "Rasterizer::NotifyLowMemoryWarning called with no surface.";
@@ -134,6 +140,52 @@ void Rasterizer::NotifyLowMemoryWarning() const {
   context->performDeferredCleanup(std::chrono::milliseconds(0));
 }
 
+void Rasterizer::ReleaseUnusedExternalViewResources() const {
+  if (!external_view_embedder_ || !surface_) {
+    return;
+  }
+  TRACE_EVENT0("flutter", "Rasterizer::ReleaseUnusedExternalViewResources");
+  auto context_switch = surface_->MakeRenderContextCurrent();
+  if (!context_switch->GetResult()) {
+    return;
+  }
+  // The embedder may have trampled on the context while releasing the
+  // resources, so Skia must not rely on the existing bindings.
+  if (external_view_embedder_->ReleaseUnusedResources() &&
+      surface_->GetContext()) {
+    surface_->GetContext()->resetContext(kAll_GrBackendState);
+  }
+}
+
+void Rasterizer::ScheduleUnusedResourcesRelease() {
+  last_draw_time_ = fml::TimePoint::Now();
+  if (!external_view_embedder_ || unused_resources_release_scheduled_) {
+    return;
+  }
+  unused_resources_release_scheduled_ = true;
+  PostUnusedResourcesRelease(kUnusedResourcesReleaseDelay);
+}
+
+void Rasterizer::PostUnusedResourcesRelease(fml::TimeDelta delay) {
+  delegate_.GetTaskRunners().GetRasterTaskRunner()->PostDelayedTask(
+      [weak_this = weak_factory_.GetWeakPtr()]() {
+        if (!weak_this) {
+          return;
+        }
+        const fml::TimeDelta idle_time =
+            fml::TimePoint::Now() - weak_this->last_draw_time_;
+        if (idle_time < kUnusedResourcesReleaseDelay) {
+          // Frames were drawn since the release was scheduled.
+          weak_this->PostUnusedResourcesRelease(kUnusedResourcesReleaseDelay -
+                                                idle_time);
+          return;
+        }
+        weak_this->unused_resources_release_scheduled_ = false;
+        weak_this->ReleaseUnusedExternalViewResources();
+      },
+      delay);
+}
+
 flutter::TextureRegistry* Rasterizer::GetTextureRegistry() {
   return &compositor_context_->texture_registry();
 }
@@ -203,6 +255,10 @@ RasterStatus Rasterizer::Draw(
                                       raster_thread_merger_);
   }
 
+  if (raster_status == RasterStatus::kSuccess) {
+    ScheduleUnusedResourcesRelease();
+  }
+
   // Consume as many pipeline items as possible. But yield the event loop
   // between successive tries.
   switch (consume_result) {
@@ -540,10 +596,11 @@ RasterStatus Rasterizer::DrawToSurfaceUnsafe(
     compositor_context_->raster_cache().PrepareNewFrame();
     frame_timings_recorder.RecordRasterStart(fml::TimePoint::Now());
 
-    // Disable partial repaint if external_view_embedder_ SubmitFrame is
-    // involved - ExternalViewEmbedder unconditionally clears the entire
-    // surface and also partial repaint with platform view present is something
-    // that still need to be figured out.
+    // Disable partial repaint of the surface if external_view_embedder_
+    // SubmitFrame is involved - ExternalViewEmbedder unconditionally clears
+    // the entire surface. An external view embedder that supports partial
+    // repaint only needs the frame damage, and repaints each of its render
+    // targets where they lag behind.
     bool disable_partial_repaint =
         external_view_embedder_ &&
         (!raster_thread_merger_ || raster_thread_merger_->IsMerged());
@@ -552,6 +609,14 @@ RasterStatus Rasterizer::DrawToSurfaceUnsafe(
     if (!disable_partial_repaint && frame->framebuffer_info().existing_damage) {
       damage.SetPreviousLayerTree(last_layer_tree_.get());
       damage.AddAdditonalDamage(*frame->framebuffer_info().existing_damage);
+      damage.SetClipToDamageRects(
+          frame->framebuffer_info().supports_multiple_damage_rects);
+    } else if (disable_partial_repaint &&
+               external_view_embedder_->SupportsPartialRepaint()) {
+      // Paint the whole frame, as the render targets of the embedder are not
+      // known yet.
+      damage.SetPreviousLayerTree(last_layer_tree_.get());
+      damage.AddAdditonalDamage(SkIRect::MakeSize(layer_tree.frame_size()));
     }
 
     RasterStatus raster_status =
@@ -564,6 +629,8 @@ RasterStatus Rasterizer::DrawToSurfaceUnsafe(
     SurfaceFrame::SubmitInfo submit_info;
     submit_info.frame_damage = damage.GetFrameDamage();
     submit_info.buffer_damage = damage.GetBufferDamage();
+    submit_info.frame_damage_rects = damage.GetFrameDamageRects();
+    submit_info.buffer_damage_rects = damage.GetBufferDamageRects();
 
     frame->set_submit_info(submit_info);
 
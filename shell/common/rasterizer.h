@@ -144,7 +144,8 @@ class Rasterizer final : public SnapshotDelegate {
   /// @brief      Notifies the rasterizer that there is a low memory situation
   ///             and it must purge as many unnecessary resources as possible.
   ///             Currently, the Skia context associated with onscreen rendering
-  ///             is told to free GPU resources.
+  ///             is told to free GPU resources, and the external view embedder
+  ///             is told to release the resources it keeps for later frames.
   ///
   void NotifyLowMemoryWarning() const;
 
@@ -482,6 +483,15 @@ class Rasterizer final : public SnapshotDelegate {
 
   void FireNextFrameCallbackIfPresent();
 
+  void ReleaseUnusedExternalViewResources() const;
+
+  // Makes the external view embedder release its unused resources once no
+  // frame has been drawn for a while, as it only ages them when frames are
+  // drawn.
+  void ScheduleUnusedResourcesRelease();
+
+  void PostUnusedResourcesRelease(fml::TimeDelta delay);
+
   static bool NoDiscard(const flutter::LayerTree& layer_tree) { return false; }
 
   Delegate& delegate_;
@@ -499,6 +509,8 @@ class Rasterizer final : public SnapshotDelegate {
   std::optional<size_t> max_cache_bytes_;
   fml::RefPtr<fml::RasterThreadMerger> raster_thread_merger_;
   std::shared_ptr<ExternalViewEmbedder> external_view_embedder_;
+  fml::TimePoint last_draw_time_;
+  bool unused_resources_release_scheduled_ = false;
 
   // WeakPtrFactory must be the last member.
   fml::TaskRunnerAffineWeakPtrFactory<Rasterizer> weak_factory_;
@@ -7,6 +7,7 @@
 #include <sstream>
 
 #include "flutter/assets/directory_asset_bundle.h"
+#include "flutter/assets/packed_asset_bundle.h"
 #include "flutter/common/graphics/persistent_cache.h"
 #include "flutter/fml/file.h"
 #include "flutter/fml/unique_fd.h"
@@ -14,20 +15,32 @@
 
 namespace flutter {
 
+// Adds the resolver for the assets in |directory|. Assets in a pack in the
+// directory are resolved from the pack, and the others from the directory.
+static void PushBackAssetDirectory(AssetManager& asset_manager,
+                                   fml::UniqueFD directory) {
+  std::unique_ptr<PackedAssetBundle> packed_assets;
+  if (directory.is_valid()) {
+    packed_assets = std::make_unique<PackedAssetBundle>(
+        fml::OpenFileReadOnly(directory, PackedAssetBundle::kFileName), true);
+  }
+  asset_manager.PushBack(std::make_unique<DirectoryAssetBundle>(
+      std::move(directory), true, std::move(packed_assets)));
+}
+
 RunConfiguration RunConfiguration::InferFromSettings(
     const Settings& settings,
     fml::RefPtr<fml::TaskRunner> io_worker) {
   auto asset_manager = std::make_shared<AssetManager>();
 
   if (fml::UniqueFD::traits_type::IsValid(settings.assets_dir)) {
-    asset_manager->PushBack(std::make_unique<DirectoryAssetBundle>(
-        fml::Duplicate(settings.assets_dir), true));
+    PushBackAssetDirectory(*asset_manager,
+                           fml::Duplicate(settings.assets_dir));
   }
 
-  asset_manager->PushBack(std::make_unique<DirectoryAssetBundle>(
-      fml::OpenDirectory(settings.assets_path.c_str(), false,
-                         fml::FilePermission::kRead),
-      true));
+  PushBackAssetDirectory(
+      *asset_manager, fml::OpenDirectory(settings.assets_path.c_str(), false,
+                                         fml::FilePermission::kRead));
 
   return {IsolateConfiguration::InferFromSettings(settings, asset_manager,
                                                   io_worker),
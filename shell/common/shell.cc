@@ -251,6 +251,11 @@ std::unique_ptr<Shell> Shell::CreateShellOnPlatformThread(
   // Send dispatcher_maker to the engine constructor because shell won't have
   // platform_view set until Shell::Setup is called later.
   auto dispatcher_maker = platform_view->GetDispatcherMaker();
+  if (shell->GetSettings().coalesce_pointer_events) {
+    dispatcher_maker = [](PointerDataDispatcher::Delegate& delegate) {
+      return std::make_unique<CoalescingPointerDataDispatcher>(delegate);
+    };
+  }
 
   // Create the engine on the UI thread.
   std::promise<std::unique_ptr<Engine>> engine_promise;
@@ -642,6 +647,18 @@ bool Shell::Setup(std::unique_ptr<PlatformView> platform_view,
   weak_rasterizer_ = rasterizer_->GetWeakPtr();
   weak_platform_view_ = platform_view_->GetWeakPtr();
 
+  if (settings_.enable_background_raster_cache) {
+    task_runners_.GetRasterTaskRunner()->PostTask(
+        [rasterizer = rasterizer_->GetWeakPtr(),
+         worker_task_runner = vm_->GetConcurrentWorkerTaskRunner()]() {
+          if (rasterizer) {
+            rasterizer->compositor_context()
+                ->raster_cache()
+                .SetWorkerTaskRunner(worker_task_runner);
+          }
+        });
+  }
+
   // Setup the time-consuming default font manager right after engine created.
   if (!settings_.prefetched_default_font_manager) {
     fml::TaskRunner::RunNowOrPostTask(task_runners_.GetUITaskRunner(),
@@ -892,10 +909,18 @@ void Shell::OnPlatformViewSetViewportMetrics(const ViewportMetrics& metrics) {
   // This is the formula Android uses.
   // https://android.googlesource.com/platform/frameworks/base/+/master/libs/hwui/renderthread/CacheManager.cpp#41
   size_t max_bytes = metrics.physical_width * metrics.physical_height * 12 * 4;
+  // Unless configured otherwise, let the raster cache hold a few screens.
+  size_t raster_cache_max_bytes =
+      settings_.raster_cache_size >= 0
+          ? settings_.raster_cache_size << 20
+          : metrics.physical_width * metrics.physical_height * 4 * 4;
   task_runners_.GetRasterTaskRunner()->PostTask(
-      [rasterizer = rasterizer_->GetWeakPtr(), max_bytes] {
+      [rasterizer = rasterizer_->GetWeakPtr(), max_bytes,
+       raster_cache_max_bytes] {
         if (rasterizer) {
           rasterizer->SetResourceCacheMaxBytes(max_bytes, false);
+          rasterizer->compositor_context()->raster_cache().SetMaxBytes(
+              raster_cache_max_bytes);
         }
       });
 
@@ -451,6 +451,19 @@ Settings SettingsFromCommandLine(const fml::CommandLine& command_line) {
                                 &old_gen_heap_size);
     settings.old_gen_heap_size = std::stoi(old_gen_heap_size);
   }
+
+  settings.enable_background_raster_cache = command_line.HasOption(
+      FlagForSwitch(Switch::EnableBackgroundRasterCache));
+
+  settings.coalesce_pointer_events =
+      command_line.HasOption(FlagForSwitch(Switch::CoalescePointerEvents));
+
+  if (command_line.HasOption(FlagForSwitch(Switch::RasterCacheSize))) {
+    std::string raster_cache_size;
+    command_line.GetOptionValue(FlagForSwitch(Switch::RasterCacheSize),
+                                &raster_cache_size);
+    settings.raster_cache_size = std::stoi(raster_cache_size);
+  }
   return settings;
 }
 
@@ -211,6 +211,20 @@ DEF_SWITCH(
 DEF_SWITCH(OldGenHeapSize,
            "old-gen-heap-size",
            "The size limit in megabytes for the Dart VM old gen heap space.")
+DEF_SWITCH(RasterCacheSize,
+           "raster-cache-size",
+           "The size limit in megabytes for the images held by the raster "
+           "cache.")
+DEF_SWITCH(EnableBackgroundRasterCache,
+           "enable-background-raster-cache",
+           "Rasterize raster cache entries of software rendered frames on "
+           "worker threads. Frames draw the uncached content until the "
+           "rasterized image is ready.")
+DEF_SWITCH(CoalescePointerEvents,
+           "coalesce-pointer-events",
+           "Merge the move and hover events of each pointer device received "
+           "during a frame, so that the framework receives at most one of "
+           "each per device and frame regardless of the input rate.")
 DEF_SWITCH(EnableSkParagraph,
            "enable-skparagraph",
            "Selects the SkParagraph implementation of the text layout engine.")
@@ -44,6 +44,9 @@ sk_sp<GrDirectContext> GPUSurfaceGL::MakeGLContext(
     return nullptr;
   }
 
+  // Load the SkSLs to precompile while the context is set up.
+  PersistentCache::GetCacheForProcess()->PrefetchKnownSkSLs();
+
   const auto options =
       MakeDefaultContextOptions(ContextType::kRender, GrBackendApi::kOpenGL);
 
@@ -56,7 +59,8 @@ sk_sp<GrDirectContext> GPUSurfaceGL::MakeGLContext(
 
   context->setResourceCacheLimits(kGrCacheMaxCount, kGrCacheMaxByteSize);
 
-  PersistentCache::GetCacheForProcess()->PrecompileKnownSkSLs(context.get());
+  PersistentCache::GetCacheForProcess()->PrecompileKnownSkSLs(
+      context.get(), delegate->GetPrecompileProgressCallback());
 
   return context;
 }
@@ -106,4 +106,9 @@ bool GPUSurfaceGLDelegate::AllowsDrawingWhenGpuDisabled() const {
   return true;
 }
 
+PersistentCache::PrecompileProgressCallback
+GPUSurfaceGLDelegate::GetPrecompileProgressCallback() const {
+  return nullptr;
+}
+
 }  // namespace flutter
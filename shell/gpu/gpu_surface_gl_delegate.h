@@ -6,6 +6,7 @@
 #define FLUTTER_SHELL_GPU_GPU_SURFACE_GL_DELEGATE_H_
 
 #include "flutter/common/graphics/gl_context_switch.h"
+#include "flutter/common/graphics/persistent_cache.h"
 #include "flutter/flow/embedded_views.h"
 #include "flutter/fml/macros.h"
 #include "third_party/skia/include/core/SkMatrix.h"
@@ -71,6 +72,11 @@ class GPUSurfaceGLDelegate {
 
   // Whether to allow drawing to the surface when the GPU is disabled
   virtual bool AllowsDrawingWhenGpuDisabled() const;
+
+  // Reports the progress of the precompilation of known SkSLs when the main
+  // GL context is created. The default is to report nothing.
+  virtual PersistentCache::PrecompileProgressCallback
+  GetPrecompileProgressCallback() const;
 };
 
 }  // namespace flutter
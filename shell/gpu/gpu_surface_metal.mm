@@ -43,7 +43,10 @@ GPUSurfaceMetal::GPUSurfaceMetal(GPUSurfaceMetalDelegate* delegate,
     : delegate_(delegate),
       render_target_type_(delegate->GetRenderTargetType()),
       context_(std::move(context)),
-      render_to_surface_(render_to_surface) {}
+      render_to_surface_(render_to_surface) {
+  // Load the SkSLs to precompile before the first frame is acquired.
+  flutter::PersistentCache::GetCacheForProcess()->PrefetchKnownSkSLs();
+}
 
 GPUSurfaceMetal::~GPUSurfaceMetal() = default;
 
@@ -59,7 +62,8 @@ void GPUSurfaceMetal::PrecompileKnownSkSLsIfNecessary() {
     return;
   }
   precompiled_sksl_context_ = current_context;
-  flutter::PersistentCache::GetCacheForProcess()->PrecompileKnownSkSLs(precompiled_sksl_context_);
+  flutter::PersistentCache::GetCacheForProcess()->PrecompileKnownSkSLs(
+      precompiled_sksl_context_, delegate_->GetPrecompileProgressCallback());
 }
 
 // |Surface|
@@ -20,4 +20,9 @@ bool GPUSurfaceMetalDelegate::AllowsDrawingWhenGpuDisabled() const {
   return true;
 }
 
+PersistentCache::PrecompileProgressCallback
+GPUSurfaceMetalDelegate::GetPrecompileProgressCallback() const {
+  return nullptr;
+}
+
 }  // namespace flutter
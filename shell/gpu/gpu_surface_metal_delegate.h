@@ -7,6 +7,7 @@
 
 #include <stdint.h>
 
+#include "flutter/common/graphics/persistent_cache.h"
 #include "flutter/fml/macros.h"
 #include "third_party/skia/include/core/SkSize.h"
 #include "third_party/skia/include/core/SkSurface.h"
@@ -94,6 +95,13 @@ class GPUSurfaceMetalDelegate {
   ///
   virtual bool AllowsDrawingWhenGpuDisabled() const;
 
+  //------------------------------------------------------------------------------
+  /// @brief Reports the progress of the precompilation of known SkSLs in the
+  /// context of the surface. The default is to report nothing.
+  ///
+  virtual PersistentCache::PrecompileProgressCallback
+  GetPrecompileProgressCallback() const;
+
   MTLRenderTargetType GetRenderTargetType();
 
  private:
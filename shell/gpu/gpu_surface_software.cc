@@ -10,10 +10,15 @@
 namespace flutter {
 
 GPUSurfaceSoftware::GPUSurfaceSoftware(GPUSurfaceSoftwareDelegate* delegate,
-                                       bool render_to_surface)
+                                       bool render_to_surface,
+                                       size_t raster_thread_count)
     : delegate_(delegate),
       render_to_surface_(render_to_surface),
-      weak_factory_(this) {}
+      weak_factory_(this) {
+  if (render_to_surface_ && raster_thread_count > 1) {
+    tiles_ = std::make_unique<GPUSurfaceSoftwareTiles>(raster_thread_count);
+  }
+}
 
 GPUSurfaceSoftware::~GPUSurfaceSoftware() = default;
 
@@ -27,6 +32,7 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceSoftware::AcquireFrame(
     const SkISize& logical_size) {
   SurfaceFrame::FramebufferInfo framebuffer_info;
   framebuffer_info.supports_readback = true;
+  framebuffer_info.supports_multiple_damage_rects = true;
 
   // TODO(38466): Refactor GPU surface APIs take into account the fact that an
   // external view embedder may want to render to the root surface.
@@ -54,6 +60,12 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceSoftware::AcquireFrame(
     return nullptr;
   }
 
+  // The backing store still holds the last frame presented if it has not been
+  // drawn into since, so only the damage of this frame needs to be repainted.
+  if (backing_store->generationID() == presented_generation_id_) {
+    framebuffer_info.existing_damage = SkIRect::MakeEmpty();
+  }
+
   // If the surface has been scaled, we need to apply the inverse scaling to the
   // underlying canvas so that coordinates are mapped to the same spot
   // irrespective of surface scaling.
@@ -68,11 +80,32 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceSoftware::AcquireFrame(
       return false;
     }
 
-    canvas->flush();
+    const SurfaceFrame::SubmitInfo& submit_info = surface_frame.submit_info();
+    if (self->tiles_) {
+      if (!self->tiles_->FinishRecordingAndRasterize(
+              surface_frame.SkiaSurface().get(),
+              submit_info.buffer_damage_rects)) {
+        return false;
+      }
+    } else {
+      canvas->flush();
+    }
+    self->presented_generation_id_ =
+        surface_frame.SkiaSurface()->generationID();
 
-    return self->delegate_->PresentBackingStore(surface_frame.SkiaSurface());
+    return self->delegate_->PresentBackingStore(
+        surface_frame.SkiaSurface(), submit_info.frame_damage_rects);
   };
 
+  if (tiles_) {
+    // The frame is recorded and only rasterized into the backing store,
+    // in parallel tiles, when it is submitted.
+    return std::make_unique<SurfaceFrame>(backing_store,
+                                          tiles_->BeginRecording(size),
+                                          std::move(framebuffer_info),
+                                          on_submit);
+  }
+
   return std::make_unique<SurfaceFrame>(backing_store,
                                         std::move(framebuffer_info), on_submit);
 }
@@ -9,13 +9,21 @@
 #include "flutter/fml/macros.h"
 #include "flutter/fml/memory/weak_ptr.h"
 #include "flutter/shell/gpu/gpu_surface_software_delegate.h"
+#include "flutter/shell/gpu/gpu_surface_software_tiles.h"
 
 namespace flutter {
 
 class GPUSurfaceSoftware : public Surface {
  public:
+  //----------------------------------------------------------------------------
+  /// @param[in]  raster_thread_count  If greater than one, each frame is
+  ///                                  recorded and then rasterized into tiles
+  ///                                  of the backing store on this many
+  ///                                  threads. See |GPUSurfaceSoftwareTiles|.
+  ///
   GPUSurfaceSoftware(GPUSurfaceSoftwareDelegate* delegate,
-                     bool render_to_surface);
+                     bool render_to_surface,
+                     size_t raster_thread_count = 1);
 
   ~GPUSurfaceSoftware() override;
 
@@ -38,6 +46,10 @@ class GPUSurfaceSoftware : public Surface {
   // hack to make avoid allocating resources for the root surface when an
   // external view embedder is present.
   const bool render_to_surface_;
+  std::unique_ptr<GPUSurfaceSoftwareTiles> tiles_;
+  // The generation of the backing store when the last frame was drawn into
+  // it. Zero if there is none.
+  uint32_t presented_generation_id_ = 0;
   fml::TaskRunnerAffineWeakPtrFactory<GPUSurfaceSoftware> weak_factory_;
   FML_DISALLOW_COPY_AND_ASSIGN(GPUSurfaceSoftware);
 };
@@ -5,6 +5,9 @@
 #ifndef FLUTTER_SHELL_GPU_GPU_SURFACE_SOFTWARE_DELEGATE_H_
 #define FLUTTER_SHELL_GPU_GPU_SURFACE_SOFTWARE_DELEGATE_H_
 
+#include <optional>
+#include <vector>
+
 #include "flutter/flow/embedded_views.h"
 #include "flutter/fml/macros.h"
 #include "third_party/skia/include/core/SkSurface.h"
@@ -43,11 +46,16 @@ class GPUSurfaceSoftwareDelegate {
   ///             backing store and the platform must display it on-screen.
   ///
   /// @param[in]  backing_store  The software backing store to present.
+  /// @param[in]  damage         The rects of the backing store that changed
+  ///                            since the last frame presented, or nullopt
+  ///                            if all of it may have.
   ///
   /// @return     Returns if the platform could present the backing store onto
   ///             the screen.
   ///
-  virtual bool PresentBackingStore(sk_sp<SkSurface> backing_store) = 0;
+  virtual bool PresentBackingStore(
+      sk_sp<SkSurface> backing_store,
+      const std::optional<std::vector<SkIRect>>& damage) = 0;
 };
 
 }  // namespace flutter
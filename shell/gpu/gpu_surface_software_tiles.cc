@@ -0,0 +1,154 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/gpu/gpu_surface_software_tiles.h"
+
+#include <algorithm>
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+#include "third_party/skia/include/utils/SkNWayCanvas.h"
+
+namespace flutter {
+
+// Forwards to the picture recorder while noting whether the frame reads
+// back from the surface, which prevents it from being split into tiles.
+class TileRecordingCanvas final : public SkNWayCanvas {
+ public:
+  TileRecordingCanvas(int width, int height) : SkNWayCanvas(width, height) {}
+
+  bool needs_readback() const { return needs_readback_; }
+
+ private:
+  bool needs_readback_ = false;
+
+  // |SkNWayCanvas|
+  SaveLayerStrategy getSaveLayerStrategy(const SaveLayerRec& rec) override {
+    if (rec.fBackdrop) {
+      needs_readback_ = true;
+    }
+    return SkNWayCanvas::getSaveLayerStrategy(rec);
+  }
+};
+
+GPUSurfaceSoftwareTiles::GPUSurfaceSoftwareTiles(size_t thread_count,
+                                                 int tile_size)
+    : thread_count_(std::max<size_t>(thread_count, 2)),
+      tile_size_(tile_size),
+      // The thread calling |Rasterize| takes a share of the tiles too.
+      worker_loop_(fml::ConcurrentMessageLoop::Create(thread_count_ - 1)),
+      worker_task_runner_(worker_loop_->GetTaskRunner()) {
+  FML_DCHECK(tile_size_ > 0);
+}
+
+GPUSurfaceSoftwareTiles::~GPUSurfaceSoftwareTiles() {
+  // Destroy the canvas before the recorder that it forwards to.
+  recording_canvas_.reset();
+}
+
+SkCanvas* GPUSurfaceSoftwareTiles::BeginRecording(const SkISize& size) {
+  recording_canvas_.reset();
+  SkCanvas* picture_canvas =
+      recorder_.beginRecording(SkRect::Make(size), nullptr);
+  recording_canvas_ =
+      std::make_unique<TileRecordingCanvas>(size.width(), size.height());
+  recording_canvas_->addCanvas(picture_canvas);
+  return recording_canvas_.get();
+}
+
+bool GPUSurfaceSoftwareTiles::FinishRecordingAndRasterize(
+    SkSurface* backing_store,
+    const std::optional<std::vector<SkIRect>>& damage) {
+  if (!recording_canvas_) {
+    return false;
+  }
+  bool needs_readback = recording_canvas_->needs_readback();
+  recording_canvas_.reset();
+  sk_sp<SkPicture> picture = recorder_.finishRecordingAsPicture();
+  if (!picture) {
+    return false;
+  }
+
+  if (needs_readback) {
+    TRACE_EVENT0("flutter", "GPUSurfaceSoftwareTiles::RasterizeSerially");
+    SkCanvas* canvas = backing_store->getCanvas();
+    canvas->drawPicture(picture);
+    canvas->flush();
+    return true;
+  }
+  return Rasterize(picture, backing_store, damage);
+}
+
+std::vector<SkIRect> GPUSurfaceSoftwareTiles::ComputeTiles(const SkISize& size,
+                                                           int tile_size) {
+  std::vector<SkIRect> tiles;
+  for (int y = 0; y < size.height(); y += tile_size) {
+    for (int x = 0; x < size.width(); x += tile_size) {
+      int right = std::min(x + tile_size, size.width());
+      int bottom = std::min(y + tile_size, size.height());
+      tiles.push_back(SkIRect::MakeLTRB(x, y, right, bottom));
+    }
+  }
+  return tiles;
+}
+
+bool GPUSurfaceSoftwareTiles::Rasterize(
+    const sk_sp<SkPicture>& picture,
+    SkSurface* backing_store,
+    const std::optional<std::vector<SkIRect>>& damage) {
+  TRACE_EVENT0("flutter", "GPUSurfaceSoftwareTiles::Rasterize");
+
+  // The tiles are written directly into the pixels of the backing store so
+  // any snapshot that shares those pixels must be detached first.
+  backing_store->notifyContentWillChange(SkSurface::kRetain_ContentChangeMode);
+  SkPixmap pixmap;
+  if (!backing_store->peekPixels(&pixmap)) {
+    FML_LOG(ERROR) << "Tiled rasterization requires a raster backing store.";
+    return false;
+  }
+
+  std::vector<SkIRect> tiles = ComputeTiles(pixmap.dimensions(), tile_size_);
+  if (damage) {
+    // The tiles outside of the damage already hold the contents of the frame.
+    tiles.erase(std::remove_if(tiles.begin(), tiles.end(),
+                               [&](const SkIRect& tile) {
+                                 return std::none_of(
+                                     damage->begin(), damage->end(),
+                                     [&](const SkIRect& rect) {
+                                       return SkIRect::Intersects(tile, rect);
+                                     });
+                               }),
+                tiles.end());
+  }
+
+  // The worker threads and this one claim tiles until none are left. This
+  // keeps all of the threads busy when the tiles differ in complexity.
+  worker_task_runner_->ParallelFor(tiles.size(), [&](size_t index) {
+    TRACE_EVENT0("flutter", "GPUSurfaceSoftwareTiles::RasterizeTile");
+    const SkIRect& tile = tiles[index];
+    std::unique_ptr<SkCanvas> canvas = SkCanvas::MakeRasterDirect(
+        pixmap.info().makeWH(tile.width(), tile.height()),
+        pixmap.writable_addr(tile.x(), tile.y()), pixmap.rowBytes());
+    if (!canvas) {
+      return;
+    }
+    canvas->translate(-tile.x(), -tile.y());
+    if (damage) {
+      // The picture is clipped to the damage rects already, so the bounds of
+      // those in this tile are enough to skip the rest of it.
+      SkIRect tile_damage = SkIRect::MakeEmpty();
+      for (const SkIRect& rect : *damage) {
+        SkIRect clipped = rect;
+        if (clipped.intersect(tile)) {
+          tile_damage.join(clipped);
+        }
+      }
+      canvas->clipRect(SkRect::Make(tile_damage));
+    }
+    canvas->drawPicture(picture);
+  });
+  return true;
+}
+
+}  // namespace flutter
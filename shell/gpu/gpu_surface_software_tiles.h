@@ -0,0 +1,105 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_GPU_GPU_SURFACE_SOFTWARE_TILES_H_
+#define FLUTTER_SHELL_GPU_GPU_SURFACE_SOFTWARE_TILES_H_
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "flutter/fml/concurrent_message_loop.h"
+#include "flutter/fml/macros.h"
+#include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkPicture.h"
+#include "third_party/skia/include/core/SkPictureRecorder.h"
+#include "third_party/skia/include/core/SkSurface.h"
+
+namespace flutter {
+
+class TileRecordingCanvas;
+
+//------------------------------------------------------------------------------
+/// @brief      Rasterizes frames into a software backing store by recording
+///             the frame and then playing the recording back into tiles of
+///             the backing store in parallel on a pool of worker threads.
+///
+///             Frames that read back from the backing store (those using a
+///             backdrop filter) cannot be split into tiles because the
+///             filter may sample pixels from neighboring tiles. Such frames
+///             are played back on the calling thread instead.
+///
+class GPUSurfaceSoftwareTiles {
+ public:
+  static constexpr int kDefaultTileSize = 256;
+
+  //----------------------------------------------------------------------------
+  /// @param[in]  thread_count  The number of threads that rasterize the
+  ///                           tiles of each frame, including the thread that
+  ///                           calls |Rasterize|. Must be at least 2.
+  /// @param[in]  tile_size     The width and height of each tile.
+  ///
+  GPUSurfaceSoftwareTiles(size_t thread_count,
+                          int tile_size = kDefaultTileSize);
+
+  ~GPUSurfaceSoftwareTiles();
+
+  size_t thread_count() const { return thread_count_; }
+
+  //----------------------------------------------------------------------------
+  /// @brief      Starts recording a frame of the given size, discarding any
+  ///             recording that was not finished.
+  ///
+  /// @return     The canvas that the frame should be painted into.
+  ///
+  SkCanvas* BeginRecording(const SkISize& size);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Finishes the recording started by |BeginRecording| and
+  ///             rasterizes it into the backing store.
+  ///
+  /// @param[in]  damage  If specified, only the tiles that intersect these
+  ///                     rects are rasterized, and the rest of the backing
+  ///                     store is left as is.
+  ///
+  /// @return     Whether the recording could be rasterized.
+  ///
+  bool FinishRecordingAndRasterize(
+      SkSurface* backing_store,
+      const std::optional<std::vector<SkIRect>>& damage = std::nullopt);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Plays the picture back into the tiles of the backing store
+  ///             in parallel, returning once all of the tiles are complete.
+  ///             The backing store must be a raster surface.
+  ///
+  /// @param[in]  damage  If specified, the picture is only played back into
+  ///                     the tiles that intersect these rects, clipped to
+  ///                     the rects in each tile.
+  ///
+  bool Rasterize(
+      const sk_sp<SkPicture>& picture,
+      SkSurface* backing_store,
+      const std::optional<std::vector<SkIRect>>& damage = std::nullopt);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Splits the bounds into rows of tiles of at most the given
+  ///             size.
+  ///
+  static std::vector<SkIRect> ComputeTiles(const SkISize& size, int tile_size);
+
+ private:
+  const size_t thread_count_;
+  const int tile_size_;
+  std::shared_ptr<fml::ConcurrentMessageLoop> worker_loop_;
+  std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner_;
+  SkPictureRecorder recorder_;
+  std::unique_ptr<TileRecordingCanvas> recording_canvas_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(GPUSurfaceSoftwareTiles);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_GPU_GPU_SURFACE_SOFTWARE_TILES_H_
@@ -48,7 +48,9 @@ class AndroidSurfaceSoftware final : public AndroidSurface,
   sk_sp<SkSurface> AcquireBackingStore(const SkISize& size) override;
 
   // |GPUSurfaceSoftwareDelegate|
-  bool PresentBackingStore(sk_sp<SkSurface> backing_store) override;
+  bool PresentBackingStore(
+      sk_sp<SkSurface> backing_store,
+      const std::optional<std::vector<SkIRect>>& damage) override;
 
  private:
   sk_sp<SkSurface> sk_surface_;
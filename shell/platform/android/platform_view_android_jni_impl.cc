@@ -1125,12 +1125,12 @@ void PlatformViewAndroidJNIImpl::FlutterViewHandlePlatformMessage(
       fml::jni::StringToJavaString(env, message->channel());
 
   if (message->hasData()) {
+    // Message data is deleted in CleanupMessageData. Releasing it may copy it,
+    // so the byte buffer must wrap the released data.
+    fml::MallocMapping mapping = message->releaseData();
     fml::jni::ScopedJavaLocalRef<jobject> message_array(
         env, env->NewDirectByteBuffer(
-                 const_cast<uint8_t*>(message->data().GetMapping()),
-                 message->data().GetSize()));
-    // Message data is deleted in CleanupMessageData.
-    fml::MallocMapping mapping = message->releaseData();
+                 const_cast<uint8_t*>(mapping.GetMapping()), mapping.GetSize()));
     env->CallVoidMethod(java_object.obj(), g_handle_platform_message_method,
                         java_channel.obj(), message_array.obj(), responseId,
                         mapping.Release());
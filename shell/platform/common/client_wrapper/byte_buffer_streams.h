@@ -86,9 +86,7 @@ class ByteBufferStreamWriter : public ByteStreamWriter {
   void WriteAlignment(uint8_t alignment) {
     uint8_t mod = bytes_->size() % alignment;
     if (mod) {
-      for (int i = 0; i < alignment - mod; ++i) {
-        WriteByte(0);
-      }
+      bytes_->insert(bytes_->end(), alignment - mod, 0);
     }
   }
 
@@ -283,6 +283,17 @@ TEST(EncodableValueTest, DeepCopy) {
   EXPECT_EQ(std::get<std::string>(innermost_map[EncodableValue("a")]), "b");
 }
 
+// Tests that constructing from an rvalue moves rather than copies, so that
+// large typed lists are not duplicated when they are wrapped.
+TEST(EncodableValueTest, MovesFromRvalue) {
+  std::vector<double> data(1024, 1.5);
+  const double* buffer = data.data();
+
+  EncodableValue value(std::move(data));
+
+  EXPECT_EQ(std::get<std::vector<double>>(value).data(), buffer);
+}
+
 // Simple class for testing custom encodable values
 class TestCustomValue {
  public:
@@ -0,0 +1,157 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_PLATFORM_COMMON_CLIENT_WRAPPER_INCLUDE_FLUTTER_STANDARD_CODEC_STREAM_H_
+#define FLUTTER_SHELL_PLATFORM_COMMON_CLIENT_WRAPPER_INCLUDE_FLUTTER_STANDARD_CODEC_STREAM_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "byte_streams.h"
+
+namespace flutter {
+
+// Writes values in the standard codec binary representation directly to a
+// stream, without building an EncodableValue tree first.
+//
+// Lists and maps are written as a header giving their size, followed by their
+// elements. For example, the encoding of {"x": [1, 2]} is written with:
+//   writer.BeginMap(1);
+//   writer.WriteString("x");
+//   writer.BeginList(2);
+//   writer.WriteInt32(1);
+//   writer.WriteInt32(2);
+//
+// The output is identical to that of StandardCodecSerializer::WriteValue for
+// the equivalent EncodableValue, so it can be decoded by any standard codec.
+class StandardCodecWriter {
+ public:
+  // Creates a writer that writes to |stream|, which must remain valid for the
+  // lifetime of this object.
+  explicit StandardCodecWriter(ByteStreamWriter* stream);
+
+  ~StandardCodecWriter();
+
+  // Prevent copying.
+  StandardCodecWriter(StandardCodecWriter const&) = delete;
+  StandardCodecWriter& operator=(StandardCodecWriter const&) = delete;
+
+  void WriteNull();
+  void WriteBool(bool value);
+  void WriteInt32(int32_t value);
+  void WriteInt64(int64_t value);
+  void WriteDouble(double value);
+  void WriteString(std::string_view value);
+  void WriteUInt8List(const uint8_t* data, size_t count);
+  void WriteInt32List(const int32_t* data, size_t count);
+  void WriteInt64List(const int64_t* data, size_t count);
+  void WriteFloat32List(const float* data, size_t count);
+  void WriteFloat64List(const double* data, size_t count);
+
+  // Starts a list of |size| elements. The next |size| values written are the
+  // elements of the list.
+  void BeginList(size_t size);
+
+  // Starts a map of |size| entries. The next 2 * |size| values written are
+  // the keys and values of the map, alternating and starting with a key.
+  void BeginMap(size_t size);
+
+ private:
+  template <typename T>
+  void WriteTypedList(uint8_t type, const T* data, size_t count);
+
+  ByteStreamWriter* stream_;
+};
+
+// Receives the values read by a StandardCodecReader.
+//
+// Strings and typed lists are passed as views into the buffer being read, and
+// are only valid for the duration of the call.
+//
+// The default implementations ignore the value.
+class StandardCodecVisitor {
+ public:
+  virtual ~StandardCodecVisitor() = default;
+
+  virtual void VisitNull() {}
+  virtual void VisitBool(bool value) {}
+  virtual void VisitInt32(int32_t value) {}
+  virtual void VisitInt64(int64_t value) {}
+  virtual void VisitDouble(double value) {}
+  virtual void VisitString(std::string_view value) {}
+  virtual void VisitUInt8List(const uint8_t* data, size_t count) {}
+  virtual void VisitInt32List(const int32_t* data, size_t count) {}
+  virtual void VisitInt64List(const int64_t* data, size_t count) {}
+  virtual void VisitFloat32List(const float* data, size_t count) {}
+  virtual void VisitFloat64List(const double* data, size_t count) {}
+
+  // Called before the |size| elements of a list are visited.
+  virtual void BeginList(size_t size) {}
+
+  // Called after the elements of a list were visited.
+  virtual void EndList() {}
+
+  // Called before the |size| entries of a map are visited, each as its key
+  // followed by its value.
+  virtual void BeginMap(size_t size) {}
+
+  // Called after the entries of a map were visited.
+  virtual void EndMap() {}
+};
+
+// Reads values in the standard codec binary representation from a buffer and
+// passes them to a StandardCodecVisitor as they are read, without building an
+// EncodableValue tree.
+//
+// Only the types of the standard codec are supported. Values written by codec
+// extensions are reported as errors.
+class StandardCodecReader {
+ public:
+  // Creates a reader reading from |bytes|, which must have a length of |size|.
+  // |bytes| must remain valid for the lifetime of this object.
+  StandardCodecReader(const uint8_t* bytes, size_t size);
+
+  ~StandardCodecReader();
+
+  // Prevent copying.
+  StandardCodecReader(StandardCodecReader const&) = delete;
+  StandardCodecReader& operator=(StandardCodecReader const&) = delete;
+
+  // Reads the next value, including all of its elements if it is a list or a
+  // map, and passes it to |visitor|.
+  //
+  // Returns false if the buffer is malformed or ends early, in which case the
+  // visitor may have seen part of the value and the reader should not be used
+  // any further.
+  bool ReadValue(StandardCodecVisitor* visitor);
+
+  // Returns true if every byte of the buffer has been read.
+  bool IsAtEnd() const { return location_ == size_; }
+
+ private:
+  bool ReadValueOfType(uint8_t type, StandardCodecVisitor* visitor);
+  bool ReadSize(size_t* size);
+  bool ReadAlignment(size_t alignment);
+
+  // Returns a pointer to the next |length| bytes and advances past them, or
+  // null if fewer than |length| bytes are left.
+  const uint8_t* ReadBytes(size_t length);
+
+  // Reads the size of a fixed-type list into |count| and returns a pointer to
+  // its elements, or null if the buffer is malformed. The elements are copied
+  // to |scratch_| if they are not suitably aligned in memory.
+  template <typename T>
+  const T* ReadTypedList(size_t* count);
+
+  const uint8_t* bytes_;
+  size_t size_;
+  size_t location_ = 0;
+  std::vector<uint64_t> scratch_;
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_PLATFORM_COMMON_CLIENT_WRAPPER_INCLUDE_FLUTTER_STANDARD_CODEC_STREAM_H_
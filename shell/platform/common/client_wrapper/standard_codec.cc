@@ -16,6 +16,7 @@
 
 #include "byte_buffer_streams.h"
 #include "include/flutter/standard_codec_serializer.h"
+#include "include/flutter/standard_codec_stream.h"
 #include "include/flutter/standard_message_codec.h"
 #include "include/flutter/standard_method_codec.h"
 
@@ -78,6 +79,21 @@ EncodedType EncodedTypeForValue(const EncodableValue& value) {
   return EncodedType::kNull;
 }
 
+// Writes the variable-length size encoding of |size| to |stream|.
+void WriteSizeToStream(size_t size, ByteStreamWriter* stream) {
+  if (size < 254) {
+    stream->WriteByte(static_cast<uint8_t>(size));
+  } else if (size <= 0xffff) {
+    stream->WriteByte(254);
+    uint16_t value = static_cast<uint16_t>(size);
+    stream->WriteBytes(reinterpret_cast<uint8_t*>(&value), 2);
+  } else {
+    stream->WriteByte(255);
+    uint32_t value = static_cast<uint32_t>(size);
+    stream->WriteBytes(reinterpret_cast<uint8_t*>(&value), 4);
+  }
+}
+
 }  // namespace
 
 StandardCodecSerializer::StandardCodecSerializer() = default;
@@ -188,7 +204,7 @@ EncodableValue StandardCodecSerializer::ReadValueOfType(
       std::string string_value;
       string_value.resize(size);
       stream->ReadBytes(reinterpret_cast<uint8_t*>(&string_value[0]), size);
-      return EncodableValue(string_value);
+      return EncodableValue(std::move(string_value));
     }
     case EncodedType::kUInt8List:
       return ReadVector<uint8_t>(stream);
@@ -205,7 +221,7 @@ EncodableValue StandardCodecSerializer::ReadValueOfType(
       for (size_t i = 0; i < length; ++i) {
         list_value.push_back(ReadValue(stream));
       }
-      return EncodableValue(list_value);
+      return EncodableValue(std::move(list_value));
     }
     case EncodedType::kMap: {
       size_t length = ReadSize(stream);
@@ -215,7 +231,7 @@ EncodableValue StandardCodecSerializer::ReadValueOfType(
         EncodableValue value = ReadValue(stream);
         map_value.emplace(std::move(key), std::move(value));
       }
-      return EncodableValue(map_value);
+      return EncodableValue(std::move(map_value));
     }
     case EncodedType::kFloat32List: {
       return ReadVector<float>(stream);
@@ -243,17 +259,7 @@ size_t StandardCodecSerializer::ReadSize(ByteStreamReader* stream) const {
 
 void StandardCodecSerializer::WriteSize(size_t size,
                                         ByteStreamWriter* stream) const {
-  if (size < 254) {
-    stream->WriteByte(static_cast<uint8_t>(size));
-  } else if (size <= 0xffff) {
-    stream->WriteByte(254);
-    uint16_t value = static_cast<uint16_t>(size);
-    stream->WriteBytes(reinterpret_cast<uint8_t*>(&value), 2);
-  } else {
-    stream->WriteByte(255);
-    uint32_t value = static_cast<uint32_t>(size);
-    stream->WriteBytes(reinterpret_cast<uint8_t*>(&value), 4);
-  }
+  WriteSizeToStream(size, stream);
 }
 
 template <typename T>
@@ -268,23 +274,315 @@ EncodableValue StandardCodecSerializer::ReadVector(
   }
   stream->ReadBytes(reinterpret_cast<uint8_t*>(vector.data()),
                     count * type_size);
-  return EncodableValue(vector);
+  return EncodableValue(std::move(vector));
 }
 
 template <typename T>
-void StandardCodecSerializer::WriteVector(const std::vector<T> vector,
+void StandardCodecSerializer::WriteVector(const std::vector<T>& vector,
                                           ByteStreamWriter* stream) const {
   size_t count = vector.size();
   WriteSize(count, stream);
-  if (count == 0) {
-    return;
-  }
   uint8_t type_size = static_cast<uint8_t>(sizeof(T));
   if (type_size > 1) {
     stream->WriteAlignment(type_size);
   }
-  stream->WriteBytes(reinterpret_cast<const uint8_t*>(vector.data()),
-                     count * type_size);
+  if (count > 0) {
+    stream->WriteBytes(reinterpret_cast<const uint8_t*>(vector.data()),
+                       count * type_size);
+  }
+}
+
+// ===== standard_codec_stream.h =====
+
+StandardCodecWriter::StandardCodecWriter(ByteStreamWriter* stream)
+    : stream_(stream) {
+  assert(stream);
+}
+
+StandardCodecWriter::~StandardCodecWriter() = default;
+
+void StandardCodecWriter::WriteNull() {
+  stream_->WriteByte(static_cast<uint8_t>(EncodedType::kNull));
+}
+
+void StandardCodecWriter::WriteBool(bool value) {
+  stream_->WriteByte(static_cast<uint8_t>(value ? EncodedType::kTrue
+                                                : EncodedType::kFalse));
+}
+
+void StandardCodecWriter::WriteInt32(int32_t value) {
+  stream_->WriteByte(static_cast<uint8_t>(EncodedType::kInt32));
+  stream_->WriteInt32(value);
+}
+
+void StandardCodecWriter::WriteInt64(int64_t value) {
+  stream_->WriteByte(static_cast<uint8_t>(EncodedType::kInt64));
+  stream_->WriteInt64(value);
+}
+
+void StandardCodecWriter::WriteDouble(double value) {
+  stream_->WriteByte(static_cast<uint8_t>(EncodedType::kFloat64));
+  stream_->WriteAlignment(8);
+  stream_->WriteDouble(value);
+}
+
+void StandardCodecWriter::WriteString(std::string_view value) {
+  stream_->WriteByte(static_cast<uint8_t>(EncodedType::kString));
+  WriteSizeToStream(value.size(), stream_);
+  if (!value.empty()) {
+    stream_->WriteBytes(reinterpret_cast<const uint8_t*>(value.data()),
+                        value.size());
+  }
+}
+
+void StandardCodecWriter::WriteUInt8List(const uint8_t* data, size_t count) {
+  WriteTypedList(static_cast<uint8_t>(EncodedType::kUInt8List), data, count);
+}
+
+void StandardCodecWriter::WriteInt32List(const int32_t* data, size_t count) {
+  WriteTypedList(static_cast<uint8_t>(EncodedType::kInt32List), data, count);
+}
+
+void StandardCodecWriter::WriteInt64List(const int64_t* data, size_t count) {
+  WriteTypedList(static_cast<uint8_t>(EncodedType::kInt64List), data, count);
+}
+
+void StandardCodecWriter::WriteFloat32List(const float* data, size_t count) {
+  WriteTypedList(static_cast<uint8_t>(EncodedType::kFloat32List), data, count);
+}
+
+void StandardCodecWriter::WriteFloat64List(const double* data, size_t count) {
+  WriteTypedList(static_cast<uint8_t>(EncodedType::kFloat64List), data, count);
+}
+
+void StandardCodecWriter::BeginList(size_t size) {
+  stream_->WriteByte(static_cast<uint8_t>(EncodedType::kList));
+  WriteSizeToStream(size, stream_);
+}
+
+void StandardCodecWriter::BeginMap(size_t size) {
+  stream_->WriteByte(static_cast<uint8_t>(EncodedType::kMap));
+  WriteSizeToStream(size, stream_);
+}
+
+template <typename T>
+void StandardCodecWriter::WriteTypedList(uint8_t type,
+                                         const T* data,
+                                         size_t count) {
+  stream_->WriteByte(type);
+  WriteSizeToStream(count, stream_);
+  if (sizeof(T) > 1) {
+    stream_->WriteAlignment(static_cast<uint8_t>(sizeof(T)));
+  }
+  if (count > 0) {
+    stream_->WriteBytes(reinterpret_cast<const uint8_t*>(data),
+                        count * sizeof(T));
+  }
+}
+
+StandardCodecReader::StandardCodecReader(const uint8_t* bytes, size_t size)
+    : bytes_(bytes), size_(size) {}
+
+StandardCodecReader::~StandardCodecReader() = default;
+
+bool StandardCodecReader::ReadValue(StandardCodecVisitor* visitor) {
+  const uint8_t* type = ReadBytes(1);
+  return type && ReadValueOfType(*type, visitor);
+}
+
+bool StandardCodecReader::ReadValueOfType(uint8_t type,
+                                          StandardCodecVisitor* visitor) {
+  switch (static_cast<EncodedType>(type)) {
+    case EncodedType::kNull:
+      visitor->VisitNull();
+      return true;
+    case EncodedType::kTrue:
+      visitor->VisitBool(true);
+      return true;
+    case EncodedType::kFalse:
+      visitor->VisitBool(false);
+      return true;
+    case EncodedType::kInt32: {
+      const uint8_t* data = ReadBytes(4);
+      if (!data) {
+        return false;
+      }
+      int32_t value;
+      std::memcpy(&value, data, 4);
+      visitor->VisitInt32(value);
+      return true;
+    }
+    case EncodedType::kInt64: {
+      const uint8_t* data = ReadBytes(8);
+      if (!data) {
+        return false;
+      }
+      int64_t value;
+      std::memcpy(&value, data, 8);
+      visitor->VisitInt64(value);
+      return true;
+    }
+    case EncodedType::kFloat64: {
+      const uint8_t* data = ReadAlignment(8) ? ReadBytes(8) : nullptr;
+      if (!data) {
+        return false;
+      }
+      double value;
+      std::memcpy(&value, data, 8);
+      visitor->VisitDouble(value);
+      return true;
+    }
+    case EncodedType::kLargeInt:
+    case EncodedType::kString: {
+      size_t size;
+      const uint8_t* data = ReadSize(&size) ? ReadBytes(size) : nullptr;
+      if (!data) {
+        return false;
+      }
+      visitor->VisitString(
+          std::string_view(reinterpret_cast<const char*>(data), size));
+      return true;
+    }
+    case EncodedType::kUInt8List: {
+      size_t count;
+      const uint8_t* data = ReadSize(&count) ? ReadBytes(count) : nullptr;
+      if (!data) {
+        return false;
+      }
+      visitor->VisitUInt8List(data, count);
+      return true;
+    }
+    case EncodedType::kInt32List: {
+      size_t count;
+      const int32_t* data = ReadTypedList<int32_t>(&count);
+      if (!data) {
+        return false;
+      }
+      visitor->VisitInt32List(data, count);
+      return true;
+    }
+    case EncodedType::kInt64List: {
+      size_t count;
+      const int64_t* data = ReadTypedList<int64_t>(&count);
+      if (!data) {
+        return false;
+      }
+      visitor->VisitInt64List(data, count);
+      return true;
+    }
+    case EncodedType::kFloat32List: {
+      size_t count;
+      const float* data = ReadTypedList<float>(&count);
+      if (!data) {
+        return false;
+      }
+      visitor->VisitFloat32List(data, count);
+      return true;
+    }
+    case EncodedType::kFloat64List: {
+      size_t count;
+      const double* data = ReadTypedList<double>(&count);
+      if (!data) {
+        return false;
+      }
+      visitor->VisitFloat64List(data, count);
+      return true;
+    }
+    case EncodedType::kList: {
+      size_t size;
+      // Every element takes at least one byte.
+      if (!ReadSize(&size) || size > size_ - location_) {
+        return false;
+      }
+      visitor->BeginList(size);
+      for (size_t i = 0; i < size; ++i) {
+        if (!ReadValue(visitor)) {
+          return false;
+        }
+      }
+      visitor->EndList();
+      return true;
+    }
+    case EncodedType::kMap: {
+      size_t size;
+      // Every key and value takes at least one byte.
+      if (!ReadSize(&size) || size > (size_ - location_) / 2) {
+        return false;
+      }
+      visitor->BeginMap(size);
+      for (size_t i = 0; i < size; ++i) {
+        if (!ReadValue(visitor) || !ReadValue(visitor)) {
+          return false;
+        }
+      }
+      visitor->EndMap();
+      return true;
+    }
+  }
+  std::cerr << "Unknown type in StandardCodecReader::ReadValue: "
+            << static_cast<int>(type) << std::endl;
+  return false;
+}
+
+bool StandardCodecReader::ReadSize(size_t* size) {
+  const uint8_t* byte = ReadBytes(1);
+  if (!byte) {
+    return false;
+  }
+  if (*byte < 254) {
+    *size = *byte;
+    return true;
+  }
+  if (*byte == 254) {
+    const uint8_t* data = ReadBytes(2);
+    if (!data) {
+      return false;
+    }
+    uint16_t value;
+    std::memcpy(&value, data, 2);
+    *size = value;
+    return true;
+  }
+  const uint8_t* data = ReadBytes(4);
+  if (!data) {
+    return false;
+  }
+  uint32_t value;
+  std::memcpy(&value, data, 4);
+  *size = value;
+  return true;
+}
+
+bool StandardCodecReader::ReadAlignment(size_t alignment) {
+  size_t mod = location_ % alignment;
+  return mod == 0 || ReadBytes(alignment - mod) != nullptr;
+}
+
+const uint8_t* StandardCodecReader::ReadBytes(size_t length) {
+  if (length > size_ - location_) {
+    return nullptr;
+  }
+  const uint8_t* data = bytes_ + location_;
+  location_ += length;
+  return data;
+}
+
+template <typename T>
+const T* StandardCodecReader::ReadTypedList(size_t* count) {
+  if (!ReadSize(count) || !ReadAlignment(sizeof(T)) ||
+      *count > (size_ - location_) / sizeof(T)) {
+    return nullptr;
+  }
+  const uint8_t* data = ReadBytes(*count * sizeof(T));
+  if (*count == 0 || reinterpret_cast<uintptr_t>(data) % alignof(T) == 0) {
+    return reinterpret_cast<const T*>(data);
+  }
+  // The buffer itself is not aligned in memory, so the elements can't be
+  // viewed in place.
+  scratch_.resize((*count * sizeof(T) + sizeof(uint64_t) - 1) /
+                  sizeof(uint64_t));
+  std::memcpy(scratch_.data(), data, *count * sizeof(T));
+  return reinterpret_cast<const T*>(scratch_.data());
 }
 
 // ===== standard_message_codec.h =====
@@ -0,0 +1,184 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+#include <vector>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/shell/platform/common/client_wrapper/byte_buffer_streams.h"
+#include "flutter/shell/platform/common/client_wrapper/include/flutter/standard_codec_stream.h"
+#include "flutter/shell/platform/common/client_wrapper/include/flutter/standard_message_codec.h"
+
+namespace flutter {
+
+namespace {
+
+constexpr size_t kValuesPerItem = 16;
+
+// The fields of one item of the benchmark message, as a plugin would keep
+// them.
+struct Item {
+  int32_t id;
+  std::string name;
+  std::vector<double> values;
+};
+
+std::vector<Item> CreateItems(size_t count) {
+  std::vector<Item> items(count);
+  for (size_t i = 0; i < count; ++i) {
+    items[i].id = static_cast<int32_t>(i);
+    items[i].name = "item " + std::to_string(i);
+    items[i].values.assign(kValuesPerItem, static_cast<double>(i));
+  }
+  return items;
+}
+
+// Builds the message as a list of maps, the way it is sent through the
+// EncodableValue API.
+EncodableValue CreateMessage(const std::vector<Item>& items) {
+  EncodableList list;
+  list.reserve(items.size());
+  for (const Item& item : items) {
+    list.emplace_back(EncodableMap{
+        {EncodableValue("id"), EncodableValue(item.id)},
+        {EncodableValue("name"), EncodableValue(item.name)},
+        {EncodableValue("values"), EncodableValue(item.values)},
+    });
+  }
+  return EncodableValue(std::move(list));
+}
+
+void WriteMessage(const std::vector<Item>& items, StandardCodecWriter* writer) {
+  writer->BeginList(items.size());
+  for (const Item& item : items) {
+    writer->BeginMap(3);
+    writer->WriteString("id");
+    writer->WriteInt32(item.id);
+    writer->WriteString("name");
+    writer->WriteString(item.name);
+    writer->WriteString("values");
+    writer->WriteFloat64List(item.values.data(), item.values.size());
+  }
+}
+
+// Sums the ids and values of the message without copying any of it.
+class SummingVisitor : public StandardCodecVisitor {
+ public:
+  void VisitInt32(int32_t value) override { sum_ += value; }
+  void VisitFloat64List(const double* data, size_t count) override {
+    for (size_t i = 0; i < count; ++i) {
+      sum_ += data[i];
+    }
+  }
+
+  double sum() const { return sum_; }
+
+ private:
+  double sum_ = 0;
+};
+
+}  // namespace
+
+static void BM_StandardCodecEncodeEncodableValue(benchmark::State& state) {
+  std::vector<Item> items = CreateItems(state.range(0));
+  const StandardMessageCodec& codec = StandardMessageCodec::GetInstance();
+  while (state.KeepRunning()) {
+    auto encoded = codec.EncodeMessage(CreateMessage(items));
+    benchmark::DoNotOptimize(encoded);
+  }
+}
+
+static void BM_StandardCodecEncodeStreaming(benchmark::State& state) {
+  std::vector<Item> items = CreateItems(state.range(0));
+  // Reused between messages, as a pooled buffer would be.
+  std::vector<uint8_t> buffer;
+  while (state.KeepRunning()) {
+    buffer.clear();
+    ByteBufferStreamWriter stream(&buffer);
+    StandardCodecWriter writer(&stream);
+    WriteMessage(items, &writer);
+    benchmark::DoNotOptimize(buffer.data());
+  }
+}
+
+static void BM_StandardCodecDecodeEncodableValue(benchmark::State& state) {
+  const StandardMessageCodec& codec = StandardMessageCodec::GetInstance();
+  auto encoded =
+      codec.EncodeMessage(CreateMessage(CreateItems(state.range(0))));
+  while (state.KeepRunning()) {
+    auto decoded = codec.DecodeMessage(*encoded);
+    benchmark::DoNotOptimize(decoded);
+  }
+}
+
+static void BM_StandardCodecDecodeStreaming(benchmark::State& state) {
+  const StandardMessageCodec& codec = StandardMessageCodec::GetInstance();
+  auto encoded =
+      codec.EncodeMessage(CreateMessage(CreateItems(state.range(0))));
+  while (state.KeepRunning()) {
+    StandardCodecReader reader(encoded->data(), encoded->size());
+    SummingVisitor visitor;
+    reader.ReadValue(&visitor);
+    benchmark::DoNotOptimize(visitor.sum());
+  }
+}
+
+static void BM_StandardCodecEncodeFloat64List(benchmark::State& state) {
+  const StandardMessageCodec& codec = StandardMessageCodec::GetInstance();
+  EncodableValue message(std::vector<double>(state.range(0), 1.5));
+  while (state.KeepRunning()) {
+    auto encoded = codec.EncodeMessage(message);
+    benchmark::DoNotOptimize(encoded);
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) *
+                          sizeof(double));
+}
+
+static void BM_StandardCodecDecodeFloat64List(benchmark::State& state) {
+  const StandardMessageCodec& codec = StandardMessageCodec::GetInstance();
+  auto encoded = codec.EncodeMessage(
+      EncodableValue(std::vector<double>(state.range(0), 1.5)));
+  while (state.KeepRunning()) {
+    auto decoded = codec.DecodeMessage(*encoded);
+    benchmark::DoNotOptimize(decoded);
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) *
+                          sizeof(double));
+}
+
+BENCHMARK(BM_StandardCodecEncodeEncodableValue)
+    ->Arg(16)
+    ->Arg(256)
+    ->Arg(4096)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(BM_StandardCodecEncodeStreaming)
+    ->Arg(16)
+    ->Arg(256)
+    ->Arg(4096)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(BM_StandardCodecDecodeEncodableValue)
+    ->Arg(16)
+    ->Arg(256)
+    ->Arg(4096)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(BM_StandardCodecDecodeStreaming)
+    ->Arg(16)
+    ->Arg(256)
+    ->Arg(4096)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(BM_StandardCodecEncodeFloat64List)
+    ->Arg(1 << 10)
+    ->Arg(1 << 18)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(BM_StandardCodecDecodeFloat64List)
+    ->Arg(1 << 10)
+    ->Arg(1 << 18)
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace flutter
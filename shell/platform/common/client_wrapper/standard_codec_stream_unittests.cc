@@ -0,0 +1,169 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/platform/common/client_wrapper/include/flutter/standard_codec_stream.h"
+
+#include <string>
+#include <vector>
+
+#include "flutter/shell/platform/common/client_wrapper/byte_buffer_streams.h"
+#include "flutter/shell/platform/common/client_wrapper/include/flutter/standard_message_codec.h"
+#include "gtest/gtest.h"
+
+namespace flutter {
+
+namespace {
+
+// Records the values it visits in a readable form.
+class RecordingVisitor : public StandardCodecVisitor {
+ public:
+  void VisitNull() override { log_ += "null "; }
+  void VisitBool(bool value) override { log_ += value ? "true " : "false "; }
+  void VisitInt32(int32_t value) override {
+    log_ += "i32:" + std::to_string(value) + " ";
+  }
+  void VisitInt64(int64_t value) override {
+    log_ += "i64:" + std::to_string(value) + " ";
+  }
+  void VisitDouble(double value) override {
+    log_ += "f64:" + std::to_string(value) + " ";
+  }
+  void VisitString(std::string_view value) override {
+    log_ += "\"" + std::string(value) + "\" ";
+  }
+  void VisitUInt8List(const uint8_t* data, size_t count) override {
+    log_ += "u8[";
+    for (size_t i = 0; i < count; ++i) {
+      log_ += std::to_string(data[i]) + (i + 1 < count ? "," : "");
+    }
+    log_ += "] ";
+  }
+  void VisitFloat64List(const double* data, size_t count) override {
+    log_ += "f64[";
+    for (size_t i = 0; i < count; ++i) {
+      log_ += std::to_string(data[i]) + (i + 1 < count ? "," : "");
+    }
+    log_ += "] ";
+  }
+  void VisitInt32List(const int32_t* data, size_t count) override {
+    log_ += "i32[" + std::to_string(count) + "] ";
+  }
+  void BeginList(size_t size) override {
+    log_ += "list" + std::to_string(size) + "( ";
+  }
+  void EndList() override { log_ += ") "; }
+  void BeginMap(size_t size) override {
+    log_ += "map" + std::to_string(size) + "( ";
+  }
+  void EndMap() override { log_ += ") "; }
+
+  const std::string& log() const { return log_; }
+
+ private:
+  std::string log_;
+};
+
+// Writes the same value as |Value()| using a StandardCodecWriter.
+void WriteValue(StandardCodecWriter* writer) {
+  writer->BeginMap(2);
+  writer->WriteString("id");
+  writer->WriteInt64(int64_t{1} << 40);
+  writer->WriteString("items");
+  writer->BeginList(5);
+  writer->WriteBool(true);
+  writer->WriteNull();
+  writer->WriteDouble(3.5);
+  const uint8_t bytes[] = {1, 2, 3};
+  writer->WriteUInt8List(bytes, 3);
+  const double doubles[] = {0.5, 1.5};
+  writer->WriteFloat64List(doubles, 2);
+}
+
+EncodableValue Value() {
+  return EncodableValue(EncodableMap{
+      {EncodableValue("id"), EncodableValue(int64_t{1} << 40)},
+      {EncodableValue("items"),
+       EncodableValue(EncodableList{
+           EncodableValue(true),
+           EncodableValue(),
+           EncodableValue(3.5),
+           EncodableValue(std::vector<uint8_t>{1, 2, 3}),
+           EncodableValue(std::vector<double>{0.5, 1.5}),
+       })},
+  });
+}
+
+}  // namespace
+
+TEST(StandardCodecStream, WriterMatchesSerializer) {
+  std::vector<uint8_t> encoded;
+  ByteBufferStreamWriter stream(&encoded);
+  StandardCodecWriter writer(&stream);
+  WriteValue(&writer);
+
+  auto expected = StandardMessageCodec::GetInstance().EncodeMessage(Value());
+  EXPECT_EQ(encoded, *expected);
+}
+
+TEST(StandardCodecStream, ReaderVisitsValues) {
+  auto encoded = StandardMessageCodec::GetInstance().EncodeMessage(Value());
+
+  StandardCodecReader reader(encoded->data(), encoded->size());
+  RecordingVisitor visitor;
+  EXPECT_TRUE(reader.ReadValue(&visitor));
+  EXPECT_TRUE(reader.IsAtEnd());
+  EXPECT_EQ(visitor.log(),
+            "map2( \"id\" i64:1099511627776 \"items\" list5( true null "
+            "f64:3.500000 u8[1,2,3] f64[0.500000,1.500000] ) ) ");
+}
+
+TEST(StandardCodecStream, ReaderCopiesUnalignedLists) {
+  auto encoded = StandardMessageCodec::GetInstance().EncodeMessage(Value());
+  std::vector<uint8_t> shifted(encoded->size() + 1);
+  std::copy(encoded->begin(), encoded->end(), shifted.begin() + 1);
+
+  StandardCodecReader reader(shifted.data() + 1, encoded->size());
+  RecordingVisitor visitor;
+  EXPECT_TRUE(reader.ReadValue(&visitor));
+  EXPECT_NE(visitor.log().find("f64[0.500000,1.500000]"), std::string::npos);
+}
+
+TEST(StandardCodecStream, ReaderReadsSequentialValues) {
+  std::vector<uint8_t> encoded;
+  ByteBufferStreamWriter stream(&encoded);
+  StandardCodecWriter writer(&stream);
+  writer.WriteString("method");
+  writer.WriteInt32List(nullptr, 0);
+  writer.WriteInt32(7);
+
+  StandardCodecReader reader(encoded.data(), encoded.size());
+  RecordingVisitor visitor;
+  EXPECT_TRUE(reader.ReadValue(&visitor));
+  EXPECT_TRUE(reader.ReadValue(&visitor));
+  EXPECT_FALSE(reader.IsAtEnd());
+  EXPECT_TRUE(reader.ReadValue(&visitor));
+  EXPECT_TRUE(reader.IsAtEnd());
+  EXPECT_EQ(visitor.log(), "\"method\" i32[0] i32:7 ");
+}
+
+TEST(StandardCodecStream, ReaderRejectsTruncatedInput) {
+  auto encoded = StandardMessageCodec::GetInstance().EncodeMessage(Value());
+
+  for (size_t size = 0; size < encoded->size(); ++size) {
+    StandardCodecReader reader(encoded->data(), size);
+    RecordingVisitor visitor;
+    EXPECT_FALSE(reader.ReadValue(&visitor)) << "size " << size;
+  }
+}
+
+TEST(StandardCodecStream, ReaderRejectsOversizedCollections) {
+  // A list claiming 0xffff elements in a 4-byte buffer.
+  const uint8_t encoded[] = {12, 254, 0xff, 0xff};
+  StandardCodecReader reader(encoded, sizeof(encoded));
+  RecordingVisitor visitor;
+  EXPECT_FALSE(reader.ReadValue(&visitor));
+  EXPECT_EQ(visitor.log(), "");
+}
+
+}  // namespace flutter
@@ -200,6 +200,18 @@ TEST(StandardMessageCodec, CanEncodeAndDecodeInt32Array) {
   CheckEncodeDecode(value, bytes);
 }
 
+TEST(StandardMessageCodec, CanEncodeAndDecodeEmptyArrayInList) {
+  // Empty arrays are still aligned, as in the Dart codec, so that the values
+  // after them are read from the right offset.
+  std::vector<uint8_t> bytes = {0x0c, 0x02, 0x0b, 0x00, 0x00, 0x00, 0x00, 0x00,
+                                0x03, 0x07, 0x00, 0x00, 0x00};
+  EncodableValue value(EncodableList{
+      EncodableValue(std::vector<double>{}),
+      EncodableValue(7),
+  });
+  CheckEncodeDecode(value, bytes);
+}
+
 TEST(StandardMessageCodec, CanEncodeAndDecodeInt64Array) {
   std::vector<uint8_t> bytes = {0x0a, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
                                 0xef, 0xcd, 0xab, 0x90, 0x78, 0x56, 0x34, 0x12,
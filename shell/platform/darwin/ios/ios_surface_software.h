@@ -35,7 +35,9 @@ class IOSSurfaceSoftware final : public IOSSurface, public GPUSurfaceSoftwareDel
   sk_sp<SkSurface> AcquireBackingStore(const SkISize& size) override;
 
   // |GPUSurfaceSoftwareDelegate|
-  bool PresentBackingStore(sk_sp<SkSurface> backing_store) override;
+  bool PresentBackingStore(
+      sk_sp<SkSurface> backing_store,
+      const std::optional<std::vector<SkIRect>>& damage) override;
 
  private:
   fml::scoped_nsobject<CALayer> layer_;
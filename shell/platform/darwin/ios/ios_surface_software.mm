@@ -64,7 +64,9 @@ sk_sp<SkSurface> IOSSurfaceSoftware::AcquireBackingStore(const SkISize& size) {
   return sk_surface_;
 }
 
-bool IOSSurfaceSoftware::PresentBackingStore(sk_sp<SkSurface> backing_store) {
+bool IOSSurfaceSoftware::PresentBackingStore(
+    sk_sp<SkSurface> backing_store,
+    const std::optional<std::vector<SkIRect>>& damage) {
   TRACE_EVENT0("flutter", "IOSSurfaceSoftware::PresentBackingStore");
   if (!IsValid() || backing_store == nullptr) {
     return false;
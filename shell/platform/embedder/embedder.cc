@@ -8,6 +8,7 @@
 #include <cstring>
 #include <iostream>
 #include <memory>
+#include <optional>
 #include <set>
 #include <string>
 #include <vector>
@@ -119,7 +120,9 @@ static bool IsSoftwareRendererConfigValid(const FlutterRendererConfig* config) {
   const FlutterSoftwareRendererConfig* software_config = &config->software;
 
   if (SAFE_ACCESS(software_config, surface_present_callback, nullptr) ==
-      nullptr) {
+          nullptr &&
+      SAFE_ACCESS(software_config, surface_present_with_damage_callback,
+                  nullptr) == nullptr) {
     return false;
   }
 
@@ -182,6 +185,8 @@ InferOpenGLPlatformViewCreationCallback(
     void* user_data,
     flutter::PlatformViewEmbedder::PlatformDispatchTable
         platform_dispatch_table,
+    flutter::PersistentCache::PrecompileProgressCallback
+        precompile_progress_callback,
     std::unique_ptr<flutter::EmbedderExternalViewEmbedder>
         external_view_embedder) {
 #ifdef SHELL_ENABLE_GL
@@ -280,6 +285,7 @@ InferOpenGLPlatformViewCreationCallback(
       gl_make_resource_current_callback,   // gl_make_resource_current_callback
       gl_surface_transformation_callback,  // gl_surface_transformation_callback
       gl_proc_resolver,                    // gl_proc_resolver
+      precompile_progress_callback,        // precompile_progress_callback
   };
 
   return fml::MakeCopyable(
@@ -306,6 +312,8 @@ InferMetalPlatformViewCreationCallback(
     void* user_data,
     flutter::PlatformViewEmbedder::PlatformDispatchTable
         platform_dispatch_table,
+    flutter::PersistentCache::PrecompileProgressCallback
+        precompile_progress_callback,
     std::unique_ptr<flutter::EmbedderExternalViewEmbedder>
         external_view_embedder) {
   if (config->type != kMetal) {
@@ -340,6 +348,7 @@ InferMetalPlatformViewCreationCallback(
   flutter::EmbedderSurfaceMetal::MetalDispatchTable metal_dispatch_table = {
       .present = metal_present,
       .get_texture = metal_get_texture,
+      .precompile_progress_callback = precompile_progress_callback,
   };
 
   std::shared_ptr<flutter::EmbedderExternalViewEmbedder> view_embedder =
@@ -368,37 +377,89 @@ InferMetalPlatformViewCreationCallback(
 #endif
 }
 
+static FlutterRect ToFlutterRect(const SkIRect& rect) {
+  FlutterRect flutter_rect = {};
+  flutter_rect.left = rect.left();
+  flutter_rect.top = rect.top();
+  flutter_rect.right = rect.right();
+  flutter_rect.bottom = rect.bottom();
+  return flutter_rect;
+}
+
+// Returns the bounds of the damage, or nullopt if it is unspecified.
+static std::optional<SkIRect> ToSkIRect(const FlutterDamage* damage) {
+  if (damage == nullptr) {
+    return std::nullopt;
+  }
+  size_t num_rects = SAFE_ACCESS(damage, num_rects, 0);
+  const FlutterRect* rects = SAFE_ACCESS(damage, damage, nullptr);
+  if (num_rects > 0 && rects == nullptr) {
+    FML_LOG(ERROR) << "Embedder specified damage without rectangles.";
+    return std::nullopt;
+  }
+  SkRect bounds = SkRect::MakeEmpty();
+  for (size_t i = 0; i < num_rects; i++) {
+    bounds.join(SkRect::MakeLTRB(rects[i].left, rects[i].top, rects[i].right,
+                                 rects[i].bottom));
+  }
+  return bounds.roundOut();
+}
+
 static flutter::Shell::CreateCallback<flutter::PlatformView>
 InferSoftwarePlatformViewCreationCallback(
     const FlutterRendererConfig* config,
     void* user_data,
     flutter::PlatformViewEmbedder::PlatformDispatchTable
         platform_dispatch_table,
+    flutter::PersistentCache::PrecompileProgressCallback
+        precompile_progress_callback,
     std::unique_ptr<flutter::EmbedderExternalViewEmbedder>
         external_view_embedder) {
   if (config->type != kSoftware) {
     return nullptr;
   }
 
+  auto present_with_damage = SAFE_ACCESS(
+      &config->software, surface_present_with_damage_callback, nullptr);
   auto software_present_backing_store =
-      [ptr = config->software.surface_present_callback, user_data](
-          const void* allocation, size_t row_bytes, size_t height) -> bool {
-    return ptr(user_data, allocation, row_bytes, height);
+      [ptr = config->software.surface_present_callback, present_with_damage,
+       user_data](const void* allocation, size_t row_bytes, size_t height,
+                  const std::vector<SkIRect>& damage) -> bool {
+    if (!present_with_damage) {
+      return ptr(user_data, allocation, row_bytes, height);
+    }
+    std::vector<FlutterRect> damage_rects;
+    for (const auto& rect : damage) {
+      if (!rect.isEmpty()) {
+        damage_rects.push_back(ToFlutterRect(rect));
+      }
+    }
+    FlutterDamage flutter_damage = {};
+    flutter_damage.struct_size = sizeof(FlutterDamage);
+    flutter_damage.num_rects = damage_rects.size();
+    flutter_damage.damage = damage_rects.data();
+    return present_with_damage(user_data, allocation, row_bytes, height,
+                               &flutter_damage);
   };
 
   flutter::EmbedderSurfaceSoftware::SoftwareDispatchTable
       software_dispatch_table = {
           software_present_backing_store,  // required
+          precompile_progress_callback,    // optional
       };
 
+  size_t raster_thread_count =
+      SAFE_ACCESS(&config->software, raster_thread_count, 0);
+
   return fml::MakeCopyable(
-      [software_dispatch_table, platform_dispatch_table,
+      [software_dispatch_table, raster_thread_count, platform_dispatch_table,
        external_view_embedder =
            std::move(external_view_embedder)](flutter::Shell& shell) mutable {
         return std::make_unique<flutter::PlatformViewEmbedder>(
             shell,                             // delegate
             shell.GetTaskRunners(),            // task runners
             software_dispatch_table,           // software dispatch table
+            raster_thread_count,               // raster thread count
             platform_dispatch_table,           // platform dispatch table
             std::move(external_view_embedder)  // external view embedder
         );
@@ -411,6 +472,8 @@ InferPlatformViewCreationCallback(
     void* user_data,
     flutter::PlatformViewEmbedder::PlatformDispatchTable
         platform_dispatch_table,
+    flutter::PersistentCache::PrecompileProgressCallback
+        precompile_progress_callback,
     std::unique_ptr<flutter::EmbedderExternalViewEmbedder>
         external_view_embedder) {
   if (config == nullptr) {
@@ -421,15 +484,15 @@ InferPlatformViewCreationCallback(
     case kOpenGL:
       return InferOpenGLPlatformViewCreationCallback(
           config, user_data, platform_dispatch_table,
-          std::move(external_view_embedder));
+          precompile_progress_callback, std::move(external_view_embedder));
     case kSoftware:
       return InferSoftwarePlatformViewCreationCallback(
           config, user_data, platform_dispatch_table,
-          std::move(external_view_embedder));
+          precompile_progress_callback, std::move(external_view_embedder));
     case kMetal:
       return InferMetalPlatformViewCreationCallback(
           config, user_data, platform_dispatch_table,
-          std::move(external_view_embedder));
+          precompile_progress_callback, std::move(external_view_embedder));
     default:
       return nullptr;
   }
@@ -629,6 +692,13 @@ CreateEmbedderRenderTarget(const FlutterCompositor* compositor,
     return nullptr;
   }
 
+  // The existing damage is only valid during the call to the create callback,
+  // so don't keep it in the copies of the backing store handed back to the
+  // embedder later.
+  std::optional<SkIRect> existing_damage =
+      ToSkIRect(SAFE_ACCESS(&backing_store, existing_damage, nullptr));
+  backing_store.existing_damage = nullptr;
+
   // In case we return early without creating an embedder render target, the
   // embedder has still given us ownership of its baton which we must return
   // back to it. If this method is successful, the closure is released when the
@@ -674,7 +744,8 @@ CreateEmbedderRenderTarget(const FlutterCompositor* compositor,
   }
 
   return std::make_unique<flutter::EmbedderRenderTarget>(
-      backing_store, std::move(render_surface), collect_callback.Release());
+      backing_store, std::move(render_surface), collect_callback.Release(),
+      existing_damage);
 }
 
 static std::pair<std::unique_ptr<flutter::EmbedderExternalViewEmbedder>,
@@ -1009,6 +1080,17 @@ FlutterEngineResult FlutterEngineInitialize(size_t version,
     settings.log_tag = SAFE_ACCESS(args, log_tag, nullptr);
   }
 
+  flutter::PersistentCache::PrecompileProgressCallback
+      precompile_progress_callback;
+  if (SAFE_ACCESS(args, shader_precompilation_callback, nullptr) != nullptr) {
+    FlutterShaderPrecompilationCallback callback =
+        SAFE_ACCESS(args, shader_precompilation_callback, nullptr);
+    precompile_progress_callback = [callback, user_data](
+                                       size_t precompiled_count,
+                                       size_t total_count) {
+      callback(precompiled_count, total_count, user_data);
+    };
+  }
   flutter::PlatformViewEmbedder::UpdateSemanticsNodesCallback
       update_semantics_nodes_callback = nullptr;
   if (SAFE_ACCESS(args, update_semantics_node_callback, nullptr) != nullptr) {
@@ -1194,7 +1276,7 @@ FlutterEngineResult FlutterEngineInitialize(size_t version,
       };
 
   auto on_create_platform_view = InferPlatformViewCreationCallback(
-      config, user_data, platform_dispatch_table,
+      config, user_data, platform_dispatch_table, precompile_progress_callback,
       std::move(external_view_embedder_result.first));
 
   if (!on_create_platform_view) {
@@ -1633,9 +1715,38 @@ FlutterEngineResult FlutterEngineSendKeyEvent(FLUTTER_API_SYMBOL(FlutterEngine)
                                   "running Flutter application.");
 }
 
+// Wraps a buffer whose ownership was handed to the engine so that the release
+// callback is invoked when the engine is done with it.
+static std::unique_ptr<fml::Mapping> AdoptEmbedderBuffer(
+    const uint8_t* data,
+    size_t size,
+    FlutterDataReleaseCallback release_callback,
+    void* user_data) {
+  return std::make_unique<fml::NonOwnedMapping>(
+      data, size,
+      [release_callback, user_data](const uint8_t* released_data,
+                                    size_t released_size) {
+        release_callback(released_data, released_size, user_data);
+      });
+}
+
 FlutterEngineResult FlutterEngineSendPlatformMessage(
     FLUTTER_API_SYMBOL(FlutterEngine) engine,
     const FlutterPlatformMessage* flutter_message) {
+  // Take ownership of an adopted buffer before anything else so that it is
+  // released on every path out of this call.
+  std::unique_ptr<fml::Mapping> adopted_message;
+  if (flutter_message != nullptr) {
+    FlutterDataReleaseCallback release_callback =
+        SAFE_ACCESS(flutter_message, message_release_callback, nullptr);
+    if (release_callback != nullptr) {
+      adopted_message = AdoptEmbedderBuffer(
+          SAFE_ACCESS(flutter_message, message, nullptr),
+          SAFE_ACCESS(flutter_message, message_size, 0), release_callback,
+          SAFE_ACCESS(flutter_message, message_release_user_data, nullptr));
+    }
+  }
+
   if (engine == nullptr) {
     return LOG_EMBEDDER_ERROR(kInvalidArguments, "Invalid engine handle.");
   }
@@ -1670,6 +1781,9 @@ FlutterEngineResult FlutterEngineSendPlatformMessage(
   if (message_size == 0) {
     message = std::make_unique<flutter::PlatformMessage>(
         flutter_message->channel, response);
+  } else if (adopted_message) {
+    message = std::make_unique<flutter::PlatformMessage>(
+        flutter_message->channel, std::move(adopted_message), response);
   } else {
     message = std::make_unique<flutter::PlatformMessage>(
         flutter_message->channel,
@@ -1760,6 +1874,49 @@ FlutterEngineResult FlutterEngineSendPlatformMessageResponse(
   return kSuccess;
 }
 
+FlutterEngineResult FlutterEngineSendPlatformMessageResponseNoCopy(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    const FlutterPlatformMessageResponseHandle* handle,
+    const uint8_t* data,
+    size_t data_length,
+    FlutterDataReleaseCallback release_callback,
+    void* user_data) {
+  if (release_callback == nullptr) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments,
+                              "The release callback was null.");
+  }
+
+  // Released when the response is done with it, or on return if the response
+  // could not be sent.
+  std::unique_ptr<fml::Mapping> adopted_data =
+      AdoptEmbedderBuffer(data, data_length, release_callback, user_data);
+
+  if (data_length != 0 && data == nullptr) {
+    return LOG_EMBEDDER_ERROR(
+        kInvalidArguments,
+        "Data size was non zero but the pointer to the data was null.");
+  }
+
+  if (handle == nullptr) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments,
+                              "The response handle was null.");
+  }
+
+  auto response = handle->message->response();
+
+  if (response) {
+    if (data_length == 0) {
+      response->CompleteEmpty();
+    } else {
+      response->Complete(std::move(adopted_data));
+    }
+  }
+
+  delete handle;
+
+  return kSuccess;
+}
+
 FlutterEngineResult __FlutterEngineFlushPendingTasksNow() {
   fml::MessageLoop::GetCurrent().RunExpiredTasksNow();
   return kSuccess;
@@ -2338,6 +2495,8 @@ FlutterEngineResult FlutterEngineGetProcAddresses(
   SET_PROC(PostCallbackOnAllNativeThreads,
            FlutterEnginePostCallbackOnAllNativeThreads);
   SET_PROC(NotifyDisplayUpdate, FlutterEngineNotifyDisplayUpdate);
+  SET_PROC(SendPlatformMessageResponseNoCopy,
+           FlutterEngineSendPlatformMessageResponseNoCopy);
 #undef SET_PROC
 
   return kSuccess;
@@ -352,6 +352,17 @@ typedef struct {
   FlutterSize lower_left_corner_radius;
 } FlutterRoundedRect;
 
+/// An area of a surface, described by the rectangles that cover it, in
+/// physical pixels.
+typedef struct {
+  /// The size of this struct. Must be sizeof(FlutterDamage).
+  size_t struct_size;
+  /// The number of rectangles in `damage`.
+  size_t num_rects;
+  /// The rectangles that cover the area.
+  FlutterRect* damage;
+} FlutterDamage;
+
 /// This information is passed to the embedder when requesting a frame buffer
 /// object.
 ///
@@ -541,6 +552,13 @@ typedef struct {
   FlutterMetalTextureFrameCallback external_texture_frame_callback;
 } FlutterMetalRendererConfig;
 
+typedef bool (*SoftwareSurfacePresentWithDamageCallback)(
+    void* /* user data */,
+    const void* /* allocation */,
+    size_t /* row bytes */,
+    size_t /* height */,
+    const FlutterDamage* /* damage */);
+
 typedef struct {
   /// The size of this struct. Must be sizeof(FlutterSoftwareRendererConfig).
   size_t struct_size;
@@ -549,6 +567,22 @@ typedef struct {
   /// format. The buffer is owned by the Flutter engine and must be copied in
   /// this callback if needed.
   SoftwareSurfacePresentCallback surface_present_callback;
+  /// The number of threads used to rasterize each frame. If this is greater
+  /// than one, each frame is recorded and then rasterized in parallel tiles of
+  /// the buffer before the buffer is passed to the `surface_present_callback`.
+  /// Frames using backdrop filters are always rasterized on a single thread.
+  /// This is ignored when a custom compositor is specified. A value of zero
+  /// (the default) rasterizes every frame on the raster thread.
+  size_t raster_thread_count;
+  /// The callback presented to the embedder to present a fully populated buffer
+  /// along with the area of the buffer that changed since the last buffer was
+  /// presented, as one or more possibly overlapping rectangles. The engine
+  /// keeps the contents of the buffer between frames and only repaints that
+  /// area, so the embedder may copy just that area instead of the whole
+  /// buffer. If this is specified, `surface_present_callback` is
+  /// not used and may be null. This is ignored when a custom compositor is
+  /// specified.
+  SoftwareSurfacePresentWithDamageCallback surface_present_with_damage_callback;
 } FlutterSoftwareRendererConfig;
 
 typedef struct {
@@ -752,6 +786,13 @@ struct _FlutterPlatformMessageResponseHandle;
 typedef struct _FlutterPlatformMessageResponseHandle
     FlutterPlatformMessageResponseHandle;
 
+/// The callback invoked by the engine once it is done with a buffer whose
+/// ownership was handed to it. The callback is given the data pointer and size
+/// the buffer was handed over with and may be invoked on any thread.
+typedef void (*FlutterDataReleaseCallback)(const uint8_t* /* data */,
+                                           size_t /* size */,
+                                           void* /* user data */);
+
 typedef struct {
   /// The size of this struct. Must be sizeof(FlutterPlatformMessage).
   size_t struct_size;
@@ -765,6 +806,21 @@ typedef struct {
   /// `FlutterEngineSendPlatformMessageResponse` will cause a memory leak. It is
   /// not safe to send multiple responses on a single response object.
   const FlutterPlatformMessageResponseHandle* response_handle;
+  /// Only used for messages sent to the engine via
+  /// `FlutterEngineSendPlatformMessage`, and always null in messages received
+  /// from the engine.
+  ///
+  /// If this is null, the engine copies the message before
+  /// `FlutterEngineSendPlatformMessage` returns. Otherwise, the engine takes
+  /// ownership of the `message` buffer and hands it to the Dart application
+  /// without copying it. The buffer must stay valid, and must not be modified
+  /// by the embedder, until the engine invokes this callback with
+  /// `message_release_user_data`. Dart code may write to the buffer, so it must
+  /// not be in read-only memory. The callback is invoked exactly once, even if
+  /// the message could not be sent.
+  FlutterDataReleaseCallback message_release_callback;
+  /// The user data baton passed to `message_release_callback`.
+  void* message_release_user_data;
 } FlutterPlatformMessage;
 
 typedef void (*FlutterPlatformMessageCallback)(
@@ -1070,6 +1126,17 @@ typedef struct {
     // The description of the Metal backing store.
     FlutterMetalBackingStore metal;
   };
+  /// The area of the backing store whose contents are not those of the last
+  /// layer it was presented with, such as for a backing store the embedder
+  /// recycles after presenting other backing stores in its place. It may be
+  /// specified in `FlutterCompositor.create_backing_store_callback` and is only
+  /// read during that call. The engine then repaints this area, in addition to
+  /// the part of the frame that changed, instead of the whole backing store.
+  /// If null (the default), the whole backing store is repainted.
+  ///
+  /// The area repainted for each presented backing store is given to the
+  /// embedder in `FlutterLayer.paint_region`.
+  const FlutterDamage* existing_damage;
 } FlutterBackingStore;
 
 typedef struct {
@@ -1106,6 +1173,11 @@ typedef struct {
   FlutterPoint offset;
   /// The size of the layer (in physical pixels).
   FlutterSize size;
+  /// For a layer whose contents are rendered by Flutter, the area of the
+  /// backing store that was repainted for this frame, in the coordinates of the
+  /// backing store. The rest of the backing store was left as is. Null for a
+  /// layer whose contents are determined by the embedder.
+  const FlutterDamage* paint_region;
 } FlutterLayer;
 
 typedef bool (*FlutterBackingStoreCreateCallback)(
@@ -1141,9 +1213,14 @@ typedef struct {
   /// embedder may collect any resources associated with the backing store.
   FlutterBackingStoreCollectCallback collect_backing_store_callback;
   /// Callback invoked by the engine to composite the contents of each layer
-  /// onto the screen.
+  /// onto the screen. Contents drawn above a platform view that do not
+  /// overlap it are placed in a backing store below it, so there may be fewer
+  /// backing stores than there are platform views.
   FlutterLayersPresentCallback present_layers_callback;
-  /// Avoid caching backing stores provided by this compositor.
+  /// Avoid caching backing stores provided by this compositor. Unless this
+  /// is set, the engine keeps backing stores it no longer needs for a few
+  /// frames and may present them as a different `FlutterLayer`, or at a
+  /// different position in the layers, than the one they were created for.
   bool avoid_backing_store_cache;
 } FlutterCompositor;
 
@@ -1341,6 +1418,20 @@ typedef void (*FlutterLogMessageCallback)(const char* /* tag */,
                                           const char* /* message */,
                                           void* /* user_data */);
 
+// Callback for the progress of shader precompilation.
+//
+// Cached shaders are precompiled when the rendering surface is created. This
+// is called after each shader is precompiled with the number of shaders
+// handled so far in `precompiled_count`, and the number of shaders to
+// precompile in `total_count`. Precompilation is complete when both are
+// equal. Both are zero if there is nothing to precompile, which is always the
+// case with the software renderer. `user_data` is a user data baton passed in
+// `FlutterEngineRun`.
+typedef void (*FlutterShaderPrecompilationCallback)(
+    size_t /* precompiled_count */,
+    size_t /* total_count */,
+    void* /* user_data */);
+
 /// An opaque object that describes the AOT data that can be used to launch a
 /// FlutterEngine instance in AOT mode.
 typedef struct _FlutterEngineAOTData* FlutterEngineAOTData;
@@ -1589,6 +1680,17 @@ typedef struct {
   //
   // The first argument is the `user_data` from `FlutterEngineInitialize`.
   OnPreEngineRestartCallback on_pre_engine_restart_callback;
+
+  // A callback that reports the progress of shader precompilation.
+  //
+  // This optional callback can be used to hold off on showing the first frame
+  // until cached shaders are ready, or to measure how long precompilation
+  // takes. It is called at least once, with both counts equal, each time the
+  // rendering surface of this engine is created, whatever the renderer. This
+  // callback is made on the raster thread and embedders must re-thread if
+  // necessary. Performing blocking calls in this callback delays the first
+  // frame.
+  FlutterShaderPrecompilationCallback shader_precompilation_callback;
 } FlutterProjectArgs;
 
 #ifndef FLUTTER_ENGINE_NO_PROTOTYPES
@@ -1849,6 +1951,41 @@ FlutterEngineResult FlutterEngineSendPlatformMessageResponse(
     const uint8_t* data,
     size_t data_length);
 
+//------------------------------------------------------------------------------
+/// @brief      Send a response from the native side to a platform message from
+///             the Dart Flutter application, handing ownership of the response
+///             data to the engine instead of having it copied.
+///
+///             The data is given to the Dart application without being
+///             copied. It must stay valid, and must not be modified by the
+///             embedder, until the engine invokes the release callback. Dart
+///             code may write to the data, so it must not be in read-only
+///             memory. The release callback is invoked exactly once, on any
+///             thread, even if this call fails.
+///
+/// @see        FlutterEngineSendPlatformMessageResponse()
+///
+/// @param[in]  engine            The running engine instance.
+/// @param[in]  handle            The platform message response handle.
+/// @param[in]  data              The data to associate with the platform
+///                               message response.
+/// @param[in]  data_length       The length of the platform message response
+///                               data.
+/// @param[in]  release_callback  The callback invoked by the engine once it no
+///                               longer needs the data.
+/// @param[in]  user_data         The user data passed to the release callback.
+///
+/// @return     The result of the call.
+///
+FLUTTER_EXPORT
+FlutterEngineResult FlutterEngineSendPlatformMessageResponseNoCopy(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    const FlutterPlatformMessageResponseHandle* handle,
+    const uint8_t* data,
+    size_t data_length,
+    FlutterDataReleaseCallback release_callback,
+    void* user_data);
+
 //------------------------------------------------------------------------------
 /// @brief      This API is only meant to be used by platforms that need to
 ///             flush tasks on a message loop not controlled by the Flutter
@@ -2367,6 +2504,14 @@ typedef FlutterEngineResult (*FlutterEngineNotifyDisplayUpdateFnPtr)(
     FlutterEngineDisplaysUpdateType update_type,
     const FlutterEngineDisplay* displays,
     size_t display_count);
+typedef FlutterEngineResult (
+    *FlutterEngineSendPlatformMessageResponseNoCopyFnPtr)(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    const FlutterPlatformMessageResponseHandle* handle,
+    const uint8_t* data,
+    size_t data_length,
+    FlutterDataReleaseCallback release_callback,
+    void* user_data);
 
 /// Function-pointer-based versions of the APIs above.
 typedef struct {
@@ -2411,6 +2556,8 @@ typedef struct {
   FlutterEnginePostCallbackOnAllNativeThreadsFnPtr
       PostCallbackOnAllNativeThreads;
   FlutterEngineNotifyDisplayUpdateFnPtr NotifyDisplayUpdate;
+  FlutterEngineSendPlatformMessageResponseNoCopyFnPtr
+      SendPlatformMessageResponseNoCopy;
 } FlutterEngineProcTable;
 
 //------------------------------------------------------------------------------
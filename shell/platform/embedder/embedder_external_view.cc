@@ -8,6 +8,14 @@
 
 namespace flutter {
 
+static SkCanvas* BeginRecording(SkPictureRecorder& recorder,
+                                const SkISize& frame_size,
+                                sk_sp<RTree>* rtree) {
+  RTreeFactory rtree_factory;
+  *rtree = rtree_factory.getInstance();
+  return recorder.beginRecording(SkRect::Make(frame_size), &rtree_factory);
+}
+
 static SkISize TransformedSurfaceSize(const SkISize& size,
                                       const SkMatrix& transformation) {
   const auto source_rect = SkRect::MakeWH(size.width(), size.height());
@@ -32,8 +40,7 @@ EmbedderExternalView::EmbedderExternalView(
       embedded_view_params_(std::move(params)),
       recorder_(std::make_unique<SkPictureRecorder>()),
       canvas_spy_(std::make_unique<CanvasSpy>(
-          recorder_->beginRecording(frame_size.width(), frame_size.height()))) {
-}
+          BeginRecording(*recorder_, frame_size, &rtree_))) {}
 
 EmbedderExternalView::~EmbedderExternalView() = default;
 
@@ -59,7 +66,7 @@ bool EmbedderExternalView::HasPlatformView() const {
 }
 
 bool EmbedderExternalView::HasEngineRenderedContents() const {
-  return canvas_spy_->DidDrawIntoCanvas();
+  return !contents_merged_ && canvas_spy_->DidDrawIntoCanvas();
 }
 
 EmbedderExternalView::ViewIdentifier EmbedderExternalView::GetViewIdentifier()
@@ -71,15 +78,58 @@ const EmbeddedViewParams* EmbedderExternalView::GetEmbeddedViewParams() const {
   return embedded_view_params_.get();
 }
 
-bool EmbedderExternalView::Render(const EmbedderRenderTarget& render_target) {
+SkIRect EmbedderExternalView::GetPaintRegion(
+    const std::optional<SkIRect>& frame_damage,
+    const EmbedderRenderTarget& render_target) const {
+  const auto surface_bounds = SkIRect::MakeSize(render_surface_size_);
+  const auto& existing_damage = render_target.GetExistingDamage();
+  if (!frame_damage || !existing_damage) {
+    return surface_bounds;
+  }
+  auto paint_region =
+      surface_transformation_.mapRect(SkRect::Make(*frame_damage)).roundOut();
+  paint_region.join(*existing_damage);
+  if (!paint_region.intersect(surface_bounds)) {
+    return SkIRect::MakeEmpty();
+  }
+  return paint_region;
+}
+
+void EmbedderExternalView::FinishRecording() {
+  if (recording_finished_) {
+    return;
+  }
+  recording_finished_ = true;
+  // The R-Tree is only populated once the picture is created.
+  if (auto picture = recorder_->finishRecordingAsPicture()) {
+    pictures_.push_back(std::move(picture));
+  }
+}
+
+bool EmbedderExternalView::ContentsIntersect(const SkRect& rect) const {
+  FML_DCHECK(recording_finished_);
+  return !rtree_->searchNonOverlappingDrawnRects(rect).empty();
+}
+
+void EmbedderExternalView::MergeContentsOf(EmbedderExternalView& other) {
+  FML_DCHECK(recording_finished_ && other.recording_finished_);
+  FML_DCHECK(&other != this);
+  pictures_.insert(pictures_.end(), other.pictures_.begin(),
+                   other.pictures_.end());
+  other.pictures_.clear();
+  other.contents_merged_ = true;
+}
+
+bool EmbedderExternalView::Render(const EmbedderRenderTarget& render_target,
+                                  const SkIRect& paint_region) {
   TRACE_EVENT0("flutter", "EmbedderExternalView::Render");
 
   FML_DCHECK(HasEngineRenderedContents())
       << "Unnecessarily asked to render into a render target when there was "
          "nothing to render.";
 
-  auto picture = recorder_->finishRecordingAsPicture();
-  if (!picture) {
+  FinishRecording();
+  if (pictures_.empty()) {
     return false;
   }
 
@@ -96,9 +146,15 @@ bool EmbedderExternalView::Render(const EmbedderRenderTarget& render_target) {
     return false;
   }
 
+  // The rest of the render surface already holds the contents of this frame.
+  SkAutoCanvasRestore restore(canvas, true);
+  canvas->resetMatrix();
+  canvas->clipRect(SkRect::Make(paint_region));
   canvas->setMatrix(surface_transformation_);
   canvas->clear(SK_ColorTRANSPARENT);
-  canvas->drawPicture(picture);
+  for (const auto& picture : pictures_) {
+    canvas->drawPicture(picture);
+  }
   canvas->flush();
 
   return true;
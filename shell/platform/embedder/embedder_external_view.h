@@ -8,8 +8,10 @@
 #include <optional>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include "flutter/flow/embedded_views.h"
+#include "flutter/flow/rtree.h"
 #include "flutter/fml/hash_combine.h"
 #include "flutter/fml/macros.h"
 #include "flutter/shell/common/canvas_spy.h"
@@ -108,7 +110,35 @@ class EmbedderExternalView {
 
   SkISize GetRenderSurfaceSize() const;
 
-  bool Render(const EmbedderRenderTarget& render_target);
+  // The area of the render target to repaint, in the coordinates of its render
+  // surface. This is the frame damage and the existing damage of the render
+  // target, or the whole render surface if either is unknown.
+  SkIRect GetPaintRegion(const std::optional<SkIRect>& frame_damage,
+                         const EmbedderRenderTarget& render_target) const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Ends the recording of the contents of this view. No more
+  ///             contents may be drawn into its canvas afterwards.
+  ///
+  void FinishRecording();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Whether any of the drawing operations recorded for this view
+  ///             intersect the given rect, in frame coordinates. The recording
+  ///             must be finished.
+  ///
+  bool ContentsIntersect(const SkRect& rect) const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Takes the contents of another view, which are rendered on
+  ///             top of the contents of this view into its render target. The
+  ///             other view is left without engine rendered contents. Both
+  ///             recordings must be finished.
+  ///
+  void MergeContentsOf(EmbedderExternalView& other);
+
+  bool Render(const EmbedderRenderTarget& render_target,
+              const SkIRect& paint_region);
 
  private:
   const SkISize render_surface_size_;
@@ -116,7 +146,13 @@ class EmbedderExternalView {
   ViewIdentifier view_identifier_;
   std::unique_ptr<EmbeddedViewParams> embedded_view_params_;
   std::unique_ptr<SkPictureRecorder> recorder_;
+  sk_sp<RTree> rtree_;
   std::unique_ptr<CanvasSpy> canvas_spy_;
+  // The recorded contents of this view followed by those of the views merged
+  // into it. Empty until the recording is finished.
+  std::vector<sk_sp<SkPicture>> pictures_;
+  bool recording_finished_ = false;
+  bool contents_merged_ = false;
 
   FML_DISALLOW_COPY_AND_ASSIGN(EmbedderExternalView);
 };
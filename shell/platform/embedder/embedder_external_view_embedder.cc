@@ -6,6 +6,7 @@
 
 #include <algorithm>
 
+#include "flutter/fml/trace_event.h"
 #include "flutter/shell/platform/embedder/embedder_layers.h"
 #include "flutter/shell/platform/embedder/embedder_render_target.h"
 #include "third_party/skia/include/gpu/GrDirectContext.h"
@@ -41,6 +42,7 @@ SkMatrix EmbedderExternalViewEmbedder::GetSurfaceTransformation() const {
 void EmbedderExternalViewEmbedder::Reset() {
   pending_views_.clear();
   composition_order_.clear();
+  composition_targets_.clear();
 }
 
 // |ExternalViewEmbedder|
@@ -120,6 +122,71 @@ SkCanvas* EmbedderExternalViewEmbedder::CompositeEmbeddedView(int view_id) {
   return found->second->GetCanvas();
 }
 
+// |ExternalViewEmbedder|
+bool EmbedderExternalViewEmbedder::SupportsPartialRepaint() {
+  return true;
+}
+
+// |ExternalViewEmbedder|
+bool EmbedderExternalViewEmbedder::ReleaseUnusedResources() {
+  // The pooled render targets are collected when the returned set goes out of
+  // scope.
+  //
+  // @warning: Embedder may trample on our OpenGL context here.
+  return !render_target_cache_.ClearPooledRenderTargets().empty();
+}
+
+std::optional<SkIRect> EmbedderExternalViewEmbedder::GetFrameDamage(
+    const SurfaceFrame& frame) const {
+  // The contents of the render targets depend on the layers they were
+  // rendered for, so any change in the layers requires a full repaint.
+  if (pending_surface_transformation_ != presented_surface_transformation_ ||
+      !std::equal(composition_order_.begin(), composition_order_.end(),
+                  presented_composition_order_.begin(),
+                  presented_composition_order_.end(),
+                  EmbedderExternalView::ViewIdentifier::Equal{}) ||
+      !std::equal(composition_targets_.begin(), composition_targets_.end(),
+                  presented_composition_targets_.begin(),
+                  presented_composition_targets_.end(),
+                  EmbedderExternalView::ViewIdentifier::Equal{})) {
+    return std::nullopt;
+  }
+  return frame.submit_info().frame_damage;
+}
+
+void EmbedderExternalViewEmbedder::CoalesceViews() {
+  TRACE_EVENT0("flutter", "EmbedderExternalViewEmbedder::CoalesceViews");
+  // The view that the contents of the following views are merged into, and the
+  // bounds of the platform views presented on top of its contents so far.
+  EmbedderExternalView* target_view = nullptr;
+  std::vector<SkRect> platform_view_rects;
+  for (const auto& view_id : composition_order_) {
+    auto& external_view = *pending_views_.at(view_id);
+    external_view.FinishRecording();
+    // The platform view of a view is presented below its contents.
+    if (external_view.HasPlatformView()) {
+      platform_view_rects.push_back(
+          external_view.GetEmbeddedViewParams()->finalBoundingRect());
+    }
+    if (!external_view.HasEngineRenderedContents()) {
+      composition_targets_.push_back(view_id);
+      continue;
+    }
+    const bool overlaps_platform_views = std::any_of(
+        platform_view_rects.begin(), platform_view_rects.end(),
+        [&external_view](const SkRect& platform_view_rect) {
+          return external_view.ContentsIntersect(platform_view_rect);
+        });
+    if (target_view && !overlaps_platform_views) {
+      target_view->MergeContentsOf(external_view);
+    } else {
+      target_view = &external_view;
+      platform_view_rects.clear();
+    }
+    composition_targets_.push_back(target_view->GetViewIdentifier());
+  }
+}
+
 static FlutterBackingStoreConfig MakeBackingStoreConfig(
     const SkISize& backing_store_size) {
   FlutterBackingStoreConfig config = {};
@@ -136,24 +203,15 @@ static FlutterBackingStoreConfig MakeBackingStoreConfig(
 void EmbedderExternalViewEmbedder::SubmitFrame(
     GrDirectContext* context,
     std::unique_ptr<SurfaceFrame> frame) {
+  CoalesceViews();
+
+  const auto frame_damage = GetFrameDamage(*frame);
+  presented_composition_order_.clear();
+  presented_composition_targets_.clear();
+
   auto [matched_render_targets, pending_keys] =
       render_target_cache_.GetExistingTargetsInCache(pending_views_);
 
-  // This is where unused render targets will be collected. Control may flow to
-  // the embedder. Here, the embedder has the opportunity to trample on the
-  // OpenGL context.
-  //
-  // For optimum performance, we should tell the render target cache to clear
-  // its unused entries before allocating new ones. This collection step before
-  // allocating new render targets ameliorates peak memory usage within the
-  // frame. But, this causes an issue in a known internal embedder. To work
-  // around this issue while that embedder migrates, collection of render
-  // targets is deferred after the presentation.
-  //
-  // @warning: Embedder may trample on our OpenGL context here.
-  auto deferred_cleanup_render_targets =
-      render_target_cache_.ClearAllRenderTargetsInCache();
-
   for (const auto& pending_key : pending_keys) {
     const auto& external_view = pending_views_.at(pending_key);
 
@@ -173,6 +231,15 @@ void EmbedderExternalViewEmbedder::SubmitFrame(
     // directly.
     const auto render_surface_size = external_view->GetRenderSurfaceSize();
 
+    // Render targets that other views or older frames no longer use may be
+    // recycled instead of asking the embedder for a new one. Their contents
+    // are those of another layer, so they are repainted in full.
+    if (auto recycled_render_target =
+            render_target_cache_.RecycleRenderTarget(render_surface_size)) {
+      matched_render_targets[pending_key] = std::move(recycled_render_target);
+      continue;
+    }
+
     const auto backing_store_config =
         MakeBackingStoreConfig(render_surface_size);
 
@@ -189,9 +256,29 @@ void EmbedderExternalViewEmbedder::SubmitFrame(
       FML_LOG(ERROR) << "Embedder did not return a valid render target.";
       return;
     }
+    // With platform views, the embedder cannot know which of the layers a
+    // backing store it recycles was last presented with.
+    if (composition_order_.size() > 1) {
+      render_target->SetExistingDamage(std::nullopt);
+    }
     matched_render_targets[pending_key] = std::move(render_target);
   }
 
+  // This is where render targets that the cache no longer keeps will be
+  // collected. Control may flow to the embedder. Here, the embedder has the
+  // opportunity to trample on the OpenGL context.
+  //
+  // Unused render targets are only evicted once the render targets of this
+  // frame have been recycled from them. Collecting them before allocating new
+  // render targets would ameliorate peak memory usage within the frame. But,
+  // this causes an issue in a known internal embedder. To work around this
+  // issue while that embedder migrates, collection of render targets is
+  // deferred after the presentation.
+  //
+  // @warning: Embedder may trample on our OpenGL context here.
+  auto deferred_cleanup_render_targets =
+      render_target_cache_.EvictUnusedRenderTargets();
+
   // The OpenGL context could have been trampled by the embedder at this point
   // as it attempted to collect old render targets and create new ones. Tell
   // Skia to not rely on existing bindings.
@@ -200,14 +287,23 @@ void EmbedderExternalViewEmbedder::SubmitFrame(
   }
 
   // Scribble embedder provide render targets. The order in which we scribble
-  // into the buffers is irrelevant to the presentation order.
+  // into the buffers is irrelevant to the presentation order. Only the parts
+  // of the render targets that lag behind this frame are repainted.
+  std::unordered_map<EmbedderExternalView::ViewIdentifier, SkIRect,
+                     EmbedderExternalView::ViewIdentifier::Hash,
+                     EmbedderExternalView::ViewIdentifier::Equal>
+      paint_regions;
   for (const auto& render_target : matched_render_targets) {
-    if (!pending_views_.at(render_target.first)
-             ->Render(*render_target.second)) {
+    const auto& external_view = pending_views_.at(render_target.first);
+    const auto paint_region =
+        external_view->GetPaintRegion(frame_damage, *render_target.second);
+    if (!external_view->Render(*render_target.second, paint_region)) {
       FML_LOG(ERROR)
           << "Could not render into the embedder supplied render target.";
       return;
     }
+    render_target.second->SetExistingDamage(SkIRect::MakeEmpty());
+    paint_regions[render_target.first] = paint_region;
   }
 
   // We are going to be transferring control back over to the embedder there the
@@ -246,7 +342,8 @@ void EmbedderExternalViewEmbedder::SubmitFrame(
       if (external_view->HasEngineRenderedContents()) {
         const auto& exteral_render_target = matched_render_targets.at(view_id);
         presented_layers.PushBackingStoreLayer(
-            exteral_render_target->GetBackingStore());
+            exteral_render_target->GetBackingStore(),
+            paint_regions.at(view_id));
       }
     }
 
@@ -254,6 +351,9 @@ void EmbedderExternalViewEmbedder::SubmitFrame(
     //
     // @warning: Embedder may trample on our OpenGL context here.
     presented_layers.InvokePresentCallback(present_callback_);
+    presented_composition_order_ = composition_order_;
+    presented_composition_targets_ = composition_targets_;
+    presented_surface_transformation_ = pending_surface_transformation_;
   }
 
   // See why this is necessary in the comment where this collection in realized.
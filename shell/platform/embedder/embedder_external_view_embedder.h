@@ -103,6 +103,12 @@ class EmbedderExternalViewEmbedder final : public ExternalViewEmbedder {
   // |ExternalViewEmbedder|
   SkCanvas* GetRootCanvas() override;
 
+  // |ExternalViewEmbedder|
+  bool SupportsPartialRepaint() override;
+
+  // |ExternalViewEmbedder|
+  bool ReleaseUnusedResources() override;
+
  private:
   const bool avoid_backing_store_cache_;
   const CreateRenderTargetCallback create_render_target_callback_;
@@ -113,12 +119,32 @@ class EmbedderExternalViewEmbedder final : public ExternalViewEmbedder {
   SkMatrix pending_surface_transformation_;
   EmbedderExternalView::PendingViews pending_views_;
   std::vector<EmbedderExternalView::ViewIdentifier> composition_order_;
+  // For each view in composition order, the view whose render target its
+  // contents are rendered into.
+  std::vector<EmbedderExternalView::ViewIdentifier> composition_targets_;
   EmbedderRenderTargetCache render_target_cache_;
+  // The layers of the last frame presented, which the frame damage is relative
+  // to. Empty if the last frame could not be presented.
+  std::vector<EmbedderExternalView::ViewIdentifier>
+      presented_composition_order_;
+  std::vector<EmbedderExternalView::ViewIdentifier>
+      presented_composition_targets_;
+  SkMatrix presented_surface_transformation_;
 
   void Reset();
 
   SkMatrix GetSurfaceTransformation() const;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Merges the contents of the views that do not overlap any of
+  ///             the platform views below them, down to the closest view with
+  ///             engine rendered contents, into that view. This reduces the
+  ///             number of backing stores the embedder has to present.
+  ///
+  void CoalesceViews();
+
+  std::optional<SkIRect> GetFrameDamage(const SurfaceFrame& frame) const;
+
   FML_DISALLOW_COPY_AND_ASSIGN(EmbedderExternalViewEmbedder);
 };
 
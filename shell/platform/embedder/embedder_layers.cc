@@ -17,13 +17,30 @@ EmbedderLayers::EmbedderLayers(SkISize frame_size,
 
 EmbedderLayers::~EmbedderLayers() = default;
 
-void EmbedderLayers::PushBackingStoreLayer(const FlutterBackingStore* store) {
+void EmbedderLayers::PushBackingStoreLayer(const FlutterBackingStore* store,
+                                           const SkIRect& paint_region) {
   FlutterLayer layer = {};
 
   layer.struct_size = sizeof(FlutterLayer);
   layer.type = kFlutterLayerContentTypeBackingStore;
   layer.backing_store = store;
 
+  FlutterDamage damage = {};
+  damage.struct_size = sizeof(FlutterDamage);
+  if (!paint_region.isEmpty()) {
+    FlutterRect rect = {};
+    rect.left = paint_region.left();
+    rect.top = paint_region.top();
+    rect.right = paint_region.right();
+    rect.bottom = paint_region.bottom();
+    paint_region_rects_referenced_.push_back(
+        std::make_unique<FlutterRect>(rect));
+    damage.num_rects = 1;
+    damage.damage = paint_region_rects_referenced_.back().get();
+  }
+  paint_regions_referenced_.push_back(std::make_unique<FlutterDamage>(damage));
+  layer.paint_region = paint_regions_referenced_.back().get();
+
   const auto layer_bounds =
       SkRect::MakeWH(frame_size_.width(), frame_size_.height());
 
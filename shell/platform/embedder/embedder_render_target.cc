@@ -8,12 +8,15 @@
 
 namespace flutter {
 
-EmbedderRenderTarget::EmbedderRenderTarget(FlutterBackingStore backing_store,
-                                           sk_sp<SkSurface> render_surface,
-                                           fml::closure on_release)
+EmbedderRenderTarget::EmbedderRenderTarget(
+    FlutterBackingStore backing_store,
+    sk_sp<SkSurface> render_surface,
+    fml::closure on_release,
+    std::optional<SkIRect> existing_damage)
     : backing_store_(backing_store),
       render_surface_(std::move(render_surface)),
-      on_release_(on_release) {
+      on_release_(on_release),
+      existing_damage_(existing_damage) {
   // TODO(38468): The optimization to elide backing store updates between frames
   // has not been implemented yet.
   backing_store_.did_update = true;
@@ -34,4 +37,13 @@ sk_sp<SkSurface> EmbedderRenderTarget::GetRenderSurface() const {
   return render_surface_;
 }
 
+const std::optional<SkIRect>& EmbedderRenderTarget::GetExistingDamage() const {
+  return existing_damage_;
+}
+
+void EmbedderRenderTarget::SetExistingDamage(
+    std::optional<SkIRect> existing_damage) {
+  existing_damage_ = existing_damage;
+}
+
 }  // namespace flutter
@@ -5,6 +5,8 @@
 #ifndef FLUTTER_SHELL_PLATFORM_EMBEDDER_EMBEDDER_RENDER_TARGET_H_
 #define FLUTTER_SHELL_PLATFORM_EMBEDDER_EMBEDDER_RENDER_TARGET_H_
 
+#include <optional>
+
 #include "flutter/fml/closure.h"
 #include "flutter/fml/macros.h"
 #include "flutter/shell/platform/embedder/embedder.h"
@@ -33,10 +35,15 @@ class EmbedderRenderTarget {
   /// @param[in]  on_release      The callback to invoke (eventually forwarded
   ///                             to the embedder) when the backing store is no
   ///                             longer required by the engine.
+  /// @param[in]  existing_damage The area of the render surface whose contents
+  ///                             are not those of the last layer it was
+  ///                             presented with, or nullopt if none of its
+  ///                             contents may be kept.
   ///
   EmbedderRenderTarget(FlutterBackingStore backing_store,
                        sk_sp<SkSurface> render_surface,
-                       fml::closure on_release);
+                       fml::closure on_release,
+                       std::optional<SkIRect> existing_damage = std::nullopt);
 
   //----------------------------------------------------------------------------
   /// @brief      Destroys this instance of the render target and invokes the
@@ -65,10 +72,30 @@ class EmbedderRenderTarget {
   ///
   const FlutterBackingStore* GetBackingStore() const;
 
+  //----------------------------------------------------------------------------
+  /// @brief      The area of the render surface whose contents are not those
+  ///             of the last layer it was presented with. Only this area and
+  ///             the part of the frame that changed since need to be
+  ///             repainted.
+  ///
+  /// @return     The existing damage, or nullopt if the whole render surface
+  ///             must be repainted.
+  ///
+  const std::optional<SkIRect>& GetExistingDamage() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Updates the existing damage, such as after the render surface
+  ///             has been rendered into.
+  ///
+  /// @param[in]  existing_damage  The new existing damage.
+  ///
+  void SetExistingDamage(std::optional<SkIRect> existing_damage);
+
  private:
   FlutterBackingStore backing_store_;
   sk_sp<SkSurface> render_surface_;
   fml::closure on_release_;
+  std::optional<SkIRect> existing_damage_;
 
   FML_DISALLOW_COPY_AND_ASSIGN(EmbedderRenderTarget);
 };
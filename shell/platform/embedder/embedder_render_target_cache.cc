@@ -4,9 +4,12 @@
 
 #include "flutter/shell/platform/embedder/embedder_render_target_cache.h"
 
+#include "flutter/fml/trace_event.h"
+
 namespace flutter {
 
-EmbedderRenderTargetCache::EmbedderRenderTargetCache() = default;
+EmbedderRenderTargetCache::EmbedderRenderTargetCache(size_t max_pooled_bytes)
+    : max_pooled_bytes_(max_pooled_bytes) {}
 
 EmbedderRenderTargetCache::~EmbedderRenderTargetCache() = default;
 
@@ -31,25 +34,84 @@ EmbedderRenderTargetCache::GetExistingTargetsInCache(
           std::move(compatible_targets.top());
       compatible_targets.pop();
       resolved_render_targets[view.first] = std::move(target);
+      stats_.reused_count++;
     }
   }
+
+  // The render targets of the last frame that were not reused are left for
+  // the unmatched views of this and later frames to recycle.
+  PoolCachedRenderTargets();
+  frame_count_++;
   return {std::move(resolved_render_targets), std::move(unmatched_identifiers)};
 }
 
+std::unique_ptr<EmbedderRenderTarget>
+EmbedderRenderTargetCache::RecycleRenderTarget(const SkISize& size) {
+  auto found = pooled_render_targets_.find(size);
+  if (found == pooled_render_targets_.end()) {
+    return nullptr;
+  }
+  auto& bucket = found->second;
+  auto target = std::move(bucket.back().target);
+  pooled_bytes_ -= bucket.back().bytes;
+  bucket.pop_back();
+  if (bucket.empty()) {
+    pooled_render_targets_.erase(found);
+  }
+  target->SetExistingDamage(std::nullopt);
+  stats_.recycled_count++;
+  return target;
+}
+
 std::set<std::unique_ptr<EmbedderRenderTarget>>
-EmbedderRenderTargetCache::ClearAllRenderTargetsInCache() {
+EmbedderRenderTargetCache::EvictUnusedRenderTargets() {
+  std::set<std::unique_ptr<EmbedderRenderTarget>> evicted_targets;
+  while (!pooled_render_targets_.empty()) {
+    // The buckets are in order of use, so the least recently used render
+    // target is at the front of one of them.
+    auto oldest = pooled_render_targets_.begin();
+    for (auto it = pooled_render_targets_.begin();
+         it != pooled_render_targets_.end(); ++it) {
+      if (it->second.front().frame < oldest->second.front().frame) {
+        oldest = it;
+      }
+    }
+    auto& bucket = oldest->second;
+    if (pooled_bytes_ <= max_pooled_bytes_ &&
+        frame_count_ - bucket.front().frame <= kMaxUnusedFrames) {
+      break;
+    }
+    evicted_targets.emplace(std::move(bucket.front().target));
+    pooled_bytes_ -= bucket.front().bytes;
+    bucket.pop_front();
+    if (bucket.empty()) {
+      pooled_render_targets_.erase(oldest);
+    }
+    stats_.evicted_count++;
+  }
+  TraceStatsToTimeline();
+  return evicted_targets;
+}
+
+std::set<std::unique_ptr<EmbedderRenderTarget>>
+EmbedderRenderTargetCache::ClearPooledRenderTargets() {
   std::set<std::unique_ptr<EmbedderRenderTarget>> cleared_targets;
-  for (auto& targets : cached_render_targets_) {
-    auto& targets_stack = targets.second;
-    while (!targets_stack.empty()) {
-      cleared_targets.emplace(std::move(targets_stack.top()));
-      targets_stack.pop();
+  for (auto& targets : pooled_render_targets_) {
+    for (auto& pooled_target : targets.second) {
+      cleared_targets.emplace(std::move(pooled_target.target));
     }
   }
-  cached_render_targets_.clear();
+  pooled_render_targets_.clear();
+  pooled_bytes_ = 0;
   return cleared_targets;
 }
 
+std::set<std::unique_ptr<EmbedderRenderTarget>>
+EmbedderRenderTargetCache::ClearAllRenderTargetsInCache() {
+  PoolCachedRenderTargets();
+  return ClearPooledRenderTargets();
+}
+
 void EmbedderRenderTargetCache::CacheRenderTarget(
     EmbedderExternalView::ViewIdentifier view_identifier,
     std::unique_ptr<EmbedderRenderTarget> target) {
@@ -67,7 +129,40 @@ size_t EmbedderRenderTargetCache::GetCachedTargetsCount() const {
   for (const auto& targets : cached_render_targets_) {
     count += targets.second.size();
   }
+  return count + GetPooledTargetsCount();
+}
+
+size_t EmbedderRenderTargetCache::GetPooledTargetsCount() const {
+  size_t count = 0;
+  for (const auto& targets : pooled_render_targets_) {
+    count += targets.second.size();
+  }
   return count;
 }
 
+void EmbedderRenderTargetCache::PoolCachedRenderTargets() {
+  for (auto& targets : cached_render_targets_) {
+    auto& targets_stack = targets.second;
+    while (!targets_stack.empty()) {
+      auto surface = targets_stack.top()->GetRenderSurface();
+      const auto bytes = surface->imageInfo().computeMinByteSize();
+      pooled_render_targets_[targets.first.surface_size].push_back(
+          {std::move(targets_stack.top()), bytes, frame_count_});
+      pooled_bytes_ += bytes;
+      targets_stack.pop();
+    }
+  }
+  cached_render_targets_.clear();
+}
+
+void EmbedderRenderTargetCache::TraceStatsToTimeline() const {
+#if !FLUTTER_RELEASE
+  FML_TRACE_COUNTER("flutter", "EmbedderRenderTargetCache",
+                    reinterpret_cast<int64_t>(this), "PooledTargets",
+                    GetPooledTargetsCount(), "PooledBytes", pooled_bytes_,
+                    "RecycledTargets", stats_.recycled_count, "EvictedTargets",
+                    stats_.evicted_count);
+#endif  // !FLUTTER_RELEASE
+}
+
 }  // namespace flutter
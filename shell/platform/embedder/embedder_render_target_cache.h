@@ -5,11 +5,13 @@
 #ifndef FLUTTER_SHELL_PLATFORM_EMBEDDER_EMBEDDER_RENDER_TARGET_CACHE_H_
 #define FLUTTER_SHELL_PLATFORM_EMBEDDER_EMBEDDER_RENDER_TARGET_CACHE_H_
 
+#include <deque>
 #include <set>
 #include <stack>
 #include <tuple>
 #include <unordered_map>
 
+#include "flutter/fml/hash_combine.h"
 #include "flutter/fml/macros.h"
 #include "flutter/shell/platform/embedder/embedder_external_view.h"
 
@@ -19,9 +21,37 @@ namespace flutter {
 /// @brief      A cache used to reference render targets that are owned by the
 ///             embedder but needed by th engine to render a frame.
 ///
+///             Render targets used by a view in one frame are given back to
+///             the same view in the next frame if its size did not change.
+///             Render targets that are not used by the same view are kept in a
+///             pool, bucketed by size, from which views of any identity may
+///             recycle them in later frames instead of asking the embedder to
+///             create new ones. The least recently used render targets are
+///             collected once the pool grows beyond its byte budget, and
+///             render targets that stay unused for |kMaxUnusedFrames| frames
+///             are collected regardless. As unused render targets only age
+///             when frames are rendered, the pool is also cleared when the
+///             platform is low on memory or when frames stop.
+///
 class EmbedderRenderTargetCache {
  public:
-  EmbedderRenderTargetCache();
+  // A budget of about four full screen render targets on a large phone.
+  static constexpr size_t kDefaultMaxPooledBytes = 48 * 1024 * 1024;
+  static constexpr size_t kMaxUnusedFrames = 30;
+
+  struct Stats {
+    // Render targets given back to the same view in the next frame.
+    size_t reused_count = 0;
+    // Render targets recycled from the pool. Each of these avoids both a
+    // call to the create and to the collect backing store callbacks.
+    size_t recycled_count = 0;
+    // Render targets collected because the pool was over its budget or
+    // because they were not used for too long.
+    size_t evicted_count = 0;
+  };
+
+  explicit EmbedderRenderTargetCache(
+      size_t max_pooled_bytes = kDefaultMaxPooledBytes);
 
   ~EmbedderRenderTargetCache();
 
@@ -31,10 +61,49 @@ class EmbedderRenderTargetCache {
                          EmbedderExternalView::ViewIdentifier::Hash,
                          EmbedderExternalView::ViewIdentifier::Equal>;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Resolves the render targets of the pending views that have
+  ///             engine rendered contents from the cache. The render targets
+  ///             of the last frame that are not reused by the same view are
+  ///             moved to the pool.
+  ///
+  /// @return     The resolved render targets and the identifiers of the views
+  ///             for which no render target of the right size was found.
+  ///
   std::pair<RenderTargets, EmbedderExternalView::ViewIdentifierSet>
   GetExistingTargetsInCache(
       const EmbedderExternalView::PendingViews& pending_views);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Takes the most recently pooled render target of the given
+  ///             size. Its contents are those of another view or of an older
+  ///             frame, so it has no existing damage.
+  ///
+  /// @return     The render target, or null if there is none of that size.
+  ///
+  std::unique_ptr<EmbedderRenderTarget> RecycleRenderTarget(
+      const SkISize& size);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Removes the render targets that were not used for too long
+  ///             from the pool, then the least recently used ones until the
+  ///             pool is within its byte budget.
+  ///
+  /// @return     The removed render targets, which are collected once the
+  ///             caller releases them.
+  ///
+  std::set<std::unique_ptr<EmbedderRenderTarget>> EvictUnusedRenderTargets();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Removes all the render targets from the pool. The render
+  ///             targets used in the last frame, which may still be on
+  ///             screen, are kept.
+  ///
+  /// @return     The removed render targets, which are collected once the
+  ///             caller releases them.
+  ///
+  std::set<std::unique_ptr<EmbedderRenderTarget>> ClearPooledRenderTargets();
+
   std::set<std::unique_ptr<EmbedderRenderTarget>>
   ClearAllRenderTargetsInCache();
 
@@ -43,6 +112,12 @@ class EmbedderRenderTargetCache {
 
   size_t GetCachedTargetsCount() const;
 
+  size_t GetPooledTargetsCount() const;
+
+  size_t GetPooledBytes() const { return pooled_bytes_; }
+
+  const Stats& GetStats() const { return stats_; }
+
  private:
   using CachedRenderTargets =
       std::unordered_map<EmbedderExternalView::RenderTargetDescriptor,
@@ -50,7 +125,33 @@ class EmbedderRenderTargetCache {
                          EmbedderExternalView::RenderTargetDescriptor::Hash,
                          EmbedderExternalView::RenderTargetDescriptor::Equal>;
 
+  struct PooledRenderTarget {
+    std::unique_ptr<EmbedderRenderTarget> target;
+    size_t bytes;
+    // The frame in which the render target was last used.
+    size_t frame;
+  };
+
+  struct SizeHash {
+    std::size_t operator()(const SkISize& size) const {
+      return fml::HashCombine(size.width(), size.height());
+    }
+  };
+
+  // The pooled render targets of each size, from least to most recently used.
+  using PooledRenderTargets =
+      std::unordered_map<SkISize, std::deque<PooledRenderTarget>, SizeHash>;
+
+  const size_t max_pooled_bytes_;
   CachedRenderTargets cached_render_targets_;
+  PooledRenderTargets pooled_render_targets_;
+  size_t pooled_bytes_ = 0;
+  size_t frame_count_ = 0;
+  Stats stats_;
+
+  void PoolCachedRenderTargets();
+
+  void TraceStatsToTimeline() const;
 
   FML_DISALLOW_COPY_AND_ASSIGN(EmbedderRenderTargetCache);
 };
@@ -75,6 +75,12 @@ EmbedderSurfaceGL::GLProcResolver EmbedderSurfaceGL::GetGLProcResolver() const {
   return gl_dispatch_table_.gl_proc_resolver;
 }
 
+// |GPUSurfaceGLDelegate|
+PersistentCache::PrecompileProgressCallback
+EmbedderSurfaceGL::GetPrecompileProgressCallback() const {
+  return gl_dispatch_table_.precompile_progress_callback;
+}
+
 // |EmbedderSurface|
 std::unique_ptr<Surface> EmbedderSurfaceGL::CreateGPUSurface() {
   const bool render_to_surface = !external_view_embedder_;
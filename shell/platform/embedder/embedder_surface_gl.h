@@ -24,6 +24,8 @@ class EmbedderSurfaceGL final : public EmbedderSurface,
     std::function<SkMatrix(void)>
         gl_surface_transformation_callback;              // optional
     std::function<void*(const char*)> gl_proc_resolver;  // optional
+    PersistentCache::PrecompileProgressCallback
+        precompile_progress_callback;  // optional
   };
 
   EmbedderSurfaceGL(
@@ -70,6 +72,10 @@ class EmbedderSurfaceGL final : public EmbedderSurface,
   // |GPUSurfaceGLDelegate|
   GLProcResolver GetGLProcResolver() const override;
 
+  // |GPUSurfaceGLDelegate|
+  PersistentCache::PrecompileProgressCallback GetPrecompileProgressCallback()
+      const override;
+
   FML_DISALLOW_COPY_AND_ASSIGN(EmbedderSurfaceGL);
 };
 
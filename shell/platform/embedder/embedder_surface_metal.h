@@ -20,6 +20,8 @@ class EmbedderSurfaceMetal final : public EmbedderSurface,
     std::function<bool(GPUMTLTextureInfo texture)> present;  // required
     std::function<GPUMTLTextureInfo(const SkISize& frame_size)>
         get_texture;  // required
+    PersistentCache::PrecompileProgressCallback
+        precompile_progress_callback;  // optional
   };
 
   EmbedderSurfaceMetal(
@@ -60,6 +62,10 @@ class EmbedderSurfaceMetal final : public EmbedderSurface,
   // |GPUSurfaceMetalDelegate|
   bool PresentTexture(GPUMTLTextureInfo texture) const override;
 
+  // |GPUSurfaceMetalDelegate|
+  PersistentCache::PrecompileProgressCallback GetPrecompileProgressCallback()
+      const override;
+
   FML_DISALLOW_COPY_AND_ASSIGN(EmbedderSurfaceMetal);
 };
 
@@ -75,4 +75,9 @@ bool EmbedderSurfaceMetal::PresentTexture(GPUMTLTextureInfo texture) const {
   return metal_dispatch_table_.present(texture);
 }
 
+PersistentCache::PrecompileProgressCallback EmbedderSurfaceMetal::GetPrecompileProgressCallback()
+    const {
+  return metal_dispatch_table_.precompile_progress_callback;
+}
+
 }  // namespace flutter
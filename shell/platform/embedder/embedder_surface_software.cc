@@ -11,8 +11,10 @@ namespace flutter {
 
 EmbedderSurfaceSoftware::EmbedderSurfaceSoftware(
     SoftwareDispatchTable software_dispatch_table,
+    size_t raster_thread_count,
     std::shared_ptr<EmbedderExternalViewEmbedder> external_view_embedder)
     : software_dispatch_table_(software_dispatch_table),
+      raster_thread_count_(raster_thread_count),
       external_view_embedder_(external_view_embedder) {
   if (!software_dispatch_table_.software_present_backing_store) {
     return;
@@ -33,12 +35,19 @@ std::unique_ptr<Surface> EmbedderSurfaceSoftware::CreateGPUSurface() {
     return nullptr;
   }
   const bool render_to_surface = !external_view_embedder_;
-  auto surface = std::make_unique<GPUSurfaceSoftware>(this, render_to_surface);
+  auto surface = std::make_unique<GPUSurfaceSoftware>(this, render_to_surface,
+                                                      raster_thread_count_);
 
   if (!surface->IsValid()) {
     return nullptr;
   }
 
+  // There are no shaders to precompile. Report that precompilation is
+  // complete, as the GPU backends do when their caches are empty.
+  if (software_dispatch_table_.precompile_progress_callback) {
+    software_dispatch_table_.precompile_progress_callback(0, 0);
+  }
+
   return surface;
 }
 
@@ -77,7 +86,8 @@ sk_sp<SkSurface> EmbedderSurfaceSoftware::AcquireBackingStore(
 
 // |GPUSurfaceSoftwareDelegate|
 bool EmbedderSurfaceSoftware::PresentBackingStore(
-    sk_sp<SkSurface> backing_store) {
+    sk_sp<SkSurface> backing_store,
+    const std::optional<std::vector<SkIRect>>& damage) {
   if (!IsValid()) {
     FML_LOG(ERROR) << "Tried to present an invalid software surface.";
     return false;
@@ -100,9 +110,10 @@ bool EmbedderSurfaceSoftware::PresentBackingStore(
   }
 
   return software_dispatch_table_.software_present_backing_store(
-      pixmap.addr(),      //
-      pixmap.rowBytes(),  //
-      pixmap.height()     //
+      pixmap.addr(),                                          //
+      pixmap.rowBytes(),                                      //
+      pixmap.height(),                                        //
+      damage.value_or(std::vector<SkIRect>{pixmap.bounds()})  //
   );
 }
 
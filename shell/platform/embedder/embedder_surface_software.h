@@ -5,6 +5,7 @@
 #ifndef FLUTTER_SHELL_PLATFORM_EMBEDDER_EMBEDDER_SURFACE_SOFTWARE_H_
 #define FLUTTER_SHELL_PLATFORM_EMBEDDER_EMBEDDER_SURFACE_SOFTWARE_H_
 
+#include "flutter/common/graphics/persistent_cache.h"
 #include "flutter/fml/macros.h"
 #include "flutter/shell/gpu/gpu_surface_software.h"
 #include "flutter/shell/platform/embedder/embedder_external_view_embedder.h"
@@ -16,12 +17,18 @@ class EmbedderSurfaceSoftware final : public EmbedderSurface,
                                       public GPUSurfaceSoftwareDelegate {
  public:
   struct SoftwareDispatchTable {
-    std::function<bool(const void* allocation, size_t row_bytes, size_t height)>
+    std::function<bool(const void* allocation,
+                       size_t row_bytes,
+                       size_t height,
+                       const std::vector<SkIRect>& damage)>
         software_present_backing_store;  // required
+    PersistentCache::PrecompileProgressCallback
+        precompile_progress_callback;  // optional
   };
 
   EmbedderSurfaceSoftware(
       SoftwareDispatchTable software_dispatch_table,
+      size_t raster_thread_count,
       std::shared_ptr<EmbedderExternalViewEmbedder> external_view_embedder);
 
   ~EmbedderSurfaceSoftware() override;
@@ -29,6 +36,7 @@ class EmbedderSurfaceSoftware final : public EmbedderSurface,
  private:
   bool valid_ = false;
   SoftwareDispatchTable software_dispatch_table_;
+  const size_t raster_thread_count_;
   sk_sp<SkSurface> sk_surface_;
   std::shared_ptr<EmbedderExternalViewEmbedder> external_view_embedder_;
 
@@ -45,7 +53,9 @@ class EmbedderSurfaceSoftware final : public EmbedderSurface,
   sk_sp<SkSurface> AcquireBackingStore(const SkISize& size) override;
 
   // |GPUSurfaceSoftwareDelegate|
-  bool PresentBackingStore(sk_sp<SkSurface> backing_store) override;
+  bool PresentBackingStore(
+      sk_sp<SkSurface> backing_store,
+      const std::optional<std::vector<SkIRect>>& damage) override;
 
   FML_DISALLOW_COPY_AND_ASSIGN(EmbedderSurfaceSoftware);
 };
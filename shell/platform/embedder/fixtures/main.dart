@@ -288,6 +288,14 @@ void platform_messages_no_response() {
   signalNativeTest();
 }
 
+@pragma('vm:entry-point')
+void platform_messages_no_copy_response() {
+  PlatformDispatcher.instance.sendPlatformMessage('test/no_copy', null, (ByteData? reply) {
+    var list = reply!.buffer.asUint8List(reply.offsetInBytes, reply.lengthInBytes);
+    signalNativeMessage(utf8.decode(list));
+  });
+}
+
 @pragma('vm:entry-point')
 void null_platform_messages() {
   PlatformDispatcher.instance.onPlatformMessage =
@@ -885,6 +893,39 @@ void compositor_can_post_only_platform_views() {
   PlatformDispatcher.instance.scheduleFrame();
 }
 
+@pragma('vm:entry-point')
+void overlays_not_overlapping_platform_views() {
+  PlatformDispatcher.instance.onBeginFrame = (Duration duration) {
+    Color red = Color.fromARGB(255, 255, 0, 0);
+    Color blue = Color.fromARGB(255, 0, 0, 255);
+    Size size = Size(100.0, 100.0);
+
+    SceneBuilder builder = SceneBuilder();
+    builder.addPicture(Offset(0.0, 0.0), CreateColoredBox(Color.fromARGB(255, 128, 128, 128), Size(800.0, 600.0)));
+
+    // Next to the platform view, so drawn into the root layer.
+    builder.pushOffset(0.0, 0.0);
+    builder.addPlatformView(1, width: size.width, height: size.height);
+    builder.pop();
+    builder.addPicture(Offset(200.0, 0.0), CreateColoredBox(red, size));
+
+    // On top of the platform view, so drawn into a layer of its own.
+    builder.pushOffset(0.0, 200.0);
+    builder.addPlatformView(2, width: size.width, height: size.height);
+    builder.pop();
+    builder.addPicture(Offset(50.0, 250.0), CreateColoredBox(blue, size));
+
+    // Next to the platform view, so drawn into the layer above.
+    builder.pushOffset(400.0, 400.0);
+    builder.addPlatformView(3, width: size.width, height: size.height);
+    builder.pop();
+    builder.addPicture(Offset(200.0, 200.0), CreateColoredBox(red, size));
+
+    PlatformDispatcher.instance.views.first.render(builder.build());
+  };
+  PlatformDispatcher.instance.scheduleFrame();
+}
+
 @pragma('vm:entry-point')
 void render_targets_are_recycled() {
   int frame_count = 0;
@@ -968,3 +1009,27 @@ void invalid_backingstore() {
   };
   PlatformDispatcher.instance.scheduleFrame();
 }
+
+@pragma('vm:entry-point')
+void blink_cursor() {
+  int frame = 0;
+  PlatformDispatcher.instance.onBeginFrame = (Duration duration) {
+    Color gray = Color.fromARGB(255, 127, 127, 127);
+    Color black = Color.fromARGB(255, 0, 0, 0);
+    SceneBuilder builder = SceneBuilder();
+    builder.pushOffset(0.0, 0.0);
+    builder.addPicture(Offset(0.0, 0.0), CreateColoredBox(gray, Size(800.0, 600.0)));
+    if (frame % 2 == 0) {
+      builder.addPicture(Offset(100.0, 100.0), CreateColoredBox(black, Size(2.0, 20.0)));
+    }
+    builder.pop();
+    PlatformDispatcher.instance.views.first.render(builder.build());
+  };
+  PlatformDispatcher.instance.onDrawFrame = () {
+    frame++;
+    if (frame < 4) {
+      PlatformDispatcher.instance.scheduleFrame();
+    }
+  };
+  PlatformDispatcher.instance.scheduleFrame();
+}
@@ -10,12 +10,14 @@ PlatformViewEmbedder::PlatformViewEmbedder(
     PlatformView::Delegate& delegate,
     flutter::TaskRunners task_runners,
     EmbedderSurfaceSoftware::SoftwareDispatchTable software_dispatch_table,
+    size_t raster_thread_count,
     PlatformDispatchTable platform_dispatch_table,
     std::shared_ptr<EmbedderExternalViewEmbedder> external_view_embedder)
     : PlatformView(delegate, std::move(task_runners)),
       external_view_embedder_(external_view_embedder),
       embedder_surface_(
           std::make_unique<EmbedderSurfaceSoftware>(software_dispatch_table,
+                                                    raster_thread_count,
                                                     external_view_embedder_)),
       platform_dispatch_table_(platform_dispatch_table) {}
 
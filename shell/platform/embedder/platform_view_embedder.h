@@ -55,6 +55,7 @@ class PlatformViewEmbedder final : public PlatformView {
       PlatformView::Delegate& delegate,
       flutter::TaskRunners task_runners,
       EmbedderSurfaceSoftware::SoftwareDispatchTable software_dispatch_table,
+      size_t raster_thread_count,
       PlatformDispatchTable platform_dispatch_table,
       std::shared_ptr<EmbedderExternalViewEmbedder> external_view_embedder);
 
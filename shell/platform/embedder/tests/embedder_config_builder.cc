@@ -100,6 +100,7 @@ EmbedderConfigBuilder::EmbedderConfigBuilder(
     SetIsolateCreateCallbackHook();
     SetSemanticsCallbackHooks();
     SetLogMessageCallbackHook();
+    SetShaderPrecompilationCallbackHook();
     SetLocalizationCallbackHooks();
     AddCommandLineArgument("--disable-observatory");
 
@@ -126,6 +127,28 @@ void EmbedderConfigBuilder::SetSoftwareRendererConfig(SkISize surface_size) {
   context_.SetupSurface(surface_size);
 }
 
+void EmbedderConfigBuilder::SetSoftwarePresentWithDamageCallback() {
+  // SetSoftwareRendererConfig must be called before this.
+  FML_CHECK(renderer_config_.type == FlutterRendererType::kSoftware);
+  renderer_config_.software.surface_present_callback = nullptr;
+  renderer_config_.software.surface_present_with_damage_callback =
+      [](void* context, const void* allocation, size_t row_bytes, size_t height,
+         const FlutterDamage* damage) {
+        auto image_info =
+            SkImageInfo::MakeN32Premul(SkISize::Make(row_bytes / 4, height));
+        SkBitmap bitmap;
+        if (!bitmap.installPixels(image_info, const_cast<void*>(allocation),
+                                  row_bytes)) {
+          FML_LOG(ERROR) << "Could not copy pixels for the software "
+                            "composition from the engine.";
+          return false;
+        }
+        bitmap.setImmutable();
+        return reinterpret_cast<EmbedderTestContextSoftware*>(context)
+            ->PresentWithDamage(SkImage::MakeFromBitmap(bitmap), damage);
+      };
+}
+
 void EmbedderConfigBuilder::SetOpenGLFBOCallBack() {
 #ifdef SHELL_ENABLE_GL
   // SetOpenGLRendererConfig must be called before this.
@@ -217,6 +240,11 @@ void EmbedderConfigBuilder::SetLogMessageCallbackHook() {
       EmbedderTestContext::GetLogMessageCallbackHook();
 }
 
+void EmbedderConfigBuilder::SetShaderPrecompilationCallbackHook() {
+  project_args_.shader_precompilation_callback =
+      EmbedderTestContext::GetShaderPrecompilationCallbackHook();
+}
+
 void EmbedderConfigBuilder::SetLogTag(std::string tag) {
   log_tag_ = std::move(tag);
   project_args_.log_tag = log_tag_.c_str();
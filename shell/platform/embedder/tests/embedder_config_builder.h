@@ -62,6 +62,13 @@ class EmbedderConfigBuilder {
   // test this behavior.
   void SetOpenGLPresentCallBack();
 
+  // Used to present the buffers of the software renderer through
+  // `software.surface_present_with_damage_callback` instead of
+  // `software.surface_present_callback`. The damage of each buffer is reported
+  // to the callback set on the context with `SetPresentDamageCallback`.
+  // SetSoftwareRendererConfig must be called before this.
+  void SetSoftwarePresentWithDamageCallback();
+
   void SetAssetsPath();
 
   void SetSnapshots();
@@ -78,6 +85,9 @@ class EmbedderConfigBuilder {
   // Used to set a custom log tag.
   void SetLogTag(std::string tag);
 
+  // Used to observe the progress of shader precompilation.
+  void SetShaderPrecompilationCallbackHook();
+
   void SetLocalizationCallbackHooks();
 
   void SetDartEntrypoint(std::string entrypoint);
@@ -0,0 +1,182 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/platform/embedder/embedder_render_target_cache.h"
+
+#include "flutter/testing/testing.h"
+#include "third_party/skia/include/core/SkSurface.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+// A frame in which each of the views has engine rendered contents.
+class PendingFrame {
+ public:
+  PendingFrame& AddView(EmbedderExternalView::ViewIdentifier view_identifier,
+                        const SkISize& size) {
+    auto view = std::make_unique<EmbedderExternalView>(
+        size, SkMatrix::I(), view_identifier, nullptr);
+    view->GetCanvas()->drawColor(SK_ColorRED);
+    views_[view_identifier] = std::move(view);
+    return *this;
+  }
+
+  const EmbedderExternalView::PendingViews& views() const { return views_; }
+
+ private:
+  EmbedderExternalView::PendingViews views_;
+};
+
+std::unique_ptr<EmbedderRenderTarget> CreateRenderTarget(
+    const SkISize& size,
+    size_t* collected_count) {
+  return std::make_unique<EmbedderRenderTarget>(
+      FlutterBackingStore{},
+      SkSurface::MakeRasterN32Premul(size.width(), size.height()),
+      [collected_count]() { (*collected_count)++; }, SkIRect::MakeEmpty());
+}
+
+// The bytes of a render target of the given size.
+size_t RenderTargetBytes(const SkISize& size) {
+  return size.width() * size.height() * 4;
+}
+
+}  // namespace
+
+TEST(EmbedderRenderTargetCacheTest, ReusesRenderTargetsOfTheSameView) {
+  EmbedderRenderTargetCache cache;
+  size_t collected_count = 0;
+  const auto size = SkISize::Make(100, 100);
+  cache.CacheRenderTarget(1, CreateRenderTarget(size, &collected_count));
+
+  PendingFrame frame;
+  frame.AddView(1, size);
+  auto [targets, unmatched] = cache.GetExistingTargetsInCache(frame.views());
+  ASSERT_EQ(targets.size(), 1u);
+  EXPECT_TRUE(unmatched.empty());
+  // The render target keeps what it knows about its contents.
+  ASSERT_TRUE(targets[1]->GetExistingDamage().has_value());
+  EXPECT_EQ(*targets[1]->GetExistingDamage(), SkIRect::MakeEmpty());
+  EXPECT_EQ(cache.GetStats().reused_count, 1u);
+  EXPECT_EQ(cache.GetPooledTargetsCount(), 0u);
+}
+
+TEST(EmbedderRenderTargetCacheTest, RecyclesRenderTargetsAcrossViews) {
+  EmbedderRenderTargetCache cache;
+  size_t collected_count = 0;
+  const auto size = SkISize::Make(100, 100);
+  cache.CacheRenderTarget(1, CreateRenderTarget(size, &collected_count));
+  cache.CacheRenderTarget(2, CreateRenderTarget(size, &collected_count));
+
+  // The platform view 1 went away and the platform view 3 appeared.
+  PendingFrame frame;
+  frame.AddView(2, size).AddView(3, size);
+  auto [targets, unmatched] = cache.GetExistingTargetsInCache(frame.views());
+  ASSERT_EQ(targets.size(), 1u);
+  ASSERT_EQ(unmatched.size(), 1u);
+  EXPECT_EQ(unmatched.count(3), 1u);
+  EXPECT_EQ(cache.GetPooledTargetsCount(), 1u);
+  EXPECT_EQ(cache.GetPooledBytes(), RenderTargetBytes(size));
+
+  auto recycled = cache.RecycleRenderTarget(size);
+  ASSERT_NE(recycled, nullptr);
+  // Its contents are those of the platform view 1.
+  EXPECT_FALSE(recycled->GetExistingDamage().has_value());
+  EXPECT_EQ(cache.RecycleRenderTarget(size), nullptr);
+  EXPECT_EQ(cache.GetStats().recycled_count, 1u);
+  EXPECT_EQ(cache.GetPooledBytes(), 0u);
+  EXPECT_EQ(collected_count, 0u);
+}
+
+TEST(EmbedderRenderTargetCacheTest, RecyclesRenderTargetsOfTheSameSizeOnly) {
+  EmbedderRenderTargetCache cache;
+  size_t collected_count = 0;
+  cache.CacheRenderTarget(
+      1, CreateRenderTarget(SkISize::Make(100, 100), &collected_count));
+
+  PendingFrame frame;
+  frame.AddView(1, SkISize::Make(100, 50));
+  auto [targets, unmatched] = cache.GetExistingTargetsInCache(frame.views());
+  EXPECT_TRUE(targets.empty());
+  EXPECT_EQ(unmatched.size(), 1u);
+  EXPECT_EQ(cache.RecycleRenderTarget(SkISize::Make(100, 50)), nullptr);
+  EXPECT_NE(cache.RecycleRenderTarget(SkISize::Make(100, 100)), nullptr);
+}
+
+TEST(EmbedderRenderTargetCacheTest, EvictsLeastRecentlyUsedOverBudget) {
+  const auto size = SkISize::Make(100, 100);
+  EmbedderRenderTargetCache cache(2 * RenderTargetBytes(size));
+  size_t collected_count = 0;
+
+  // Pool a render target in each of three frames.
+  for (int i = 0; i < 3; i++) {
+    cache.CacheRenderTarget(i, CreateRenderTarget(size, &collected_count));
+    PendingFrame frame;
+    cache.GetExistingTargetsInCache(frame.views());
+    cache.EvictUnusedRenderTargets();
+  }
+  EXPECT_EQ(cache.GetPooledTargetsCount(), 2u);
+  EXPECT_EQ(cache.GetPooledBytes(), 2 * RenderTargetBytes(size));
+  EXPECT_EQ(cache.GetStats().evicted_count, 1u);
+  EXPECT_EQ(collected_count, 1u);
+}
+
+TEST(EmbedderRenderTargetCacheTest, EvictsRenderTargetsUnusedForTooLong) {
+  EmbedderRenderTargetCache cache;
+  size_t collected_count = 0;
+  cache.CacheRenderTarget(
+      1, CreateRenderTarget(SkISize::Make(100, 100), &collected_count));
+
+  PendingFrame frame;
+  for (size_t i = 0; i < EmbedderRenderTargetCache::kMaxUnusedFrames; i++) {
+    cache.GetExistingTargetsInCache(frame.views());
+    cache.EvictUnusedRenderTargets();
+  }
+  EXPECT_EQ(cache.GetPooledTargetsCount(), 1u);
+  EXPECT_EQ(collected_count, 0u);
+
+  cache.GetExistingTargetsInCache(frame.views());
+  cache.EvictUnusedRenderTargets();
+  EXPECT_EQ(cache.GetPooledTargetsCount(), 0u);
+  EXPECT_EQ(collected_count, 1u);
+}
+
+TEST(EmbedderRenderTargetCacheTest, ClearPooledKeepsRenderTargetsInUse) {
+  EmbedderRenderTargetCache cache;
+  size_t collected_count = 0;
+  const auto size = SkISize::Make(100, 100);
+  cache.CacheRenderTarget(1, CreateRenderTarget(size, &collected_count));
+  PendingFrame frame;
+  cache.GetExistingTargetsInCache(frame.views());
+  // The render target used in the last frame.
+  cache.CacheRenderTarget(2, CreateRenderTarget(size, &collected_count));
+  EXPECT_EQ(cache.GetPooledTargetsCount(), 1u);
+
+  cache.ClearPooledRenderTargets();
+  EXPECT_EQ(cache.GetPooledTargetsCount(), 0u);
+  EXPECT_EQ(cache.GetPooledBytes(), 0u);
+  EXPECT_EQ(cache.GetCachedTargetsCount(), 1u);
+  EXPECT_EQ(collected_count, 1u);
+}
+
+TEST(EmbedderRenderTargetCacheTest, ClearCollectsAllRenderTargets) {
+  EmbedderRenderTargetCache cache;
+  size_t collected_count = 0;
+  const auto size = SkISize::Make(100, 100);
+  cache.CacheRenderTarget(1, CreateRenderTarget(size, &collected_count));
+  PendingFrame frame;
+  cache.GetExistingTargetsInCache(frame.views());
+  cache.CacheRenderTarget(2, CreateRenderTarget(size, &collected_count));
+  EXPECT_EQ(cache.GetCachedTargetsCount(), 2u);
+
+  cache.ClearAllRenderTargetsInCache();
+  EXPECT_EQ(cache.GetCachedTargetsCount(), 0u);
+  EXPECT_EQ(cache.GetPooledBytes(), 0u);
+  EXPECT_EQ(collected_count, 2u);
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -146,6 +146,11 @@ void EmbedderTestContext::SetLogMessageCallback(
   log_message_callback_ = callback;
 }
 
+void EmbedderTestContext::SetShaderPrecompilationCallback(
+    const ShaderPrecompilationCallback& callback) {
+  shader_precompilation_callback_ = callback;
+}
+
 FlutterUpdateSemanticsNodeCallback
 EmbedderTestContext::GetUpdateSemanticsNodeCallbackHook() {
   return [](const FlutterSemanticsNode* semantics_node, void* user_data) {
@@ -175,6 +180,16 @@ FlutterLogMessageCallback EmbedderTestContext::GetLogMessageCallbackHook() {
   };
 }
 
+FlutterShaderPrecompilationCallback
+EmbedderTestContext::GetShaderPrecompilationCallbackHook() {
+  return [](size_t precompiled_count, size_t total_count, void* user_data) {
+    auto context = reinterpret_cast<EmbedderTestContext*>(user_data);
+    if (auto callback = context->shader_precompilation_callback_) {
+      callback(precompiled_count, total_count);
+    }
+  };
+}
+
 FlutterComputePlatformResolvedLocaleCallback
 EmbedderTestContext::GetComputePlatformResolvedLocaleCallbackHook() {
   return [](const FlutterLocale** supported_locales,
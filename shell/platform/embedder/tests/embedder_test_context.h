@@ -29,6 +29,8 @@ using SemanticsActionCallback =
     std::function<void(const FlutterSemanticsCustomAction*)>;
 using LogMessageCallback =
     std::function<void(const char* tag, const char* message)>;
+using ShaderPrecompilationCallback =
+    std::function<void(size_t precompiled_count, size_t total_count)>;
 
 struct AOTDataDeleter {
   void operator()(FlutterEngineAOTData aot_data) {
@@ -81,6 +83,9 @@ class EmbedderTestContext {
 
   void SetLogMessageCallback(const LogMessageCallback& log_message_callback);
 
+  void SetShaderPrecompilationCallback(
+      const ShaderPrecompilationCallback& shader_precompilation_callback);
+
   std::future<sk_sp<SkImage>> GetNextSceneImage();
 
   EmbedderTestCompositor& GetCompositor();
@@ -118,6 +123,7 @@ class EmbedderTestContext {
   SemanticsActionCallback update_semantics_custom_action_callback_;
   std::function<void(const FlutterPlatformMessage*)> platform_message_callback_;
   LogMessageCallback log_message_callback_;
+  ShaderPrecompilationCallback shader_precompilation_callback_;
   std::unique_ptr<EmbedderTestCompositor> compositor_;
   NextSceneCallback next_scene_callback_;
   SkMatrix root_surface_transformation_;
@@ -133,6 +139,9 @@ class EmbedderTestContext {
 
   static FlutterLogMessageCallback GetLogMessageCallbackHook();
 
+  static FlutterShaderPrecompilationCallback
+  GetShaderPrecompilationCallbackHook();
+
   static FlutterComputePlatformResolvedLocaleCallback
   GetComputePlatformResolvedLocaleCallbackHook();
 
@@ -30,6 +30,27 @@ bool EmbedderTestContextSoftware::Present(sk_sp<SkImage> image) {
   return true;
 }
 
+void EmbedderTestContextSoftware::SetPresentDamageCallback(
+    const PresentDamageCallback& callback) {
+  present_damage_callback_ = callback;
+}
+
+bool EmbedderTestContextSoftware::PresentWithDamage(
+    sk_sp<SkImage> image,
+    const FlutterDamage* damage) {
+  FML_CHECK(damage != nullptr);
+  SkIRect bounds = SkIRect::MakeEmpty();
+  for (size_t i = 0; i < damage->num_rects; i++) {
+    const FlutterRect& rect = damage->damage[i];
+    bounds.join(SkRect::MakeLTRB(rect.left, rect.top, rect.right, rect.bottom)
+                    .roundOut());
+  }
+  if (present_damage_callback_) {
+    present_damage_callback_(bounds);
+  }
+  return Present(std::move(image));
+}
+
 size_t EmbedderTestContextSoftware::GetSurfacePresentCount() const {
   return software_surface_present_count_;
 }
@@ -23,6 +23,14 @@ class EmbedderTestContextSoftware : public EmbedderTestContext {
 
   bool Present(sk_sp<SkImage> image);
 
+  using PresentDamageCallback = std::function<void(const SkIRect& damage)>;
+
+  // Sets the callback invoked with the bounds of the damage of each buffer
+  // presented with `PresentWithDamage`.
+  void SetPresentDamageCallback(const PresentDamageCallback& callback);
+
+  bool PresentWithDamage(sk_sp<SkImage> image, const FlutterDamage* damage);
+
  protected:
   virtual void SetupCompositor() override;
 
@@ -30,6 +38,7 @@ class EmbedderTestContextSoftware : public EmbedderTestContext {
   sk_sp<SkSurface> surface_;
   SkISize surface_size_;
   size_t software_surface_present_count_ = 0;
+  PresentDamageCallback present_damage_callback_;
   void SetupSurface(SkISize surface_size) override;
 
   FML_DISALLOW_COPY_AND_ASSIGN(EmbedderTestContextSoftware);
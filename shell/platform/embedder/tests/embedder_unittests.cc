@@ -4,6 +4,7 @@
 
 #define FML_USED_ON_EMBEDDER
 
+#include <atomic>
 #include <string>
 #include <vector>
 
@@ -28,6 +29,7 @@
 #include "flutter/shell/platform/embedder/tests/embedder_unittests_util.h"
 #include "flutter/testing/assertions_skia.h"
 #include "flutter/testing/testing.h"
+#include "third_party/skia/include/core/SkBitmap.h"
 #include "third_party/skia/include/core/SkSurface.h"
 #include "third_party/tonic/converter/dart_converter.h"
 
@@ -409,6 +411,134 @@ TEST_F(EmbedderTest, PlatformMessagesCanBeSentWithoutResponseHandles) {
   message.Wait();
 }
 
+//------------------------------------------------------------------------------
+/// Tests that the engine can take ownership of a platform message buffer and
+/// releases it once the Dart application is done with it.
+///
+TEST_F(EmbedderTest, PlatformMessagesCanBeSentWithoutCopying) {
+  auto& context = GetEmbedderContext(EmbedderTestContextType::kSoftwareContext);
+  EmbedderConfigBuilder builder(context);
+  builder.SetSoftwareRendererConfig();
+  builder.SetDartEntrypoint("platform_messages_no_response");
+
+  // Large enough to be handed to Dart as external data.
+  const std::string message_data(4096, 'a');
+  auto buffer = std::make_unique<uint8_t[]>(message_data.size());
+  memcpy(buffer.get(), message_data.data(), message_data.size());
+
+  fml::AutoResetWaitableEvent ready, message;
+  context.AddNativeCallback(
+      "SignalNativeTest",
+      CREATE_NATIVE_ENTRY(
+          [&ready](Dart_NativeArguments args) { ready.Signal(); }));
+  context.AddNativeCallback(
+      "SignalNativeMessage",
+      CREATE_NATIVE_ENTRY(
+          ([&message, &message_data](Dart_NativeArguments args) {
+            auto received_message = tonic::DartConverter<std::string>::FromDart(
+                Dart_GetNativeArgument(args, 0));
+            ASSERT_EQ(received_message, message_data);
+            message.Signal();
+          })));
+
+  auto engine = builder.LaunchEngine();
+
+  ASSERT_TRUE(engine.is_valid());
+  ready.Wait();
+
+  struct Captures {
+    const uint8_t* buffer = nullptr;
+    std::atomic_int release_count = 0;
+  } captures;
+  captures.buffer = buffer.get();
+
+  FlutterPlatformMessage platform_message = {};
+  platform_message.struct_size = sizeof(FlutterPlatformMessage);
+  platform_message.channel = "test_channel";
+  platform_message.message = buffer.get();
+  platform_message.message_size = message_data.size();
+  platform_message.message_release_callback =
+      [](const uint8_t* data, size_t size, void* user_data) {
+        auto captures = reinterpret_cast<Captures*>(user_data);
+        EXPECT_EQ(data, captures->buffer);
+        EXPECT_EQ(size, 4096u);
+        captures->release_count++;
+      };
+  platform_message.message_release_user_data = &captures;
+
+  auto result =
+      FlutterEngineSendPlatformMessage(engine.get(), &platform_message);
+  ASSERT_EQ(result, kSuccess);
+  message.Wait();
+
+  // The Dart application may hold on to the message until the isolate is shut
+  // down.
+  engine.reset();
+  ASSERT_EQ(captures.release_count, 1);
+}
+
+//------------------------------------------------------------------------------
+/// Tests that a response to a platform message from the Dart application can be
+/// sent without copying it, and that its buffer is released.
+///
+TEST_F(EmbedderTest, PlatformMessageResponsesCanBeSentWithoutCopying) {
+  auto& context = GetEmbedderContext(EmbedderTestContextType::kSoftwareContext);
+
+  const std::string response_data(4096, 'b');
+  auto buffer = std::make_unique<uint8_t[]>(response_data.size());
+  memcpy(buffer.get(), response_data.data(), response_data.size());
+  std::atomic_int release_count = 0;
+
+  fml::AutoResetWaitableEvent response;
+  context.AddNativeCallback(
+      "SignalNativeMessage",
+      CREATE_NATIVE_ENTRY(
+          ([&response, &response_data](Dart_NativeArguments args) {
+            auto received = tonic::DartConverter<std::string>::FromDart(
+                Dart_GetNativeArgument(args, 0));
+            ASSERT_EQ(received, response_data);
+            response.Signal();
+          })));
+
+  fml::Thread thread;
+  UniqueEngine engine;
+
+  thread.GetTaskRunner()->PostTask([&]() {
+    EmbedderConfigBuilder builder(context);
+    builder.SetSoftwareRendererConfig();
+    builder.SetDartEntrypoint("platform_messages_no_copy_response");
+    builder.SetPlatformMessageCallback(
+        [&](const FlutterPlatformMessage* message) {
+          if (strcmp(message->channel, "test/no_copy") != 0) {
+            return;
+          }
+          auto result = FlutterEngineSendPlatformMessageResponseNoCopy(
+              engine.get(), message->response_handle, buffer.get(),
+              response_data.size(),
+              [](const uint8_t* data, size_t size, void* user_data) {
+                (*reinterpret_cast<std::atomic_int*>(user_data))++;
+              },
+              &release_count);
+          ASSERT_EQ(result, kSuccess);
+        });
+    engine = builder.LaunchEngine();
+    ASSERT_TRUE(engine.is_valid());
+  });
+
+  response.Wait();
+
+  // Since the engine was started on its own thread, it must be killed there as
+  // well.
+  fml::AutoResetWaitableEvent kill_latch;
+  thread.GetTaskRunner()->PostTask(
+      fml::MakeCopyable([&engine, &kill_latch]() mutable {
+        engine.reset();
+        kill_latch.Signal();
+      }));
+  kill_latch.Wait();
+  ASSERT_EQ(release_count, 1);
+}
+
 //------------------------------------------------------------------------------
 /// Tests that a null platform message can be sent.
 ///
@@ -494,6 +624,24 @@ TEST_F(EmbedderTest, CanSetCustomLogMessageCallback) {
   callback_latch.Wait();
 }
 
+TEST_F(EmbedderTest, ReportsShaderPrecompilationWithSoftwareRenderer) {
+  auto& context = GetEmbedderContext(EmbedderTestContextType::kSoftwareContext);
+  EmbedderConfigBuilder builder(context);
+  builder.SetSoftwareRendererConfig();
+  fml::AutoResetWaitableEvent callback_latch;
+  context.SetShaderPrecompilationCallback(
+      [&callback_latch](size_t precompiled_count, size_t total_count) {
+        // There is nothing to precompile with the software renderer, so this
+        // is called once to report completion.
+        EXPECT_EQ(precompiled_count, 0u);
+        EXPECT_EQ(total_count, 0u);
+        callback_latch.Signal();
+      });
+  auto engine = builder.LaunchEngine();
+  ASSERT_TRUE(engine.is_valid());
+  callback_latch.Wait();
+}
+
 //------------------------------------------------------------------------------
 /// Tests that setting a custom log tag works.
 TEST_F(EmbedderTest, CanSetCustomLogTag) {
@@ -926,7 +1074,9 @@ TEST_F(EmbedderTest, VerifyB143464703WithSoftwareBackend) {
   fml::CountDownLatch latch(1);
   context.GetCompositor().SetNextPresentCallback(
       [&](const FlutterLayer** layers, size_t layers_count) {
-        ASSERT_EQ(layers_count, 3u);
+        // The top bar does not overlap the platform view, so it is drawn into
+        // the root layer.
+        ASSERT_EQ(layers_count, 2u);
 
         // Layer 0 (Root)
         {
@@ -960,22 +1110,6 @@ TEST_F(EmbedderTest, VerifyB143464703WithSoftwareBackend) {
           ASSERT_EQ(*layers[1], layer);
         }
 
-        // Layer 2
-        {
-          FlutterBackingStore backing_store = *layers[2]->backing_store;
-          backing_store.type = kFlutterBackingStoreTypeSoftware;
-          backing_store.did_update = true;
-
-          FlutterLayer layer = {};
-          layer.struct_size = sizeof(layer);
-          layer.type = kFlutterLayerContentTypeBackingStore;
-          layer.backing_store = &backing_store;
-          layer.size = FlutterSizeMake(1024.0, 600.0);
-          layer.offset = FlutterPointMake(0.0, 0.0);
-
-          ASSERT_EQ(*layers[2], layer);
-        }
-
         latch.CountDown();
       });
 
@@ -1035,6 +1169,240 @@ TEST_F(EmbedderTest, VerifyB143464703WithSoftwareBackend) {
       ImageMatchesFixture("verifyb143464703_soft_noxform.png", rendered_scene));
 }
 
+TEST_F(EmbedderTest, CompositorRepaintsOnlyTheDamagedPartOfBackingStores) {
+  auto& context = GetEmbedderContext(EmbedderTestContextType::kSoftwareContext);
+
+  EmbedderConfigBuilder builder(context);
+  builder.SetSoftwareRendererConfig(SkISize::Make(800, 600));
+  builder.SetCompositor();
+  builder.SetDartEntrypoint("blink_cursor");
+
+  builder.SetRenderTargetType(
+      EmbedderTestBackingStoreProducer::RenderTargetType::kSoftwareBuffer);
+
+  std::vector<SkRect> paint_regions;
+  fml::CountDownLatch latch(4);
+  context.GetCompositor().SetPresentCallback(
+      [&](const FlutterLayer** layers, size_t layers_count) {
+        ASSERT_EQ(layers_count, 1u);
+        const FlutterDamage* paint_region = layers[0]->paint_region;
+        ASSERT_NE(paint_region, nullptr);
+        ASSERT_EQ(paint_region->num_rects, 1u);
+        const FlutterRect& rect = paint_region->damage[0];
+        paint_regions.push_back(
+            SkRect::MakeLTRB(rect.left, rect.top, rect.right, rect.bottom));
+        latch.CountDown();
+      },
+      /*one_shot=*/false);
+
+  auto engine = builder.LaunchEngine();
+
+  // Send a window metrics events so frames may be scheduled.
+  FlutterWindowMetricsEvent event = {};
+  event.struct_size = sizeof(event);
+  event.width = 800;
+  event.height = 600;
+  event.pixel_ratio = 1.0;
+  ASSERT_EQ(FlutterEngineSendWindowMetricsEvent(engine.get(), &event),
+            kSuccess);
+  ASSERT_TRUE(engine.is_valid());
+
+  latch.Wait();
+
+  // The first frame is painted in full. After that, only the cursor, which
+  // blinks every frame, is repainted.
+  ASSERT_EQ(paint_regions.size(), 4u);
+  ASSERT_EQ(paint_regions[0], SkRect::MakeWH(800, 600));
+  const SkRect cursor = SkRect::MakeXYWH(100, 100, 2, 20);
+  for (size_t i = 1; i < paint_regions.size(); i++) {
+    ASSERT_TRUE(paint_regions[i].contains(cursor));
+    ASSERT_LT(paint_regions[i].width(), 800 / 2);
+    ASSERT_LT(paint_regions[i].height(), 600 / 2);
+  }
+}
+
+TEST_F(EmbedderTest, CompositorRepaintsTheExistingDamageOfBackingStores) {
+  auto& context = GetEmbedderContext(EmbedderTestContextType::kSoftwareContext);
+
+  EmbedderConfigBuilder builder(context);
+  builder.SetSoftwareRendererConfig(SkISize::Make(800, 600));
+  // Ask for a backing store every frame, like an embedder that recycles its
+  // own buffers.
+  builder.SetCompositor(/*avoid_backing_store_cache=*/true);
+  builder.SetDartEntrypoint("blink_cursor");
+
+  builder.SetRenderTargetType(
+      EmbedderTestBackingStoreProducer::RenderTargetType::kSoftwareBuffer);
+
+  // Each backing store reports a part of it as being stale.
+  builder.GetCompositor().create_backing_store_callback =
+      [](const FlutterBackingStoreConfig* config,  //
+         FlutterBackingStore* backing_store_out,   //
+         void* user_data                           //
+      ) {
+        static FlutterRect stale_rect = {500, 400, 600, 500};
+        static FlutterDamage existing_damage = {sizeof(FlutterDamage), 1,
+                                                &stale_rect};
+        if (!reinterpret_cast<EmbedderTestCompositor*>(user_data)
+                 ->CreateBackingStore(config, backing_store_out)) {
+          return false;
+        }
+        backing_store_out->existing_damage = &existing_damage;
+        return true;
+      };
+
+  std::vector<SkRect> paint_regions;
+  fml::CountDownLatch latch(4);
+  context.GetCompositor().SetPresentCallback(
+      [&](const FlutterLayer** layers, size_t layers_count) {
+        ASSERT_EQ(layers_count, 1u);
+        const FlutterDamage* paint_region = layers[0]->paint_region;
+        ASSERT_NE(paint_region, nullptr);
+        ASSERT_EQ(paint_region->num_rects, 1u);
+        const FlutterRect& rect = paint_region->damage[0];
+        paint_regions.push_back(
+            SkRect::MakeLTRB(rect.left, rect.top, rect.right, rect.bottom));
+        latch.CountDown();
+      },
+      /*one_shot=*/false);
+
+  auto engine = builder.LaunchEngine();
+
+  // Send a window metrics events so frames may be scheduled.
+  FlutterWindowMetricsEvent event = {};
+  event.struct_size = sizeof(event);
+  event.width = 800;
+  event.height = 600;
+  event.pixel_ratio = 1.0;
+  ASSERT_EQ(FlutterEngineSendWindowMetricsEvent(engine.get(), &event),
+            kSuccess);
+  ASSERT_TRUE(engine.is_valid());
+
+  latch.Wait();
+
+  // The first frame is painted in full. After that, the cursor and the stale
+  // part of each new backing store are repainted.
+  ASSERT_EQ(paint_regions.size(), 4u);
+  ASSERT_EQ(paint_regions[0], SkRect::MakeWH(800, 600));
+  const SkRect cursor = SkRect::MakeXYWH(100, 100, 2, 20);
+  const SkRect stale_rect = SkRect::MakeLTRB(500, 400, 600, 500);
+  for (size_t i = 1; i < paint_regions.size(); i++) {
+    ASSERT_TRUE(paint_regions[i].contains(cursor));
+    ASSERT_TRUE(paint_regions[i].contains(stale_rect));
+    ASSERT_NE(paint_regions[i], SkRect::MakeWH(800, 600));
+  }
+}
+
+TEST_F(EmbedderTest, SoftwareRendererPresentsOnlyTheDamagedPartOfFrames) {
+  auto& context = GetEmbedderContext(EmbedderTestContextType::kSoftwareContext);
+
+  EmbedderConfigBuilder builder(context);
+  builder.SetSoftwareRendererConfig(SkISize::Make(800, 600));
+  builder.SetSoftwarePresentWithDamageCallback();
+  builder.SetDartEntrypoint("blink_cursor");
+
+  std::vector<SkIRect> damages;
+  std::future<sk_sp<SkImage>> last_scene;
+  fml::CountDownLatch latch(4);
+  static_cast<EmbedderTestContextSoftware&>(context).SetPresentDamageCallback(
+      [&](const SkIRect& damage) {
+        damages.push_back(damage);
+        if (damages.size() == 4u) {
+          // The buffer is presented right after its damage is reported.
+          last_scene = context.GetNextSceneImage();
+        }
+        latch.CountDown();
+      });
+
+  auto engine = builder.LaunchEngine();
+
+  // Send a window metrics events so frames may be scheduled.
+  FlutterWindowMetricsEvent event = {};
+  event.struct_size = sizeof(event);
+  event.width = 800;
+  event.height = 600;
+  event.pixel_ratio = 1.0;
+  ASSERT_EQ(FlutterEngineSendWindowMetricsEvent(engine.get(), &event),
+            kSuccess);
+  ASSERT_TRUE(engine.is_valid());
+
+  latch.Wait();
+
+  // The first frame is painted into a new buffer in full. After that, the
+  // buffer still holds the last frame presented, so only the cursor, which
+  // blinks every frame, is repainted.
+  ASSERT_EQ(damages.size(), 4u);
+  ASSERT_EQ(damages[0], SkIRect::MakeWH(800, 600));
+  const SkIRect cursor = SkIRect::MakeXYWH(100, 100, 2, 20);
+  for (size_t i = 1; i < damages.size(); i++) {
+    ASSERT_TRUE(damages[i].contains(cursor));
+    ASSERT_LT(damages[i].width(), 800 / 2);
+    ASSERT_LT(damages[i].height(), 600 / 2);
+  }
+
+  // The cursor is hidden in the last frame, and the contents kept from the
+  // earlier frames are intact.
+  sk_sp<SkImage> image = last_scene.get();
+  ASSERT_TRUE(image);
+  SkBitmap bitmap;
+  ASSERT_TRUE(bitmap.tryAllocPixels(
+      SkImageInfo::MakeN32Premul(image->width(), image->height())));
+  ASSERT_TRUE(image->readPixels(bitmap.pixmap(), 0, 0));
+  const SkColor gray = SkColorSetARGB(255, 127, 127, 127);
+  EXPECT_EQ(bitmap.getColor(101, 110), gray);
+  EXPECT_EQ(bitmap.getColor(50, 50), gray);
+  EXPECT_EQ(bitmap.getColor(700, 500), gray);
+}
+
+TEST_F(EmbedderTest, CompositorCoalescesOverlaysNotOverlappingPlatformViews) {
+  auto& context = GetEmbedderContext(EmbedderTestContextType::kSoftwareContext);
+
+  EmbedderConfigBuilder builder(context);
+  builder.SetSoftwareRendererConfig(SkISize::Make(800, 600));
+  builder.SetCompositor();
+  builder.SetDartEntrypoint("overlays_not_overlapping_platform_views");
+
+  builder.SetRenderTargetType(
+      EmbedderTestBackingStoreProducer::RenderTargetType::kSoftwareBuffer);
+
+  fml::CountDownLatch latch(1);
+  context.GetCompositor().SetNextPresentCallback(
+      [&](const FlutterLayer** layers, size_t layers_count) {
+        // Without coalescing, each of the three platform views would have a
+        // backing store on top of it.
+        ASSERT_EQ(layers_count, 5u);
+
+        ASSERT_EQ(layers[0]->type, kFlutterLayerContentTypeBackingStore);
+
+        ASSERT_EQ(layers[1]->type, kFlutterLayerContentTypePlatformView);
+        ASSERT_EQ(layers[1]->platform_view->identifier, 1);
+
+        ASSERT_EQ(layers[2]->type, kFlutterLayerContentTypePlatformView);
+        ASSERT_EQ(layers[2]->platform_view->identifier, 2);
+
+        ASSERT_EQ(layers[3]->type, kFlutterLayerContentTypeBackingStore);
+
+        ASSERT_EQ(layers[4]->type, kFlutterLayerContentTypePlatformView);
+        ASSERT_EQ(layers[4]->platform_view->identifier, 3);
+
+        latch.CountDown();
+      });
+
+  auto engine = builder.LaunchEngine();
+
+  // Send a window metrics events so frames may be scheduled.
+  FlutterWindowMetricsEvent event = {};
+  event.struct_size = sizeof(event);
+  event.width = 800;
+  event.height = 600;
+  event.pixel_ratio = 1.0;
+  ASSERT_EQ(FlutterEngineSendWindowMetricsEvent(engine.get(), &event),
+            kSuccess);
+  ASSERT_TRUE(engine.is_valid());
+
+  latch.Wait();
+}
+
 TEST_F(EmbedderTest, CanSendLowMemoryNotification) {
   auto& context = GetEmbedderContext(EmbedderTestContextType::kSoftwareContext);
 
@@ -47,6 +47,25 @@ TEST_F(EmbedderTest, CanCreateOpenGLRenderingEngine) {
   ASSERT_TRUE(engine.is_valid());
 }
 
+TEST_F(EmbedderTest, ReportsShaderPrecompilationWithOpenGLRenderer) {
+  auto& context = GetEmbedderContext(EmbedderTestContextType::kOpenGLContext);
+  EmbedderConfigBuilder builder(context);
+  builder.SetOpenGLRendererConfig(SkISize::Make(1, 1));
+  fml::AutoResetWaitableEvent callback_latch;
+  context.SetShaderPrecompilationCallback(
+      [&callback_latch](size_t precompiled_count, size_t total_count) {
+        EXPECT_LE(precompiled_count, total_count);
+        // The last report always has both counts equal, even when there is
+        // nothing to precompile.
+        if (precompiled_count == total_count) {
+          callback_latch.Signal();
+        }
+      });
+  auto engine = builder.LaunchEngine();
+  ASSERT_TRUE(engine.is_valid());
+  callback_latch.Wait();
+}
+
 //------------------------------------------------------------------------------
 /// If an incorrectly configured compositor is set on the engine, the engine
 /// must fail to launch instead of failing to render a frame at a later point in
@@ -13,6 +13,7 @@
 
 #include "flutter/common/graphics/persistent_cache.h"
 #include "flutter/common/task_runners.h"
+#include "flutter/flow/display_list_serialization.h"
 #include "flutter/fml/make_copyable.h"
 #include "flutter/fml/message_loop.h"
 #include "flutter/fml/synchronization/waitable_event.h"
@@ -22,6 +23,7 @@
 #include "flutter/shell/common/run_configuration.h"
 #include "flutter/shell/common/serialization_callbacks.h"
 #include "third_party/skia/include/core/SkPicture.h"
+#include "third_party/skia/include/core/SkPictureRecorder.h"
 #include "third_party/skia/include/core/SkSerialProcs.h"
 #include "third_party/skia/include/ports/SkFontMgr_fuchsia.h"
 
@@ -52,6 +54,15 @@ std::unique_ptr<flutter::PlatformMessage> MakeLocalizationPlatformMessage(
       nullptr);
 }
 
+// Whether the named asset is a serialized display list rather than an skp.
+bool IsDisplayListName(const std::string& name) {
+  static constexpr char kDisplayListExtension[] = ".dlist";
+  const size_t extension_size = sizeof(kDisplayListExtension) - 1;
+  return name.size() >= extension_size &&
+         name.compare(name.size() - extension_size, extension_size,
+                      kDisplayListExtension) == 0;
+}
+
 }  // namespace
 
 flutter::ThreadHost Engine::CreateThreadHost(const std::string& name_prefix) {
@@ -856,17 +867,28 @@ void Engine::WarmupSkps(
                                     completion_callback]() {
     TRACE_DURATION("flutter", "DeserializeSkps");
     std::vector<std::unique_ptr<fml::Mapping>> skp_mappings;
+    // Serialized display lists (see flutter::DisplayListSerializer) are
+    // warmed up after the skps.
+    std::vector<std::unique_ptr<fml::Mapping>> display_list_mappings;
     if (skp_names) {
       for (auto& skp_name : skp_names.value()) {
         auto skp_mapping = asset_manager->GetAsMapping(skp_name);
-        if (skp_mapping) {
-          skp_mappings.push_back(std::move(skp_mapping));
-        } else {
+        if (!skp_mapping) {
           FML_LOG(ERROR) << "Failed to get mapping for " << skp_name;
+        } else if (IsDisplayListName(skp_name)) {
+          display_list_mappings.push_back(std::move(skp_mapping));
+        } else {
+          skp_mappings.push_back(std::move(skp_mapping));
         }
       }
     } else {
       skp_mappings = asset_manager->GetAsMappings(".*\\.skp$", "shaders");
+      display_list_mappings =
+          asset_manager->GetAsMappings(".*\\.dlist$", "shaders");
+    }
+    size_t display_list_start = skp_mappings.size();
+    for (auto& mapping : display_list_mappings) {
+      skp_mappings.push_back(std::move(mapping));
     }
 
     size_t total_size = 0;
@@ -879,14 +901,26 @@ void Engine::WarmupSkps(
 
     std::vector<sk_sp<SkPicture>> pictures;
     unsigned int i = 0;
-    for (auto& mapping : skp_mappings) {
-      std::unique_ptr<SkMemoryStream> stream =
-          SkMemoryStream::MakeDirect(mapping->GetMapping(), mapping->GetSize());
-      SkDeserialProcs procs = {0};
-      procs.fImageProc = flutter::DeserializeImageWithoutData;
-      procs.fTypefaceProc = flutter::DeserializeTypefaceWithoutData;
-      sk_sp<SkPicture> picture =
-          SkPicture::MakeFromStream(stream.get(), &procs);
+    for (size_t index = 0; index < skp_mappings.size(); index++) {
+      auto& mapping = skp_mappings[index];
+      sk_sp<SkPicture> picture;
+      if (index >= display_list_start) {
+        sk_sp<flutter::DisplayList> display_list =
+            flutter::DisplayListSerializer::Deserialize(*mapping);
+        if (display_list) {
+          SkPictureRecorder recorder;
+          display_list->RenderTo(
+              recorder.beginRecording(display_list->bounds()));
+          picture = recorder.finishRecordingAsPicture();
+        }
+      } else {
+        std::unique_ptr<SkMemoryStream> stream = SkMemoryStream::MakeDirect(
+            mapping->GetMapping(), mapping->GetSize());
+        SkDeserialProcs procs = {0};
+        procs.fImageProc = flutter::DeserializeImageWithoutData;
+        procs.fTypefaceProc = flutter::DeserializeTypefaceWithoutData;
+        picture = SkPicture::MakeFromStream(stream.get(), &procs);
+      }
       if (!picture) {
         FML_LOG(ERROR) << "Failed to deserialize picture " << i;
         continue;
@@ -69,8 +69,10 @@ static void write_float64(GByteArray* buffer, double value) {
 
 // Write padding bytes to align to @align multiple of bytes.
 static void write_align(GByteArray* buffer, guint align) {
-  while (buffer->len % align != 0) {
-    write_uint8(buffer, 0);
+  static const uint8_t padding[8] = {};
+  guint mod = buffer->len % align;
+  if (mod != 0) {
+    g_byte_array_append(buffer, padding, align - mod);
   }
 }
 
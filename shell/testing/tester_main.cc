@@ -99,7 +99,9 @@ class TesterPlatformView : public PlatformView,
   }
 
   // |GPUSurfaceSoftwareDelegate|
-  bool PresentBackingStore(sk_sp<SkSurface> backing_store) override {
+  bool PresentBackingStore(
+      sk_sp<SkSurface> backing_store,
+      const std::optional<std::vector<SkIRect>>& damage) override {
     return true;
   }
 
@@ -2,6 +2,7 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+import 'dart:typed_data';
 import 'dart:ui';
 
 import 'package:litetest/litetest.dart';
@@ -69,4 +70,40 @@ void main() {
     expect(metrics.first.baseline, closeTo(11.200042724609375, epsillon));
     expect(metrics.first.lineNumber, 0);
   });
+
+  test('layoutBatch matches laying out each paragraph', () {
+    // Enough requests to be split into several chunks when laid out in
+    // parallel.
+    final List<ParagraphLayoutRequest> requests = <ParagraphLayoutRequest>[
+      for (int i = 0; i < 50; i++)
+        ParagraphLayoutRequest(
+          paragraphStyle: ParagraphStyle(maxLines: i.isEven ? 1 : null, ellipsis: i % 3 == 0 ? '...' : null),
+          textStyle: TextStyle(fontSize: 10.0 + i % 7),
+          text: 'Label number $i ' * (1 + i % 4),
+          width: 40.0 + 10.0 * (i % 5),
+        ),
+    ];
+
+    for (final bool parallel in <bool>[false, true]) {
+      final Float64List metrics = ParagraphBuilder.layoutBatch(requests, parallel: parallel);
+      expect(metrics.length, requests.length * 8);
+      for (int i = 0; i < requests.length; i++) {
+        final ParagraphLayoutRequest request = requests[i];
+        final ParagraphBuilder builder = ParagraphBuilder(request.paragraphStyle)
+          ..pushStyle(request.textStyle)
+          ..addText(request.text);
+        final Paragraph paragraph = builder.build()
+          ..layout(ParagraphConstraints(width: request.width));
+        final int offset = i * 8;
+        expect(metrics[offset], paragraph.width);
+        expect(metrics[offset + 1], paragraph.height);
+        expect(metrics[offset + 2], paragraph.longestLine);
+        expect(metrics[offset + 3], paragraph.minIntrinsicWidth);
+        expect(metrics[offset + 4], paragraph.maxIntrinsicWidth);
+        expect(metrics[offset + 5], paragraph.alphabeticBaseline);
+        expect(metrics[offset + 6], paragraph.ideographicBaseline);
+        expect(metrics[offset + 7], paragraph.didExceedMaxLines ? 1.0 : 0.0);
+      }
+    }
+  });
 }
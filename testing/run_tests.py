@@ -248,6 +248,8 @@ def RunEngineBenchmarks(build_dir, filter):
   if IsLinux():
     RunEngineExecutable(build_dir, 'txt_benchmarks', filter, icu_flags)
 
+    RunEngineExecutable(build_dir, 'client_wrapper_benchmarks', filter, icu_flags)
+
 
 def RunDartTest(build_dir, test_packages, dart_file, verbose_dart_snapshot, multithreaded,
                 enable_observatory=False, expect_failure=False):
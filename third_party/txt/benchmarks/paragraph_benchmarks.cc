@@ -245,6 +245,85 @@ BENCHMARK_REGISTER_F(ParagraphFixture, StylesBigO)
     ->Range(1 << 3, 1 << 12)
     ->Complexity(benchmark::oN);
 
+// Lays out a rich text paragraph at a sequence of widths, as happens while a
+// window is resized. Only the line breaks and positions are recomputed for each
+// width.
+BENCHMARK_DEFINE_F(ParagraphFixture, ResizeLayout)(benchmark::State& state) {
+  const char* text =
+      "This is a very long sentence to test if the text will properly wrap "
+      "around and go to the next line. Sometimes, short sentence. Longer "
+      "sentences are okay too because they are necessary. Very short. ";
+  auto icu_text = icu::UnicodeString::fromUTF8(text);
+  std::u16string u16_text(icu_text.getBuffer(),
+                          icu_text.getBuffer() + icu_text.length());
+
+  txt::ParagraphStyle paragraph_style;
+
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  text_style.color = SK_ColorBLACK;
+
+  txt::ParagraphBuilderTxt builder(paragraph_style, font_collection_);
+
+  for (int i = 0; i < state.range(0); ++i) {
+    text_style.font_size = 12 + i % 8;
+    builder.PushStyle(text_style);
+    builder.AddText(u16_text);
+  }
+  auto paragraph = BuildParagraph(builder);
+  paragraph->Layout(300);
+  double width = 300;
+  while (state.KeepRunning()) {
+    width = width >= 600 ? 300 : width + 7;
+    paragraph->Layout(width);
+  }
+  state.SetComplexityN(state.range(0));
+}
+BENCHMARK_REGISTER_F(ParagraphFixture, ResizeLayout)
+    ->RangeMultiplier(4)
+    ->Range(1 << 2, 1 << 8)
+    ->Complexity(benchmark::oN);
+
+// The same resize sequence with the paragraph marked dirty before every
+// layout, so that the text is measured again for each width.
+BENCHMARK_DEFINE_F(ParagraphFixture, ResizeLayoutDirty)
+(benchmark::State& state) {
+  const char* text =
+      "This is a very long sentence to test if the text will properly wrap "
+      "around and go to the next line. Sometimes, short sentence. Longer "
+      "sentences are okay too because they are necessary. Very short. ";
+  auto icu_text = icu::UnicodeString::fromUTF8(text);
+  std::u16string u16_text(icu_text.getBuffer(),
+                          icu_text.getBuffer() + icu_text.length());
+
+  txt::ParagraphStyle paragraph_style;
+
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  text_style.color = SK_ColorBLACK;
+
+  txt::ParagraphBuilderTxt builder(paragraph_style, font_collection_);
+
+  for (int i = 0; i < state.range(0); ++i) {
+    text_style.font_size = 12 + i % 8;
+    builder.PushStyle(text_style);
+    builder.AddText(u16_text);
+  }
+  auto paragraph = BuildParagraph(builder);
+  paragraph->Layout(300);
+  double width = 300;
+  while (state.KeepRunning()) {
+    width = width >= 600 ? 300 : width + 7;
+    paragraph->SetDirty();
+    paragraph->Layout(width);
+  }
+  state.SetComplexityN(state.range(0));
+}
+BENCHMARK_REGISTER_F(ParagraphFixture, ResizeLayoutDirty)
+    ->RangeMultiplier(4)
+    ->Range(1 << 2, 1 << 8)
+    ->Complexity(benchmark::oN);
+
 BENCHMARK_F(ParagraphFixture, PaintSimple)(benchmark::State& state) {
   const char* text = "Hello world! This is a simple sentence to test drawing.";
   auto icu_text = icu::UnicodeString::fromUTF8(text);
@@ -352,6 +431,76 @@ BENCHMARK_F(ParagraphFixture, PaintDecoration)(benchmark::State& state) {
   }
 }
 
+// -----------------------------------------------------------------------------
+//
+// The following benchmarks lay out text on several threads at once to measure
+// how well layout scales. Each thread has its own font collection, as each
+// isolate would, while the minikin caches are shared by all threads.
+//
+// -----------------------------------------------------------------------------
+
+static std::unique_ptr<ParagraphTxt> BuildParagraphForThread(
+    const std::shared_ptr<FontCollection>& font_collection,
+    double font_size) {
+  const char* text =
+      "This is a very long sentence to test if the text will properly wrap "
+      "around and go to the next line. Sometimes, short sentence. Longer "
+      "sentences are okay too because they are necessary. Very short. "
+      "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod "
+      "tempor incididunt ut labore et dolore magna aliqua. Ut enim ad minim "
+      "veniam, quis nostrud exercitation ullamco laboris nisi ut aliquip ex ea "
+      "commodo consequat. Duis aute irure dolor in reprehenderit in voluptate "
+      "velit esse cillum dolore eu fugiat nulla pariatur.";
+  auto icu_text = icu::UnicodeString::fromUTF8(text);
+  std::u16string u16_text(icu_text.getBuffer(),
+                          icu_text.getBuffer() + icu_text.length());
+
+  txt::ParagraphStyle paragraph_style;
+
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  text_style.font_size = font_size;
+  text_style.color = SK_ColorBLACK;
+
+  txt::ParagraphBuilderTxt builder(paragraph_style, font_collection);
+  builder.PushStyle(text_style);
+  builder.AddText(u16_text);
+  builder.Pop();
+  return BuildParagraph(builder);
+}
+
+// Relayout of the same paragraph, where every word is found in the layout
+// cache.
+static void BM_ParagraphLayoutMultiThreadedCached(benchmark::State& state) {
+  auto font_collection = GetTestFontCollection();
+  auto paragraph = BuildParagraphForThread(font_collection, 14);
+  paragraph->Layout(300);
+  while (state.KeepRunning()) {
+    paragraph->SetDirty();
+    paragraph->Layout(300);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ParagraphLayoutMultiThreadedCached)
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+
+// Layout of paragraphs whose font size changes every iteration, so that every
+// word misses the layout cache and is shaped again.
+static void BM_ParagraphLayoutMultiThreadedUncached(benchmark::State& state) {
+  auto font_collection = GetTestFontCollection();
+  double font_size = 14;
+  while (state.KeepRunning()) {
+    auto paragraph = BuildParagraphForThread(font_collection, font_size);
+    paragraph->Layout(300);
+    font_size += 0.01;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ParagraphLayoutMultiThreadedUncached)
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+
 // -----------------------------------------------------------------------------
 //
 // The following benchmarks break down the layout function and attempts to time
@@ -43,7 +43,7 @@ static inline T max(T a, T b) {
 const uint32_t EMOJI_STYLE_VS = 0xFE0F;
 const uint32_t TEXT_STYLE_VS = 0xFE0E;
 
-uint32_t FontCollection::sNextId = 0;
+std::atomic<uint32_t> FontCollection::sNextId = 0;
 
 // libtxt: return a locale string for a language list ID
 std::string GetFontLocale(uint32_t langListId) {
@@ -65,7 +65,6 @@ FontCollection::FontCollection() : mMaxChar(0) {}
 
 bool FontCollection::init(
     const std::vector<std::shared_ptr<FontFamily>>& typefaces) {
-  std::scoped_lock _l(gMinikinLock);
   mId = sNextId++;
   vector<uint32_t> lastChar;
   size_t nTypefaces = typefaces.size();
@@ -299,7 +298,7 @@ uint32_t FontCollection::calcVariantMatchingScore(
 // the detail.
 // 3. Highest score wins, with ties resolved to the first font.
 // This method never returns nullptr.
-const std::shared_ptr<FontFamily>& FontCollection::getFamilyForChar(
+const FontFamily* FontCollection::getFamilyForChar(
     uint32_t ch,
     uint32_t vs,
     uint32_t langListId,
@@ -307,13 +306,12 @@ const std::shared_ptr<FontFamily>& FontCollection::getFamilyForChar(
   if (ch >= mMaxChar) {
     // libtxt: check if the fallback font provider can match this character
     if (mFallbackFontProvider) {
-      const std::shared_ptr<FontFamily>& fallback =
-          findFallbackFont(ch, vs, langListId);
+      const FontFamily* fallback = findFallbackFont(ch, vs, langListId);
       if (fallback) {
         return fallback;
       }
     }
-    return mFamilies[0];
+    return mFamilies[0].get();
   }
 
   Range range = mRanges[ch >> kLogCharsPerPage];
@@ -334,7 +332,7 @@ const std::shared_ptr<FontFamily>& FontCollection::getFamilyForChar(
     if (score == kFirstFontScore) {
       // If the first font family supports the given character or variation
       // sequence, always use it.
-      return family;
+      return family.get();
     }
     if (score > bestScore) {
       bestScore = score;
@@ -344,8 +342,7 @@ const std::shared_ptr<FontFamily>& FontCollection::getFamilyForChar(
   if (bestFamilyIndex == -1) {
     // libtxt: check if the fallback font provider can match this character
     if (mFallbackFontProvider) {
-      const std::shared_ptr<FontFamily>& fallback =
-          findFallbackFont(ch, vs, langListId);
+      const FontFamily* fallback = findFallbackFont(ch, vs, langListId);
       if (fallback) {
         return fallback;
       }
@@ -363,34 +360,55 @@ const std::shared_ptr<FontFamily>& FontCollection::getFamilyForChar(
         return getFamilyForChar(ch, vs, langListId, variant);
       }
     }
-    return mFamilies[0];
+    return mFamilies[0].get();
   }
-  return vs == 0 ? mFamilies[mFamilyVec[bestFamilyIndex]]
-                 : mFamilies[bestFamilyIndex];
+  return vs == 0 ? mFamilies[mFamilyVec[bestFamilyIndex]].get()
+                 : mFamilies[bestFamilyIndex].get();
 }
 
-const std::shared_ptr<FontFamily>& FontCollection::findFallbackFont(
-    uint32_t ch,
-    uint32_t vs,
-    uint32_t langListId) const {
+const FontFamily* FontCollection::findFallbackFont(uint32_t ch,
+                                                   uint32_t vs,
+                                                   uint32_t langListId) const {
   std::string locale = GetFontLocale(langListId);
 
+  std::unique_lock lock(mCachedFallbackFamiliesMutex);
+  const FontFamily* cached = findCachedFallbackFont(ch, vs, locale);
+  if (cached) {
+    return cached;
+  }
+
+  // The provider may be slow to match a font, so other threads are not kept
+  // from using the cached families in the meantime.
+  lock.unlock();
+  std::shared_ptr<FontFamily> fallback =
+      mFallbackFontProvider->matchFallbackFont(ch, locale);
+  if (!fallback) {
+    return nullptr;
+  }
+  lock.lock();
+
+  // Another thread may have cached a family for this character meanwhile.
+  cached = findCachedFallbackFont(ch, vs, locale);
+  if (cached) {
+    return cached;
+  }
+  mCachedFallbackFamilies[locale].push_back(fallback);
+  return fallback.get();
+}
+
+const FontFamily* FontCollection::findCachedFallbackFont(
+    uint32_t ch,
+    uint32_t vs,
+    const std::string& locale) const {
   const auto it = mCachedFallbackFamilies.find(locale);
   if (it != mCachedFallbackFamilies.end()) {
     for (const auto& fallbackFamily : it->second) {
       if (calcCoverageScore(ch, vs, fallbackFamily)) {
-        return fallbackFamily;
+        return fallbackFamily.get();
       }
     }
   }
-
-  const std::shared_ptr<FontFamily>& fallback =
-      mFallbackFontProvider->matchFallbackFont(ch, GetFontLocale(langListId));
-
-  if (fallback) {
-    mCachedFallbackFamilies[locale].push_back(fallback);
-  }
-  return fallback;
+  return nullptr;
 }
 
 const uint32_t NBSP = 0x00A0;
@@ -434,8 +452,6 @@ bool FontCollection::hasVariationSelector(uint32_t baseCodepoint,
     return false;
   }
 
-  std::scoped_lock _l(gMinikinLock);
-
   // Currently mRanges can not be used here since it isn't aware of the
   // variation sequence.
   for (size_t i = 0; i < mVSFamilyVec.size(); i++) {
@@ -507,9 +523,9 @@ void FontCollection::itemize(const uint16_t* string,
     }
 
     if (!shouldContinueRun) {
-      const std::shared_ptr<FontFamily>& family = getFamilyForChar(
+      const FontFamily* family = getFamilyForChar(
           ch, isVariationSelector(nextCh) ? nextCh : 0, langListId, variant);
-      if (utf16Pos == 0 || family.get() != lastFamily) {
+      if (utf16Pos == 0 || family != lastFamily) {
         size_t start = utf16Pos;
         // Workaround for combining marks and emoji modifiers until we implement
         // per-cluster font selection: if a combining mark or an emoji modifier
@@ -531,7 +547,7 @@ void FontCollection::itemize(const uint16_t* string,
         result->push_back(
             {family->getClosestMatch(style), static_cast<int>(start), 0});
         run = &result->back();
-        lastFamily = family.get();
+        lastFamily = family;
       }
     }
     prevCh = ch;
@@ -17,8 +17,11 @@
 #ifndef MINIKIN_FONT_COLLECTION_H
 #define MINIKIN_FONT_COLLECTION_H
 
+#include <atomic>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <string>
 #include <unordered_set>
 #include <vector>
 
@@ -98,13 +101,22 @@ class FontCollection {
   // Initialize the FontCollection.
   bool init(const std::vector<std::shared_ptr<FontFamily>>& typefaces);
 
-  const std::shared_ptr<FontFamily>& getFamilyForChar(uint32_t ch,
-                                                      uint32_t vs,
-                                                      uint32_t langListId,
-                                                      int variant) const;
+  // Fallback families may be added by other threads while the caller is using
+  // the returned family. They are never removed, so the family outlives this
+  // collection's use of it.
+  const FontFamily* getFamilyForChar(uint32_t ch,
+                                     uint32_t vs,
+                                     uint32_t langListId,
+                                     int variant) const;
 
-  const std::shared_ptr<FontFamily>&
-  findFallbackFont(uint32_t ch, uint32_t vs, uint32_t langListId) const;
+  const FontFamily* findFallbackFont(uint32_t ch,
+                                     uint32_t vs,
+                                     uint32_t langListId) const;
+
+  // Requires |mCachedFallbackFamiliesMutex| to be held.
+  const FontFamily* findCachedFallbackFont(uint32_t ch,
+                                           uint32_t vs,
+                                           const std::string& locale) const;
 
   uint32_t calcFamilyScore(uint32_t ch,
                            uint32_t vs,
@@ -124,7 +136,7 @@ class FontCollection {
                                            const FontFamily& fontFamily);
 
   // static for allocating unique id's
-  static uint32_t sNextId;
+  static std::atomic<uint32_t> sNextId;
 
   // unique id for this font collection (suitable for cache key)
   uint32_t mId;
@@ -157,6 +169,7 @@ class FontCollection {
 
   // libtxt extension: Fallback fonts discovered after this font collection
   // was constructed.
+  mutable std::mutex mCachedFallbackFamiliesMutex;
   mutable std::map<std::string, std::vector<std::shared_ptr<FontFamily>>>
       mCachedFallbackFamilies;
 };
@@ -123,6 +123,7 @@ static std::vector<FontLanguage> parseLanguageList(const std::string& input) {
 // static
 uint32_t FontLanguageListCache::getId(const std::string& languages) {
   FontLanguageListCache* inst = FontLanguageListCache::getInstance();
+  std::scoped_lock lock(inst->mMutex);
   std::unordered_map<std::string, uint32_t>::const_iterator it =
       inst->mLanguageListLookupTable.find(languages);
   if (it != inst->mLanguageListLookupTable.end()) {
@@ -144,24 +145,26 @@ uint32_t FontLanguageListCache::getId(const std::string& languages) {
 // static
 const FontLanguages& FontLanguageListCache::getById(uint32_t id) {
   FontLanguageListCache* inst = FontLanguageListCache::getInstance();
+  std::scoped_lock lock(inst->mMutex);
   LOG_ALWAYS_FATAL_IF(id >= inst->mLanguageLists.size(),
                       "Lookup by unknown language list ID.");
+  // The returned reference stays valid after the lock is released since
+  // language lists are never modified or removed once they are added.
   return inst->mLanguageLists[id];
 }
 
 // static
 FontLanguageListCache* FontLanguageListCache::getInstance() {
-  assertMinikinLocked();
-  static FontLanguageListCache* instance = nullptr;
-  if (instance == nullptr) {
-    instance = new FontLanguageListCache();
+  static FontLanguageListCache* instance = []() {
+    FontLanguageListCache* cache = new FontLanguageListCache();
 
     // Insert an empty language list for mapping default language list to
     // kEmptyListId. The default language list has only one FontLanguage and it
     // is the unsupported language.
-    instance->mLanguageLists.push_back(FontLanguages());
-    instance->mLanguageListLookupTable.insert(std::make_pair("", kEmptyListId));
-  }
+    cache->mLanguageLists.push_back(FontLanguages());
+    cache->mLanguageListLookupTable.insert(std::make_pair("", kEmptyListId));
+    return cache;
+  }();
   return instance;
 }
 
@@ -18,6 +18,8 @@
 
 #include "HbFontCache.h"
 
+#include <mutex>
+
 #include <log/log.h>
 #include <utils/LruCache.h>
 
@@ -54,40 +56,40 @@ class HbFontCache : private android::OnEntryRemoved<int32_t, hb_font_t*> {
   android::LruCache<int32_t, hb_font_t*> mCache;
 };
 
-HbFontCache* getFontCacheLocked() {
-  assertMinikinLocked();
-  static HbFontCache* cache = nullptr;
-  if (cache == nullptr) {
-    cache = new HbFontCache();
-  }
+// Guards the font cache. The cached fonts are made immutable before they are
+// published, so they may be used after the lock is released.
+static std::mutex gHbFontCacheLock;
+
+static HbFontCache* getFontCache() {
+  static HbFontCache* cache = new HbFontCache();
   return cache;
 }
 
-void purgeHbFontCacheLocked() {
-  assertMinikinLocked();
-  getFontCacheLocked()->clear();
+void purgeHbFontCache() {
+  std::scoped_lock lock(gHbFontCacheLock);
+  getFontCache()->clear();
 }
 
-void purgeHbFontLocked(const MinikinFont* minikinFont) {
-  assertMinikinLocked();
+void purgeHbFont(const MinikinFont* minikinFont) {
   const int32_t fontId = minikinFont->GetUniqueId();
-  getFontCacheLocked()->remove(fontId);
+  std::scoped_lock lock(gHbFontCacheLock);
+  getFontCache()->remove(fontId);
 }
 
 // Returns a new reference to a hb_font_t object, caller is
 // responsible for calling hb_font_destroy() on it.
-hb_font_t* getHbFontLocked(const MinikinFont* minikinFont) {
-  assertMinikinLocked();
+//
+// The returned font is shared and immutable. Callers that need to set their
+// own font functions or scale must create a sub font of it.
+hb_font_t* getHbFont(const MinikinFont* minikinFont) {
   // TODO: get rid of nullFaceFont
-  static hb_font_t* nullFaceFont = nullptr;
+  static hb_font_t* nullFaceFont = hb_font_create(nullptr);
   if (minikinFont == nullptr) {
-    if (nullFaceFont == nullptr) {
-      nullFaceFont = hb_font_create(nullptr);
-    }
     return hb_font_reference(nullFaceFont);
   }
 
-  HbFontCache* fontCache = getFontCacheLocked();
+  std::scoped_lock lock(gHbFontCacheLock);
+  HbFontCache* fontCache = getFontCache();
   const int32_t fontId = minikinFont->GetUniqueId();
   hb_font_t* font = fontCache->get(fontId);
   if (font != nullptr) {
@@ -110,6 +112,7 @@ hb_font_t* getHbFontLocked(const MinikinFont* minikinFont) {
   hb_font_set_variations(font, variations.data(), variations.size());
   hb_font_destroy(parent_font);
   hb_face_destroy(face);
+  hb_font_make_immutable(font);
   fontCache->put(fontId, font);
   return hb_font_reference(font);
 }
@@ -22,9 +22,10 @@ struct hb_font_t;
 namespace minikin {
 class MinikinFont;
 
-void purgeHbFontCacheLocked();
-void purgeHbFontLocked(const MinikinFont* minikinFont);
-hb_font_t* getHbFontLocked(const MinikinFont* minikinFont);
+// These functions may be called from any thread.
+void purgeHbFontCache();
+void purgeHbFont(const MinikinFont* minikinFont);
+hb_font_t* getHbFont(const MinikinFont* minikinFont);
 
 }  // namespace minikin
 #endif  // MINIKIN_HBFONT_CACHE_H
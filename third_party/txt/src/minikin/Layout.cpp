@@ -20,8 +20,10 @@
 #include <unicode/ubidi.h>
 #include <unicode/utf16.h>
 #include <algorithm>
+#include <atomic>
 #include <fstream>
 #include <iostream>  // for debugging
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -40,6 +42,7 @@
 #include "HbFontCache.h"
 #include "LayoutUtils.h"
 #include "MinikinInternal.h"
+#include "flutter/fml/thread_local.h"
 
 namespace minikin {
 
@@ -89,6 +92,11 @@ class LayoutCacheKey {
 
   android::hash_t hash() const { return mHash; }
 
+  // Approximate number of heap bytes held by a cached copy of this key.
+  size_t getMemoryUsage() const {
+    return sizeof(LayoutCacheKey) + mNchars * sizeof(uint16_t);
+  }
+
   void copyText() {
     uint16_t* charsCopy = new uint16_t[mNchars];
     memcpy(charsCopy, mChars, mNchars * sizeof(uint16_t));
@@ -129,53 +137,113 @@ class LayoutCacheKey {
   android::hash_t computeHash() const;
 };
 
-class LayoutCache : private android::OnEntryRemoved<LayoutCacheKey, Layout*> {
+// The cache is split into shards that each have their own lock, so that
+// threads laying out text at the same time only contend when their words hash
+// to the same shard. Cached layouts are reference counted so that a layout
+// evicted by one thread stays alive while another thread is still copying it.
+//
+// Each shard evicts its least recently used words once the keys and layouts it
+// holds take up more than its share of |kMaxBytes|. The sizes of the shards are
+// only changed under their locks but are atomic so that the statistics can be
+// read without taking any lock.
+class LayoutCache {
  public:
-  LayoutCache() : mCache(kMaxEntries) {
-    mCache.setOnEntryRemovedListener(this);
+  void clear() {
+    for (Shard& shard : mShards) {
+      std::scoped_lock lock(shard.mutex);
+      shard.cache.clear();
+    }
   }
 
-  void clear() { mCache.clear(); }
-
-  Layout* get(LayoutCacheKey& key,
-              LayoutContext* ctx,
-              const std::shared_ptr<FontCollection>& collection) {
-    Layout* layout = mCache.get(key);
-    if (layout == NULL) {
-      key.copyText();
-      layout = new Layout();
-      key.doLayout(layout, ctx, collection);
-      mCache.put(key, layout);
+  std::shared_ptr<Layout> get(
+      LayoutCacheKey& key,
+      LayoutContext* ctx,
+      const std::shared_ptr<FontCollection>& collection) {
+    Shard& shard = mShards[key.hash() % kShardCount];
+    {
+      std::scoped_lock lock(shard.mutex);
+      const std::shared_ptr<Layout>& cached = shard.cache.get(key);
+      if (cached) {
+        mHitCount.fetch_add(1, std::memory_order_relaxed);
+        return cached;
+      }
+    }
+    mMissCount.fetch_add(1, std::memory_order_relaxed);
+
+    // Shaping is by far the most expensive part, so do it without holding the
+    // shard lock. If another thread lays out the same word in the meantime,
+    // the layout that was cached first wins.
+    auto layout = std::make_shared<Layout>();
+    key.doLayout(layout.get(), ctx, collection);
+
+    std::scoped_lock lock(shard.mutex);
+    const std::shared_ptr<Layout>& cached = shard.cache.get(key);
+    if (cached) {
+      return cached;
+    }
+    key.copyText();
+    shard.cache.put(key, layout);
+    shard.entryCount.fetch_add(1, std::memory_order_relaxed);
+    shard.byteSize.fetch_add(key.getMemoryUsage() + layout->getMemoryUsage(),
+                             std::memory_order_relaxed);
+    while (shard.byteSize.load(std::memory_order_relaxed) >
+               kMaxBytes / kShardCount &&
+           shard.cache.size() > 1) {
+      shard.cache.removeOldest();
     }
     return layout;
   }
 
- private:
-  // callback for OnEntryRemoved
-  void operator()(LayoutCacheKey& key, Layout*& value) {
-    key.freeText();
-    delete value;
+  LayoutCacheStats getStats() const {
+    LayoutCacheStats stats = {};
+    for (const Shard& shard : mShards) {
+      stats.entryCount += shard.entryCount.load(std::memory_order_relaxed);
+      stats.byteSize += shard.byteSize.load(std::memory_order_relaxed);
+    }
+    stats.hitCount = mHitCount.load(std::memory_order_relaxed);
+    stats.missCount = mMissCount.load(std::memory_order_relaxed);
+    return stats;
   }
 
-  android::LruCache<LayoutCacheKey, Layout*> mCache;
+ private:
+  static const size_t kMaxBytes = 2 * 1024 * 1024;
+  static const size_t kShardCount = 16;
+
+  class Shard
+      : private android::OnEntryRemoved<LayoutCacheKey,
+                                        std::shared_ptr<Layout>> {
+   public:
+    Shard() : cache(decltype(cache)::kUnlimitedCapacity) {
+      cache.setOnEntryRemovedListener(this);
+    }
+
+    std::mutex mutex;
+    android::LruCache<LayoutCacheKey, std::shared_ptr<Layout>> cache;
+    std::atomic<size_t> entryCount{0};
+    std::atomic<size_t> byteSize{0};
 
-  // static const size_t kMaxEntries = LruCache<LayoutCacheKey,
-  // Layout*>::kUnlimitedCapacity;
+   private:
+    // callback for OnEntryRemoved
+    void operator()(LayoutCacheKey& key,
+                    std::shared_ptr<Layout>& value) override {
+      entryCount.fetch_sub(1, std::memory_order_relaxed);
+      byteSize.fetch_sub(key.getMemoryUsage() + value->getMemoryUsage(),
+                         std::memory_order_relaxed);
+      key.freeText();
+    }
+  };
 
-  // TODO: eviction based on memory footprint; for now, we just use a constant
-  // number of strings
-  static const size_t kMaxEntries = 5000;
+  Shard mShards[kShardCount];
+  std::atomic<uint64_t> mHitCount{0};
+  std::atomic<uint64_t> mMissCount{0};
 };
 
 class LayoutEngine {
  public:
   LayoutEngine() {
     unicodeFunctions = hb_unicode_funcs_create(hb_icu_get_unicode_funcs());
-    hbBuffer = hb_buffer_create();
-    hb_buffer_set_unicode_funcs(hbBuffer, unicodeFunctions);
   }
 
-  hb_buffer_t* hbBuffer;
   hb_unicode_funcs_t* unicodeFunctions;
   LayoutCache layoutCache;
 
@@ -183,8 +251,37 @@ class LayoutEngine {
     static LayoutEngine* instance = new LayoutEngine();
     return *instance;
   }
+
+  // Returns the buffer to shape into on the calling thread. HarfBuzz buffers
+  // can't be shared between threads.
+  hb_buffer_t* getHbBuffer();
 };
 
+namespace {
+
+class ThreadHbBuffer {
+ public:
+  explicit ThreadHbBuffer(hb_unicode_funcs_t* unicodeFunctions)
+      : buffer(hb_buffer_create()) {
+    hb_buffer_set_unicode_funcs(buffer, unicodeFunctions);
+  }
+
+  ~ThreadHbBuffer() { hb_buffer_destroy(buffer); }
+
+  hb_buffer_t* const buffer;
+};
+
+}  // namespace
+
+FML_THREAD_LOCAL fml::ThreadLocalUniquePtr<ThreadHbBuffer> tls_hb_buffer;
+
+hb_buffer_t* LayoutEngine::getHbBuffer() {
+  if (tls_hb_buffer.get() == nullptr) {
+    tls_hb_buffer.reset(new ThreadHbBuffer(unicodeFunctions));
+  }
+  return tls_hb_buffer.get()->buffer;
+}
+
 bool LayoutCacheKey::operator==(const LayoutCacheKey& other) const {
   return mId == other.mId && mStart == other.mStart && mCount == other.mCount &&
          mStyle == other.mStyle && mSize == other.mSize &&
@@ -254,34 +351,31 @@ static hb_bool_t harfbuzzGetGlyphHorizontalOrigin(hb_font_t* /* hbFont */,
   return true;
 }
 
-hb_font_funcs_t* getHbFontFuncs(bool forColorBitmapFont) {
-  assertMinikinLocked();
-
-  static hb_font_funcs_t* hbFuncs = nullptr;
-  static hb_font_funcs_t* hbFuncsForColorBitmap = nullptr;
-
-  hb_font_funcs_t** funcs =
-      forColorBitmapFont ? &hbFuncs : &hbFuncsForColorBitmap;
-  if (*funcs == nullptr) {
-    *funcs = hb_font_funcs_create();
-    if (forColorBitmapFont) {
-      // Don't override the h_advance function since we use HarfBuzz's
-      // implementation for emoji for performance reasons. Note that it is
-      // technically possible for a TrueType font to have outline and embedded
-      // bitmap at the same time. We ignore modified advances of hinted outline
-      // glyphs in that case.
-    } else {
-      // Override the h_advance function since we can't use HarfBuzz's
-      // implemenation. It may return the wrong value if the font uses hinting
-      // aggressively.
-      hb_font_funcs_set_glyph_h_advance_func(
-          *funcs, harfbuzzGetGlyphHorizontalAdvance, 0, 0);
-    }
-    hb_font_funcs_set_glyph_h_origin_func(
-        *funcs, harfbuzzGetGlyphHorizontalOrigin, 0, 0);
-    hb_font_funcs_make_immutable(*funcs);
+static hb_font_funcs_t* createHbFontFuncs(bool forColorBitmapFont) {
+  hb_font_funcs_t* funcs = hb_font_funcs_create();
+  if (forColorBitmapFont) {
+    // Don't override the h_advance function since we use HarfBuzz's
+    // implementation for emoji for performance reasons. Note that it is
+    // technically possible for a TrueType font to have outline and embedded
+    // bitmap at the same time. We ignore modified advances of hinted outline
+    // glyphs in that case.
+  } else {
+    // Override the h_advance function since we can't use HarfBuzz's
+    // implemenation. It may return the wrong value if the font uses hinting
+    // aggressively.
+    hb_font_funcs_set_glyph_h_advance_func(
+        funcs, harfbuzzGetGlyphHorizontalAdvance, 0, 0);
   }
-  return *funcs;
+  hb_font_funcs_set_glyph_h_origin_func(funcs, harfbuzzGetGlyphHorizontalOrigin,
+                                        0, 0);
+  hb_font_funcs_make_immutable(funcs);
+  return funcs;
+}
+
+hb_font_funcs_t* getHbFontFuncs(bool forColorBitmapFont) {
+  static hb_font_funcs_t* hbFuncs = createHbFontFuncs(false);
+  static hb_font_funcs_t* hbFuncsForColorBitmap = createHbFontFuncs(true);
+  return forColorBitmapFont ? hbFuncsForColorBitmap : hbFuncs;
 }
 
 static bool isColorBitmapFont(hb_font_t* font) {
@@ -316,7 +410,11 @@ int Layout::findFace(const FakedFont& face, LayoutContext* ctx) {
   // Note: ctx == NULL means we're copying from the cache, no need to create
   // corresponding hb_font object.
   if (ctx != NULL) {
-    hb_font_t* font = getHbFontLocked(face.font);
+    // The cached font is shared between threads, so the paint-dependent
+    // functions and scale are set on a sub font owned by this context.
+    hb_font_t* parent = getHbFont(face.font);
+    hb_font_t* font = hb_font_create_sub_font(parent);
+    hb_font_destroy(parent);
     hb_font_set_funcs(font, getHbFontFuncs(isColorBitmapFont(font)),
                       &ctx->paint, 0);
     ctx->hbFonts.push_back(font);
@@ -325,10 +423,7 @@ int Layout::findFace(const FakedFont& face, LayoutContext* ctx) {
 }
 
 static hb_script_t codePointToScript(hb_codepoint_t codepoint) {
-  static hb_unicode_funcs_t* u = 0;
-  if (!u) {
-    u = LayoutEngine::getInstance().unicodeFunctions;
-  }
+  static hb_unicode_funcs_t* u = LayoutEngine::getInstance().unicodeFunctions;
   return hb_unicode_script(u, codepoint);
 }
 
@@ -588,8 +683,6 @@ void Layout::doLayout(const uint16_t* buf,
                       const FontStyle& style,
                       const MinikinPaint& paint,
                       const std::shared_ptr<FontCollection>& collection) {
-  std::scoped_lock _l(gMinikinLock);
-
   LayoutContext ctx;
   ctx.style = style;
   ctx.paint = paint;
@@ -612,8 +705,6 @@ float Layout::measureText(const uint16_t* buf,
                           const MinikinPaint& paint,
                           const std::shared_ptr<FontCollection>& collection,
                           float* advances) {
-  std::scoped_lock _l(gMinikinLock);
-
   LayoutContext ctx;
   ctx.style = style;
   ctx.paint = paint;
@@ -720,9 +811,9 @@ float Layout::doLayoutWord(const uint16_t* buf,
     }
     advance = layoutForWord.getAdvance();
   } else {
-    Layout* layoutForWord = cache.get(key, ctx, collection);
+    std::shared_ptr<Layout> layoutForWord = cache.get(key, ctx, collection);
     if (layout) {
-      layout->appendLayout(layoutForWord, bufStart, wordSpacing);
+      layout->appendLayout(layoutForWord.get(), bufStart, wordSpacing);
     }
     if (advances) {
       layoutForWord->getAdvances(advances);
@@ -748,7 +839,7 @@ static void addFeatures(const std::string& str,
   const char* end = start + str.size();
 
   while (start < end) {
-    static hb_feature_t feature;
+    hb_feature_t feature;
     const char* p = strchr(start, ',');
     if (!p)
       p = end;
@@ -919,7 +1010,7 @@ void Layout::doLayoutRun(const uint16_t* buf,
                          bool isRtl,
                          LayoutContext* ctx,
                          const std::shared_ptr<FontCollection>& collection) {
-  hb_buffer_t* buffer = LayoutEngine::getInstance().hbBuffer;
+  hb_buffer_t* buffer = LayoutEngine::getInstance().getHbBuffer();
   std::vector<FontCollection::Run> items;
   collection->itemize(buf + start, count, ctx->style, &items);
 
@@ -1192,11 +1283,20 @@ void Layout::getBounds(MinikinRect* bounds) const {
   bounds->set(mBounds);
 }
 
+size_t Layout::getMemoryUsage() const {
+  return sizeof(Layout) + mGlyphs.capacity() * sizeof(LayoutGlyph) +
+         mAdvances.capacity() * sizeof(float) +
+         mFaces.capacity() * sizeof(FakedFont);
+}
+
 void Layout::purgeCaches() {
-  std::scoped_lock _l(gMinikinLock);
   LayoutCache& layoutCache = LayoutEngine::getInstance().layoutCache;
   layoutCache.clear();
-  purgeHbFontCacheLocked();
+  purgeHbFontCache();
+}
+
+LayoutCacheStats Layout::getCacheStats() {
+  return LayoutEngine::getInstance().layoutCache.getStats();
 }
 
 }  // namespace minikin
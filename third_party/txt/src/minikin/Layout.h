@@ -57,6 +57,14 @@ enum {
   kBidi_Mask = 0x7
 };
 
+// Statistics of the cache of shaped words that is shared by all layouts.
+struct LayoutCacheStats {
+  size_t entryCount;
+  size_t byteSize;
+  uint64_t hitCount;
+  uint64_t missCount;
+};
+
 // Lifecycle and threading assumptions for Layout:
 // The object is assumed to be owned by a single thread; multiple threads
 // may not mutate it at the same time.
@@ -114,9 +122,17 @@ class Layout {
 
   void getBounds(MinikinRect* rect) const;
 
+  // Approximate number of heap bytes held by this layout, including the
+  // object itself.
+  size_t getMemoryUsage() const;
+
   // Purge all caches, useful in low memory conditions
   static void purgeCaches();
 
+  // Cheap enough to call on every layout, as no lock is taken. The counts of
+  // the different shards may be slightly out of sync with each other.
+  static LayoutCacheStats getCacheStats();
+
  private:
   friend class LayoutCacheKey;
 
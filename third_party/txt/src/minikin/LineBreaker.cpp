@@ -128,13 +128,28 @@ float LineBreaker::addStyleRun(MinikinPaint* paint,
                                size_t end,
                                bool isRtl) {
   float width = 0.0f;
-
-  float hyphenPenalty = 0.0;
   if (paint != nullptr) {
     width = Layout::measureText(mTextBuf.data(), start, end - start,
                                 mTextBuf.size(), isRtl, style, *paint, typeface,
                                 mCharWidths.data() + start);
+  }
+  addMeasuredStyleRun(paint, typeface, style, start, end, isRtl);
+  return width;
+}
 
+// libtxt: Finds the candidate breaks of a run whose widths are already in the
+// width buffer. Unlike calling addStyleRun with a nullptr paint, the paint is
+// still used to compute the hyphenation and line penalties, so the breaks are
+// the same as if the run had been measured again.
+void LineBreaker::addMeasuredStyleRun(
+    MinikinPaint* paint,
+    const std::shared_ptr<FontCollection>& typeface,
+    FontStyle style,
+    size_t start,
+    size_t end,
+    bool isRtl) {
+  float hyphenPenalty = 0.0;
+  if (paint != nullptr) {
     // a heuristic that seems to perform well
     hyphenPenalty =
         0.5 * paint->size * paint->scaleX * mLineWidths.getLineWidth(0);
@@ -228,8 +243,6 @@ float LineBreaker::addStyleRun(MinikinPaint* paint,
       current = (size_t)mWordBreaker.next();
     }
   }
-
-  return width;
 }
 
 // add a word break (possibly for a hyphenated fragment), and add desperate
@@ -148,6 +148,15 @@ class LineBreaker {
                     size_t end,
                     bool isRtl);
 
+  // libtxt: Like addStyleRun, but uses widths that were stored in charWidths()
+  // by an earlier measurement of the same run instead of shaping it again.
+  void addMeasuredStyleRun(MinikinPaint* paint,
+                           const std::shared_ptr<FontCollection>& typeface,
+                           FontStyle style,
+                           size_t start,
+                           size_t end,
+                           bool isRtl);
+
   void addReplacement(size_t start, size_t end, float width);
 
   size_t computeBreaks();
@@ -19,22 +19,17 @@
 #ifndef MINIKIN_INTERNAL_H
 #define MINIKIN_INTERNAL_H
 
-#include <mutex>
-
 #include <hb.h>
 
 #include <minikin/MinikinFont.h>
 
 namespace minikin {
 
-// All external Minikin interfaces are designed to be thread-safe.
-// Presently, that's implemented by through a global lock, and having
-// all external interfaces take that lock.
-
-extern std::recursive_mutex gMinikinLock;
-
-// Aborts if gMinikinLock is not acquired. Do nothing on the release build.
-void assertMinikinLocked();
+// All external Minikin interfaces are designed to be thread-safe. Rather than
+// serializing every call on a global lock, each piece of shared state (the
+// layout cache, the HarfBuzz font cache and the language list cache) is
+// guarded by its own lock, so that layouts on different threads only contend
+// when they touch the same cache entries.
 
 hb_blob_t* getFontTable(const MinikinFont* minikinFont, uint32_t tag);
 
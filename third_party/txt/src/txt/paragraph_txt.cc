@@ -28,6 +28,7 @@
 #include <vector>
 
 #include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
 #include "font_collection.h"
 #include "font_skia.h"
 #include "minikin/FontLanguageListCache.h"
@@ -187,6 +188,19 @@ void FindWords(const std::vector<uint16_t>& text,
     words->emplace_back(word_start, end);
 }
 
+// Reports the state of minikin's cache of shaped words, which is shared by all
+// paragraphs, to the timeline.
+void TraceLayoutCacheStats() {
+#if !FLUTTER_RELEASE
+  minikin::LayoutCacheStats stats = minikin::Layout::getCacheStats();
+  FML_TRACE_COUNTER("flutter", "LayoutCache", 0,      //
+                    "Entries", stats.entryCount,      //
+                    "KBytes", stats.byteSize / 1024,  //
+                    "Hits", stats.hitCount,           //
+                    "Misses", stats.missCount);
+#endif  // !FLUTTER_RELEASE
+}
+
 }  // namespace
 
 static const float kDoubleDecorationSpacing = 3.0f;
@@ -246,6 +260,7 @@ void ParagraphTxt::SetInlinePlaceholders(
     std::vector<PlaceholderRun> inline_placeholders,
     std::unordered_set<size_t> obj_replacement_char_indexes) {
   needs_layout_ = true;
+  needs_shaping_ = true;
   inline_placeholders_ = std::move(inline_placeholders);
   obj_replacement_char_indexes_ = std::move(obj_replacement_char_indexes);
 }
@@ -253,7 +268,10 @@ void ParagraphTxt::SetInlinePlaceholders(
 bool ParagraphTxt::ComputeLineBreaks() {
   line_metrics_.clear();
   line_widths_.clear();
-  max_intrinsic_width_ = 0;
+  if (needs_shaping_) {
+    max_intrinsic_width_ = 0;
+    char_widths_.assign(text_.size(), 0);
+  }
 
   std::vector<size_t> newline_positions;
   // Discover and add all hard breaks.
@@ -293,6 +311,10 @@ bool ParagraphTxt::ComputeLineBreaks() {
     memcpy(breaker_.buffer(), text_.data() + block_start,
            block_size * sizeof(text_[0]));
     breaker_.setText();
+    if (!needs_shaping_) {
+      memcpy(breaker_.charWidths(), char_widths_.data() + block_start,
+             block_size * sizeof(char_widths_[0]));
+    }
 
     // Add the runs that include this line to the LineBreaker.
     double block_total_width = 0;
@@ -342,18 +364,27 @@ bool ParagraphTxt::ComputeLineBreaks() {
         breaker_.addStyleRun(nullptr, collection, font, run_start, run_end,
                              isRtl);
         inline_placeholder_index++;
-      } else {
+      } else if (needs_shaping_) {
         // Is a regular text run.
         double run_width = breaker_.addStyleRun(&paint, collection, font,
                                                 run_start, run_end, isRtl);
         block_total_width += run_width;
+      } else {
+        // Is a regular text run that was measured by an earlier layout.
+        breaker_.addMeasuredStyleRun(&paint, collection, font, run_start,
+                                     run_end, isRtl);
       }
 
       if (run.end > block_end)
         break;
       run_index++;
     }
-    max_intrinsic_width_ = std::max(max_intrinsic_width_, block_total_width);
+    if (needs_shaping_) {
+      max_intrinsic_width_ =
+          std::max(max_intrinsic_width_, block_total_width);
+      memcpy(char_widths_.data() + block_start, breaker_.charWidths(),
+             block_size * sizeof(char_widths_[0]));
+    }
 
     size_t breaks_count = breaker_.computeBreaks();
     const int* breaks = breaker_.getBreaks();
@@ -686,9 +717,11 @@ void ParagraphTxt::Layout(double width) {
   if (!ComputeLineBreaks())
     return;
 
-  std::vector<BidiRun> bidi_runs;
-  if (!ComputeBidiRuns(&bidi_runs))
-    return;
+  if (needs_shaping_) {
+    bidi_runs_.clear();
+    if (!ComputeBidiRuns(&bidi_runs_))
+      return;
+  }
 
   SkFont font;
   font.setEdging(SkFont::Edging::kAntiAlias);
@@ -701,8 +734,14 @@ void ParagraphTxt::Layout(double width) {
   double prev_max_descent = 0;
   double max_word_width = 0;
 
-  // Compute strut minimums according to paragraph_style_.
-  ComputeStrut(&strut_, font);
+  if (needs_shaping_) {
+    // Compute strut minimums according to paragraph_style_.
+    ComputeStrut(&strut_, font);
+    TraceLayoutCacheStats();
+  }
+
+  // Everything below depends on the width and is recomputed on every layout.
+  needs_shaping_ = false;
 
   // Paragraph bounds tracking.
   size_t line_limit =
@@ -739,7 +778,7 @@ void ParagraphTxt::Layout(double width) {
 
     // Find the runs comprising this line.
     std::vector<BidiRun> line_runs;
-    for (const BidiRun& bidi_run : bidi_runs) {
+    for (const BidiRun& bidi_run : bidi_runs_) {
       // A "ghost" run is a run that does not impact the layout, breaking,
       // alignment, width, etc but is still "visible" through getRectsForRange.
       // For example, trailing whitespace on centered text can be scrolled
@@ -1369,11 +1408,13 @@ double ParagraphTxt::GetLongestLine() {
 
 void ParagraphTxt::SetParagraphStyle(const ParagraphStyle& style) {
   needs_layout_ = true;
+  needs_shaping_ = true;
   paragraph_style_ = style;
 }
 
 void ParagraphTxt::SetFontCollection(
     std::shared_ptr<FontCollection> font_collection) {
+  needs_shaping_ = true;
   font_collection_ = std::move(font_collection);
 }
 
@@ -2016,6 +2057,8 @@ bool ParagraphTxt::DidExceedMaxLines() {
 
 void ParagraphTxt::SetDirty(bool dirty) {
   needs_layout_ = dirty;
+  if (dirty)
+    needs_shaping_ = true;
 }
 
 std::vector<LineMetrics>& ParagraphTxt::GetLineMetrics() {
@@ -124,6 +124,9 @@ class ParagraphTxt : public Paragraph {
   // Sets the needs_layout_ to dirty. When Layout() is called, a new Layout will
   // be performed when this is set to true. Can also be used to prevent a new
   // Layout from being calculated by setting to false.
+  //
+  // Setting this to true also discards the shaping results that Layout()
+  // otherwise reuses when only the width changes.
   void SetDirty(bool dirty = true);
 
  private:
@@ -300,6 +303,15 @@ class ParagraphTxt : public Paragraph {
     void Shift(double delta);
   };
 
+  // The results of Layout() below do not depend on the width, and are reused
+  // when only the width changes. They are recomputed when needs_shaping_ is
+  // set, which happens whenever the text, styles or fonts may have changed.
+  bool needs_shaping_ = true;
+  // The advance of each code unit of text_, as measured for line breaking.
+  std::vector<float> char_widths_;
+  // The bidi runs of text_ in visual order.
+  std::vector<BidiRun> bidi_runs_;
+
   // Holds the laid out x positions of each glyph.
   std::vector<GlyphLine> glyph_lines_;
 
@@ -342,7 +354,8 @@ class ParagraphTxt : public Paragraph {
       std::vector<PlaceholderRun> inline_placeholders,
       std::unordered_set<size_t> obj_replacement_char_indexes);
 
-  // Break the text into lines.
+  // Break the text into lines. Reuses char_widths_ unless needs_shaping_ is
+  // set, in which case the text is measured again and char_widths_ updated.
   bool ComputeLineBreaks();
 
   // Break the text into runs based on LTR/RTL text direction.
@@ -18,6 +18,7 @@
 #include <iostream>
 
 #include "flutter/fml/logging.h"
+#include "minikin/Layout.h"
 #include "render_test.h"
 #include "third_party/icu/source/common/unicode/unistr.h"
 #include "third_party/skia/include/core/SkColor.h"
@@ -5913,6 +5914,101 @@ TEST_F(ParagraphTest, RepeatLayoutParagraph) {
   ASSERT_TRUE(Snapshot());
 }
 
+TEST_F(ParagraphTest, RelayoutAtNewWidthMatchesFreshLayout) {
+  const char* text =
+      "Sentence to layout at diff widths to get diff line counts. short words "
+      "short words short words short words short words short words short words "
+      "short words short words short words short words short words short words "
+      "end";
+  auto icu_text = icu::UnicodeString::fromUTF8(text);
+  std::u16string u16_text(icu_text.getBuffer(),
+                          icu_text.getBuffer() + icu_text.length());
+
+  txt::ParagraphStyle paragraph_style;
+  paragraph_style.break_strategy = minikin::kBreakStrategy_HighQuality;
+
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  text_style.font_size = 31;
+  text_style.letter_spacing = 1;
+  text_style.color = SK_ColorBLACK;
+  txt::TextStyle large_style = text_style;
+  large_style.font_size = 45;
+
+  auto build_paragraph = [&]() {
+    txt::ParagraphBuilderTxt builder(paragraph_style, GetTestFontCollection());
+    builder.PushStyle(text_style);
+    builder.AddText(u16_text);
+    builder.PushStyle(large_style);
+    builder.AddText(u16_text);
+    builder.Pop();
+    builder.Pop();
+    return BuildParagraph(builder);
+  };
+
+  auto relaid_paragraph = build_paragraph();
+  relaid_paragraph->Layout(300);
+  relaid_paragraph->Layout(550);
+
+  auto fresh_paragraph = build_paragraph();
+  fresh_paragraph->Layout(550);
+
+  ASSERT_EQ(relaid_paragraph->GetLineCount(), fresh_paragraph->GetLineCount());
+  EXPECT_EQ(relaid_paragraph->GetHeight(), fresh_paragraph->GetHeight());
+  EXPECT_EQ(relaid_paragraph->GetLongestLine(),
+            fresh_paragraph->GetLongestLine());
+  EXPECT_EQ(relaid_paragraph->GetMaxIntrinsicWidth(),
+            fresh_paragraph->GetMaxIntrinsicWidth());
+  EXPECT_EQ(relaid_paragraph->GetMinIntrinsicWidth(),
+            fresh_paragraph->GetMinIntrinsicWidth());
+  std::vector<LineMetrics>& relaid_lines = relaid_paragraph->GetLineMetrics();
+  std::vector<LineMetrics>& fresh_lines = fresh_paragraph->GetLineMetrics();
+  for (size_t i = 0; i < fresh_lines.size(); ++i) {
+    EXPECT_EQ(relaid_lines[i].start_index, fresh_lines[i].start_index);
+    EXPECT_EQ(relaid_lines[i].end_index, fresh_lines[i].end_index);
+    EXPECT_EQ(relaid_lines[i].width, fresh_lines[i].width);
+  }
+}
+
+TEST_F(ParagraphTest, ShapedWordsAreSharedBetweenParagraphs) {
+  auto font_collection = GetTestFontCollection();
+
+  txt::ParagraphStyle paragraph_style;
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  text_style.font_size = 26;
+  text_style.color = SK_ColorBLACK;
+
+  auto build_paragraph = [&](const std::u16string& text) {
+    txt::ParagraphBuilderTxt builder(paragraph_style, font_collection);
+    builder.PushStyle(text_style);
+    builder.AddText(text);
+    builder.Pop();
+    return BuildParagraph(builder);
+  };
+
+  minikin::Layout::purgeCaches();
+
+  auto first_paragraph = build_paragraph(u"apple banana cherry");
+  first_paragraph->Layout(GetTestCanvasWidth());
+  minikin::LayoutCacheStats first_stats = minikin::Layout::getCacheStats();
+  EXPECT_GT(first_stats.entryCount, 0u);
+  EXPECT_GT(first_stats.byteSize, 0u);
+
+  // Every word of the second paragraph was already shaped for the first one.
+  auto second_paragraph = build_paragraph(u"cherry apple banana");
+  second_paragraph->Layout(GetTestCanvasWidth());
+  minikin::LayoutCacheStats second_stats = minikin::Layout::getCacheStats();
+  EXPECT_EQ(second_stats.entryCount, first_stats.entryCount);
+  EXPECT_EQ(second_stats.missCount, first_stats.missCount);
+  EXPECT_GT(second_stats.hitCount, first_stats.hitCount);
+
+  font_collection->ClearFontFamilyCache();
+  minikin::LayoutCacheStats cleared_stats = minikin::Layout::getCacheStats();
+  EXPECT_EQ(cleared_stats.entryCount, 0u);
+  EXPECT_EQ(cleared_stats.byteSize, 0u);
+}
+
 TEST_F(ParagraphTest, Ellipsize) {
   const char* text =
       "This is a very long sentence to test if the text will properly wrap "